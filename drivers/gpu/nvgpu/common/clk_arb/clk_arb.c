@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -34,6 +34,7 @@
 #include <nvgpu/timers.h>
 #include <nvgpu/worker.h>
 #include <nvgpu/gk20a.h>
+#include <nvgpu/string.h>
 #ifdef CONFIG_NVGPU_LS_PMU
 #include <nvgpu/pmu/clk/clk.h>
 #include <nvgpu/pmu/perf.h>
@@ -111,23 +112,60 @@ void nvgpu_clk_arb_set_global_alarm(struct gk20a *g, u32 alarm)
 }
 
 #ifdef CONFIG_NVGPU_LS_PMU
+/*
+ * Drop the cached GPC2CLK F-points and their slave clocks, the next VF table
+ * update queries them again.
+ */
+void nvgpu_clk_arb_invalidate_vf_table(struct nvgpu_clk_arb *arb)
+{
+	nvgpu_clk_arb_vf_cache_invalidate(&arb->vf_cache);
+}
+
+static int nvgpu_clk_arb_vf_get_f_points(struct gk20a *g, u32 *num_points,
+	u16 *freqs_in_mhz)
+{
+	return g->ops.clk.clk_domain_get_f_points(g, CTRL_CLK_DOMAIN_GPCCLK,
+		num_points, freqs_in_mhz);
+}
+
+static int nvgpu_clk_arb_vf_get_slave_clks(struct gk20a *g,
+	struct nvgpu_clk_vf_point *point)
+{
+	struct nvgpu_clk_slave_freq setfllclk;
+	int status;
+
+	(void) memset(&setfllclk, 0, sizeof(setfllclk));
+	setfllclk.gpc_mhz = point->gpc_mhz;
+
+	status = g->ops.clk_arb.get_arbiter_slave_clks(g, &setfllclk);
+	if (status < 0) {
+		return status;
+	}
+
+	point->sys_mhz = setfllclk.sys_mhz;
+	point->xbar_mhz = setfllclk.xbar_mhz;
+	point->nvd_mhz = setfllclk.nvd_mhz;
+	point->host_mhz = setfllclk.host_mhz;
+
+	return 0;
+}
+
+static const struct nvgpu_clk_arb_vf_source nvgpu_clk_arb_vf_source = {
+	.refresh_vf_points = nvgpu_clk_vf_point_cache,
+	.get_f_points = nvgpu_clk_arb_vf_get_f_points,
+	.get_slave_clks = nvgpu_clk_arb_vf_get_slave_clks,
+};
+
 int nvgpu_clk_arb_update_vf_table(struct nvgpu_clk_arb *arb)
 {
 	struct gk20a *g = arb->g;
 	struct nvgpu_clk_vf_table *table;
-
-	u32 i, j;
+	struct nvgpu_clk_arb_vf_limits limits;
 	int status = -EINVAL;
-	u16 clk_cur;
-	u32 num_points;
-
-	struct nvgpu_pmu_perf_pstate_clk_info *p0_info;
 
 	table = NV_READ_ONCE(arb->current_vf_table);
 	/* make flag visible when all data has resolved in the tables */
 	nvgpu_smp_rmb();
-	table = (table == &arb->vf_table_pool[0]) ? &arb->vf_table_pool[1] :
-		&arb->vf_table_pool[0];
 
 	/* Get allowed memory ranges */
 	if (g->ops.clk_arb.get_arbiter_clk_range(g, CTRL_CLK_DOMAIN_GPCCLK,
@@ -144,77 +182,36 @@ int nvgpu_clk_arb_update_vf_table(struct nvgpu_clk_arb *arb)
 		goto exit_vf_table;
 	}
 
-	table->gpc2clk_num_points = MAX_F_POINTS;
-	table->mclk_num_points = MAX_F_POINTS;
-	if (g->ops.clk.clk_domain_get_f_points(arb->g, CTRL_CLK_DOMAIN_GPCCLK,
-		&table->gpc2clk_num_points, arb->gpc2clk_f_points)) {
-		nvgpu_err(g, "failed to fetch GPC2CLK frequency points");
-		goto exit_vf_table;
-	}
-	if (!table->gpc2clk_num_points) {
-		nvgpu_err(g, "empty queries to f points gpc2clk %d", table->gpc2clk_num_points);
-		status = -EINVAL;
-		goto exit_vf_table;
-	}
-
-	(void) memset(table->gpc2clk_points, 0,
-		table->gpc2clk_num_points*sizeof(struct nvgpu_clk_vf_point));
-
-	p0_info = nvgpu_pmu_perf_pstate_get_clk_set_info(g,
-			CTRL_PERF_PSTATE_P0, CLKWHICH_GPCCLK);
-	if (!p0_info) {
-		status = -EINVAL;
+	limits.gpc2clk_min = arb->gpc2clk_min;
+	limits.gpc2clk_max = arb->gpc2clk_max;
+	if (g->ops.clk_arb.get_arbiter_pstate_range(g, CTRL_PERF_PSTATE_P0,
+			CTRL_CLK_DOMAIN_GPCCLK, &limits.p0_min,
+			&limits.p0_max) < 0) {
 		nvgpu_err(g, "failed to get GPC2CLK P0 info");
 		goto exit_vf_table;
 	}
 
-	/* GPC2CLK needs to be checked in two passes. The first determines the
-	 * relationships between GPC2CLK, SYS2CLK and XBAR2CLK, while the
-	 * second verifies that the clocks minimum is satisfied and sets
-	 * the voltages,the later part is done in nvgpu_pmu_perf_changeseq_set_clks
+	/*
+	 * The F-points and their slave clocks only change when the VF curve
+	 * is refreshed, which drops the points which moved. Until then an
+	 * update with unchanged limits keeps the current table.
 	 */
-	j = 0; num_points = 0; clk_cur = 0;
-	for (i = 0; i < table->gpc2clk_num_points; i++) {
-		struct nvgpu_clk_slave_freq setfllclk;
-
-		if ((arb->gpc2clk_f_points[i] >= arb->gpc2clk_min) &&
-			(arb->gpc2clk_f_points[i] <= arb->gpc2clk_max) &&
-			(arb->gpc2clk_f_points[i] != clk_cur)) {
-
-			table->gpc2clk_points[j].gpc_mhz =
-				arb->gpc2clk_f_points[i];
-			setfllclk.gpc_mhz = arb->gpc2clk_f_points[i];
-
-			status = clk_get_fll_clks_per_clk_domain(g, &setfllclk);
-			if (status < 0) {
-				nvgpu_err(g,
-					"failed to get GPC2CLK slave clocks");
-				goto exit_vf_table;
-			}
+	if ((table != NULL) &&
+			nvgpu_clk_arb_vf_cache_is_current(&arb->vf_cache,
+				&limits)) {
+		status = 0;
+		goto exit_vf_table;
+	}
 
-			table->gpc2clk_points[j].sys_mhz =
-				setfllclk.sys_mhz;
-			table->gpc2clk_points[j].xbar_mhz =
-				setfllclk.xbar_mhz;
-			table->gpc2clk_points[j].nvd_mhz =
-				setfllclk.nvd_mhz;
-			table->gpc2clk_points[j].host_mhz =
-				setfllclk.host_mhz;
-
-			clk_cur = table->gpc2clk_points[j].gpc_mhz;
-
-			if ((clk_cur >= p0_info->min_mhz) &&
-					(clk_cur <= p0_info->max_mhz)) {
-				VF_POINT_SET_PSTATE_SUPPORTED(
-					&table->gpc2clk_points[j],
-					CTRL_PERF_PSTATE_P0);
-			}
+	table = (table == &arb->vf_table_pool[0]) ? &arb->vf_table_pool[1] :
+		&arb->vf_table_pool[0];
+	table->mclk_num_points = MAX_F_POINTS;
 
-			j++;
-			num_points++;
-		}
+	status = nvgpu_clk_arb_vf_cache_build(g, &arb->vf_cache,
+			&nvgpu_clk_arb_vf_source, &limits, table);
+	if (status < 0) {
+		goto exit_vf_table;
 	}
-	table->gpc2clk_num_points = num_points;
 
 	/* make table visible when all data has resolved in the tables */
 	nvgpu_smp_wmb();
@@ -236,10 +233,10 @@ static void nvgpu_clk_arb_run_vf_table_cb(struct nvgpu_clk_arb *arb)
 	struct gk20a *g = arb->g;
 	int err;
 
-	/* get latest vf curve from pmu */
-	err = nvgpu_clk_vf_point_cache(g);
+	/* get latest vf curve from pmu, dropping the F-points which moved */
+	err = nvgpu_clk_arb_vf_cache_refresh(g, &arb->vf_cache,
+			&nvgpu_clk_arb_vf_source);
 	if (err != 0) {
-		nvgpu_err(g, "failed to cache VF table");
 		nvgpu_clk_arb_set_global_alarm(g,
 			EVENT(ALARM_VF_TABLE_UPDATE_FAILED));
 		nvgpu_clk_arb_worker_enqueue(g, &arb->update_arb_work_item);
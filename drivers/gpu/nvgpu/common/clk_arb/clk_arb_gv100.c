@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -162,6 +162,42 @@ int gv100_get_arbiter_clk_default(struct gk20a *g, u32 api_domain,
 	return 0;
 }
 
+int gv100_get_arbiter_slave_clks(struct gk20a *g,
+		struct nvgpu_clk_slave_freq *setfllclk)
+{
+	return clk_get_fll_clks_per_clk_domain(g, setfllclk);
+}
+
+int gv100_get_arbiter_pstate_range(struct gk20a *g, u32 pstate,
+		u32 api_domain, u16 *min_mhz, u16 *max_mhz)
+{
+	struct nvgpu_pmu_perf_pstate_clk_info *info;
+	u32 clkwhich;
+
+	switch (api_domain) {
+	case CTRL_CLK_DOMAIN_MCLK:
+		clkwhich = CLKWHICH_MCLK;
+		break;
+
+	case CTRL_CLK_DOMAIN_GPCCLK:
+		clkwhich = CLKWHICH_GPCCLK;
+		break;
+
+	default:
+		return -EINVAL;
+	}
+
+	info = nvgpu_pmu_perf_pstate_get_clk_set_info(g, pstate, clkwhich);
+	if (info == NULL) {
+		return -EINVAL;
+	}
+
+	*min_mhz = info->min_mhz;
+	*max_mhz = info->max_mhz;
+
+	return 0;
+}
+
 int gv100_init_clk_arbiter(struct gk20a *g)
 {
 	struct nvgpu_clk_arb *arb;
@@ -190,9 +226,8 @@ int gv100_init_clk_arbiter(struct gk20a *g)
 		goto init_fail;
 	}
 
-	arb->gpc2clk_f_points = nvgpu_kcalloc(g, MAX_F_POINTS, sizeof(u16));
-	if (arb->gpc2clk_f_points == NULL) {
-		err = -ENOMEM;
+	err = nvgpu_clk_arb_vf_cache_init(g, &arb->vf_cache);
+	if (err != 0) {
 		goto init_fail;
 	}
 
@@ -297,7 +332,7 @@ int gv100_init_clk_arbiter(struct gk20a *g)
 	return arb->status;
 
 init_fail:
-	nvgpu_kfree(g, arb->gpc2clk_f_points);
+	nvgpu_clk_arb_vf_cache_deinit(g, &arb->vf_cache);
 	nvgpu_kfree(g, arb->mclk_f_points);
 
 	for (index = 0; index < 2; index++) {
@@ -539,7 +574,7 @@ void gv100_clk_arb_cleanup(struct nvgpu_clk_arb *arb)
 	struct gk20a *g = arb->g;
 	int index;
 
-	nvgpu_kfree(g, arb->gpc2clk_f_points);
+	nvgpu_clk_arb_vf_cache_deinit(g, &arb->vf_cache);
 	nvgpu_kfree(g, arb->mclk_f_points);
 
 	for (index = 0; index < 2; index++) {
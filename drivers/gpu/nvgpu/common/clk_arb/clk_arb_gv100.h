@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -24,6 +24,7 @@
 
 struct nvgpu_clk_session;
 struct nvgpu_clk_arb;
+struct nvgpu_clk_slave_freq;
 
 #define DVCO_MIN_DEFAULT_MHZ	405
 
@@ -35,6 +36,10 @@ int gv100_get_arbiter_clk_range(struct gk20a *g, u32 api_domain,
 		u16 *min_mhz, u16 *max_mhz);
 int gv100_get_arbiter_clk_default(struct gk20a *g, u32 api_domain,
 		u16 *default_mhz);
+int gv100_get_arbiter_slave_clks(struct gk20a *g,
+		struct nvgpu_clk_slave_freq *setfllclk);
+int gv100_get_arbiter_pstate_range(struct gk20a *g, u32 pstate,
+		u32 api_domain, u16 *min_mhz, u16 *max_mhz);
 int gv100_init_clk_arbiter(struct gk20a *g);
 void gv100_clk_arb_run_arbiter_cb(struct nvgpu_clk_arb *arb);
 void gv100_clk_arb_cleanup(struct nvgpu_clk_arb *arb);
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <nvgpu/types.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/log.h>
+#include <nvgpu/string.h>
+#include <nvgpu/clk_arb.h>
+#include <nvgpu/pmu/perf.h>
+
+int nvgpu_clk_arb_vf_cache_init(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache)
+{
+	(void) memset(cache, 0, sizeof(*cache));
+
+	cache->f_points = nvgpu_kcalloc(g, MAX_F_POINTS, sizeof(u16));
+	if (cache->f_points == NULL) {
+		return -ENOMEM;
+	}
+
+	cache->refresh_f_points = nvgpu_kcalloc(g, MAX_F_POINTS, sizeof(u16));
+	cache->points = nvgpu_kcalloc(g, MAX_F_POINTS,
+		sizeof(struct nvgpu_clk_vf_point));
+	if ((cache->refresh_f_points == NULL) || (cache->points == NULL)) {
+		nvgpu_clk_arb_vf_cache_deinit(g, cache);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void nvgpu_clk_arb_vf_cache_deinit(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache)
+{
+	nvgpu_kfree(g, cache->points);
+	nvgpu_kfree(g, cache->refresh_f_points);
+	nvgpu_kfree(g, cache->f_points);
+	cache->points = NULL;
+	cache->refresh_f_points = NULL;
+	cache->f_points = NULL;
+	cache->valid = false;
+}
+
+/*
+ * Drop the cached F-points and their slave clocks, the next build queries
+ * them again.
+ */
+void nvgpu_clk_arb_vf_cache_invalidate(struct nvgpu_clk_arb_vf_cache *cache)
+{
+	cache->valid = false;
+}
+
+/*
+ * Fetch the latest VF curve and compare its F-points with the cached ones.
+ * Only the F-points which moved are resolved again, and the last table is
+ * kept if none did.
+ */
+int nvgpu_clk_arb_vf_cache_refresh(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_source *src)
+{
+	u32 num_points = MAX_F_POINTS;
+	bool moved = false;
+	u32 i;
+
+	if (src->refresh_vf_points(g) != 0) {
+		nvgpu_err(g, "failed to cache VF table");
+		return -EINVAL;
+	}
+
+	if (!cache->valid) {
+		/* the next build queries the F-points */
+		return 0;
+	}
+
+	if ((src->get_f_points(g, &num_points,
+			cache->refresh_f_points) != 0) ||
+	    (num_points != cache->num_points)) {
+		/* let the next build query the F-points again */
+		nvgpu_clk_arb_vf_cache_invalidate(cache);
+		return 0;
+	}
+
+	for (i = 0U; i < num_points; i++) {
+		if (cache->refresh_f_points[i] != cache->f_points[i]) {
+			cache->f_points[i] = cache->refresh_f_points[i];
+			(void) memset(&cache->points[i], 0,
+				sizeof(struct nvgpu_clk_vf_point));
+			moved = true;
+		}
+	}
+	if (moved) {
+		cache->built = false;
+	}
+
+	return 0;
+}
+
+/*
+ * Check whether the last table built from the cache is still valid for the
+ * given limits. Counted as a skipped update if it is.
+ */
+bool nvgpu_clk_arb_vf_cache_is_current(struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_limits *limits)
+{
+	if (!cache->valid || !cache->built ||
+	    (cache->limits.gpc2clk_min != limits->gpc2clk_min) ||
+	    (cache->limits.gpc2clk_max != limits->gpc2clk_max) ||
+	    (cache->limits.p0_min != limits->p0_min) ||
+	    (cache->limits.p0_max != limits->p0_max)) {
+		return false;
+	}
+
+	cache->stats.skipped++;
+	return true;
+}
+
+static int nvgpu_clk_arb_vf_cache_fill(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_source *src)
+{
+	u32 num_points = MAX_F_POINTS;
+
+	if (src->get_f_points(g, &num_points, cache->f_points) != 0) {
+		nvgpu_err(g, "failed to fetch GPC2CLK frequency points");
+		return -EINVAL;
+	}
+	if ((num_points == 0U) || (num_points > MAX_F_POINTS)) {
+		nvgpu_err(g, "bad number of GPC2CLK f points %u", num_points);
+		return -EINVAL;
+	}
+
+	cache->num_points = num_points;
+	(void) memset(cache->points, 0,
+		MAX_F_POINTS * sizeof(struct nvgpu_clk_vf_point));
+	cache->valid = true;
+
+	return 0;
+}
+
+/* Look up the slave clocks of F-point i unless already cached. */
+static int nvgpu_clk_arb_vf_cache_resolve(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_source *src, u32 i)
+{
+	struct nvgpu_clk_vf_point point;
+	int status;
+
+	if (cache->points[i].gpc_mhz != 0U) {
+		return 0;
+	}
+
+	(void) memset(&point, 0, sizeof(point));
+	point.gpc_mhz = cache->f_points[i];
+
+	status = src->get_slave_clks(g, &point);
+	if (status < 0) {
+		nvgpu_err(g, "failed to get GPC2CLK slave clocks");
+		return status;
+	}
+
+	point.gpc_mhz = cache->f_points[i];
+	cache->points[i] = point;
+	cache->stats.points_resolved++;
+
+	return 0;
+}
+
+/*
+ * Build a VF table for the given limits from the cache, filling the cache
+ * as needed.
+ */
+int nvgpu_clk_arb_vf_cache_build(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_source *src,
+		const struct nvgpu_clk_arb_vf_limits *limits,
+		struct nvgpu_clk_vf_table *table)
+{
+	u32 i, j;
+	u16 f_mhz, clk_cur;
+	int status;
+
+	cache->built = false;
+
+	if (!cache->valid) {
+		status = nvgpu_clk_arb_vf_cache_fill(g, cache, src);
+		if (status < 0) {
+			return status;
+		}
+	}
+
+	/* GPC2CLK needs to be checked in two passes. The first determines the
+	 * relationships between GPC2CLK, SYS2CLK and XBAR2CLK, while the
+	 * second verifies that the clocks minimum is satisfied and sets
+	 * the voltages,the later part is done in nvgpu_pmu_perf_changeseq_set_clks
+	 */
+	j = 0; clk_cur = 0;
+	for (i = 0; i < cache->num_points; i++) {
+		f_mhz = cache->f_points[i];
+
+		if ((f_mhz >= limits->gpc2clk_min) &&
+			(f_mhz <= limits->gpc2clk_max) &&
+			(f_mhz != clk_cur)) {
+
+			status = nvgpu_clk_arb_vf_cache_resolve(g, cache,
+					src, i);
+			if (status < 0) {
+				return status;
+			}
+
+			table->gpc2clk_points[j] = cache->points[i];
+			clk_cur = f_mhz;
+
+			if ((clk_cur >= limits->p0_min) &&
+					(clk_cur <= limits->p0_max)) {
+				VF_POINT_SET_PSTATE_SUPPORTED(
+					&table->gpc2clk_points[j],
+					CTRL_PERF_PSTATE_P0);
+			}
+
+			j++;
+		}
+	}
+	table->gpc2clk_num_points = j;
+
+	cache->limits = *limits;
+	cache->built = true;
+	cache->stats.rebuilds++;
+
+	return 0;
+}
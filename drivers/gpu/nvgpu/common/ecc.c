@@ -24,6 +24,7 @@
 #include <nvgpu/gr/gr_ecc.h>
 #include <nvgpu/ltc.h>
 #include <nvgpu/string.h>
+#include <nvgpu/barrier.h>
 
 void nvgpu_ecc_stat_add(struct gk20a *g, struct nvgpu_ecc_stat *stat)
 {
@@ -35,6 +36,7 @@ void nvgpu_ecc_stat_add(struct gk20a *g, struct nvgpu_ecc_stat *stat)
 
 	nvgpu_list_add_tail(&stat->node, &ecc->stats_list);
 	ecc->stats_count = nvgpu_safe_add_s32(ecc->stats_count, 1);
+	ecc->stats_gen = nvgpu_wrapping_add_u32(ecc->stats_gen, 1U);
 
 	nvgpu_mutex_release(&ecc->stats_lock);
 }
@@ -47,6 +49,7 @@ void nvgpu_ecc_stat_del(struct gk20a *g, struct nvgpu_ecc_stat *stat)
 
 	nvgpu_list_del(&stat->node);
 	ecc->stats_count = nvgpu_safe_sub_s32(ecc->stats_count, 1);
+	ecc->stats_gen = nvgpu_wrapping_add_u32(ecc->stats_gen, 1U);
 
 	nvgpu_mutex_release(&ecc->stats_lock);
 }
@@ -107,6 +110,8 @@ void nvgpu_ecc_free(struct gk20a *g)
 
 	nvgpu_mutex_acquire(&ecc->stats_lock);
 	WARN_ON(!nvgpu_list_empty(&ecc->stats_list));
+	nvgpu_kfree(g, ecc->stats_index);
+	ecc->stats_index = NULL;
 	nvgpu_mutex_release(&ecc->stats_lock);
 
 	(void)memset(ecc, 0, sizeof(*ecc));
@@ -166,3 +171,105 @@ void nvgpu_ecc_remove_support(struct gk20a *g)
 
 	nvgpu_mutex_destroy(&g->ecc.stats_lock);
 }
+
+/* rebuild the flat index of stats_list if the list changed, stats_lock held */
+static int ecc_stats_index_update(struct gk20a *g, struct nvgpu_ecc *ecc)
+{
+	struct nvgpu_ecc_stat *stat;
+	u32 count = (u32)ecc->stats_count;
+	u32 i = 0U;
+
+	if ((ecc->stats_index != NULL) &&
+	    (ecc->stats_index_gen == ecc->stats_gen)) {
+		return 0;
+	}
+
+	nvgpu_kfree(g, ecc->stats_index);
+	ecc->stats_index = NULL;
+	ecc->stats_index_count = 0U;
+
+	ecc->stats_index = nvgpu_kzalloc(g, nvgpu_safe_mult_u64(
+			sizeof(*ecc->stats_index), nvgpu_safe_add_u32(count, 1U)));
+	if (ecc->stats_index == NULL) {
+		return -ENOMEM;
+	}
+
+	nvgpu_list_for_each_entry(stat, &ecc->stats_list,
+			nvgpu_ecc_stat, node) {
+		if (i >= count) {
+			break;
+		}
+		ecc->stats_index[i] = stat;
+		i = nvgpu_safe_add_u32(i, 1U);
+	}
+
+	ecc->stats_index_count = i;
+	ecc->stats_index_gen = ecc->stats_gen;
+
+	return 0;
+}
+
+int nvgpu_ecc_snapshot(struct gk20a *g, struct nvgpu_ecc_snapshot *snap)
+{
+	struct nvgpu_ecc *ecc = &g->ecc;
+	u32 i;
+	int err;
+
+	nvgpu_mutex_acquire(&ecc->stats_lock);
+
+	err = ecc_stats_index_update(g, ecc);
+	if (err != 0) {
+		goto done;
+	}
+
+	snap->gen = ecc->stats_index_gen;
+	snap->count = ecc->stats_index_count;
+	if (snap->size < snap->count) {
+		err = -ENOSPC;
+		goto done;
+	}
+
+	/* counters are only written by their unit's interrupt handler */
+	for (i = 0U; i < snap->count; i++) {
+		snap->counters[i] = NV_READ_ONCE(ecc->stats_index[i]->counter);
+	}
+
+done:
+	nvgpu_mutex_release(&ecc->stats_lock);
+	return err;
+}
+
+int nvgpu_ecc_snapshot_delta(const struct nvgpu_ecc_snapshot *prev,
+		const struct nvgpu_ecc_snapshot *cur, u32 *delta)
+{
+	u32 i;
+
+	if ((prev->gen != cur->gen) || (prev->count != cur->count)) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < cur->count; i++) {
+		delta[i] = nvgpu_wrapping_sub_u32(cur->counters[i],
+				prev->counters[i]);
+	}
+
+	return 0;
+}
+
+const char *nvgpu_ecc_snapshot_stat_name(struct gk20a *g,
+		const struct nvgpu_ecc_snapshot *snap, u32 index)
+{
+	struct nvgpu_ecc *ecc = &g->ecc;
+	const char *name = NULL;
+
+	nvgpu_mutex_acquire(&ecc->stats_lock);
+	if ((ecc->stats_index != NULL) &&
+	    (ecc->stats_index_gen == ecc->stats_gen) &&
+	    (snap->gen == ecc->stats_gen) &&
+	    (index < ecc->stats_index_count)) {
+		name = ecc->stats_index[index]->name;
+	}
+	nvgpu_mutex_release(&ecc->stats_lock);
+
+	return name;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -223,6 +223,76 @@ exit:
 	return err;
 }
 
+/* queue push of several commands with lock, the head is set once */
+int nvgpu_engine_mem_queue_push_batch(struct nvgpu_falcon *flcn,
+	struct nvgpu_engine_mem_queue *queue, void *const *data,
+	const u32 *size, u32 count)
+{
+	struct gk20a *g;
+	u32 total = 0U;
+	u32 i, len;
+	int err = 0;
+
+	if ((flcn == NULL) || (queue == NULL)) {
+		return -EINVAL;
+	}
+
+	g = queue->g;
+
+	if (queue->oflag != OFLAG_WRITE) {
+		nvgpu_err(g, "flcn-%d, queue-%d not opened for write",
+			queue->flcn_id, queue->id);
+		err = -EINVAL;
+		goto exit;
+	}
+
+	if (count == 0U) {
+		goto exit;
+	}
+
+	for (i = 0U; i < count; i++) {
+		len = size[i];
+		total = nvgpu_safe_add_u32(total,
+				NVGPU_ALIGN(len, QUEUE_ALIGNMENT));
+	}
+
+	/* acquire mutex */
+	nvgpu_mutex_acquire(&queue->mutex);
+
+	/* reserve room for all commands, rewinding first if needed */
+	err = engine_mem_queue_prepare_write(flcn, queue, total);
+	if (err != 0) {
+		goto unlock_mutex;
+	}
+
+	for (i = 0U; i < count; i++) {
+		len = size[i];
+		err = queue->push(flcn, queue, queue->position,
+				data[i], len);
+		if (err != 0) {
+			/* nothing is published, the head stays put */
+			nvgpu_err(g, "flcn-%d queue-%d, fail to write",
+				queue->flcn_id, queue->id);
+			goto unlock_mutex;
+		}
+
+		queue->position += NVGPU_ALIGN(len, QUEUE_ALIGNMENT);
+	}
+
+	err = queue->head(g, queue->id, queue->index,
+			  &queue->position, QUEUE_SET);
+	if (err != 0) {
+		nvgpu_err(g, "flcn-%d queue-%d, position SET failed",
+			queue->flcn_id, queue->id);
+	}
+
+unlock_mutex:
+	/* release mutex */
+	nvgpu_mutex_release(&queue->mutex);
+exit:
+	return err;
+}
+
 /* queue pop operation with lock */
 int nvgpu_engine_mem_queue_pop(struct nvgpu_falcon *flcn,
 	struct nvgpu_engine_mem_queue *queue, void *data, u32 size,
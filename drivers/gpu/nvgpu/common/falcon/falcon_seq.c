@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <nvgpu/falcon_seq.h>
+#include <nvgpu/bitops.h>
+#include <nvgpu/errno.h>
+#include <nvgpu/string.h>
+#include <nvgpu/timers.h>
+#include <nvgpu/utils.h>
+
+static u8 falcon_seq_tag_index(u8 tag)
+{
+	return (u8)min((u32)tag, NVGPU_FALCON_SEQ_MAX_TAGS - 1U);
+}
+
+static u32 falcon_seq_num_words(struct nvgpu_falcon_seq_alloc *seqs)
+{
+	return DIV_ROUND_UP(seqs->num_ids, NVGPU_FALCON_SEQ_WORD_BITS);
+}
+
+void nvgpu_falcon_seq_alloc_init(struct nvgpu_falcon_seq_alloc *seqs,
+		u32 num_ids)
+{
+	u32 i;
+
+	(void) memset(seqs, 0, sizeof(*seqs));
+
+	seqs->num_ids = min(num_ids, NVGPU_FALCON_SEQ_MAX_IDS);
+
+	/* IDs past num_ids in the last word are permanently in use */
+	for (i = seqs->num_ids; (i % NVGPU_FALCON_SEQ_WORD_BITS) != 0U; i++) {
+		u32 w = i / NVGPU_FALCON_SEQ_WORD_BITS;
+		u32 val = (u32)nvgpu_atomic_read(&seqs->tbl[w]);
+
+		val |= BIT32(i % NVGPU_FALCON_SEQ_WORD_BITS);
+		nvgpu_atomic_set(&seqs->tbl[w], (int)val);
+	}
+}
+
+static bool falcon_seq_cache_get(struct nvgpu_falcon_seq_alloc *seqs,
+		u32 *id)
+{
+	u32 i;
+	int old;
+
+	for (i = 0U; i < NVGPU_FALCON_SEQ_CACHE_SIZE; i++) {
+		old = nvgpu_atomic_read(&seqs->cache[i]);
+		if ((old != 0) &&
+		    (nvgpu_atomic_cmpxchg(&seqs->cache[i], old, 0) == old)) {
+			*id = (u32)old - 1U;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool falcon_seq_cache_put(struct nvgpu_falcon_seq_alloc *seqs, u32 id)
+{
+	u32 i;
+
+	for (i = 0U; i < NVGPU_FALCON_SEQ_CACHE_SIZE; i++) {
+		if (nvgpu_atomic_cmpxchg(&seqs->cache[i], 0,
+				(int)(id + 1U)) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool falcon_seq_tbl_get(struct nvgpu_falcon_seq_alloc *seqs, u32 *id)
+{
+	u32 words = falcon_seq_num_words(seqs);
+	u32 start = (u32)nvgpu_atomic_read(&seqs->hint);
+	u32 i, w, val, bit;
+	unsigned long free_bits;
+	int old, cur;
+
+	for (i = 0U; i < words; i++) {
+		w = (start + i) % words;
+		old = nvgpu_atomic_read(&seqs->tbl[w]);
+
+		while (true) {
+			val = (u32)old;
+			free_bits = (unsigned long)(~val);
+			if (free_bits == 0UL) {
+				break;
+			}
+			bit = (u32)(nvgpu_ffs(free_bits) - 1UL);
+			cur = nvgpu_atomic_cmpxchg(&seqs->tbl[w], old,
+					(int)(val | BIT32(bit)));
+			if (cur == old) {
+				nvgpu_atomic_set(&seqs->hint, (int)w);
+				*id = (w * NVGPU_FALCON_SEQ_WORD_BITS) + bit;
+				return true;
+			}
+			old = cur;
+		}
+	}
+
+	return false;
+}
+
+static void falcon_seq_tbl_put(struct nvgpu_falcon_seq_alloc *seqs, u32 id)
+{
+	nvgpu_atomic_t *word = &seqs->tbl[id / NVGPU_FALCON_SEQ_WORD_BITS];
+	u32 mask = BIT32(id % NVGPU_FALCON_SEQ_WORD_BITS);
+	int old = nvgpu_atomic_read(word);
+	int cur;
+
+	while (true) {
+		cur = nvgpu_atomic_cmpxchg(word, old, (int)((u32)old & ~mask));
+		if (cur == old) {
+			break;
+		}
+		old = cur;
+	}
+}
+
+int nvgpu_falcon_seq_acquire(struct nvgpu_falcon_seq_alloc *seqs, u8 tag,
+		u32 *id)
+{
+	if (!falcon_seq_cache_get(seqs, id) &&
+	    !falcon_seq_tbl_get(seqs, id)) {
+		return -EAGAIN;
+	}
+
+	seqs->tag[*id] = falcon_seq_tag_index(tag);
+	seqs->post_ns[*id] = nvgpu_current_time_ns();
+
+	return 0;
+}
+
+void nvgpu_falcon_seq_release(struct gk20a *g,
+		struct nvgpu_falcon_seq_alloc *seqs, u32 id, bool completed)
+{
+	s64 delta;
+
+	if (completed) {
+		delta = nvgpu_current_time_ns() - seqs->post_ns[id];
+		nvgpu_swhist_record(g, &seqs->lat[seqs->tag[id]],
+				(delta > 0) ? (u64)delta : 0ULL);
+	}
+
+	/* a cached ID stays marked in the bitmap */
+	if (!falcon_seq_cache_put(seqs, id)) {
+		falcon_seq_tbl_put(seqs, id);
+	}
+}
+
+void nvgpu_falcon_seq_get_latency(struct nvgpu_falcon_seq_alloc *seqs,
+		u8 tag, struct nvgpu_swhist_data *data)
+{
+	nvgpu_swhist_read(&seqs->lat[falcon_seq_tag_index(tag)], data);
+}
@@ -405,7 +405,8 @@ static int channel_setup_kernelmode(struct nvgpu_channel *c,
 		goto clean_up_sync;
 	}
 
-	err = nvgpu_priv_cmdbuf_queue_alloc(c->vm, job_count, &c->priv_cmd_q);
+	err = nvgpu_priv_cmdbuf_queue_alloc(c->vm, job_count,
+			!nvgpu_channel_is_deterministic(c), &c->priv_cmd_q);
 	if (err != 0) {
 		goto clean_up_prealloc;
 	}
@@ -504,7 +505,7 @@ static void nvgpu_channel_finalize_job(struct nvgpu_channel *c,
 	nvgpu_fence_put(&job->post_fence);
 
 	/*
-	 * Free the private command buffers (in order of allocation)
+	 * Free the private command buffers
 	 */
 	if (job->wait_cmd != NULL) {
 		nvgpu_priv_cmdbuf_free(c->priv_cmd_q, job->wait_cmd);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2011-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -31,6 +31,7 @@
 #include <nvgpu/nvgpu_err.h>
 #include <nvgpu/cic_rm.h>
 #include <nvgpu/rc.h>
+#include <nvgpu/swhist.h>
 #ifdef CONFIG_NVGPU_LS_PMU
 #include <nvgpu/pmu/mutex.h>
 #endif
@@ -50,6 +51,7 @@ int nvgpu_fifo_preempt_tsg(struct gk20a *g, struct nvgpu_tsg *tsg)
 	u32 token = PMU_INVALID_MUTEX_OWNER_ID;
 	int mutex_ret = 0;
 #endif
+	s64 start_ns;
 
 	nvgpu_log_fn(g, "tsgid: %d", tsg->tsgid);
 
@@ -57,6 +59,7 @@ int nvgpu_fifo_preempt_tsg(struct gk20a *g, struct nvgpu_tsg *tsg)
 		return 0;
 	}
 
+	start_ns = nvgpu_swhist_begin();
 	do {
 		nvgpu_mutex_acquire(&tsg->runlist->runlist_lock);
 
@@ -109,6 +112,8 @@ int nvgpu_fifo_preempt_tsg(struct gk20a *g, struct nvgpu_tsg *tsg)
 		}
 	} while (--preempt_retry_count != 0U);
 
+	nvgpu_swhist_end(g, NVGPU_SWHIST_PREEMPT, start_ns);
+
 	if (ret != 0) {
 		if (nvgpu_platform_is_silicon(g)) {
 			nvgpu_err(g, "preempt timed out for tsgid: %u, "
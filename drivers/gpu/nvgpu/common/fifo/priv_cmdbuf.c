@@ -22,7 +22,6 @@
 
 #include <nvgpu/log.h>
 #include <nvgpu/utils.h>
-#include <nvgpu/log2.h>
 #include <nvgpu/barrier.h>
 #include <nvgpu/dma.h>
 #include <nvgpu/nvgpu_mem.h>
@@ -31,64 +30,186 @@
 #include <nvgpu/priv_cmdbuf.h>
 #include <nvgpu/gk20a.h>
 #include <nvgpu/trace.h>
-#include <nvgpu/circ_buf.h>
+#include <nvgpu/bitops.h>
+#include <nvgpu/lock.h>
 #include <nvgpu/string.h>
 
+/*
+ * Private command buffers are carved out of fixed-size slabs. There is one
+ * slab class for wait commands and one for increment commands; a slab is a
+ * single DMA buffer split into slots of the command size of its class, and a
+ * bitmap tracks which slots are in use. Entries can thus be freed in any
+ * order, and a class can grow by whole slabs when it runs out of slots.
+ */
+#define PRIV_CMDBUF_CLASS_WAIT		0U
+#define PRIV_CMDBUF_CLASS_INCR		1U
+#define PRIV_CMDBUF_NUM_CLASSES		2U
+
+/* Upper limit for the number of slabs of one class on growable queues */
+#define PRIV_CMDBUF_MAX_SLABS		4U
+
+struct priv_cmd_slab;
+
 struct priv_cmd_entry {
 	struct nvgpu_mem *mem;
 	u32 off;	/* offset in mem, in u32 entries */
 	u32 fill_off;	/* write offset from off, in u32 entries */
 	u32 size;	/* in words */
-	u32 alloc_size;
+	u32 nr_slots;	/* slab slots covered by this entry */
+	struct priv_cmd_slab *slab;
+};
+
+struct priv_cmd_slab {
+	struct nvgpu_mem mem;
+	unsigned long *bitmap;	/* one bit per slot */
+	/* an entry lives at the index of the first slot it covers */
+	struct priv_cmd_entry *entries;
+	struct priv_cmd_class *cls;
+};
+
+struct priv_cmd_class {
+	u32 slot_size;		/* in words */
+	u32 slots_per_slab;
+	u32 nr_slabs;
+	u32 max_slabs;
+	struct priv_cmd_slab *slabs[PRIV_CMDBUF_MAX_SLABS];
+
+	/* occupancy and tuning stats, see nvgpu_priv_cmdbuf_queue_get_stats */
+	u32 slots_used;
+	u32 slots_peak;
+	u32 grows;
+	u64 allocs;
+	u64 alloc_failures;
 };
 
 struct priv_cmd_queue {
 	struct vm_gk20a *vm;
-	struct nvgpu_mem mem; /* pushbuf */
-	u32 size;	/* allocated length in words */
-	u32 put;	/* next entry will begin here */
-	u32 get;	/* next entry to free begins here */
-
-	/* an entry is a fragment of the pushbuf memory */
-	struct priv_cmd_entry *entries;
-	u32 entries_len; /* allocated length */
-	u32 entry_put;
-	u32 entry_get;
+	/* protects the slab bitmaps and the class bookkeeping */
+	struct nvgpu_spinlock lock;
+	struct priv_cmd_class classes[PRIV_CMDBUF_NUM_CLASSES];
 };
 
-/* allocate private cmd buffer queue.
-   used for inserting commands before/after user submitted buffers. */
-int nvgpu_priv_cmdbuf_queue_alloc(struct vm_gk20a *vm,
-	u32 job_count, struct priv_cmd_queue **queue)
+static void priv_cmdbuf_slab_destroy(struct priv_cmd_queue *q,
+		struct priv_cmd_slab *slab)
 {
+	struct vm_gk20a *vm = q->vm;
 	struct gk20a *g = vm->mm->g;
-	struct priv_cmd_queue *q;
-	u64 size, tmp_size;
-	int err = 0;
-	u32 wait_size, incr_size;
-	u32 mem_per_job;
+
+	nvgpu_dma_unmap_free(vm, &slab->mem);
+	nvgpu_vfree(g, slab->entries);
+	nvgpu_kfree(g, slab->bitmap);
+	nvgpu_kfree(g, slab);
+}
+
+static struct priv_cmd_slab *priv_cmdbuf_slab_create(struct priv_cmd_queue *q,
+		struct priv_cmd_class *cls)
+{
+	struct vm_gk20a *vm = q->vm;
+	struct gk20a *g = vm->mm->g;
+	struct priv_cmd_slab *slab;
+	u64 size;
+	int err;
+
+	slab = nvgpu_kzalloc(g, sizeof(*slab));
+	if (slab == NULL) {
+		return NULL;
+	}
+
+	slab->cls = cls;
+
+	slab->bitmap = nvgpu_kzalloc(g,
+			nvgpu_safe_mult_u64(
+				(u64)BITS_TO_LONGS(cls->slots_per_slab),
+				sizeof(unsigned long)));
+	if (slab->bitmap == NULL) {
+		goto err_free_slab;
+	}
+
+	slab->entries = nvgpu_vzalloc(g,
+			nvgpu_safe_mult_u64((u64)cls->slots_per_slab,
+				sizeof(*slab->entries)));
+	if (slab->entries == NULL) {
+		goto err_free_bitmap;
+	}
+
+	size = nvgpu_safe_mult_u64(
+			nvgpu_safe_mult_u64((u64)cls->slots_per_slab,
+				(u64)cls->slot_size),
+			sizeof(u32));
+	err = nvgpu_dma_alloc_map_sys(vm, size, &slab->mem);
+	if (err != 0) {
+		nvgpu_err(g, "%s: memory allocation failed", __func__);
+		goto err_free_entries;
+	}
+
+	return slab;
+
+err_free_entries:
+	nvgpu_vfree(g, slab->entries);
+err_free_bitmap:
+	nvgpu_kfree(g, slab->bitmap);
+err_free_slab:
+	nvgpu_kfree(g, slab);
+	return NULL;
+}
+
+static int priv_cmdbuf_class_init(struct priv_cmd_queue *q,
+		struct priv_cmd_class *cls, u32 slot_size, u32 job_count,
+		bool growable)
+{
+	u64 slot_bytes = nvgpu_safe_mult_u64((u64)slot_size, sizeof(u32));
+	u64 size;
+
+	nvgpu_assert(slot_size > 0U);
 
 	/*
-	 * sema size is at least as much as syncpt size, but semas may not be
-	 * enabled in the build. If neither semas nor syncpts are enabled, priv
-	 * cmdbufs and as such kernel mode submits with job tracking won't be
-	 * supported.
+	 * The first slab fits one command of this class for each job. Any
+	 * page alignment slack becomes extra slots.
 	 */
-#ifdef CONFIG_NVGPU_SW_SEMAPHORE
-	wait_size = g->ops.sync.sema.get_wait_cmd_size();
-	incr_size = g->ops.sync.sema.get_incr_cmd_size();
-#else
-	wait_size = g->ops.sync.syncpt.get_wait_cmd_size();
-	incr_size = g->ops.sync.syncpt.get_incr_cmd_size(true);
-#endif
+	size = PAGE_ALIGN(nvgpu_safe_mult_u64((u64)max(job_count, 1U),
+				slot_bytes));
+	if ((size / slot_bytes) > U32_MAX) {
+		return -ERANGE;
+	}
+
+	cls->slot_size = slot_size;
+	cls->slots_per_slab = (u32)(size / slot_bytes);
+	cls->max_slabs = growable ? PRIV_CMDBUF_MAX_SLABS : 1U;
+
+	cls->slabs[0] = priv_cmdbuf_slab_create(q, cls);
+	if (cls->slabs[0] == NULL) {
+		return -ENOMEM;
+	}
+	cls->nr_slabs = 1U;
+
+	return 0;
+}
+
+static void priv_cmdbuf_class_deinit(struct priv_cmd_queue *q,
+		struct priv_cmd_class *cls)
+{
+	u32 i;
+
+	for (i = 0U; i < cls->nr_slabs; i++) {
+		priv_cmdbuf_slab_destroy(q, cls->slabs[i]);
+		cls->slabs[i] = NULL;
+	}
+	cls->nr_slabs = 0U;
+}
+
+int nvgpu_priv_cmdbuf_queue_alloc_sized(struct vm_gk20a *vm,
+	u32 wait_size, u32 incr_size, u32 job_count, bool growable,
+	struct priv_cmd_queue **queue)
+{
+	struct gk20a *g = vm->mm->g;
+	struct priv_cmd_queue *q;
+	int err = 0;
 
 	/*
 	 * Compute the amount of priv_cmdbuf space we need. In general the
 	 * worst case is the kernel inserts both a semaphore pre-fence and
 	 * post-fence. Any sync-pt fences will take less memory so we can
-	 * ignore them unless they're the only supported type. Jobs can also
-	 * have more than one pre-fence but that's abnormal and we'll -EAGAIN
-	 * if such jobs would fill the queue.
+	 * ignore them unless they're the only supported type.
 	 *
 	 * A semaphore ACQ (fence-wait) is 8 words: semaphore_a, semaphore_b,
 	 * semaphore_c, and semaphore_d. A semaphore INCR (fence-get) will be
@@ -96,34 +217,19 @@ int nvgpu_priv_cmdbuf_queue_alloc(struct vm_gk20a *vm,
 	 * another 2 words. In reality these numbers vary by chip but we'll use
 	 * 8 and 10 as examples.
 	 *
-	 * Given the job count, cmdbuf space is allocated such that each job
-	 * can get one wait command and one increment command:
+	 * Given the job count, the initial wait and incr slabs are sized such
+	 * that each job can get one wait command and one increment command:
 	 *
-	 *   job_count * (8 + 10) * 4 bytes
+	 *   job_count * 8 * 4 bytes + job_count * 10 * 4 bytes
 	 *
-	 * These cmdbufs are inserted as gpfifo entries right before and after
-	 * the user submitted gpfifo entries per submit.
-	 *
-	 * One extra slot is added to the queue length so that the requested
-	 * job count can actually be allocated. This ring buffer implementation
-	 * is full when the number of consumed entries is one less than the
-	 * allocation size:
-	 *
-	 * alloc bytes = job_count * (wait + incr + 1) * slot in bytes
+	 * Jobs can also have more than one pre-fence. Such a wait command
+	 * takes several contiguous wait slots. If a growable queue has no room
+	 * left, another slab of the same size is added to the class, up to
+	 * PRIV_CMDBUF_MAX_SLABS; otherwise the allocation fails with -EAGAIN.
 	 */
-	mem_per_job = nvgpu_safe_mult_u32(
-			nvgpu_safe_add_u32(
-				nvgpu_safe_add_u32(wait_size, incr_size),
-				1U),
-			(u32)sizeof(u32));
-	/* both 32 bit and mem_per_job is small */
-	size = nvgpu_safe_mult_u64((u64)job_count, (u64)mem_per_job);
-
-	tmp_size = PAGE_ALIGN(roundup_pow_of_two(size));
-	if (tmp_size > U32_MAX) {
+	if (job_count > U32_MAX / 2U - 1U) {
 		return -ERANGE;
 	}
-	size = (u32)tmp_size;
 
 	q = nvgpu_kzalloc(g, sizeof(*q));
 	if (q == NULL) {
@@ -131,166 +237,242 @@ int nvgpu_priv_cmdbuf_queue_alloc(struct vm_gk20a *vm,
 	}
 
 	q->vm = vm;
+	nvgpu_spinlock_init(&q->lock);
 
-	if (job_count > U32_MAX / 2U - 1U) {
-		err = -ERANGE;
-		goto err_free_queue;
-	}
-
-	/* One extra to account for the full condition: 2 * job_count + 1 */
-	q->entries_len = nvgpu_safe_mult_u32(2U,
-			nvgpu_safe_add_u32(job_count, 1U));
-	q->entries = nvgpu_vzalloc(g,
-			nvgpu_safe_mult_u64((u64)q->entries_len,
-				sizeof(*q->entries)));
-	if (q->entries == NULL) {
-		err = -ENOMEM;
+	err = priv_cmdbuf_class_init(q, &q->classes[PRIV_CMDBUF_CLASS_WAIT],
+			wait_size, job_count, growable);
+	if (err != 0) {
 		goto err_free_queue;
 	}
 
-	err = nvgpu_dma_alloc_map_sys(vm, size, &q->mem);
+	err = priv_cmdbuf_class_init(q, &q->classes[PRIV_CMDBUF_CLASS_INCR],
+			incr_size, job_count, growable);
 	if (err != 0) {
-		nvgpu_err(g, "%s: memory allocation failed", __func__);
-		goto err_free_entries;
+		goto err_deinit_wait;
 	}
 
-	tmp_size = q->mem.size / sizeof(u32);
-	nvgpu_assert(tmp_size <= U32_MAX);
-	q->size = (u32)tmp_size;
-
 	*queue = q;
 	return 0;
-err_free_entries:
-	nvgpu_vfree(g, q->entries);
+err_deinit_wait:
+	priv_cmdbuf_class_deinit(q, &q->classes[PRIV_CMDBUF_CLASS_WAIT]);
 err_free_queue:
 	nvgpu_kfree(g, q);
 	return err;
 }
 
+#ifdef CONFIG_NVGPU_KERNEL_MODE_SUBMIT
+/* allocate private cmd buffer queue.
+   used for inserting commands before/after user submitted buffers. */
+int nvgpu_priv_cmdbuf_queue_alloc(struct vm_gk20a *vm,
+	u32 job_count, bool growable, struct priv_cmd_queue **queue)
+{
+	struct gk20a *g = vm->mm->g;
+	u32 wait_size, incr_size;
+
+	/*
+	 * sema size is at least as much as syncpt size, but semas may not be
+	 * enabled in the build. If neither semas nor syncpts are enabled, priv
+	 * cmdbufs and as such kernel mode submits with job tracking won't be
+	 * supported.
+	 */
+#ifdef CONFIG_NVGPU_SW_SEMAPHORE
+	wait_size = g->ops.sync.sema.get_wait_cmd_size();
+	incr_size = g->ops.sync.sema.get_incr_cmd_size();
+#else
+	wait_size = g->ops.sync.syncpt.get_wait_cmd_size();
+	incr_size = g->ops.sync.syncpt.get_incr_cmd_size(true);
+#endif
+
+	return nvgpu_priv_cmdbuf_queue_alloc_sized(vm, wait_size, incr_size,
+			job_count, growable, queue);
+}
+#endif
+
 void nvgpu_priv_cmdbuf_queue_free(struct priv_cmd_queue *q)
 {
 	struct vm_gk20a *vm = q->vm;
 	struct gk20a *g = vm->mm->g;
+	u32 i;
 
-	nvgpu_dma_unmap_free(vm, &q->mem);
-	nvgpu_vfree(g, q->entries);
+	for (i = 0U; i < PRIV_CMDBUF_NUM_CLASSES; i++) {
+		priv_cmdbuf_class_deinit(q, &q->classes[i]);
+	}
 	nvgpu_kfree(g, q);
 }
 
-/* allocate a cmd buffer with given size. size is number of u32 entries */
-static int nvgpu_priv_cmdbuf_alloc_buf(struct priv_cmd_queue *q, u32 orig_size,
-			     struct priv_cmd_entry *e)
+/*
+ * Pick the class with the smallest slot that fits the whole command. Commands
+ * larger than any slot are multiple waits, so they take contiguous wait slots.
+ */
+static struct priv_cmd_class *priv_cmdbuf_class_for_size(
+		struct priv_cmd_queue *q, u32 size)
 {
-	struct gk20a *g = q->vm->mm->g;
-	u32 size = orig_size;
-	u32 free_count;
-
-	nvgpu_log_fn(g, "size %d", orig_size);
-
-	/*
-	 * If free space in the end is less than requested, increase the size
-	 * to make the real allocated space start from beginning. The hardware
-	 * expects each cmdbuf to be contiguous in the dma space.
-	 *
-	 * This too small extra space in the end may happen because the
-	 * requested wait and incr command buffers do not necessarily align
-	 * with the whole buffer capacity. They don't always align because the
-	 * buffer size is rounded to the next power of two and because not all
-	 * jobs necessarily use exactly one wait command.
-	 */
-	if (nvgpu_safe_add_u32(q->put, size) > q->size) {
-		size = orig_size + (q->size - q->put);
+	struct priv_cmd_class *wait = &q->classes[PRIV_CMDBUF_CLASS_WAIT];
+	struct priv_cmd_class *incr = &q->classes[PRIV_CMDBUF_CLASS_INCR];
+
+	if (size <= wait->slot_size) {
+		if ((size <= incr->slot_size) &&
+				(incr->slot_size < wait->slot_size)) {
+			return incr;
+		}
+		return wait;
 	}
 
-	nvgpu_log_info(g, "priv cmd queue get:put %d:%d",
-			q->get, q->put);
-
-	nvgpu_assert(q->put < q->size);
-	nvgpu_assert(q->get < q->size);
-	nvgpu_assert(q->size > 0U);
-	free_count = (q->size - q->put + q->get - 1U) & (q->size - 1U);
-
-	if (size > free_count) {
-		return -EAGAIN;
+	if (size <= incr->slot_size) {
+		return incr;
 	}
 
-	e->fill_off = 0;
-	e->size = orig_size;
-	e->alloc_size = size;
-	e->mem = &q->mem;
+	return wait;
+}
 
-	/*
-	 * if we have increased size to skip free space in the end, set put
-	 * to beginning of cmd buffer + size, as if the prev put was at
-	 * position 0.
-	 */
-	if (size != orig_size) {
-		e->off = 0;
-		q->put = orig_size;
-	} else {
-		e->off = q->put;
-		q->put = (q->put + orig_size) & (q->size - 1U);
+/* allocate a cmd buffer with given size. size is number of u32 entries */
+static int nvgpu_priv_cmdbuf_alloc_buf(struct priv_cmd_class *cls,
+		u32 size, u32 nr_slots, struct priv_cmd_entry **e)
+{
+	struct priv_cmd_slab *slab;
+	struct priv_cmd_entry *entry;
+	unsigned long pos;
+	u32 i;
+
+	for (i = 0U; i < cls->nr_slabs; i++) {
+		slab = cls->slabs[i];
+
+		pos = bitmap_find_next_zero_area(slab->bitmap,
+				cls->slots_per_slab, 0UL, nr_slots, 0UL);
+		if (nvgpu_safe_add_u64(pos, nr_slots) >
+				(u64)cls->slots_per_slab) {
+			continue;
+		}
+
+		nvgpu_bitmap_set(slab->bitmap, (u32)pos, nr_slots);
+
+		entry = &slab->entries[pos];
+		entry->mem = &slab->mem;
+		entry->off = nvgpu_safe_mult_u32((u32)pos, cls->slot_size);
+		entry->fill_off = 0U;
+		entry->size = size;
+		entry->nr_slots = nr_slots;
+		entry->slab = slab;
+
+		cls->slots_used = nvgpu_safe_add_u32(cls->slots_used,
+				nr_slots);
+		cls->slots_peak = max(cls->slots_peak, cls->slots_used);
+		cls->allocs = nvgpu_safe_add_u64(cls->allocs, 1ULL);
+
+		*e = entry;
+		return 0;
 	}
 
-	/* we already handled q->put + size > q->size so BUG_ON this */
-	BUG_ON(q->put > q->size);
-
-	nvgpu_log_fn(g, "done");
-
-	return 0;
+	return -EAGAIN;
 }
 
 int nvgpu_priv_cmdbuf_alloc(struct priv_cmd_queue *q, u32 size,
 			     struct priv_cmd_entry **e)
 {
-	u32 next_put = nvgpu_safe_add_u32(q->entry_put, 1U) % q->entries_len;
-	struct priv_cmd_entry *entry;
-	int err;
-
-	if (next_put == q->entry_get) {
-		return -EAGAIN;
+	struct gk20a *g = q->vm->mm->g;
+	struct priv_cmd_class *cls = priv_cmdbuf_class_for_size(q, size);
+	struct priv_cmd_slab *slab = NULL;
+	u32 nr_slots;
+	int err = -EAGAIN;
+
+	nvgpu_log_fn(g, "size %d", size);
+
+	nvgpu_assert(size > 0U);
+	nvgpu_assert(cls->slot_size > 0U);
+	nvgpu_assert(nvgpu_safe_add_u32(size, cls->slot_size) > size);
+	nr_slots = (size + cls->slot_size - 1U) / cls->slot_size;
+
+	nvgpu_spinlock_acquire(&q->lock);
+	/* a command that would not fit even in an empty slab always fails */
+	if (nr_slots <= cls->slots_per_slab) {
+		err = nvgpu_priv_cmdbuf_alloc_buf(cls, size, nr_slots, e);
+	}
+	if ((err == 0) || (nr_slots > cls->slots_per_slab) ||
+			(cls->nr_slabs >= cls->max_slabs)) {
+		goto done;
 	}
-	entry = &q->entries[q->entry_put];
+	nvgpu_spinlock_release(&q->lock);
+
+	/* the DMA allocation may sleep; do it outside of the lock */
+	slab = priv_cmdbuf_slab_create(q, cls);
+
+	nvgpu_spinlock_acquire(&q->lock);
+	if ((slab != NULL) && (cls->nr_slabs < cls->max_slabs)) {
+		cls->slabs[cls->nr_slabs] = slab;
+		cls->nr_slabs = nvgpu_safe_add_u32(cls->nr_slabs, 1U);
+		cls->grows = nvgpu_safe_add_u32(cls->grows, 1U);
+		slab = NULL;
+		nvgpu_log_info(g, "priv cmd queue grew to %u slabs of %u words",
+				cls->nr_slabs, cls->slot_size);
+	}
+	err = nvgpu_priv_cmdbuf_alloc_buf(cls, size, nr_slots, e);
 
-	err = nvgpu_priv_cmdbuf_alloc_buf(q, size, entry);
+done:
 	if (err != 0) {
-		return err;
+		cls->alloc_failures = nvgpu_safe_add_u64(cls->alloc_failures,
+				1ULL);
 	}
+	nvgpu_spinlock_release(&q->lock);
 
-	q->entry_put = next_put;
-	*e = entry;
+	if (slab != NULL) {
+		/* lost a race against another grow; the slab is not needed */
+		priv_cmdbuf_slab_destroy(q, slab);
+	}
 
-	return 0;
+	nvgpu_log_fn(g, "done");
+
+	return err;
 }
 
-void nvgpu_priv_cmdbuf_rollback(struct priv_cmd_queue *q,
-		struct priv_cmd_entry *e)
+void nvgpu_priv_cmdbuf_free(struct priv_cmd_queue *q, struct priv_cmd_entry *e)
 {
-	nvgpu_assert(q->put < q->size);
-	nvgpu_assert(q->size > 0U);
-	nvgpu_assert(e->alloc_size <= q->size);
-	q->put = (q->put + q->size - e->alloc_size) & (q->size - 1U);
-
+	struct priv_cmd_slab *slab = e->slab;
+	struct priv_cmd_class *cls;
+	u32 pos;
+
+	nvgpu_assert(slab != NULL);
+	cls = slab->cls;
+
+	nvgpu_spinlock_acquire(&q->lock);
+	pos = e->off / cls->slot_size;
+	nvgpu_assert(&slab->entries[pos] == e);
+	nvgpu_bitmap_clear(slab->bitmap, pos, e->nr_slots);
+	cls->slots_used = nvgpu_safe_sub_u32(cls->slots_used, e->nr_slots);
 	(void)memset(e, 0, sizeof(*e));
-
-	nvgpu_assert(q->entry_put < q->entries_len);
-	nvgpu_assert(q->entries_len > 0U);
-	q->entry_put = (q->entry_put + q->entries_len - 1U)
-		% q->entries_len;
+	nvgpu_spinlock_release(&q->lock);
 }
 
-void nvgpu_priv_cmdbuf_free(struct priv_cmd_queue *q, struct priv_cmd_entry *e)
+void nvgpu_priv_cmdbuf_rollback(struct priv_cmd_queue *q,
+		struct priv_cmd_entry *e)
 {
-	struct gk20a *g = q->vm->mm->g;
+	/* Entries are independent of each other, so this is just a free. */
+	nvgpu_priv_cmdbuf_free(q, e);
+}
 
-	if ((q->get != e->off) && e->off != 0U) {
-		nvgpu_err(g, "priv cmdbuf requests out-of-order");
-	}
-	nvgpu_assert(q->size > 0U);
-	q->get = nvgpu_safe_add_u32(e->off, e->size) & (q->size - 1U);
-	q->entry_get = nvgpu_safe_add_u32(q->entry_get, 1U) % q->entries_len;
+static void priv_cmdbuf_class_get_stats(struct priv_cmd_class *cls,
+		struct nvgpu_priv_cmdbuf_class_stats *stats)
+{
+	stats->slot_size = cls->slot_size;
+	stats->slabs = cls->nr_slabs;
+	stats->max_slabs = cls->max_slabs;
+	stats->slots_total = nvgpu_safe_mult_u32(cls->nr_slabs,
+			cls->slots_per_slab);
+	stats->slots_used = cls->slots_used;
+	stats->slots_peak = cls->slots_peak;
+	stats->grows = cls->grows;
+	stats->allocs = cls->allocs;
+	stats->alloc_failures = cls->alloc_failures;
+}
 
-	(void)memset(e, 0, sizeof(*e));
+void nvgpu_priv_cmdbuf_queue_get_stats(struct priv_cmd_queue *q,
+		struct nvgpu_priv_cmdbuf_stats *stats)
+{
+	nvgpu_spinlock_acquire(&q->lock);
+	priv_cmdbuf_class_get_stats(&q->classes[PRIV_CMDBUF_CLASS_WAIT],
+			&stats->wait);
+	priv_cmdbuf_class_get_stats(&q->classes[PRIV_CMDBUF_CLASS_INCR],
+			&stats->incr);
+	nvgpu_spinlock_release(&q->lock);
 }
 
 void nvgpu_priv_cmdbuf_append(struct gk20a *g, struct priv_cmd_entry *e,
@@ -33,6 +33,7 @@
 #include <nvgpu/rc.h>
 #include <nvgpu/string.h>
 #include <nvgpu/static_analysis.h>
+#include <nvgpu/swhist.h>
 #ifdef CONFIG_NVGPU_LS_PMU
 #include <nvgpu/pmu/mutex.h>
 #endif
@@ -528,6 +529,7 @@ static int nvgpu_runlist_do_update(struct gk20a *g, struct nvgpu_runlist *rl,
 	u32 token = PMU_INVALID_MUTEX_OWNER_ID;
 	int mutex_ret = 0;
 #endif
+	s64 start_ns = nvgpu_swhist_begin();
 	int ret = 0;
 
 	nvgpu_log_fn(g, " ");
@@ -547,6 +549,7 @@ static int nvgpu_runlist_do_update(struct gk20a *g, struct nvgpu_runlist *rl,
 	}
 #endif
 	nvgpu_mutex_release(&rl->runlist_lock);
+	nvgpu_swhist_end(g, NVGPU_SWHIST_RUNLIST_UPDATE, start_ns);
 
 	if (ret == -ETIMEDOUT) {
 		nvgpu_rc_runlist_update(g, rl->id);
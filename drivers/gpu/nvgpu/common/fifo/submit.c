@@ -35,6 +35,7 @@
 #include <nvgpu/bug.h>
 #include <nvgpu/fence.h>
 #include <nvgpu/swprofile.h>
+#include <nvgpu/swhist.h>
 #include <nvgpu/vpr.h>
 #include <nvgpu/trace.h>
 #include <nvgpu/nvhost.h>
@@ -742,6 +743,7 @@ static int nvgpu_submit_channel_gpfifo(struct nvgpu_channel *c,
 				struct nvgpu_swprofiler *profiler)
 {
 	struct gk20a *g = c->g;
+	s64 start_ns;
 	int err;
 
 	err = check_submit_allowed(c);
@@ -760,6 +762,7 @@ static int nvgpu_submit_channel_gpfifo(struct nvgpu_channel *c,
 		return -ENOMEM;
 	}
 
+	start_ns = nvgpu_swhist_begin();
 	nvgpu_swprofile_snapshot(profiler, PROF_KICKOFF_ENTRY);
 
 	/* update debug settings */
@@ -809,6 +812,7 @@ static int nvgpu_submit_channel_gpfifo(struct nvgpu_channel *c,
 		c->gpfifo.put, c->gpfifo.get, c->gpfifo.entry_num);
 
 	nvgpu_swprofile_snapshot(profiler, PROF_KICKOFF_END);
+	nvgpu_swhist_end(g, NVGPU_SWHIST_SUBMIT, start_ns);
 
 	nvgpu_log_fn(g, "done");
 	return err;
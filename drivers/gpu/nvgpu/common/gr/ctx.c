@@ -168,6 +168,8 @@ void nvgpu_gr_ctx_free_patch_ctx(struct gk20a *g, struct vm_gk20a *vm,
 	if (nvgpu_mem_is_valid(&patch_ctx->mem)) {
 		nvgpu_dma_unmap_free(vm, &patch_ctx->mem);
 		patch_ctx->data_count = 0;
+		patch_ctx->stage_count = 0;
+		patch_ctx->batching = false;
 	}
 }
 
@@ -482,25 +484,42 @@ u32 nvgpu_gr_ctx_get_sm_diversity_config(struct nvgpu_gr_ctx *gr_ctx)
 }
 #endif
 
-/* load saved fresh copy of gloden image into channel gr_ctx */
-void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
-	struct nvgpu_gr_ctx *gr_ctx,
-	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
-	bool cde)
+static u32 nvgpu_gr_ctx_golden_variant_key(struct gk20a *g,
+	struct nvgpu_gr_ctx *gr_ctx, bool cde)
 {
-	struct nvgpu_mem *mem;
-#ifdef CONFIG_NVGPU_DEBUGGER
-	u64 virt_addr = 0;
-#endif
+	u32 key = 0U;
 
+	(void)g;
+	(void)gr_ctx;
 	(void)cde;
 
-	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gr, " ");
+#ifdef CONFIG_NVGPU_DEBUGGER
+	if ((g->ops.gr.ctxsw_prog.set_cde_enabled != NULL) && cde) {
+		key |= NVGPU_GR_GLOBAL_CTX_VARIANT_CDE;
+	}
+	if (gr_ctx->boosted_ctx) {
+		key |= NVGPU_GR_GLOBAL_CTX_VARIANT_BOOST;
+	}
+#endif
+#ifdef CONFIG_NVGPU_SET_FALCON_ACCESS_MAP
+	if (g->allow_all) {
+		key |= NVGPU_GR_GLOBAL_CTX_VARIANT_ALLOW_ALL;
+	}
+#endif
 
-	mem = &gr_ctx->mem;
+	return key;
+}
 
-	nvgpu_gr_global_ctx_load_local_golden_image(g,
-		local_golden_image, mem);
+/*
+ * Apply ctxsw header fields that do not depend on the context itself, only
+ * on the configuration captured in the variant key.
+ */
+static void nvgpu_gr_ctx_init_golden_ctx_fields(struct gk20a *g,
+	struct nvgpu_gr_ctx *gr_ctx, struct nvgpu_mem *mem, bool cde)
+{
+	(void)gr_ctx;
+	(void)mem;
+	(void)cde;
 
 #ifdef CONFIG_NVGPU_HAL_NON_FUSA
 	g->ops.gr.ctxsw_prog.init_ctxsw_hdr_data(g, mem);
@@ -516,9 +535,6 @@ void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
 	/* set priv access map */
 	g->ops.gr.ctxsw_prog.set_priv_access_map_config_mode(g, mem,
 		g->allow_all);
-	g->ops.gr.ctxsw_prog.set_priv_access_map_addr(g, mem,
-		nvgpu_gr_ctx_get_global_ctx_va(gr_ctx,
-			NVGPU_GR_CTX_PRIV_ACCESS_MAP_VA));
 #endif
 
 #ifdef CONFIG_NVGPU_HAL_NON_FUSA
@@ -532,25 +548,67 @@ void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
 		g->ops.gr.ctxsw_prog.set_pmu_options_boost_clock_frequencies(g,
 			mem, nvgpu_safe_cast_bool_to_u32(gr_ctx->boosted_ctx));
 	}
+
+	/* PM ctxt switch is off by default */
+	g->ops.gr.ctxsw_prog.set_pm_mode(g, mem,
+		g->ops.gr.ctxsw_prog.hw_get_pm_mode_no_ctxsw());
+	g->ops.gr.ctxsw_prog.set_pm_ptr(g, mem, 0ULL);
 #endif
+}
 
-	nvgpu_log(g, gpu_dbg_info | gpu_dbg_gr, "write patch count = %d",
-			gr_ctx->patch_ctx.data_count);
-	g->ops.gr.ctxsw_prog.set_patch_count(g, mem,
-		gr_ctx->patch_ctx.data_count);
-	g->ops.gr.ctxsw_prog.set_patch_addr(g, mem,
-		gr_ctx->patch_ctx.mem.gpu_va);
+/* load saved fresh copy of gloden image into channel gr_ctx */
+void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
+	struct nvgpu_gr_ctx *gr_ctx,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	bool cde)
+{
+	struct nvgpu_mem *mem;
+	u32 key;
+	int err;
+
+	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gr, " ");
+
+	mem = &gr_ctx->mem;
+	key = nvgpu_gr_ctx_golden_variant_key(g, gr_ctx, cde);
+
+	/*
+	 * Use pre-baked variant of golden image if this configuration has
+	 * been seen before, otherwise bake it now for next contexts.
+	 */
+	if (!nvgpu_gr_global_ctx_load_local_golden_image_variant(g,
+			local_golden_image, key, mem)) {
+		nvgpu_gr_global_ctx_load_local_golden_image(g,
+			local_golden_image, mem);
+
+		nvgpu_gr_ctx_init_golden_ctx_fields(g, gr_ctx, mem, cde);
+
+		err = nvgpu_gr_global_ctx_save_local_golden_image_variant(g,
+			local_golden_image, key, mem);
+		if (err != 0) {
+			nvgpu_log(g, gpu_dbg_gr,
+				"golden image variant 0x%x not saved err %d",
+				key, err);
+		}
+	}
 
 #ifdef CONFIG_NVGPU_DEBUGGER
-	/* PM ctxt switch is off by default */
 	gr_ctx->pm_ctx.pm_mode =
 		g->ops.gr.ctxsw_prog.hw_get_pm_mode_no_ctxsw();
-	virt_addr = 0;
+#endif
 
-	g->ops.gr.ctxsw_prog.set_pm_mode(g, mem, gr_ctx->pm_ctx.pm_mode);
-	g->ops.gr.ctxsw_prog.set_pm_ptr(g, mem, virt_addr);
+#ifdef CONFIG_NVGPU_SET_FALCON_ACCESS_MAP
+	g->ops.gr.ctxsw_prog.set_priv_access_map_addr(g, mem,
+		nvgpu_gr_ctx_get_global_ctx_va(gr_ctx,
+			NVGPU_GR_CTX_PRIV_ACCESS_MAP_VA));
 #endif
 
+	nvgpu_log(g, gpu_dbg_info | gpu_dbg_gr, "write patch count = %d",
+			gr_ctx->patch_ctx.data_count);
+	g->ops.gr.ctxsw_prog.set_patch_count(g, mem,
+		gr_ctx->patch_ctx.data_count);
+	g->ops.gr.ctxsw_prog.set_patch_addr(g, mem,
+		gr_ctx->patch_ctx.mem.gpu_va);
+
 	nvgpu_log(g, gpu_dbg_gr, "done");
 }
 
@@ -560,11 +618,41 @@ void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
  * _ctx_patch_write(..., patch) statements. However any necessary map overhead
  * should be minimized; thus, bundle the sequence of these writes together, and
  * set them up and close with _ctx_patch_write_begin/_ctx_patch_write_end.
+ *
+ * Between begin and end, patch entries are staged in a small CPU array and
+ * copied into the patch buffer with one nvgpu_mem_wr_n() when the array fills
+ * up or when the sequence is closed.
  */
+static void nvgpu_gr_ctx_patch_flush(struct gk20a *g,
+	struct patch_desc *patch_ctx)
+{
+	u32 size;
+
+	if (patch_ctx->stage_count == 0U) {
+		return;
+	}
+
+	size = nvgpu_safe_mult_u32(patch_ctx->stage_count,
+			(u32)sizeof(struct patch_entry));
+
+	nvgpu_mem_wr_n(g, &patch_ctx->mem,
+		nvgpu_safe_mult_u64(patch_ctx->stage_base,
+			sizeof(struct patch_entry)),
+		patch_ctx->stage, size);
+
+	nvgpu_log(g, gpu_dbg_info, "patch flush base %u count %u",
+		patch_ctx->stage_base, patch_ctx->stage_count);
+
+	patch_ctx->stage_count = 0U;
+}
+
 void nvgpu_gr_ctx_patch_write_begin(struct gk20a *g,
 	struct nvgpu_gr_ctx *gr_ctx,
 	bool update_patch_count)
 {
+	/* flush anything left over from a sequence that was not closed */
+	nvgpu_gr_ctx_patch_flush(g, &gr_ctx->patch_ctx);
+
 	if (update_patch_count) {
 		/* reset patch count if ucode has already processed it */
 		gr_ctx->patch_ctx.data_count =
@@ -572,12 +660,17 @@ void nvgpu_gr_ctx_patch_write_begin(struct gk20a *g,
 		nvgpu_log(g, gpu_dbg_info, "patch count reset to %d",
 					gr_ctx->patch_ctx.data_count);
 	}
+
+	gr_ctx->patch_ctx.batching = true;
 }
 
 void nvgpu_gr_ctx_patch_write_end(struct gk20a *g,
 	struct nvgpu_gr_ctx *gr_ctx,
 	bool update_patch_count)
 {
+	nvgpu_gr_ctx_patch_flush(g, &gr_ctx->patch_ctx);
+	gr_ctx->patch_ctx.batching = false;
+
 	/* Write context count to context image if it is mapped */
 	if (update_patch_count) {
 		g->ops.gr.ctxsw_prog.set_patch_count(g, &gr_ctx->mem,
@@ -587,6 +680,33 @@ void nvgpu_gr_ctx_patch_write_end(struct gk20a *g,
 	}
 }
 
+static void nvgpu_gr_ctx_patch_stage(struct gk20a *g,
+	struct patch_desc *patch_ctx, u32 addr, u32 data)
+{
+	struct patch_entry *entry;
+
+	/*
+	 * Staged entries must stay contiguous in the patch buffer. Flush
+	 * first if the stage is full or data_count was moved under us.
+	 */
+	if ((patch_ctx->stage_count == PATCH_CTX_STAGE_ENTRIES) ||
+	    ((patch_ctx->stage_count != 0U) &&
+	     (patch_ctx->data_count != nvgpu_safe_add_u32(
+			patch_ctx->stage_base, patch_ctx->stage_count)))) {
+		nvgpu_gr_ctx_patch_flush(g, patch_ctx);
+	}
+
+	if (patch_ctx->stage_count == 0U) {
+		patch_ctx->stage_base = patch_ctx->data_count;
+	}
+
+	entry = &patch_ctx->stage[patch_ctx->stage_count];
+	entry->addr = addr;
+	entry->data = data;
+	patch_ctx->stage_count = nvgpu_safe_add_u32(patch_ctx->stage_count,
+						1U);
+}
+
 void nvgpu_gr_ctx_patch_write(struct gk20a *g,
 	struct nvgpu_gr_ctx *gr_ctx,
 	u32 addr, u32 data, bool patch)
@@ -616,15 +736,20 @@ void nvgpu_gr_ctx_patch_write(struct gk20a *g,
 			return;
 		}
 
-		nvgpu_mem_wr32(g, &gr_ctx->patch_ctx.mem,
+		if (gr_ctx->patch_ctx.batching) {
+			nvgpu_gr_ctx_patch_stage(g, &gr_ctx->patch_ctx,
+				addr, data);
+		} else {
+			nvgpu_mem_wr32(g, &gr_ctx->patch_ctx.mem,
 						(u64)patch_slot, addr);
-		nvgpu_mem_wr32(g, &gr_ctx->patch_ctx.mem,
+			nvgpu_mem_wr32(g, &gr_ctx->patch_ctx.mem,
 						(u64)patch_slot + 1ULL, data);
+			nvgpu_log(g, gpu_dbg_info,
+				"patch addr = 0x%x data = 0x%x data_count %d",
+				addr, data, gr_ctx->patch_ctx.data_count);
+		}
 		gr_ctx->patch_ctx.data_count = nvgpu_safe_add_u32(
 						gr_ctx->patch_ctx.data_count, 1U);
-		nvgpu_log(g, gpu_dbg_info,
-			"patch addr = 0x%x data = 0x%x data_count %d",
-			addr, data, gr_ctx->patch_ctx.data_count);
 	} else {
 		nvgpu_writel(g, addr, data);
 	}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -25,6 +25,22 @@
 
 struct nvgpu_mem;
 
+/**
+ * Number of patch entries staged in CPU memory before they are flushed
+ * into patch context buffer with a single bulk write.
+ */
+#define PATCH_CTX_STAGE_ENTRIES		64U
+
+/**
+ * Patch entry as laid out in patch context buffer.
+ */
+struct patch_entry {
+	/** Register address. */
+	u32 addr;
+	/** Register data. */
+	u32 data;
+};
+
 /**
  * Patch context buffer descriptor structure.
  *
@@ -37,9 +53,32 @@ struct patch_desc {
 	struct nvgpu_mem mem;
 
 	/**
-	 * Count of entries written into patch context buffer.
+	 * Count of entries written into patch context buffer, including
+	 * the entries still staged in #stage.
 	 */
 	u32 data_count;
+
+	/**
+	 * Set between #nvgpu_gr_ctx_patch_write_begin() and
+	 * #nvgpu_gr_ctx_patch_write_end(). Patch writes are staged only
+	 * while this is set, otherwise they go straight to #mem.
+	 */
+	bool batching;
+
+	/**
+	 * Entry index in patch context buffer of the first staged entry.
+	 */
+	u32 stage_base;
+
+	/**
+	 * Count of entries in #stage not yet flushed to #mem.
+	 */
+	u32 stage_count;
+
+	/**
+	 * Patch entries staged for the next bulk write into #mem.
+	 */
+	struct patch_entry stage[PATCH_CTX_STAGE_ENTRIES];
 };
 
 #ifdef CONFIG_NVGPU_GRAPHICS
@@ -22,7 +22,9 @@
 
 #include <nvgpu/gk20a.h>
 #include <nvgpu/nvgpu_init.h>
-#include <nvgpu/list.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/barrier.h>
+#include <nvgpu/static_analysis.h>
 #include <nvgpu/log.h>
 #include <nvgpu/log2.h>
 #include <nvgpu/mm.h>
@@ -38,97 +40,47 @@
 static void nvgpu_gr_fecs_trace_periodic_polling(void *arg);
 
 int nvgpu_gr_fecs_trace_add_context(struct gk20a *g, u32 context_ptr,
-	pid_t pid, u32 vmid, struct nvgpu_list_node *list)
+	pid_t pid, u32 vmid)
 {
 	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
-	struct nvgpu_fecs_trace_context_entry *entry;
 
 	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_ctxsw,
 		"adding hash entry context_ptr=%x -> pid=%d, vmid=%d",
 		context_ptr, pid, vmid);
 
-	entry = nvgpu_kzalloc(g, sizeof(*entry));
-	if (entry == NULL) {
-		nvgpu_err(g,
-			"can't alloc new entry for context_ptr=%x pid=%d vmid=%d",
+	return nvgpu_gr_fecs_trace_ctx_table_add(g, &trace->ctx_table,
 			context_ptr, pid, vmid);
-		return -ENOMEM;
-	}
-
-	nvgpu_init_list_node(&entry->entry);
-	entry->context_ptr = context_ptr;
-	entry->pid = pid;
-	entry->vmid = vmid;
-
-	nvgpu_mutex_acquire(&trace->list_lock);
-	nvgpu_list_add_tail(&entry->entry, list);
-	nvgpu_mutex_release(&trace->list_lock);
-
-	return 0;
 }
 
-void nvgpu_gr_fecs_trace_remove_context(struct gk20a *g, u32 context_ptr,
-	struct nvgpu_list_node *list)
+void nvgpu_gr_fecs_trace_remove_context(struct gk20a *g, u32 context_ptr)
 {
 	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
-	struct nvgpu_fecs_trace_context_entry *entry, *tmp;
 
 	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_ctxsw,
 		"freeing entry context_ptr=%x", context_ptr);
 
-	nvgpu_mutex_acquire(&trace->list_lock);
-	nvgpu_list_for_each_entry_safe(entry, tmp, list,
-			nvgpu_fecs_trace_context_entry,	entry) {
-		if (entry->context_ptr == context_ptr) {
-			nvgpu_list_del(&entry->entry);
-			nvgpu_log(g, gpu_dbg_ctxsw,
-				"freed entry=%p context_ptr=%x", entry,
-				entry->context_ptr);
-			nvgpu_kfree(g, entry);
-			break;
-		}
-	}
-	nvgpu_mutex_release(&trace->list_lock);
+	nvgpu_gr_fecs_trace_ctx_table_remove(g, &trace->ctx_table,
+		context_ptr);
 }
 
-void nvgpu_gr_fecs_trace_remove_contexts(struct gk20a *g,
-	struct nvgpu_list_node *list)
+void nvgpu_gr_fecs_trace_remove_contexts(struct gk20a *g)
 {
 	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
-	struct nvgpu_fecs_trace_context_entry *entry, *tmp;
 
-	nvgpu_mutex_acquire(&trace->list_lock);
-	nvgpu_list_for_each_entry_safe(entry, tmp, list,
-			nvgpu_fecs_trace_context_entry,	entry) {
-		nvgpu_list_del(&entry->entry);
-		nvgpu_kfree(g, entry);
-	}
-	nvgpu_mutex_release(&trace->list_lock);
+	nvgpu_gr_fecs_trace_ctx_table_clear(&trace->ctx_table);
 }
 
 void nvgpu_gr_fecs_trace_find_pid(struct gk20a *g, u32 context_ptr,
-	struct nvgpu_list_node *list, pid_t *pid, u32 *vmid)
+	pid_t *pid, u32 *vmid)
 {
 	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
-	struct nvgpu_fecs_trace_context_entry *entry;
-
-	nvgpu_mutex_acquire(&trace->list_lock);
-	nvgpu_list_for_each_entry(entry, list, nvgpu_fecs_trace_context_entry,
-			entry) {
-		if (entry->context_ptr == context_ptr) {
-			nvgpu_log(g, gpu_dbg_ctxsw,
-				"found context_ptr=%x -> pid=%d, vmid=%d",
-				entry->context_ptr, entry->pid, entry->vmid);
-			*pid = entry->pid;
-			*vmid = entry->vmid;
-			nvgpu_mutex_release(&trace->list_lock);
-			return;
-		}
-	}
-	nvgpu_mutex_release(&trace->list_lock);
 
-	*pid = 0;
-	*vmid = 0xffffffffU;
+	if (nvgpu_gr_fecs_trace_ctx_table_find(&trace->ctx_table,
+			context_ptr, pid, vmid)) {
+		nvgpu_log(g, gpu_dbg_ctxsw,
+			"found context_ptr=%x -> pid=%d, vmid=%d",
+			context_ptr, *pid, *vmid);
+	}
 }
 
 int nvgpu_gr_fecs_trace_init(struct gk20a *g)
@@ -148,14 +100,19 @@ int nvgpu_gr_fecs_trace_init(struct gk20a *g)
 		nvgpu_set_enabled(g, NVGPU_SUPPORT_FECS_CTXSW_TRACE, false);
 		return -ENOMEM;
 	}
+
+	err = nvgpu_gr_fecs_trace_ctx_table_init(g, &trace->ctx_table);
+	if (err != 0) {
+		nvgpu_err(g, "failed to allocate fecs_trace context table");
+		nvgpu_kfree(g, trace);
+		nvgpu_set_enabled(g, NVGPU_SUPPORT_FECS_CTXSW_TRACE, false);
+		return -ENOMEM;
+	}
 	g->fecs_trace = trace;
 
 	nvgpu_mutex_init(&trace->poll_lock);
-	nvgpu_mutex_init(&trace->list_lock);
 	nvgpu_mutex_init(&trace->enable_lock);
 
-	nvgpu_init_list_node(&trace->context_list);
-
 	trace->enable_count = 0;
 
 	err = nvgpu_periodic_timer_init(&trace->poll_timer,
@@ -184,9 +141,8 @@ int nvgpu_gr_fecs_trace_deinit(struct gk20a *g)
 	}
 	nvgpu_periodic_timer_destroy(&trace->poll_timer);
 
-	nvgpu_gr_fecs_trace_remove_contexts(g, &trace->context_list);
+	nvgpu_gr_fecs_trace_ctx_table_deinit(g, &trace->ctx_table);
 
-	nvgpu_mutex_destroy(&g->fecs_trace->list_lock);
 	nvgpu_mutex_destroy(&g->fecs_trace->poll_lock);
 	nvgpu_mutex_destroy(&g->fecs_trace->enable_lock);
 
@@ -375,7 +331,6 @@ int nvgpu_gr_fecs_trace_ring_read(struct gk20a *g, int index,
 	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
 	pid_t cur_pid = 0, new_pid = 0;
 	u32 cur_vmid = 0U, new_vmid = 0U;
-	u32 vmid = 0U;
 	int count = 0;
 
 	struct nvgpu_fecs_trace_record *r =
@@ -391,6 +346,7 @@ int nvgpu_gr_fecs_trace_ring_read(struct gk20a *g, int index,
 		nvgpu_warn(g,
 			"trace=%p read=%d record=%p magic_lo=%08x magic_hi=%08x (invalid)",
 			trace, index, r, r->magic_lo, r->magic_hi);
+		trace->stats.invalid++;
 		return -EINVAL;
 	}
 
@@ -402,7 +358,7 @@ int nvgpu_gr_fecs_trace_ring_read(struct gk20a *g, int index,
 
 	if ((r->context_ptr != 0U) && (r->context_id != 0U)) {
 		nvgpu_gr_fecs_trace_find_pid(g, r->context_ptr,
-			&trace->context_list, &cur_pid, &cur_vmid);
+			&cur_pid, &cur_vmid);
 	} else {
 		cur_vmid = 0xffffffffU;
 		cur_pid = 0;
@@ -410,7 +366,7 @@ int nvgpu_gr_fecs_trace_ring_read(struct gk20a *g, int index,
 
 	if (r->new_context_ptr != 0U) {
 		nvgpu_gr_fecs_trace_find_pid(g, r->new_context_ptr,
-			&trace->context_list, &new_pid, &new_vmid);
+			&new_pid, &new_vmid);
 	} else {
 		new_vmid = 0xffffffffU;
 		new_pid = 0;
@@ -476,22 +432,70 @@ int nvgpu_gr_fecs_trace_ring_read(struct gk20a *g, int index,
 		if (g->ops.gr.fecs_trace.vm_dev_write != NULL) {
 			g->ops.gr.fecs_trace.vm_dev_write(g, entry.vmid,
 				vm_update_mask, &entry);
-		} else {
-			nvgpu_gr_fecs_trace_write_entry(g, &entry);
+		} else if (nvgpu_gr_fecs_trace_write_entry(g, &entry) < 0) {
+			trace->stats.dropped++;
 		}
 		count++;
 	}
 
-	nvgpu_gr_fecs_trace_wake_up(g, (int)vmid);
+	trace->stats.records++;
+	trace->stats.entries += (u64)count;
+
+	/* readers are woken up once per batch by nvgpu_gr_fecs_trace_poll() */
 	return count;
 }
 
+/*
+ * Hand consumed records back to FECS. Called with poll_lock held.
+ */
+static void nvgpu_gr_fecs_trace_ack_read_index(struct gk20a *g, int read)
+{
+	if (nvgpu_is_enabled(g, NVGPU_FECS_TRACE_FEATURE_CONTROL)) {
+		/*
+		 * In the next step, read pointer is going to be updated.
+		 * So, MSB of read pointer should be set back to 1. This will
+		 * keep FECS trace enabled.
+		 */
+		read = (int)(((u32)read) | (BIT32(NVGPU_FECS_TRACE_FEATURE_CONTROL_BIT)));
+	}
+
+	/* ensure FECS records has been updated before incrementing read index */
+	nvgpu_wmb();
+	g->ops.gr.fecs_trace.set_read_index(g, read);
+
+	/*
+	 * FECS ucode does a priv holdoff around the assertion of context
+	 * reset. So, pri transactions (e.g. mailbox1 register write) might
+	 * fail due to this. Hence, do write with ack i.e. write and read
+	 * it back to make sure write happened for mailbox1.
+	 */
+	while (g->ops.gr.fecs_trace.get_read_index(g) != read) {
+		nvgpu_log(g, gpu_dbg_ctxsw, "mailbox1 update failed");
+		g->ops.gr.fecs_trace.set_read_index(g, read);
+	}
+}
+
+static void nvgpu_gr_fecs_trace_update_rate(struct nvgpu_gr_fecs_trace *trace,
+	u64 records)
+{
+	s64 now = nvgpu_current_time_ns();
+	s64 delta = now - trace->last_poll_ns;
+
+	if ((trace->last_poll_ns != 0) && (delta > 0)) {
+		trace->stats.records_per_sec =
+			(records * 1000000000ULL) / (u64)delta;
+	}
+	trace->last_poll_ns = now;
+}
+
 int nvgpu_gr_fecs_trace_poll(struct gk20a *g)
 {
 	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
 	u32 vm_update_mask = 0U;
+	u64 records;
 	int read = 0;
 	int write = 0;
+	int batch;
 	int cnt;
 	int err = 0;
 
@@ -500,6 +504,8 @@ int nvgpu_gr_fecs_trace_poll(struct gk20a *g)
 		goto done_unlock;
 	}
 
+	records = trace->stats.records;
+
 	err = gk20a_busy(g);
 	if (err) {
 		goto done_unlock;
@@ -516,8 +522,10 @@ int nvgpu_gr_fecs_trace_poll(struct gk20a *g)
 	read = g->ops.gr.fecs_trace.get_read_index(g);
 
 	cnt = CIRC_CNT((u32)write, (u32)read, GK20A_FECS_TRACE_NUM_RECORDS);
-	if (!cnt)
+	if (!cnt) {
+		nvgpu_gr_fecs_trace_update_rate(trace, 0ULL);
 		goto done;
+	}
 
 	nvgpu_log(g, gpu_dbg_ctxsw,
 		"circular buffer: read=%d (mailbox=%d) write=%d cnt=%d",
@@ -530,44 +538,41 @@ int nvgpu_gr_fecs_trace_poll(struct gk20a *g)
 		goto done;
 	}
 
+	trace->stats.polls++;
+
 	if (nvgpu_is_enabled(g, NVGPU_FECS_TRACE_FEATURE_CONTROL)) {
 		/* Bits 30:0 of MAILBOX1 represents actual read pointer value */
 		read = ((u32)read) & (~(BIT32(NVGPU_FECS_TRACE_FEATURE_CONTROL_BIT)));
 	}
 
-	while (read != write) {
-		cnt = nvgpu_gr_fecs_trace_ring_read(g, read, &vm_update_mask);
-		if (cnt <= 0) {
+	/*
+	 * Consume records in batches: FECS gets its read index back and
+	 * readers are woken up once per batch instead of once per record,
+	 * while FECS can still refill the ring during long drains.
+	 */
+	cnt = 1;
+	while ((read != write) && (cnt > 0)) {
+		for (batch = 0; (batch < NVGPU_FECS_TRACE_POLL_BATCH) &&
+				(read != write); batch++) {
+			cnt = nvgpu_gr_fecs_trace_ring_read(g, read,
+					&vm_update_mask);
+			if (cnt <= 0) {
+				break;
+			}
+
+			/* Get to next record. */
+			read = (read + 1) & (GK20A_FECS_TRACE_NUM_RECORDS - 1);
+		}
+
+		if (batch == 0) {
 			break;
 		}
 
-		/* Get to next record. */
-		read = (read + 1) & (GK20A_FECS_TRACE_NUM_RECORDS - 1);
+		nvgpu_gr_fecs_trace_ack_read_index(g, read);
+		nvgpu_gr_fecs_trace_wake_up(g, 0);
 	}
 
-	if (nvgpu_is_enabled(g, NVGPU_FECS_TRACE_FEATURE_CONTROL)) {
-		/*
-		 * In the next step, read pointer is going to be updated.
-		 * So, MSB of read pointer should be set back to 1. This will
-		 * keep FECS trace enabled.
-		 */
-		read = (int)(((u32)read) | (BIT32(NVGPU_FECS_TRACE_FEATURE_CONTROL_BIT)));
-	}
-
-	/* ensure FECS records has been updated before incrementing read index */
-	nvgpu_wmb();
-	g->ops.gr.fecs_trace.set_read_index(g, read);
-
-	/*
-	 * FECS ucode does a priv holdoff around the assertion of context
-	 * reset. So, pri transactions (e.g. mailbox1 register write) might
-	 * fail due to this. Hence, do write with ack i.e. write and read
-	 * it back to make sure write happened for mailbox1.
-	 */
-	while (g->ops.gr.fecs_trace.get_read_index(g) != read) {
-		nvgpu_log(g, gpu_dbg_ctxsw, "mailbox1 update failed");
-		g->ops.gr.fecs_trace.set_read_index(g, read);
-	}
+	nvgpu_gr_fecs_trace_update_rate(trace, trace->stats.records - records);
 
 	if (g->ops.gr.fecs_trace.vm_dev_update) {
 		g->ops.gr.fecs_trace.vm_dev_update(g, vm_update_mask);
@@ -580,6 +585,19 @@ done_unlock:
 	return err;
 }
 
+void nvgpu_gr_fecs_trace_get_stats(struct gk20a *g,
+	struct nvgpu_fecs_trace_stats *stats)
+{
+	struct nvgpu_gr_fecs_trace *trace = g->fecs_trace;
+
+	nvgpu_mutex_acquire(&trace->poll_lock);
+	*stats = trace->stats;
+	nvgpu_mutex_release(&trace->poll_lock);
+
+	stats->contexts = nvgpu_gr_fecs_trace_ctx_table_count(
+			&trace->ctx_table);
+}
+
 static void nvgpu_gr_fecs_trace_periodic_polling(void *arg)
 {
 	struct gk20a *g = (struct gk20a *)arg;
@@ -664,8 +682,7 @@ int nvgpu_gr_fecs_trace_bind_channel(struct gk20a *g,
 
 	g->ops.gr.ctxsw_prog.set_ts_buffer_ptr(g, mem, addr, aperture_mask);
 
-	ret = nvgpu_gr_fecs_trace_add_context(g, context_ptr, pid, vmid,
-		&trace->context_list);
+	ret = nvgpu_gr_fecs_trace_add_context(g, context_ptr, pid, vmid);
 
 	return ret;
 }
@@ -692,8 +709,7 @@ int nvgpu_gr_fecs_trace_unbind_channel(struct gk20a *g,
 		nvgpu_gr_fecs_trace_poll(g);
 	}
 
-	nvgpu_gr_fecs_trace_remove_context(g, context_ptr,
-		&trace->context_list);
+	nvgpu_gr_fecs_trace_remove_context(g, context_ptr);
 
 	return 0;
 }
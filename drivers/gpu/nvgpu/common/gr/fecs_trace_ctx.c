@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <nvgpu/types.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/log.h>
+#include <nvgpu/barrier.h>
+#include <nvgpu/static_analysis.h>
+#include <nvgpu/gr/fecs_trace_ctx.h>
+
+static inline u32 nvgpu_gr_fecs_trace_ctx_hash(u32 context_ptr)
+{
+	/* Fibonacci hashing, context_ptr low bits are mostly aligned */
+	return (u32)(((u64)context_ptr * 0x9E3779B1ULL) & 0xffffffffULL) >>
+		(32U - NVGPU_FECS_TRACE_CTX_TABLE_SHIFT);
+}
+
+static inline u32 nvgpu_gr_fecs_trace_ctx_next(u32 i)
+{
+	return (i + 1U) & (NVGPU_FECS_TRACE_CTX_TABLE_SIZE - 1U);
+}
+
+/*
+ * Lookup helper for writers, called with the table lock held. Returns the
+ * slot holding context_ptr, or the free slot terminating its probe sequence.
+ */
+static u32 nvgpu_gr_fecs_trace_ctx_slot(
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr)
+{
+	u32 i = nvgpu_gr_fecs_trace_ctx_hash(context_ptr);
+
+	while ((table->entries[i].context_ptr != 0U) &&
+			(table->entries[i].context_ptr != context_ptr)) {
+		i = nvgpu_gr_fecs_trace_ctx_next(i);
+	}
+
+	return i;
+}
+
+static void nvgpu_gr_fecs_trace_ctx_write_begin(
+	struct nvgpu_gr_fecs_trace_ctx_table *table)
+{
+	nvgpu_atomic_inc(&table->seq);
+	nvgpu_smp_wmb();
+}
+
+static void nvgpu_gr_fecs_trace_ctx_write_end(
+	struct nvgpu_gr_fecs_trace_ctx_table *table)
+{
+	nvgpu_smp_wmb();
+	nvgpu_atomic_inc(&table->seq);
+}
+
+int nvgpu_gr_fecs_trace_ctx_table_init(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table)
+{
+	table->entries = nvgpu_vzalloc(g, sizeof(*table->entries) *
+				NVGPU_FECS_TRACE_CTX_TABLE_SIZE);
+	if (table->entries == NULL) {
+		return -ENOMEM;
+	}
+
+	nvgpu_mutex_init(&table->lock);
+	nvgpu_atomic_set(&table->seq, 0);
+	table->count = 0U;
+
+	return 0;
+}
+
+void nvgpu_gr_fecs_trace_ctx_table_deinit(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table)
+{
+	nvgpu_gr_fecs_trace_ctx_table_clear(table);
+	nvgpu_mutex_destroy(&table->lock);
+	nvgpu_vfree(g, table->entries);
+	table->entries = NULL;
+}
+
+int nvgpu_gr_fecs_trace_ctx_table_add(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr,
+	pid_t pid, u32 vmid)
+{
+	struct nvgpu_fecs_trace_context_entry *entry;
+	int err = 0;
+
+	if (context_ptr == 0U) {
+		return -EINVAL;
+	}
+
+	nvgpu_mutex_acquire(&table->lock);
+
+	entry = &table->entries[nvgpu_gr_fecs_trace_ctx_slot(table,
+					context_ptr)];
+	if ((entry->context_ptr == 0U) &&
+			(table->count >= NVGPU_FECS_TRACE_CTX_TABLE_MAX)) {
+		nvgpu_err(g,
+			"no room for context_ptr=%x pid=%d vmid=%d",
+			context_ptr, pid, vmid);
+		err = -ENOSPC;
+		goto done;
+	}
+
+	nvgpu_gr_fecs_trace_ctx_write_begin(table);
+	if (entry->context_ptr == 0U) {
+		table->count = nvgpu_safe_add_u32(table->count, 1U);
+	}
+	NV_WRITE_ONCE(entry->pid, pid);
+	NV_WRITE_ONCE(entry->vmid, vmid);
+	NV_WRITE_ONCE(entry->context_ptr, context_ptr);
+	nvgpu_gr_fecs_trace_ctx_write_end(table);
+
+done:
+	nvgpu_mutex_release(&table->lock);
+	return err;
+}
+
+void nvgpu_gr_fecs_trace_ctx_table_remove(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr)
+{
+	struct nvgpu_fecs_trace_context_entry *entries = table->entries;
+	u32 i, j, k;
+
+	if (context_ptr == 0U) {
+		return;
+	}
+
+	nvgpu_mutex_acquire(&table->lock);
+
+	i = nvgpu_gr_fecs_trace_ctx_slot(table, context_ptr);
+	if (entries[i].context_ptr == 0U) {
+		goto done;
+	}
+
+	nvgpu_gr_fecs_trace_ctx_write_begin(table);
+
+	/*
+	 * Backward shift deletion: pull later members of the probe run into
+	 * the hole so that lookups never need tombstones.
+	 */
+	j = i;
+	while (true) {
+		j = nvgpu_gr_fecs_trace_ctx_next(j);
+		if (entries[j].context_ptr == 0U) {
+			break;
+		}
+
+		k = nvgpu_gr_fecs_trace_ctx_hash(entries[j].context_ptr);
+		/* entry at j stays if its home slot k lies in (i, j] */
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+			continue;
+		}
+
+		NV_WRITE_ONCE(entries[i].pid, entries[j].pid);
+		NV_WRITE_ONCE(entries[i].vmid, entries[j].vmid);
+		NV_WRITE_ONCE(entries[i].context_ptr, entries[j].context_ptr);
+		i = j;
+	}
+	NV_WRITE_ONCE(entries[i].context_ptr, 0U);
+	NV_WRITE_ONCE(entries[i].pid, 0);
+	NV_WRITE_ONCE(entries[i].vmid, 0U);
+	table->count = nvgpu_safe_sub_u32(table->count, 1U);
+
+	nvgpu_gr_fecs_trace_ctx_write_end(table);
+
+	nvgpu_log(g, gpu_dbg_ctxsw, "freed context_ptr=%x", context_ptr);
+
+done:
+	nvgpu_mutex_release(&table->lock);
+}
+
+void nvgpu_gr_fecs_trace_ctx_table_clear(
+	struct nvgpu_gr_fecs_trace_ctx_table *table)
+{
+	u32 i;
+
+	nvgpu_mutex_acquire(&table->lock);
+	nvgpu_gr_fecs_trace_ctx_write_begin(table);
+	for (i = 0U; i < NVGPU_FECS_TRACE_CTX_TABLE_SIZE; i++) {
+		NV_WRITE_ONCE(table->entries[i].context_ptr, 0U);
+	}
+	table->count = 0U;
+	nvgpu_gr_fecs_trace_ctx_write_end(table);
+	nvgpu_mutex_release(&table->lock);
+}
+
+/*
+ * Walk the probe sequence of context_ptr. Bounded by the table size so that
+ * a lockless walk racing with a backward shift cannot run away.
+ */
+static bool nvgpu_gr_fecs_trace_ctx_lookup(
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr,
+	pid_t *pid, u32 *vmid)
+{
+	struct nvgpu_fecs_trace_context_entry *entry;
+	u32 i = nvgpu_gr_fecs_trace_ctx_hash(context_ptr);
+	u32 n;
+	u32 ptr;
+
+	for (n = 0U; n < NVGPU_FECS_TRACE_CTX_TABLE_SIZE; n++) {
+		entry = &table->entries[i];
+		ptr = NV_READ_ONCE(entry->context_ptr);
+		if (ptr == 0U) {
+			break;
+		}
+		if (ptr == context_ptr) {
+			*pid = NV_READ_ONCE(entry->pid);
+			*vmid = NV_READ_ONCE(entry->vmid);
+			return true;
+		}
+		i = nvgpu_gr_fecs_trace_ctx_next(i);
+	}
+
+	*pid = 0;
+	*vmid = 0xffffffffU;
+	return false;
+}
+
+bool nvgpu_gr_fecs_trace_ctx_table_find(
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr,
+	pid_t *pid, u32 *vmid)
+{
+	bool found;
+	int seq;
+
+	/*
+	 * Lockless lookup on a snapshot of seq. Writers sleep holding the
+	 * lock, so rather than spinning while an update is in progress or
+	 * retrying after one, redo the lookup under the lock.
+	 */
+	seq = nvgpu_atomic_read(&table->seq);
+	if (((u32)seq & 1U) == 0U) {
+		nvgpu_smp_rmb();
+		found = nvgpu_gr_fecs_trace_ctx_lookup(table, context_ptr,
+				pid, vmid);
+		nvgpu_smp_rmb();
+		if (nvgpu_atomic_read(&table->seq) == seq) {
+			return found;
+		}
+	}
+
+	nvgpu_mutex_acquire(&table->lock);
+	found = nvgpu_gr_fecs_trace_ctx_lookup(table, context_ptr, pid, vmid);
+	nvgpu_mutex_release(&table->lock);
+
+	return found;
+}
+
+u32 nvgpu_gr_fecs_trace_ctx_table_count(
+	struct nvgpu_gr_fecs_trace_ctx_table *table)
+{
+	u32 count;
+
+	nvgpu_mutex_acquire(&table->lock);
+	count = table->count;
+	nvgpu_mutex_release(&table->lock);
+
+	return count;
+}
@@ -26,10 +26,9 @@
 #include <nvgpu/kmem.h>
 #include <nvgpu/bug.h>
 #include <nvgpu/dma.h>
-#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+#include <nvgpu/lock.h>
 #include <nvgpu/static_analysis.h>
 #include <nvgpu/string.h>
-#endif
 
 #include <nvgpu/gr/global_ctx.h>
 #include <nvgpu/power_features/pg.h>
@@ -379,21 +378,162 @@ int nvgpu_gr_global_ctx_alloc_local_golden_image(struct gk20a *g,
 	}
 
 	local_golden_image->size = size;
+	nvgpu_mutex_init(&local_golden_image->variant_lock);
 
 	*img = local_golden_image;
 	return 0;
 }
 
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+#define GOLDEN_CHECKSUM_PRIME1	0x9E3779B185EBCA87ULL
+#define GOLDEN_CHECKSUM_PRIME2	0xC2B2AE3D27D4EB4FULL
+#define GOLDEN_CHECKSUM_PRIME3	0x165667B19E3779F9ULL
+#define GOLDEN_CHECKSUM_LANES	4U
+#define GOLDEN_DIFF_LOG_MAX	16U
+
+/*
+ * Checksum arithmetic below relies on unsigned wrap-around, so plain
+ * operators are used instead of the nvgpu_safe_* helpers.
+ */
+static inline u64 golden_checksum_rotl(u64 v, u32 r)
+{
+	return (v << r) | (v >> (64U - r));
+}
+
+static inline u64 golden_checksum_round(u64 acc, u64 v)
+{
+	acc += v * GOLDEN_CHECKSUM_PRIME2;
+	acc = golden_checksum_rotl(acc, 31U);
+	return acc * GOLDEN_CHECKSUM_PRIME1;
+}
+
+/*
+ * 64-bit rolling checksum of a local golden image. The bulk of the image
+ * is consumed as four independent u64 lanes so the multiply chains can
+ * overlap; remaining words are folded in one at a time.
+ */
+static u64 nvgpu_gr_global_ctx_checksum(const u32 *data, size_t size)
+{
+	u64 lane[GOLDEN_CHECKSUM_LANES] = {
+		GOLDEN_CHECKSUM_PRIME1 + GOLDEN_CHECKSUM_PRIME2,
+		GOLDEN_CHECKSUM_PRIME2,
+		0ULL,
+		0ULL - GOLDEN_CHECKSUM_PRIME1,
+	};
+	size_t words = size / sizeof(u32);
+	size_t blocks = words / (2U * GOLDEN_CHECKSUM_LANES);
+	size_t i, j;
+	u64 h;
+
+	for (i = 0U; i < blocks; i++) {
+		const u32 *p = &data[i * 2U * GOLDEN_CHECKSUM_LANES];
+
+		for (j = 0U; j < GOLDEN_CHECKSUM_LANES; j++) {
+			lane[j] = golden_checksum_round(lane[j],
+				((u64)p[2U * j + 1U] << 32U) | (u64)p[2U * j]);
+		}
+	}
+
+	h = golden_checksum_rotl(lane[0], 1U) +
+		golden_checksum_rotl(lane[1], 7U) +
+		golden_checksum_rotl(lane[2], 12U) +
+		golden_checksum_rotl(lane[3], 18U);
+	h += (u64)size;
+
+	for (i = blocks * 2U * GOLDEN_CHECKSUM_LANES; i < words; i++) {
+		h ^= (u64)data[i] * GOLDEN_CHECKSUM_PRIME1;
+		h = golden_checksum_rotl(h, 23U) * GOLDEN_CHECKSUM_PRIME2 +
+			GOLDEN_CHECKSUM_PRIME3;
+	}
+
+	/* final avalanche */
+	h ^= h >> 33U;
+	h *= GOLDEN_CHECKSUM_PRIME2;
+	h ^= h >> 29U;
+	h *= GOLDEN_CHECKSUM_PRIME3;
+	h ^= h >> 32U;
+
+	return h;
+}
+#endif
+
+static struct nvgpu_gr_global_ctx_variant *
+nvgpu_gr_global_ctx_variant_from_ref(struct nvgpu_ref *ref)
+{
+	return (struct nvgpu_gr_global_ctx_variant *)((uintptr_t)ref -
+				offsetof(struct nvgpu_gr_global_ctx_variant, ref));
+}
+
+static void nvgpu_gr_global_ctx_variant_release(struct nvgpu_ref *ref)
+{
+	struct nvgpu_gr_global_ctx_variant *variant =
+		nvgpu_gr_global_ctx_variant_from_ref(ref);
+	struct gk20a *g = variant->g;
+
+	nvgpu_vfree(g, variant->context);
+	nvgpu_kfree(g, variant);
+}
+
+static void nvgpu_gr_global_ctx_free_variants(
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image)
+{
+	struct nvgpu_gr_global_ctx_variant *variant;
+	u32 i;
+
+	for (i = 0U; i < NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX; i++) {
+		variant = local_golden_image->variants[i];
+		local_golden_image->variants[i] = NULL;
+		if (variant != NULL) {
+			/* Freed by the last load still copying from it */
+			nvgpu_ref_put(&variant->ref,
+				nvgpu_gr_global_ctx_variant_release);
+		}
+	}
+}
+
 void nvgpu_gr_global_ctx_init_local_golden_image(struct gk20a *g,
 		struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
 		struct nvgpu_mem *source_mem, size_t size)
 {
 	(void)size;
+
+	/* Variants were baked from the previous image */
+	nvgpu_mutex_acquire(&local_golden_image->variant_lock);
+	nvgpu_gr_global_ctx_free_variants(local_golden_image);
+	nvgpu_mutex_release(&local_golden_image->variant_lock);
+
 	nvgpu_mem_rd_n(g, source_mem, 0, local_golden_image->context,
 		nvgpu_safe_cast_u64_to_u32(local_golden_image->size));
+
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+	local_golden_image->checksum = nvgpu_gr_global_ctx_checksum(
+		local_golden_image->context, local_golden_image->size);
+#endif
 }
 
 #ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+static void nvgpu_gr_global_ctx_log_golden_diff(struct gk20a *g,
+	const u32 *data1, const u32 *data2, size_t size)
+{
+	u32 words = nvgpu_safe_cast_u64_to_u32(size / sizeof(u32));
+	u32 mismatches = 0U;
+	u32 i;
+
+	for (i = 0U; i < words; i = nvgpu_safe_add_u32(i, 1U)) {
+		if (data1[i] != data2[i]) {
+			if (mismatches < GOLDEN_DIFF_LOG_MAX) {
+				nvgpu_log_info(g,
+					"mismatch i = %u golden1: %u golden2 %u",
+					i, data1[i], data2[i]);
+			}
+			mismatches = nvgpu_safe_add_u32(mismatches, 1U);
+		}
+	}
+
+	nvgpu_log_info(g, "golden image mismatch in %u of %u words",
+		mismatches, words);
+}
+
 bool nvgpu_gr_global_ctx_compare_golden_images(struct gk20a *g,
 	bool is_sysmem,
 	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image1,
@@ -403,9 +543,6 @@ bool nvgpu_gr_global_ctx_compare_golden_images(struct gk20a *g,
 	bool is_identical = true;
 	u32 *data1 = local_golden_image1->context;
 	u32 *data2 = local_golden_image2->context;
-#ifdef CONFIG_NVGPU_DGPU
-	u32 i;
-#endif
 
 #ifdef NVGPU_UNITTEST_FAULT_INJECTION_ENABLEMENT
 	if (nvgpu_posix_fault_injection_handle_call(
@@ -414,41 +551,48 @@ bool nvgpu_gr_global_ctx_compare_golden_images(struct gk20a *g,
 	}
 #endif
 
-	/*
-	 * In case of sysmem, direct mem compare can be used.
-	 * For vidmem, word by word comparison only works and
-	 * it is too early to use ce engine for read operations.
-	 */
-	if (is_sysmem) {
-		if (nvgpu_memcmp((u8 *)data1, (u8 *)data2, size) != 0) {
-			is_identical = false;
-		}
+#ifndef CONFIG_NVGPU_DGPU
+	if (!is_sysmem) {
+		nvgpu_log_info(g, "%s result %u", __func__, false);
+		return false;
 	}
-	else {
-#ifdef CONFIG_NVGPU_DGPU
-		for( i = 0U; i < nvgpu_safe_cast_u64_to_u32(size/sizeof(u32));
-					i = nvgpu_safe_add_u32(i, 1U)) {
-			if (*(data1 + i) != *(data2 + i)) {
-				is_identical = false;
-				nvgpu_log_info(g,
-				"mismatch i = %u golden1: %u golden2 %u",
-				i, *(data1 + i), *(data2 + i));
-				break;
-			}
-		}
 #else
-		is_identical = false;
+	(void)is_sysmem;
 #endif
+
+	/*
+	 * Both images are local copies in sysmem by now, even if they were
+	 * captured from vidmem, so a single bulk compare works for either.
+	 * Walk the images word by word only to report a mismatch.
+	 */
+	if (nvgpu_memcmp((u8 *)data1, (u8 *)data2, size) != 0) {
+		is_identical = false;
+		nvgpu_gr_global_ctx_log_golden_diff(g, data1, data2, size);
 	}
 
 	nvgpu_log_info(g, "%s result %u", __func__, is_identical);
 	return is_identical;
 }
+
+bool nvgpu_gr_global_ctx_verify_local_golden_image(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image)
+{
+	u64 checksum;
+
+	checksum = nvgpu_gr_global_ctx_checksum(local_golden_image->context,
+			local_golden_image->size);
+	if (checksum != local_golden_image->checksum) {
+		nvgpu_err(g, "local golden image checksum 0x%llx expected 0x%llx",
+			checksum, local_golden_image->checksum);
+		return false;
+	}
+
+	return true;
+}
 #endif
 
-void nvgpu_gr_global_ctx_load_local_golden_image(struct gk20a *g,
-	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
-	struct nvgpu_mem *target_mem)
+static void nvgpu_gr_global_ctx_load_image(struct gk20a *g,
+	u32 *context, size_t size, struct nvgpu_mem *target_mem)
 {
 	/* Channel gr_ctx buffer is gpu cacheable.
 	   Flush and invalidate before cpu update. */
@@ -457,15 +601,132 @@ void nvgpu_gr_global_ctx_load_local_golden_image(struct gk20a *g,
 		nvgpu_err(g, "l2_flush failed");
 	}
 
-	nvgpu_mem_wr_n(g, target_mem, 0, local_golden_image->context,
-		nvgpu_safe_cast_u64_to_u32(local_golden_image->size));
+	nvgpu_mem_wr_n(g, target_mem, 0, context,
+		nvgpu_safe_cast_u64_to_u32(size));
+}
+
+void nvgpu_gr_global_ctx_load_local_golden_image(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	struct nvgpu_mem *target_mem)
+{
+	nvgpu_gr_global_ctx_load_image(g, local_golden_image->context,
+		local_golden_image->size, target_mem);
 
 	nvgpu_log(g, gpu_dbg_gr, "loaded saved golden image into gr_ctx");
 }
 
+bool nvgpu_gr_global_ctx_load_local_golden_image_variant(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	u32 key, struct nvgpu_mem *target_mem)
+{
+	struct nvgpu_gr_global_ctx_variant *variant = NULL;
+
+	nvgpu_mutex_acquire(&local_golden_image->variant_lock);
+
+	if (key < NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX) {
+		variant = local_golden_image->variants[key];
+	}
+	if (variant == NULL) {
+		local_golden_image->variant_misses = nvgpu_safe_add_u64(
+			local_golden_image->variant_misses, 1ULL);
+		nvgpu_mutex_release(&local_golden_image->variant_lock);
+		return false;
+	}
+
+	local_golden_image->variant_hits = nvgpu_safe_add_u64(
+		local_golden_image->variant_hits, 1ULL);
+
+	/* Keep variant alive across a concurrent re-init */
+	nvgpu_ref_get(&variant->ref);
+
+	nvgpu_mutex_release(&local_golden_image->variant_lock);
+
+	nvgpu_gr_global_ctx_load_image(g, variant->context,
+		local_golden_image->size, target_mem);
+
+	nvgpu_ref_put(&variant->ref, nvgpu_gr_global_ctx_variant_release);
+
+	nvgpu_log(g, gpu_dbg_gr, "loaded golden image variant 0x%x into gr_ctx",
+		key);
+
+	return true;
+}
+
+int nvgpu_gr_global_ctx_save_local_golden_image_variant(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	u32 key, struct nvgpu_mem *source_mem)
+{
+	struct nvgpu_gr_global_ctx_variant *variant;
+
+	if (key >= NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX) {
+		return -EINVAL;
+	}
+
+	variant = nvgpu_kzalloc(g, sizeof(*variant));
+	if (variant == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Copy outside the lock, a racing save of same key is harmless */
+	variant->context = nvgpu_vzalloc(g, local_golden_image->size);
+	if (variant->context == NULL) {
+		nvgpu_kfree(g, variant);
+		return -ENOMEM;
+	}
+
+	variant->g = g;
+	nvgpu_ref_init(&variant->ref);
+
+	nvgpu_mem_rd_n(g, source_mem, 0, variant->context,
+		nvgpu_safe_cast_u64_to_u32(local_golden_image->size));
+
+	nvgpu_mutex_acquire(&local_golden_image->variant_lock);
+
+	if (local_golden_image->variants[key] != NULL) {
+		nvgpu_mutex_release(&local_golden_image->variant_lock);
+		nvgpu_ref_put(&variant->ref,
+			nvgpu_gr_global_ctx_variant_release);
+		return 0;
+	}
+
+	local_golden_image->variants[key] = variant;
+
+	nvgpu_mutex_release(&local_golden_image->variant_lock);
+
+	nvgpu_log(g, gpu_dbg_gr, "saved golden image variant 0x%x", key);
+
+	return 0;
+}
+
+void nvgpu_gr_global_ctx_get_variant_stats(
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	struct nvgpu_gr_global_ctx_variant_stats *stats)
+{
+	u32 i;
+
+	(void) memset(stats, 0, sizeof(*stats));
+
+	nvgpu_mutex_acquire(&local_golden_image->variant_lock);
+
+	for (i = 0U; i < NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX; i++) {
+		if (local_golden_image->variants[i] != NULL) {
+			stats->variants = nvgpu_safe_add_u32(stats->variants,
+						1U);
+			stats->bytes = nvgpu_safe_add_u64(stats->bytes,
+						local_golden_image->size);
+		}
+	}
+	stats->hits = local_golden_image->variant_hits;
+	stats->misses = local_golden_image->variant_misses;
+
+	nvgpu_mutex_release(&local_golden_image->variant_lock);
+}
+
 void nvgpu_gr_global_ctx_deinit_local_golden_image(struct gk20a *g,
 	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image)
 {
+	nvgpu_gr_global_ctx_free_variants(local_golden_image);
+	nvgpu_mutex_destroy(&local_golden_image->variant_lock);
 	nvgpu_vfree(g, local_golden_image->context);
 	nvgpu_kfree(g, local_golden_image);
 }
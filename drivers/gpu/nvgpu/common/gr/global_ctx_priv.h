@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -23,6 +23,9 @@
 #ifndef NVGPU_GR_GLOBAL_CTX_PRIV_H
 #define NVGPU_GR_GLOBAL_CTX_PRIV_H
 
+#include <nvgpu/kref.h>
+#include <nvgpu/lock.h>
+
 /**
  * Global context buffer descriptor structure.
  *
@@ -46,6 +49,27 @@ struct nvgpu_gr_global_ctx_buffer_desc {
 	global_ctx_mem_destroy_fn destroy;
 };
 
+/**
+ * Local Golden context image variant.
+ */
+struct nvgpu_gr_global_ctx_variant {
+	/**
+	 * Reference count, one for the cache slot and one for each load
+	 * in progress.
+	 */
+	struct nvgpu_ref ref;
+
+	/**
+	 * Pointer to GPU driver struct, used to free the variant.
+	 */
+	struct gk20a *g;
+
+	/**
+	 * Pointer to variant image memory.
+	 */
+	u32 *context;
+};
+
 /**
  * Local Golden context image descriptor structure.
  *
@@ -63,6 +87,34 @@ struct nvgpu_gr_global_ctx_local_golden_image {
 	 * Size of local Golden context image.
 	 */
 	size_t size;
+
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+	/**
+	 * Checksum of #context, computed when image is initialized.
+	 */
+	u64 checksum;
+#endif
+
+	/**
+	 * Lock to protect #variants and statistics.
+	 */
+	struct nvgpu_mutex variant_lock;
+
+	/**
+	 * Pre-baked copies of this image indexed by variant key, NULL if
+	 * the configuration has not been seen yet.
+	 */
+	struct nvgpu_gr_global_ctx_variant *variants[NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX];
+
+	/**
+	 * Number of context loads served from #variants.
+	 */
+	u64 variant_hits;
+
+	/**
+	 * Number of context loads not served from #variants.
+	 */
+	u64 variant_misses;
 };
 
 #endif /* NVGPU_GR_GLOBAL_CTX_PRIV_H */
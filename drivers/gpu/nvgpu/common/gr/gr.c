@@ -319,6 +319,15 @@ static void gr_remove_support(struct gk20a *g)
 
 	nvgpu_log_fn(g, " ");
 
+#ifdef CONFIG_NVGPU_DEBUGGER
+	/* The hwpm map build thread reads the netlist. */
+	for (i = 0U; i < g->num_gr_instances; i++) {
+		if (g->gr[i].hwpm_map != NULL) {
+			nvgpu_gr_hwpm_map_wait_build(g->gr[i].hwpm_map);
+		}
+	}
+#endif
+
 	nvgpu_netlist_deinit_ctx_vars(g);
 
 	for (i = 0U; i < g->num_gr_instances; i++) {
@@ -492,7 +501,13 @@ static int gr_init_setup_sw(struct gk20a *g, struct nvgpu_gr *gr)
 
 	if (gr->sw_ready) {
 		nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gr, "skip init");
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+		/* golden image is reused as is, make sure it is intact */
+		return nvgpu_gr_obj_ctx_verify_golden_image(g,
+				gr->golden_image);
+#else
 		return 0;
+#endif
 	}
 
 	err = nvgpu_gr_obj_ctx_init(g, &gr->golden_image,
@@ -508,6 +523,8 @@ static int gr_init_setup_sw(struct gk20a *g, struct nvgpu_gr *gr)
 		nvgpu_err(g, "hwpm_map init failed");
 		goto clean_up;
 	}
+	/* Not fatal, the map is built on first use if this fails. */
+	(void) nvgpu_gr_hwpm_map_build_async(g, gr->hwpm_map, gr->config);
 #endif
 
 	err = gr_init_ctx_bufs(g, gr);
@@ -555,7 +572,12 @@ static int gr_init_prepare_hw_impl(struct gk20a *g)
 {
 	struct netlist_av_list *sw_non_ctx_load =
 		nvgpu_netlist_get_sw_non_ctx_load_av_list(g);
-	u32 i;
+	struct nvgpu_reg_batch batch = {
+		.table = (const u32 *)(const void *)sw_non_ctx_load->l,
+		.count = sw_non_ctx_load->count,
+		.stride = (u32)(sizeof(struct netlist_av) / sizeof(u32)),
+		.value = (u32)(offsetof(struct netlist_av, value) / sizeof(u32)),
+	};
 	int err = 0;
 
 	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gr, "Prepare GR%u HW",
@@ -569,10 +591,7 @@ static int gr_init_prepare_hw_impl(struct gk20a *g)
 
 	/* load non_ctx init */
 	nvgpu_log_info(g, "begin: netlist: sw_non_ctx_load: register writes");
-	for (i = 0; i < sw_non_ctx_load->count; i++) {
-		nvgpu_writel(g, sw_non_ctx_load->l[i].addr,
-			sw_non_ctx_load->l[i].value);
-	}
+	nvgpu_writel_batch(g, &batch);
 
 	nvgpu_gr_init_reset_enable_hw_non_ctx_local(g);
 	nvgpu_gr_init_reset_enable_hw_non_ctx_global(g);
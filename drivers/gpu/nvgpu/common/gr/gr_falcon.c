@@ -311,7 +311,8 @@ int nvgpu_gr_falcon_init_ctxsw_ucode(struct gk20a *g,
 
 	nvgpu_log(g, gpu_dbg_gr, "Requst and copy FECS/GPCCS firmwares");
 
-	fecs_fw = nvgpu_request_firmware(g, NVGPU_FECS_UCODE_IMAGE, 0);
+	fecs_fw = nvgpu_request_firmware(g, NVGPU_FECS_UCODE_IMAGE,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
 	if (fecs_fw == NULL) {
 		nvgpu_err(g, "failed to load fecs ucode!!");
 		return -ENOENT;
@@ -321,7 +322,8 @@ int nvgpu_gr_falcon_init_ctxsw_ucode(struct gk20a *g,
 	fecs_boot_image = (void *)(fecs_fw->data +
 				sizeof(struct nvgpu_ctxsw_bootloader_desc));
 
-	gpccs_fw = nvgpu_request_firmware(g, NVGPU_GPCCS_UCODE_IMAGE, 0);
+	gpccs_fw = nvgpu_request_firmware(g, NVGPU_GPCCS_UCODE_IMAGE,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
 	if (gpccs_fw == NULL) {
 		nvgpu_release_firmware(g, fecs_fw);
 		nvgpu_err(g, "failed to load gpccs ucode!!");
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -23,9 +23,10 @@
 #include <nvgpu/gk20a.h>
 #include <nvgpu/netlist.h>
 #include <nvgpu/log.h>
-#include <nvgpu/sort.h>
 #include <nvgpu/kmem.h>
-#include <nvgpu/bsearch.h>
+#include <nvgpu/lock.h>
+#include <nvgpu/thread.h>
+#include <nvgpu/barrier.h>
 #include <nvgpu/fbp.h>
 #include <nvgpu/gr/config.h>
 #include <nvgpu/gr/hwpm_map.h>
@@ -41,6 +42,9 @@
 /* Dummy address for ctxsw'ed pri reg checksum. */
 #define CTXSW_PRI_CHECKSUM_DUMMY_REG  0x00ffffffU
 
+/* Marks an unused hash table slot; register addresses are 24 bit. */
+#define HWPM_MAP_HASH_EMPTY	(~U32(0U))
+
 int nvgpu_gr_hwpm_map_init(struct gk20a *g, struct nvgpu_gr_hwpm_map **hwpm_map,
 	u32 size)
 {
@@ -57,8 +61,10 @@ int nvgpu_gr_hwpm_map_init(struct gk20a *g, struct nvgpu_gr_hwpm_map **hwpm_map,
 		return -ENOMEM;
 	}
 
+	tmp_map->g = g;
 	tmp_map->pm_ctxsw_image_size = size;
 	tmp_map->init = false;
+	nvgpu_mutex_init(&tmp_map->lock);
 
 	*hwpm_map = tmp_map;
 
@@ -68,10 +74,14 @@ int nvgpu_gr_hwpm_map_init(struct gk20a *g, struct nvgpu_gr_hwpm_map **hwpm_map,
 void nvgpu_gr_hwpm_map_deinit(struct gk20a *g,
 	struct nvgpu_gr_hwpm_map *hwpm_map)
 {
+	nvgpu_gr_hwpm_map_wait_build(hwpm_map);
+
 	if (hwpm_map->init) {
+		nvgpu_big_free(g, hwpm_map->hash);
 		nvgpu_big_free(g, hwpm_map->map);
 	}
 
+	nvgpu_mutex_destroy(&hwpm_map->lock);
 	nvgpu_kfree(g, hwpm_map);
 }
 
@@ -80,21 +90,66 @@ u32 nvgpu_gr_hwpm_map_get_size(struct nvgpu_gr_hwpm_map *hwpm_map)
 	return hwpm_map->pm_ctxsw_image_size;
 }
 
-static int map_cmp(const void *a, const void *b)
+static inline u32 hwpm_map_hash(u32 addr, u32 shift)
+{
+	/* Fibonacci hashing of the register word index */
+	return (u32)(((u64)(addr >> 2U) * 0x9E3779B1ULL) & U32_MAX) >> shift;
+}
+
+/*
+ * Build an open addressed hash table with at least twice as many slots as
+ * map entries so that probe sequences stay short. If a register appears
+ * more than once, the first entry in buffer order is used.
+ */
+static int nvgpu_gr_hwpm_map_build_hash(struct gk20a *g,
+	struct nvgpu_gr_hwpm_map *hwpm_map,
+	struct ctxsw_buf_offset_map_entry *map, u32 count)
 {
-	const struct ctxsw_buf_offset_map_entry *e1;
-	const struct ctxsw_buf_offset_map_entry *e2;
+	struct ctxsw_buf_offset_map_entry *hash;
+	u32 bits = 1U;
+	u32 slots, mask, i, slot, probe;
+	u32 max_probe = 0U;
 
-	e1 = (const struct ctxsw_buf_offset_map_entry *)a;
-	e2 = (const struct ctxsw_buf_offset_map_entry *)b;
+	while ((bits < 31U) && ((BIT32(bits) >> 1U) < count)) {
+		bits++;
+	}
+	slots = BIT32(bits);
+	mask = slots - 1U;
 
-	if (e1->addr < e2->addr) {
-		return -1;
+	hash = nvgpu_big_malloc(g, (size_t)slots * sizeof(*hash));
+	if (hash == NULL) {
+		return -ENOMEM;
 	}
 
-	if (e1->addr > e2->addr) {
-		return 1;
+	for (i = 0U; i < slots; i++) {
+		hash[i].addr = HWPM_MAP_HASH_EMPTY;
+		hash[i].offset = 0U;
 	}
+
+	for (i = 0U; i < count; i++) {
+		slot = hwpm_map_hash(map[i].addr, 32U - bits);
+		probe = 0U;
+		while ((hash[slot].addr != HWPM_MAP_HASH_EMPTY) &&
+				(hash[slot].addr != map[i].addr)) {
+			slot = (slot + 1U) & mask;
+			probe++;
+		}
+		if (hash[slot].addr == HWPM_MAP_HASH_EMPTY) {
+			hash[slot] = map[i];
+		}
+		if (probe > max_probe) {
+			max_probe = probe;
+		}
+	}
+
+	hwpm_map->hash = hash;
+	hwpm_map->hash_shift = 32U - bits;
+	hwpm_map->hash_max_probe = max_probe;
+
+	nvgpu_log(g, gpu_dbg_gr | gpu_dbg_hwpm,
+		"hwpm map: %u entries, %u slots, max probe %u",
+		count, slots, max_probe);
+
 	return 0;
 }
 
@@ -554,11 +609,15 @@ static int nvgpu_gr_hwpm_map_create(struct gk20a *g,
 		goto cleanup;
 	}
 
-	sort(map, count, sizeof(*map), map_cmp, NULL);
+	if (nvgpu_gr_hwpm_map_build_hash(g, hwpm_map, map, count) != 0) {
+		goto cleanup;
+	}
 
 	hwpm_map->map = map;
 	hwpm_map->count = count;
-	hwpm_map->init = true;
+	/* Publish the table before lock-free lookups can see init set */
+	nvgpu_smp_wmb();
+	NV_WRITE_ONCE(hwpm_map->init, true);
 
 	nvgpu_log(g, gpu_dbg_hwpm,
 		"Reg Addr => HWPM Ctxt switch buffer offset");
@@ -576,6 +635,55 @@ cleanup:
 	return -EINVAL;
 }
 
+static int nvgpu_gr_hwpm_map_build_thread(void *arg)
+{
+	struct nvgpu_gr_hwpm_map *hwpm_map = arg;
+	struct gk20a *g = hwpm_map->g;
+
+	nvgpu_mutex_acquire(&hwpm_map->lock);
+	if (!hwpm_map->init) {
+		(void) nvgpu_gr_hwpm_map_create(g, hwpm_map,
+				hwpm_map->build_config);
+	}
+	nvgpu_mutex_release(&hwpm_map->lock);
+
+	return 0;
+}
+
+/*
+ * Build the map in the background so that the first regops on the PM
+ * context do not pay for it. If the thread cannot be started or fails,
+ * the map is built on first use instead.
+ */
+int nvgpu_gr_hwpm_map_build_async(struct gk20a *g,
+	struct nvgpu_gr_hwpm_map *hwpm_map, struct nvgpu_gr_config *config)
+{
+	int err;
+
+	if (hwpm_map->init || hwpm_map->build_thread_started) {
+		return 0;
+	}
+
+	hwpm_map->build_config = config;
+	err = nvgpu_thread_create(&hwpm_map->build_thread, hwpm_map,
+			nvgpu_gr_hwpm_map_build_thread, "nvgpu_hwpm_map");
+	if (err != 0) {
+		nvgpu_warn(g, "hwpm map build thread failed: %d", err);
+		return err;
+	}
+	hwpm_map->build_thread_started = true;
+
+	return 0;
+}
+
+void nvgpu_gr_hwpm_map_wait_build(struct nvgpu_gr_hwpm_map *hwpm_map)
+{
+	if (hwpm_map->build_thread_started) {
+		nvgpu_thread_join(&hwpm_map->build_thread);
+		hwpm_map->build_thread_started = false;
+	}
+}
+
 /*
  *  This function will return the 32 bit offset for a priv register if it is
  *  present in the PM context buffer.
@@ -584,33 +692,46 @@ int nvgpu_gr_hwmp_map_find_priv_offset(struct gk20a *g,
 	struct nvgpu_gr_hwpm_map *hwpm_map,
 	u32 addr, u32 *priv_offset, struct nvgpu_gr_config *config)
 {
-	struct ctxsw_buf_offset_map_entry *map, *result, map_key;
+	struct ctxsw_buf_offset_map_entry *hash;
 	int err = 0;
-	u32 count;
+	u32 mask, slot, probe;
 
 	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gpu_dbg, "addr=0x%x", addr);
 
-	/* Create map of pri address and pm offset if necessary */
-	if (!hwpm_map->init) {
-		err = nvgpu_gr_hwpm_map_create(g, hwpm_map, config);
+	/*
+	 * The map is read-only once built. Only take the lock if it has not
+	 * been built yet, to create it or wait for the build thread.
+	 */
+	if (!NV_READ_ONCE(hwpm_map->init)) {
+		nvgpu_mutex_acquire(&hwpm_map->lock);
+		if (!hwpm_map->init) {
+			err = nvgpu_gr_hwpm_map_create(g, hwpm_map, config);
+		}
+		nvgpu_mutex_release(&hwpm_map->lock);
 		if (err != 0) {
 			return err;
 		}
+	} else {
+		/* Pairs with the barrier before init is set */
+		nvgpu_smp_rmb();
 	}
 
 	*priv_offset = 0;
 
-	map = hwpm_map->map;
-	count = hwpm_map->count;
-
-	map_key.addr = addr;
-	result = nvgpu_bsearch(&map_key, map, count, sizeof(*map), map_cmp);
+	hash = hwpm_map->hash;
+	mask = (u32)(BIT64(32U - hwpm_map->hash_shift) - 1ULL);
+	slot = hwpm_map_hash(addr, hwpm_map->hash_shift);
 
-	if (result != NULL) {
-		*priv_offset = result->offset;
-	} else {
-		err = -EINVAL;
+	for (probe = 0U; probe <= hwpm_map->hash_max_probe; probe++) {
+		if (hash[slot].addr == addr) {
+			*priv_offset = hash[slot].offset;
+			return 0;
+		}
+		if (hash[slot].addr == HWPM_MAP_HASH_EMPTY) {
+			break;
+		}
+		slot = (slot + 1U) & mask;
 	}
 
-	return err;
+	return -EINVAL;
 }
@@ -472,12 +472,48 @@ error:
 	return err;
 }
 
+static void nvgpu_gr_obj_ctx_load_sw_ctx(struct gk20a *g,
+		struct netlist_aiv_list *sw_ctx_load)
+{
+	struct nvgpu_reg_batch batch = {
+		.table = (const u32 *)(const void *)sw_ctx_load->l,
+		.count = sw_ctx_load->count,
+		.stride = (u32)(sizeof(struct netlist_aiv) / sizeof(u32)),
+		.value = (u32)(offsetof(struct netlist_aiv, value) /
+				sizeof(u32)),
+	};
+
+#ifdef CONFIG_NVGPU_MIG
+	if ((nvgpu_is_enabled(g, NVGPU_SUPPORT_MIG)) &&
+			(g->ops.gr.init.is_allowed_reg != NULL)) {
+		u32 i;
+
+		/* Registers are filtered per GR instance, write one by one. */
+		for (i = 0U; i < sw_ctx_load->count; i++) {
+			if (!(g->ops.gr.init.is_allowed_reg(g,
+					sw_ctx_load->l[i].addr))) {
+				nvgpu_log(g, gpu_dbg_mig | gpu_dbg_gr,
+					"(MIG) Skip graphics ctx load reg "
+						"index[%u] addr[%x] value[%x] ",
+					i, sw_ctx_load->l[i].addr,
+					sw_ctx_load->l[i].value);
+				continue;
+			}
+			nvgpu_writel(g, sw_ctx_load->l[i].addr,
+				     sw_ctx_load->l[i].value);
+		}
+		return;
+	}
+#endif
+
+	nvgpu_writel_batch(g, &batch);
+}
+
 static int nvgpu_gr_obj_ctx_init_hw_state(struct gk20a *g,
 					struct nvgpu_mem *inst_block)
 {
 	int err = 0;
 	u32 data;
-	u32 i;
 	struct netlist_aiv_list *sw_ctx_load =
 				nvgpu_netlist_get_sw_ctx_load_aiv_list(g);
 
@@ -506,23 +542,7 @@ static int nvgpu_gr_obj_ctx_init_hw_state(struct gk20a *g,
 
 	/* load ctx init */
 	nvgpu_log_info(g, "begin: netlist: sw_ctx_load: register writes");
-	for (i = 0U; i < sw_ctx_load->count; i++) {
-#ifdef CONFIG_NVGPU_MIG
-		if ((nvgpu_is_enabled(g, NVGPU_SUPPORT_MIG)) &&
-				(g->ops.gr.init.is_allowed_reg != NULL) &&
-				(!(g->ops.gr.init.is_allowed_reg(g,
-					sw_ctx_load->l[i].addr)))) {
-			nvgpu_log(g, gpu_dbg_mig | gpu_dbg_gr,
-				"(MIG) Skip graphics ctx load reg "
-					"index[%u] addr[%x] value[%x] ",
-				i, sw_ctx_load->l[i].addr,
-				sw_ctx_load->l[i].value);
-			continue;
-		}
-#endif
-		nvgpu_writel(g, sw_ctx_load->l[i].addr,
-			     sw_ctx_load->l[i].value);
-	}
+	nvgpu_gr_obj_ctx_load_sw_ctx(g, sw_ctx_load);
 	nvgpu_log_info(g, "end: netlist: sw_ctx_load: register writes");
 
 	nvgpu_log_info(g, "configure sm_hww_esr_report mask after sw_ctx_load");
@@ -964,6 +984,25 @@ bool nvgpu_gr_obj_ctx_is_golden_image_ready(
 	return ready;
 }
 
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+int nvgpu_gr_obj_ctx_verify_golden_image(struct gk20a *g,
+	struct nvgpu_gr_obj_ctx_golden_image *golden_image)
+{
+	int err = 0;
+
+	nvgpu_mutex_acquire(&golden_image->ctx_mutex);
+	if (golden_image->ready &&
+	    !nvgpu_gr_global_ctx_verify_local_golden_image(g,
+			golden_image->local_golden_image)) {
+		nvgpu_err(g, "golden context image corrupted");
+		err = -EINVAL;
+	}
+	nvgpu_mutex_release(&golden_image->ctx_mutex);
+
+	return err;
+}
+#endif
+
 int nvgpu_gr_obj_ctx_init(struct gk20a *g,
 	struct nvgpu_gr_obj_ctx_golden_image **gr_golden_image, u32 size)
 {
@@ -24,6 +24,7 @@
 #include <nvgpu/io.h>
 #include <nvgpu/bug.h>
 #include <nvgpu/string.h>
+#include <nvgpu/utils.h>
 #include <nvgpu/power_features/pg.h>
 #ifdef CONFIG_NVGPU_LS_PMU
 #include <nvgpu/pmu/pmu_pg.h>
@@ -34,6 +35,73 @@
 #define ZBC_ENTRY_UPDATED	1
 #define ZBC_ENTRY_ADDED		2
 
+/* 2^32 / golden ratio, spreads the low bits of the words over the hash */
+#define ZBC_HASH_MULT		0x9E3779B1ULL
+
+static u32 gr_zbc_hash_word(u32 hash, u32 word)
+{
+	u64 prod = (u64)(hash ^ word) * ZBC_HASH_MULT;
+
+	return u64_lo32(prod) ^ u64_hi32(prod);
+}
+
+static u32 gr_zbc_hash_value(u32 format, u32 value)
+{
+	return gr_zbc_hash_word(gr_zbc_hash_word(0U, format), value);
+}
+
+static u32 gr_zbc_hash_color(u32 format, const u32 *color_ds,
+			const u32 *color_l2)
+{
+	u32 hash = gr_zbc_hash_word(0U, format);
+	u32 i;
+
+	for (i = 0U; i < NVGPU_GR_ZBC_COLOR_VALUE_SIZE; i++) {
+		hash = gr_zbc_hash_word(hash, color_ds[i]);
+		hash = gr_zbc_hash_word(hash, color_l2[i]);
+	}
+
+	return hash;
+}
+
+/*
+ * Entries are only ever added to the tables, so each hash chain is a
+ * singly linked list of table indices with new entries pushed at the head.
+ */
+static void gr_zbc_hash_link_color(struct nvgpu_gr_zbc *zbc, u32 index)
+{
+	struct zbc_color_table *c_tbl = &zbc->zbc_col_tbl[index];
+	u32 bucket;
+
+	c_tbl->hash = gr_zbc_hash_color(c_tbl->format, c_tbl->color_ds,
+			c_tbl->color_l2);
+	bucket = c_tbl->hash & GR_ZBC_HASH_MASK;
+	c_tbl->next = zbc->col_hash[bucket];
+	zbc->col_hash[bucket] = index;
+}
+
+static void gr_zbc_hash_link_depth(struct nvgpu_gr_zbc *zbc, u32 index)
+{
+	struct zbc_depth_table *d_tbl = &zbc->zbc_dep_tbl[index];
+	u32 bucket;
+
+	d_tbl->hash = gr_zbc_hash_value(d_tbl->format, d_tbl->depth);
+	bucket = d_tbl->hash & GR_ZBC_HASH_MASK;
+	d_tbl->next = zbc->dep_hash[bucket];
+	zbc->dep_hash[bucket] = index;
+}
+
+static void gr_zbc_hash_link_stencil(struct nvgpu_gr_zbc *zbc, u32 index)
+{
+	struct zbc_stencil_table *s_tbl = &zbc->zbc_s_tbl[index];
+	u32 bucket;
+
+	s_tbl->hash = gr_zbc_hash_value(s_tbl->format, s_tbl->stencil);
+	bucket = s_tbl->hash & GR_ZBC_HASH_MASK;
+	s_tbl->next = zbc->s_hash[bucket];
+	zbc->s_hash[bucket] = index;
+}
+
 static void nvgpu_gr_zbc_update_stencil_reg(struct gk20a *g,
 			     struct nvgpu_gr_zbc_entry *stencil_val, u32 index)
 {
@@ -50,17 +118,18 @@ static int nvgpu_gr_zbc_add_stencil(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 			struct nvgpu_gr_zbc_entry *stencil_val)
 {
 	struct zbc_stencil_table *s_tbl;
+	u32 hash = gr_zbc_hash_value(stencil_val->format, stencil_val->stencil);
 	u32 i;
 	int entry_added = -ENOSPC;
 	bool entry_exist = false;
 
 	/* search existing tables */
-	for (i = zbc->min_stencil_index; i <= zbc->max_used_stencil_index;
-		i++) {
+	for (i = zbc->s_hash[hash & GR_ZBC_HASH_MASK];
+		i != GR_ZBC_HASH_NONE; i = s_tbl->next) {
 
 		s_tbl = &zbc->zbc_s_tbl[i];
 
-		if ((s_tbl->ref_cnt != 0U) &&
+		if ((s_tbl->hash == hash) &&
 		    (s_tbl->stencil == stencil_val->stencil) &&
 		    (s_tbl->format == stencil_val->format)) {
 			s_tbl->ref_cnt = nvgpu_safe_add_u32(s_tbl->ref_cnt, 1U);
@@ -84,6 +153,7 @@ static int nvgpu_gr_zbc_add_stencil(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 		s_tbl->stencil = stencil_val->stencil;
 		s_tbl->format = stencil_val->format;
 		s_tbl->ref_cnt = nvgpu_safe_add_u32(s_tbl->ref_cnt, 1U);
+		gr_zbc_hash_link_stencil(zbc, zbc->max_used_stencil_index);
 
 		nvgpu_gr_zbc_update_stencil_reg(g, stencil_val,
 			zbc->max_used_stencil_index);
@@ -107,16 +177,18 @@ static int nvgpu_gr_zbc_add_depth(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 			struct nvgpu_gr_zbc_entry *depth_val)
 {
 	struct zbc_depth_table *d_tbl;
+	u32 hash = gr_zbc_hash_value(depth_val->format, depth_val->depth);
 	u32 i;
 	int entry_added = -ENOSPC;
 	bool entry_exist = false;
 
 	/* search existing tables */
-	for (i = zbc->min_depth_index; i <= zbc->max_used_depth_index; i++) {
+	for (i = zbc->dep_hash[hash & GR_ZBC_HASH_MASK];
+		i != GR_ZBC_HASH_NONE; i = d_tbl->next) {
 
 		d_tbl = &zbc->zbc_dep_tbl[i];
 
-		if ((d_tbl->ref_cnt != 0U) &&
+		if ((d_tbl->hash == hash) &&
 		    (d_tbl->depth == depth_val->depth) &&
 		    (d_tbl->format == depth_val->format)) {
 			d_tbl->ref_cnt = nvgpu_safe_add_u32(d_tbl->ref_cnt, 1U);
@@ -140,6 +212,7 @@ static int nvgpu_gr_zbc_add_depth(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 		d_tbl->depth = depth_val->depth;
 		d_tbl->format = depth_val->format;
 		d_tbl->ref_cnt = nvgpu_safe_add_u32(d_tbl->ref_cnt, 1U);
+		gr_zbc_hash_link_depth(zbc, zbc->max_used_depth_index);
 
 		nvgpu_gr_zbc_update_depth_reg(g, depth_val,
 			zbc->max_used_depth_index);
@@ -164,16 +237,19 @@ static int nvgpu_gr_zbc_add_color(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 			struct nvgpu_gr_zbc_entry *color_val)
 {
 	struct zbc_color_table *c_tbl;
+	u32 hash = gr_zbc_hash_color(color_val->format, color_val->color_ds,
+			color_val->color_l2);
 	u32 i;
 	int entry_added = -ENOSPC;
 	bool entry_exist = false;
 
-	/* search existing table */
-	for (i = zbc->min_color_index; i <= zbc->max_used_color_index; i++) {
+	/* search existing table, full compare only on a hash match */
+	for (i = zbc->col_hash[hash & GR_ZBC_HASH_MASK];
+		i != GR_ZBC_HASH_NONE; i = c_tbl->next) {
 
 		c_tbl = &zbc->zbc_col_tbl[i];
 
-		if ((c_tbl->ref_cnt != 0U) &&
+		if ((c_tbl->hash == hash) &&
 			(c_tbl->format == color_val->format) &&
 			(nvgpu_memcmp((u8 *)c_tbl->color_ds,
 				(u8 *)color_val->color_ds,
@@ -207,6 +283,7 @@ static int nvgpu_gr_zbc_add_color(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 		}
 		c_tbl->format = color_val->format;
 		c_tbl->ref_cnt = nvgpu_safe_add_u32(c_tbl->ref_cnt, 1U);
+		gr_zbc_hash_link_color(zbc, zbc->max_used_color_index);
 
 		nvgpu_gr_zbc_update_color_reg(g, color_val,
 			zbc->max_used_color_index);
@@ -217,16 +294,12 @@ static int nvgpu_gr_zbc_add_color(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 	return entry_added;
 }
 
-static int nvgpu_gr_zbc_add(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
+static int nvgpu_gr_zbc_add_locked(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 			    struct nvgpu_gr_zbc_entry *zbc_val)
 {
-	int added = false;
-#if defined(CONFIG_NVGPU_LS_PMU) && defined(CONFIG_NVGPU_POWER_PG)
-	u32 entries;
-#endif
+	int added;
 
 	/* no endian swap ? */
-	nvgpu_mutex_acquire(&zbc->zbc_lock);
 	nvgpu_speculation_barrier();
 	switch (zbc_val->type) {
 	case NVGPU_GR_ZBC_TYPE_COLOR:
@@ -242,32 +315,62 @@ static int nvgpu_gr_zbc_add(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 			nvgpu_err(g,
 			"invalid zbc table type %d", zbc_val->type);
 			added = -EINVAL;
-			goto err_mutex;
 		}
 		break;
 	default:
 		nvgpu_err(g,
 			"invalid zbc table type %d", zbc_val->type);
 		added = -EINVAL;
-		goto err_mutex;
+		break;
 	}
 
+	return added;
+}
+
+static void nvgpu_gr_zbc_save(struct gk20a *g, struct nvgpu_gr_zbc *zbc)
+{
+	zbc->table_saves = nvgpu_safe_add_u32(zbc->table_saves, 1U);
 #if defined(CONFIG_NVGPU_LS_PMU) && defined(CONFIG_NVGPU_POWER_PG)
-	if (added == ZBC_ENTRY_ADDED) {
-		/* update zbc for elpg only when new entry is added */
-		entries = max(
-			nvgpu_safe_sub_u32(zbc->max_used_color_index,
-				zbc->min_color_index),
-			nvgpu_safe_sub_u32(zbc->max_used_depth_index,
-				zbc->min_depth_index));
-		if (g->elpg_enabled) {
-			nvgpu_pmu_save_zbc(g, entries);
-		}
+	u32 entries;
+
+	/* update zbc for elpg only when new entry is added */
+	entries = max(
+		nvgpu_safe_sub_u32(zbc->max_used_color_index,
+			zbc->min_color_index),
+		nvgpu_safe_sub_u32(zbc->max_used_depth_index,
+			zbc->min_depth_index));
+	if (g->elpg_enabled) {
+		nvgpu_pmu_save_zbc(g, entries);
 	}
+#else
+	(void)g;
 #endif
+}
+
+static int nvgpu_gr_zbc_add(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
+			    struct nvgpu_gr_zbc_entry **zbc_vals, u32 count)
+{
+	int added = 0;
+	bool save = false;
+	u32 i;
+
+	nvgpu_mutex_acquire(&zbc->zbc_lock);
+	for (i = 0U; i < count; i++) {
+		added = nvgpu_gr_zbc_add_locked(g, zbc, zbc_vals[i]);
+		if (added == ZBC_ENTRY_ADDED) {
+			save = true;
+		}
+		if (added < 0) {
+			break;
+		}
+	}
 
-err_mutex:
+	/* one save for all entries added by the batch */
+	if (save) {
+		nvgpu_gr_zbc_save(g, zbc);
+	}
 	nvgpu_mutex_release(&zbc->zbc_lock);
+
 	if (added < 0) {
 		return added;
 	}
@@ -279,8 +382,20 @@ int nvgpu_gr_zbc_set_table(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
 {
 	nvgpu_log(g, gpu_dbg_zbc, " zbc_val->type %u", zbc_val->type);
 
+	return nvgpu_gr_zbc_set_table_batch(g, zbc, &zbc_val, 1U);
+}
+
+int nvgpu_gr_zbc_set_table_batch(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
+			   struct nvgpu_gr_zbc_entry **zbc_vals, u32 count)
+{
+	nvgpu_log(g, gpu_dbg_zbc, " count %u", count);
+
+	if (count == 0U) {
+		return 0;
+	}
+
 	return nvgpu_pg_elpg_protected_call(g,
-		nvgpu_gr_zbc_add(g, zbc, zbc_val));
+		nvgpu_gr_zbc_add(g, zbc, zbc_vals, count));
 }
 
 /* get a zbc table entry specified by index
@@ -523,6 +638,40 @@ static void nvgpu_gr_zbc_init_indices(struct gk20a *g, struct nvgpu_gr_zbc *zbc)
 		zbc->max_stencil_index);
 }
 
+static void nvgpu_gr_zbc_init_hash(struct gk20a *g, struct nvgpu_gr_zbc *zbc)
+{
+	u32 i;
+
+	for (i = 0U; i < GR_ZBC_HASH_BUCKETS; i++) {
+		zbc->col_hash[i] = GR_ZBC_HASH_NONE;
+		zbc->dep_hash[i] = GR_ZBC_HASH_NONE;
+		zbc->s_hash[i] = GR_ZBC_HASH_NONE;
+	}
+
+	for (i = zbc->min_color_index; i <= zbc->max_used_color_index; i++) {
+		if (zbc->zbc_col_tbl[i].ref_cnt != 0U) {
+			gr_zbc_hash_link_color(zbc, i);
+		}
+	}
+
+	for (i = zbc->min_depth_index; i <= zbc->max_used_depth_index; i++) {
+		if (zbc->zbc_dep_tbl[i].ref_cnt != 0U) {
+			gr_zbc_hash_link_depth(zbc, i);
+		}
+	}
+
+	if (!nvgpu_is_enabled(g, NVGPU_SUPPORT_ZBC_STENCIL)) {
+		return;
+	}
+
+	for (i = zbc->min_stencil_index; i <= zbc->max_used_stencil_index;
+		i++) {
+		if (zbc->zbc_s_tbl[i].ref_cnt != 0U) {
+			gr_zbc_hash_link_stencil(zbc, i);
+		}
+	}
+}
+
 static void nvgpu_gr_zbc_load_default_sw_table(struct gk20a *g,
 					struct nvgpu_gr_zbc *zbc)
 {
@@ -535,6 +684,8 @@ static void nvgpu_gr_zbc_load_default_sw_table(struct gk20a *g,
 	if (nvgpu_is_enabled(g, NVGPU_SUPPORT_ZBC_STENCIL)) {
 		nvgpu_gr_zbc_load_default_sw_stencil_table(g, zbc);
 	}
+
+	nvgpu_gr_zbc_init_hash(g, zbc);
 }
 
 static int gr_zbc_allocate_local_tbls(struct gk20a *g, struct nvgpu_gr_zbc *zbc)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -37,23 +37,35 @@
 #define GR_ZBC_STENCIL_CLEAR_FMT_INVAILD	0U
 #define GR_ZBC_STENCIL_CLEAR_FMT_U8		1U
 
+/* Number of hash buckets of each table type, must be a power of 2 */
+#define GR_ZBC_HASH_BUCKETS		32U
+#define GR_ZBC_HASH_MASK		(GR_ZBC_HASH_BUCKETS - 1U)
+/* Terminates a hash chain */
+#define GR_ZBC_HASH_NONE		U32_MAX
+
 struct zbc_color_table {
 	u32 color_ds[NVGPU_GR_ZBC_COLOR_VALUE_SIZE];
 	u32 color_l2[NVGPU_GR_ZBC_COLOR_VALUE_SIZE];
 	u32 format;
-	u32 ref_cnt;
+	u32 ref_cnt;	/* Number of users of the entry */
+	u32 hash;	/* Hash of (format, value) */
+	u32 next;	/* Next index in the hash chain */
 };
 
 struct zbc_depth_table {
 	u32 depth;
 	u32 format;
-	u32 ref_cnt;
+	u32 ref_cnt;	/* Number of users of the entry */
+	u32 hash;	/* Hash of (format, value) */
+	u32 next;	/* Next index in the hash chain */
 };
 
 struct zbc_stencil_table {
 	u32 stencil;
 	u32 format;
-	u32 ref_cnt;
+	u32 ref_cnt;	/* Number of users of the entry */
+	u32 hash;	/* Hash of (format, value) */
+	u32 next;	/* Next index in the hash chain */
 };
 
 struct nvgpu_gr_zbc_entry {
@@ -83,6 +95,10 @@ struct nvgpu_gr_zbc {
 	u32 max_used_color_index; /* Max used color table index */
 	u32 max_used_depth_index; /* Max used depth table index */
 	u32 max_used_stencil_index; /* Max used stencil table index */
+	u32 col_hash[GR_ZBC_HASH_BUCKETS]; /* Color hash chain heads */
+	u32 dep_hash[GR_ZBC_HASH_BUCKETS]; /* Depth hash chain heads */
+	u32 s_hash[GR_ZBC_HASH_BUCKETS]; /* Stencil hash chain heads */
+	u32 table_saves;	/* Saves of the table, one per batch adding entries */
 };
 
 #endif /* NVGPU_GR_ZBC_PRIV_H */
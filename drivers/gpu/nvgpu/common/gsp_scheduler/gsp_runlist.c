@@ -82,41 +82,64 @@ static void gsp_get_runlist_info(struct gk20a *g,
 	rl_info->runlist_id = runlist->id;
 }
 
-int nvgpu_gsp_runlist_submit(struct gk20a *g, struct nvgpu_runlist *runlist)
+int nvgpu_gsp_runlists_submit(struct gk20a *g,
+	struct nvgpu_runlist **runlists, u32 count)
 {
-	struct nv_flcn_cmd_gsp cmd;
-	bool command_ack = false;
+	struct nv_flcn_cmd_gsp cmd[GSP_CMD_BATCH_MAX];
+	struct nv_flcn_cmd_gsp *cmds[GSP_CMD_BATCH_MAX];
+	bool command_ack[GSP_CMD_BATCH_MAX];
+	void *cb_params[GSP_CMD_BATCH_MAX];
 	int err = 0;
 	size_t tmp_size;
+	u32 i;
 
 	nvgpu_log_fn(g, " ");
 
-	(void) memset(&cmd, 0, sizeof(struct nv_flcn_cmd_gsp));
-	cmd.hdr.unit_id = NV_GSP_UNIT_SUBMIT_RUNLIST;
+	if ((count == 0U) || (count > GSP_CMD_BATCH_MAX)) {
+		return -EINVAL;
+	}
+
 	tmp_size = GSP_CMD_HDR_SIZE + sizeof(struct nvgpu_gsp_runlist_info);
 	nvgpu_assert(tmp_size <= U64(U8_MAX));
-	cmd.hdr.size = (u8)tmp_size;
 
-	/* copy domain info into cmd buffer */
-	gsp_get_runlist_info(g, &cmd.cmd.runlist, runlist);
+	for (i = 0U; i < count; i++) {
+		(void) memset(&cmd[i], 0, sizeof(struct nv_flcn_cmd_gsp));
+		cmd[i].hdr.unit_id = NV_GSP_UNIT_SUBMIT_RUNLIST;
+		cmd[i].hdr.size = (u8)tmp_size;
 
-	err = nvgpu_gsp_cmd_post(g, &cmd, GSP_NV_CMDQ_LOG_ID,
-			gsp_handle_cmd_ack, &command_ack, U32_MAX);
+		/* copy domain info into cmd buffer */
+		gsp_get_runlist_info(g, &cmd[i].cmd.runlist, runlists[i]);
+
+		cmds[i] = &cmd[i];
+		command_ack[i] = false;
+		cb_params[i] = &command_ack[i];
+	}
+
+	err = nvgpu_gsp_cmd_post_batch(g, cmds, count, GSP_NV_CMDQ_LOG_ID,
+			gsp_handle_cmd_ack, cb_params, U32_MAX);
 	if (err != 0) {
 		nvgpu_err(g, "command post failed");
 		goto exit;
 	}
 
-	err = nvgpu_gsp_wait_message_cond(g, nvgpu_get_poll_timeout(g),
-			&command_ack, U8(true));
-	if (err != 0) {
-		nvgpu_err(g, "command ack receive failed");
+	for (i = 0U; i < count; i++) {
+		err = nvgpu_gsp_wait_message_cond(g, nvgpu_get_poll_timeout(g),
+				&command_ack[i], U8(true));
+		if (err != 0) {
+			nvgpu_err(g, "command ack receive failed");
+			break;
+		}
 	}
 
 exit:
 	return err;
 }
 
+int nvgpu_gsp_runlist_submit(struct gk20a *g, struct nvgpu_runlist *runlist)
+{
+	return nvgpu_gsp_runlists_submit(g, &runlist, 1U);
+}
+
 static void gsp_get_device_info(struct gk20a *g,
 		struct nvgpu_gsp_device_info *dev_info)
 {
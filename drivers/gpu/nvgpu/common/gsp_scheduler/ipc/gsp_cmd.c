@@ -24,6 +24,7 @@
 #include <nvgpu/pmu.h>
 #include <nvgpu/log.h>
 #include <nvgpu/gsp.h>
+#include <nvgpu/engine_queue.h>
 
 #include "../gsp_scheduler.h"
 #include "gsp_seq.h"
@@ -69,8 +70,8 @@ invalid_cmd:
 	return false;
 }
 
-static int gsp_write_cmd(struct nvgpu_gsp_sched *gsp_sched,
-	struct nv_flcn_cmd_gsp *cmd, u32 queue_id,
+static int gsp_write_cmds(struct nvgpu_gsp_sched *gsp_sched,
+	struct nv_flcn_cmd_gsp **cmds, u32 count, u32 queue_id,
 	u32 timeout_ms)
 {
 	struct nvgpu_timeout timeout;
@@ -83,8 +84,8 @@ static int gsp_write_cmd(struct nvgpu_gsp_sched *gsp_sched,
 	nvgpu_timeout_init_cpu_timer(g, &timeout, timeout_ms);
 
 	do {
-		err = nvgpu_gsp_queue_push(gsp_sched->queues, queue_id, gsp->gsp_flcn,
-					    cmd, cmd->hdr.size);
+		err = nvgpu_gsp_queue_push_batch(gsp_sched->queues, queue_id,
+					gsp->gsp_flcn, cmds, count);
 		if ((err == -EAGAIN) &&
 		    (nvgpu_timeout_expired(&timeout) == 0)) {
 			nvgpu_usleep_range(1000U, 2000U);
@@ -94,56 +95,104 @@ static int gsp_write_cmd(struct nvgpu_gsp_sched *gsp_sched,
 	} while (true);
 
 	if (err != 0) {
-		nvgpu_err(g, "fail to write cmd to queue %d", queue_id);
+		nvgpu_err(g, "fail to write %u cmds to queue %d", count,
+			queue_id);
 	}
 
 	return err;
 }
 
-int nvgpu_gsp_cmd_post(struct gk20a *g, struct nv_flcn_cmd_gsp *cmd,
-	u32 queue_id, gsp_callback callback,
-	void *cb_param, u32 timeout)
+static void gsp_release_seqs(struct gk20a *g,
+	struct gsp_sequences *sequences, struct gsp_sequence **seqs, u32 count)
+{
+	u32 i;
+
+	for (i = 0U; i < count; i++) {
+		/* never reached the GSP, not a completed sequence */
+		nvgpu_gsp_seq_set_state(seqs[i], GSP_SEQ_STATE_PENDING);
+		gsp_seq_release(g, sequences, seqs[i]);
+	}
+}
+
+int nvgpu_gsp_cmd_post_batch(struct gk20a *g, struct nv_flcn_cmd_gsp **cmds,
+	u32 count, u32 queue_id, gsp_callback callback,
+	void **cb_params, u32 timeout)
 {
 	struct nvgpu_gsp_sched *gsp_sched = g->gsp_sched;
-	struct gsp_sequence *seq = NULL;
+	struct gsp_sequence *seqs[GSP_CMD_BATCH_MAX];
+	u32 total = 0U;
+	u32 i;
 	int err = 0;
 
-	if (cmd == NULL) {
-		nvgpu_err(g, "gsp cmd buffer is empty");
+	if ((cmds == NULL) || (count == 0U) ||
+	    (count > GSP_CMD_BATCH_MAX)) {
+		nvgpu_err(g, "invalid gsp cmd batch of %u", count);
 		err = -EINVAL;
 		goto exit;
 	}
 
-	/* Sanity check the command input. */
-	if (!gsp_validate_cmd(gsp_sched, cmd, queue_id)) {
-		err = -EINVAL;
-		goto exit;
+	for (i = 0U; i < count; i++) {
+		if (cmds[i] == NULL) {
+			nvgpu_err(g, "gsp cmd buffer is empty");
+			err = -EINVAL;
+			goto exit;
+		}
+
+		/* Sanity check the command input. */
+		if (!gsp_validate_cmd(gsp_sched, cmds[i], queue_id)) {
+			err = -EINVAL;
+			goto exit;
+		}
+
+		total = nvgpu_safe_add_u32(total,
+				NVGPU_ALIGN(U32(cmds[i]->hdr.size),
+					QUEUE_ALIGNMENT));
 	}
 
-	/* Attempt to reserve a sequence for this command. */
-	err = nvgpu_gsp_seq_acquire(g, gsp_sched->sequences, &seq,
-			callback, cb_param);
-	if (err != 0) {
+	/* The batch is written in one piece, same limit as a single cmd. */
+	if (total > (nvgpu_gsp_queue_get_size(gsp_sched->queues,
+			queue_id) >> 1)) {
+		nvgpu_err(g, "gsp cmd batch too large: %u bytes", total);
+		err = -EINVAL;
 		goto exit;
 	}
 
-	/* Set the sequence number in the command header. */
-	cmd->hdr.seq_id = nvgpu_gsp_seq_get_id(seq);
+	for (i = 0U; i < count; i++) {
+		/* Attempt to reserve a sequence for this command. */
+		err = nvgpu_gsp_seq_acquire(g, gsp_sched->sequences, &seqs[i],
+				cmds[i]->hdr.unit_id, callback,
+				(cb_params != NULL) ? cb_params[i] : NULL);
+		if (err != 0) {
+			gsp_release_seqs(g, gsp_sched->sequences, seqs, i);
+			goto exit;
+		}
+
+		/* Set the sequence number in the command header. */
+		cmds[i]->hdr.seq_id = nvgpu_gsp_seq_get_id(seqs[i]);
 
-	cmd->hdr.ctrl_flags = 0U;
-	cmd->hdr.ctrl_flags = PMU_CMD_FLAGS_STATUS;
+		cmds[i]->hdr.ctrl_flags = 0U;
+		cmds[i]->hdr.ctrl_flags = PMU_CMD_FLAGS_STATUS;
 
-	nvgpu_gsp_seq_set_state(seq, GSP_SEQ_STATE_USED);
+		nvgpu_gsp_seq_set_state(seqs[i], GSP_SEQ_STATE_USED);
+	}
 
-	err = gsp_write_cmd(gsp_sched, cmd, queue_id, timeout);
+	err = gsp_write_cmds(gsp_sched, cmds, count, queue_id, timeout);
 	if (err != 0) {
-		gsp_seq_release(gsp_sched->sequences, seq);
+		gsp_release_seqs(g, gsp_sched->sequences, seqs, count);
 	}
 
 exit:
 	return err;
 }
 
+int nvgpu_gsp_cmd_post(struct gk20a *g, struct nv_flcn_cmd_gsp *cmd,
+	u32 queue_id, gsp_callback callback,
+	void *cb_param, u32 timeout)
+{
+	return nvgpu_gsp_cmd_post_batch(g, &cmd, 1U, queue_id, callback,
+			&cb_param, timeout);
+}
+
 u32 nvgpu_gsp_get_last_cmd_id(struct gk20a *g)
 {
 	(void)g;
@@ -40,6 +40,9 @@ struct gk20a;
 #define  NV_GSP_UNIT_SUBMIT_RUNLIST	0x04U
 #define  NV_GSP_UNIT_END		0x0AU
 
+/* Maximum number of commands posted at once by nvgpu_gsp_cmd_post_batch() */
+#define GSP_CMD_BATCH_MAX	16U
+
 #define GSP_MSG_HDR_SIZE	U32(sizeof(struct gsp_hdr))
 #define GSP_CMD_HDR_SIZE	U32(sizeof(struct gsp_hdr))
 
@@ -62,5 +65,13 @@ u8 gsp_unit_id_is_valid(u8 id);
 /* command handling methods*/
 int nvgpu_gsp_cmd_post(struct gk20a *g, struct nv_flcn_cmd_gsp *cmd,
 	u32 queue_id, gsp_callback callback, void *cb_param, u32 timeout);
+/*
+ * Post up to GSP_CMD_BATCH_MAX commands with a single queue reservation and
+ * head update. cb_params, if not NULL, holds one callback parameter per
+ * command. Either all commands are posted or none.
+ */
+int nvgpu_gsp_cmd_post_batch(struct gk20a *g, struct nv_flcn_cmd_gsp **cmds,
+	u32 count, u32 queue_id, gsp_callback callback,
+	void **cb_params, u32 timeout);
 
 #endif /* NVGPU_GSP_CMD_IF_H */
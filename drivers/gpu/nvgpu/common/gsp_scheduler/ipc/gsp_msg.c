@@ -181,6 +181,10 @@ int nvgpu_gsp_process_message(struct gk20a *g)
 		goto exit;
 	}
 
+	/*
+	 * Drain everything the GSP has posted so far. Responses to a batch of
+	 * commands are handled in one pass instead of one interrupt each.
+	 */
 	do {
 		read_msg = gsp_read_message(gsp_sched,
 				GSP_NV_MSGQ_LOG_ID, &msg, &status);
@@ -188,10 +192,9 @@ int nvgpu_gsp_process_message(struct gk20a *g)
 			break;
 		}
 
-		nvgpu_info(g, "read msg hdr: ");
-		nvgpu_info(g, "unit_id = 0x%08x, size = 0x%08x",
-			msg.hdr.unit_id, msg.hdr.size);
-		nvgpu_info(g, "ctrl_flags = 0x%08x, seq_id = 0x%08x",
+		nvgpu_log_info(g, "read msg hdr: unit_id = 0x%08x, "
+			"size = 0x%08x", msg.hdr.unit_id, msg.hdr.size);
+		nvgpu_log_info(g, "ctrl_flags = 0x%08x, seq_id = 0x%08x",
 			msg.hdr.ctrl_flags, msg.hdr.seq_id);
 
 		msg.hdr.ctrl_flags &= (u8)~GSP_CMD_FLAGS_MASK;
@@ -201,13 +204,14 @@ int nvgpu_gsp_process_message(struct gk20a *g)
 		} else {
 			gsp_response_handle(gsp_sched, &msg);
 		}
-
-		if (!nvgpu_gsp_queue_is_empty(gsp_sched->queues,
-				GSP_NV_MSGQ_LOG_ID)) {
-			g->ops.gsp.set_msg_intr(g);
-		}
 	} while (read_msg);
 
+	/* A read failed with messages left: retry them on a new interrupt. */
+	if ((status != 0) && !nvgpu_gsp_queue_is_empty(gsp_sched->queues,
+			GSP_NV_MSGQ_LOG_ID)) {
+		g->ops.gsp.set_msg_intr(g);
+	}
+
 exit:
 	return status;
 }
@@ -147,6 +147,29 @@ int nvgpu_gsp_queue_push(struct nvgpu_engine_mem_queue **queues,
 	return nvgpu_engine_mem_queue_push(flcn, queue, cmd, size);
 }
 
+int nvgpu_gsp_queue_push_batch(struct nvgpu_engine_mem_queue **queues,
+			u32 queue_id, struct nvgpu_falcon *flcn,
+			struct nv_flcn_cmd_gsp **cmds, u32 count)
+{
+	struct nvgpu_engine_mem_queue *queue;
+	void *data[GSP_CMD_BATCH_MAX];
+	u32 size[GSP_CMD_BATCH_MAX];
+	u32 i;
+
+	if (count > GSP_CMD_BATCH_MAX) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < count; i++) {
+		data[i] = cmds[i];
+		size[i] = cmds[i]->hdr.size;
+	}
+
+	queue = queues[queue_id];
+	return nvgpu_engine_mem_queue_push_batch(flcn, queue, data, size,
+			count);
+}
+
 bool nvgpu_gsp_queue_is_empty(struct nvgpu_engine_mem_queue **queues,
 			u32 queue_id)
 {
@@ -41,6 +41,9 @@ u32 nvgpu_gsp_queue_get_size(struct nvgpu_engine_mem_queue **queues,
 int nvgpu_gsp_queue_push(struct nvgpu_engine_mem_queue **queues,
 			  u32 queue_id, struct nvgpu_falcon *flcn,
 			  struct nv_flcn_cmd_gsp *cmd, u32 size);
+int nvgpu_gsp_queue_push_batch(struct nvgpu_engine_mem_queue **queues,
+			  u32 queue_id, struct nvgpu_falcon *flcn,
+			  struct nv_flcn_cmd_gsp **cmds, u32 count);
 bool nvgpu_gsp_queue_is_empty(struct nvgpu_engine_mem_queue **queues,
 			       u32 queue_id);
 bool nvgpu_gsp_queue_read(struct gk20a *g,
@@ -39,8 +39,7 @@ static void gsp_sequences_init(struct gk20a *g,
 	(void) memset(sequences->seq, 0,
 		sizeof(*sequences->seq) * GSP_MAX_NUM_SEQUENCES);
 
-	(void) memset(sequences->gsp_seq_tbl, 0,
-		sizeof(sequences->gsp_seq_tbl));
+	nvgpu_falcon_seq_alloc_init(&sequences->ids, GSP_MAX_NUM_SEQUENCES);
 
 	for (i = 0; i < GSP_MAX_NUM_SEQUENCES; i++) {
 		sequences->seq[i].id = (u8)i;
@@ -54,7 +53,7 @@ int nvgpu_gsp_sequences_init(struct gk20a *g, struct nvgpu_gsp_sched *gsp_sched)
 
 	nvgpu_log_fn(g, " ");
 
-	seqs = (struct gsp_sequences *) nvgpu_kzalloc(g, sizeof(*seqs->seq));
+	seqs = (struct gsp_sequences *) nvgpu_big_zalloc(g, sizeof(*seqs));
 	if (seqs == NULL) {
 		nvgpu_err(g, "GSP sequences allocation failed");
 		return -ENOMEM;
@@ -64,15 +63,13 @@ int nvgpu_gsp_sequences_init(struct gk20a *g, struct nvgpu_gsp_sched *gsp_sched)
 			GSP_MAX_NUM_SEQUENCES * sizeof(*seqs->seq));
 	if (seqs->seq == NULL) {
 		nvgpu_err(g, "GSP sequence allocation failed");
-		nvgpu_kfree(g, seqs);
+		nvgpu_big_free(g, seqs);
 		return -ENOMEM;
 	}
 
 	gsp_sched->sequences = seqs;
 	gsp_sched->sequences->seq = seqs->seq;
 
-	nvgpu_mutex_init(&seqs->gsp_seq_lock);
-
 	gsp_sequences_init(g, seqs);
 
 	return err;
@@ -81,14 +78,13 @@ int nvgpu_gsp_sequences_init(struct gk20a *g, struct nvgpu_gsp_sched *gsp_sched)
 void nvgpu_gsp_sequences_free(struct gk20a *g,
 			struct gsp_sequences *sequences)
 {
-	nvgpu_mutex_destroy(&sequences->gsp_seq_lock);
 	nvgpu_kfree(g, sequences->seq);
-	nvgpu_kfree(g, sequences);
+	nvgpu_big_free(g, sequences);
 }
 
 int nvgpu_gsp_seq_acquire(struct gk20a *g,
 			struct gsp_sequences *sequences,
-			struct gsp_sequence **pseq,
+			struct gsp_sequence **pseq, u8 unit_id,
 			gsp_callback callback, void *cb_params)
 {
 	struct gsp_sequence *seq;
@@ -97,23 +93,12 @@ int nvgpu_gsp_seq_acquire(struct gk20a *g,
 
 	nvgpu_log_fn(g, " ");
 
-	nvgpu_mutex_acquire(&sequences->gsp_seq_lock);
-
-	index = (u32)find_first_zero_bit(sequences->gsp_seq_tbl,
-			GSP_MAX_NUM_SEQUENCES);
-
-	if (index >= GSP_MAX_NUM_SEQUENCES) {
+	err = nvgpu_falcon_seq_acquire(&sequences->ids, unit_id, &index);
+	if (err != 0) {
 		nvgpu_err(g, "no free sequence available");
-		nvgpu_mutex_release(&sequences->gsp_seq_lock);
-		err = -EAGAIN;
 		goto exit;
 	}
 
-	nvgpu_assert(index < U64(INT_MAX));
-	nvgpu_set_bit(index, sequences->gsp_seq_tbl);
-
-	nvgpu_mutex_release(&sequences->gsp_seq_lock);
-
 	seq = &sequences->seq[index];
 
 	seq->state = GSP_SEQ_STATE_PENDING;
@@ -127,17 +112,23 @@ exit:
 	return err;
 }
 
-void gsp_seq_release(struct gsp_sequences *sequences,
+void gsp_seq_release(struct gk20a *g, struct gsp_sequences *sequences,
 			struct gsp_sequence *seq)
 {
+	bool completed = (seq->state == GSP_SEQ_STATE_USED);
+
 	seq->state	= GSP_SEQ_STATE_FREE;
 	seq->callback	= NULL;
 	seq->cb_params	= NULL;
 	seq->out_payload = NULL;
 
-	nvgpu_mutex_acquire(&sequences->gsp_seq_lock);
-	nvgpu_clear_bit(seq->id, sequences->gsp_seq_tbl);
-	nvgpu_mutex_release(&sequences->gsp_seq_lock);
+	nvgpu_falcon_seq_release(g, &sequences->ids, seq->id, completed);
+}
+
+void nvgpu_gsp_seq_get_latency(struct gsp_sequences *sequences, u8 unit_id,
+			struct nvgpu_swhist_data *data)
+{
+	nvgpu_falcon_seq_get_latency(&sequences->ids, unit_id, data);
 }
 
 int nvgpu_gsp_seq_response_handle(struct gk20a *g,
@@ -162,7 +153,7 @@ int nvgpu_gsp_seq_response_handle(struct gk20a *g,
 	}
 
 	/* release the sequence so that it may be used for other commands */
-	gsp_seq_release(sequences, seq);
+	gsp_seq_release(g, sequences, seq);
 
 	return 0;
 }
@@ -24,14 +24,12 @@
 #define NVGPU_GSP_SEQ_H
 
 #include <nvgpu/types.h>
-#include <nvgpu/lock.h>
+#include <nvgpu/falcon_seq.h>
 
 struct gk20a;
 struct nv_flcn_msg_gsp;
 
 #define GSP_MAX_NUM_SEQUENCES	256U
-#define GSP_SEQ_BIT_SHIFT	5U
-#define GSP_SEQ_TBL_SIZE	(GSP_MAX_NUM_SEQUENCES >> GSP_SEQ_BIT_SHIFT)
 
 enum gsp_seq_state {
 	GSP_SEQ_STATE_FREE = 0U,
@@ -52,8 +50,7 @@ struct gsp_sequence {
 
 struct gsp_sequences {
 	struct gsp_sequence *seq;
-	unsigned long gsp_seq_tbl[GSP_SEQ_TBL_SIZE];
-	struct nvgpu_mutex gsp_seq_lock;
+	struct nvgpu_falcon_seq_alloc ids;
 };
 
 int nvgpu_gsp_sequences_init(struct gk20a *g, struct nvgpu_gsp_sched *gsp_sched);
@@ -61,7 +58,7 @@ void nvgpu_gsp_sequences_free(struct gk20a *g,
 			struct gsp_sequences *sequences);
 int nvgpu_gsp_seq_acquire(struct gk20a *g,
 			struct gsp_sequences *sequences,
-			struct gsp_sequence **pseq,
+			struct gsp_sequence **pseq, u8 unit_id,
 			gsp_callback callback, void *cb_params);
 int nvgpu_gsp_seq_response_handle(struct gk20a *g,
 			struct gsp_sequences *sequences,
@@ -69,6 +66,8 @@ int nvgpu_gsp_seq_response_handle(struct gk20a *g,
 u8 nvgpu_gsp_seq_get_id(struct gsp_sequence *seq);
 void nvgpu_gsp_seq_set_state(struct gsp_sequence *seq,
 			enum gsp_seq_state state);
-void gsp_seq_release(struct gsp_sequences *sequences,
+void gsp_seq_release(struct gk20a *g, struct gsp_sequences *sequences,
 			struct gsp_sequence *seq);
+void nvgpu_gsp_seq_get_latency(struct gsp_sequences *sequences, u8 unit_id,
+			struct nvgpu_swhist_data *data);
 #endif /* NVGPU_GSP_SEQ_H */
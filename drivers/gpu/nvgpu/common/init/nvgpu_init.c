@@ -27,6 +27,8 @@
 #include <nvgpu/kmem.h>
 #include <nvgpu/allocator.h>
 #include <nvgpu/timers.h>
+#include <nvgpu/thread.h>
+#include <nvgpu/cond.h>
 #include <nvgpu/soc.h>
 #include <nvgpu/enabled.h>
 #include <nvgpu/gmmu.h>
@@ -692,15 +694,58 @@ static int nvgpu_init_interrupt_setup(struct gk20a *g)
 	return 0;
 }
 
-typedef int (*nvgpu_init_func_t)(struct gk20a *g);
-struct nvgpu_init_table_t {
-	nvgpu_init_func_t func;
-	const char *name;
-	u32 enable_flag;
-};
 #define NVGPU_INIT_TABLE_ENTRY(ops_ptr, enable_flag) \
-	{ (ops_ptr), #ops_ptr,  (enable_flag) }
+	{ (ops_ptr), #ops_ptr, (enable_flag), 0U, 0ULL, false }
+#define NVGPU_INIT_TABLE_ASYNC_ENTRY(ops_ptr, enable_flag, step_id, deps) \
+	{ (ops_ptr), #ops_ptr, (enable_flag), (step_id), (deps), true }
 #define NO_FLAG 0U
+#define NO_DEPS 0ULL
+
+/*
+ * Ids of init table entries that async entries depend on, or that are
+ * async themselves.
+ */
+#define NVGPU_INIT_STEP_NETLIST			1U
+
+struct nvgpu_init_exec;
+
+struct nvgpu_init_worker {
+	struct nvgpu_init_exec *exec;
+	struct nvgpu_thread thread;
+	u32 id;
+};
+
+struct nvgpu_init_exec {
+	struct gk20a *g;
+	const struct nvgpu_init_table_t *table;
+	u32 num_steps;
+	struct nvgpu_init_profile *profile;
+	s64 start_ns;
+
+	/* protects the state below */
+	struct nvgpu_mutex lock;
+	/* bumped and broadcast whenever a step completes, workers only */
+	struct nvgpu_cond cond;
+	nvgpu_atomic_t gen;
+	bool cond_valid;
+
+	/* table indices each step waits for */
+	u64 wait_mask[NVGPU_INIT_TABLE_MAX_STEPS];
+	/* async steps */
+	u64 async;
+	u32 num_async;
+	/* steps not started yet */
+	u64 pending;
+	/* steps completed or skipped */
+	u64 done;
+	u32 running;
+	/* lowest failed table index, num_steps if none */
+	u32 failed;
+	int err;
+
+	struct nvgpu_init_worker workers[NVGPU_INIT_MAX_WORKERS];
+	u32 num_workers;
+};
 
 static bool needs_init(struct gk20a *g, nvgpu_init_func_t func, u32 enable_flag)
 {
@@ -708,10 +753,314 @@ static bool needs_init(struct gk20a *g, nvgpu_init_func_t func, u32 enable_flag)
 		nvgpu_is_enabled(g, enable_flag)) && (func != NULL);
 }
 
+static int nvgpu_init_exec_prepare(struct nvgpu_init_exec *exec)
+{
+	struct gk20a *g = exec->g;
+	const struct nvgpu_init_table_t *table = exec->table;
+	u32 i, j;
+
+	for (i = 0U; i < exec->num_steps; i++) {
+		exec->profile->steps[i].name = table[i].name;
+
+		if (!needs_init(g, table[i].func, table[i].enable_flag)) {
+			nvgpu_log_info(g,
+				"Skipping initializing %s (enable_flag=%u func=%p)",
+				table[i].name, table[i].enable_flag,
+				table[i].func);
+			exec->profile->steps[i].skipped = true;
+			exec->done |= BIT64(i);
+			continue;
+		}
+
+		exec->pending |= BIT64(i);
+
+		if (!table[i].async) {
+			exec->wait_mask[i] = BIT64(i) - 1ULL;
+			continue;
+		}
+
+		exec->async |= BIT64(i);
+		exec->num_async = nvgpu_safe_add_u32(exec->num_async, 1U);
+		for (j = 0U; j < exec->num_steps; j++) {
+			if ((table[j].id == 0U) ||
+			    ((table[i].deps & BIT64(table[j].id)) == 0ULL)) {
+				continue;
+			}
+			if (j >= i) {
+				nvgpu_err(g, "%s: depends on later step %s",
+					table[i].name, table[j].name);
+				return -EINVAL;
+			}
+			exec->wait_mask[i] |= BIT64(j);
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Called with exec->lock held. Returns the steps that may still be started
+ * by this thread. Once a step failed, steps after it are not started but
+ * the ones before it still are, so that the returned error matches a serial
+ * run of the table. Async steps after the failing one may already have
+ * completed though, see nvgpu_init_run_table().
+ */
+static u64 nvgpu_init_exec_todo(struct nvgpu_init_exec *exec, bool caller)
+{
+	u64 todo = exec->pending;
+
+	if (exec->failed < NVGPU_INIT_TABLE_MAX_STEPS) {
+		todo &= BIT64(exec->failed) - 1ULL;
+	}
+	if (!caller) {
+		todo &= exec->async;
+	}
+
+	return todo;
+}
+
+/*
+ * Called with exec->lock held. Returns the lowest table index in todo that
+ * is ready to run, or num_steps if there is none. With workers around the
+ * caller prefers synchronous steps and leaves async ones to the workers.
+ */
+static u32 nvgpu_init_exec_pick(struct nvgpu_init_exec *exec, u64 todo,
+		bool caller)
+{
+	u64 ready = 0ULL;
+	u32 i;
+
+	for (i = 0U; i < exec->num_steps; i++) {
+		if (((todo & BIT64(i)) != 0ULL) &&
+		    ((exec->wait_mask[i] & ~exec->done) == 0ULL)) {
+			ready |= BIT64(i);
+		}
+	}
+
+	if (caller && (exec->num_workers > 0U) &&
+	    ((ready & ~exec->async) != 0ULL)) {
+		ready &= ~exec->async;
+	}
+
+	for (i = 0U; i < exec->num_steps; i++) {
+		if ((ready & BIT64(i)) != 0ULL) {
+			break;
+		}
+	}
+
+	return i;
+}
+
+/*
+ * Called with exec->lock held, drops it while the step runs.
+ */
+static void nvgpu_init_exec_run_step(struct nvgpu_init_exec *exec, u32 i,
+		u32 worker)
+{
+	struct gk20a *g = exec->g;
+	const struct nvgpu_init_table_t *step = &exec->table[i];
+	struct nvgpu_init_step_profile *prof = &exec->profile->steps[i];
+	s64 start_ns;
+	int err;
+
+	exec->pending &= ~BIT64(i);
+	exec->running = nvgpu_safe_add_u32(exec->running, 1U);
+	nvgpu_mutex_release(&exec->lock);
+
+	nvgpu_log_info(g, "Initializing %s", step->name);
+	start_ns = nvgpu_current_time_ns();
+	err = step->func(g);
+	prof->duration_ns = nvgpu_current_time_ns() - start_ns;
+	prof->start_ns = start_ns - exec->start_ns;
+	prof->err = err;
+	prof->worker = worker;
+
+	if (err != 0) {
+		nvgpu_err(g, "Failed initialization for: %s", step->name);
+	}
+
+	nvgpu_mutex_acquire(&exec->lock);
+	exec->done |= BIT64(i);
+	exec->running = nvgpu_safe_sub_u32(exec->running, 1U);
+	if ((err != 0) && (i < exec->failed)) {
+		exec->failed = i;
+		exec->err = err;
+	}
+	nvgpu_atomic_inc(&exec->gen);
+	nvgpu_mutex_release(&exec->lock);
+
+	if (exec->cond_valid) {
+		(void) nvgpu_cond_broadcast(&exec->cond);
+	}
+
+	nvgpu_mutex_acquire(&exec->lock);
+}
+
+/*
+ * Called with exec->lock held, drops it while waiting.
+ */
+static void nvgpu_init_exec_wait(struct nvgpu_init_exec *exec)
+{
+	int gen = nvgpu_atomic_read(&exec->gen);
+
+	/* without workers the lowest pending step is always ready */
+	nvgpu_assert(exec->cond_valid);
+
+	nvgpu_mutex_release(&exec->lock);
+	(void) NVGPU_COND_WAIT(&exec->cond,
+			nvgpu_atomic_read(&exec->gen) != gen, 0U);
+	nvgpu_mutex_acquire(&exec->lock);
+}
+
+static void nvgpu_init_exec_loop(struct nvgpu_init_exec *exec, u32 worker)
+{
+	bool caller = (worker == 0U);
+	u64 todo;
+	u32 i;
+
+	nvgpu_mutex_acquire(&exec->lock);
+	while (true) {
+		todo = nvgpu_init_exec_todo(exec, caller);
+		if (todo == 0ULL) {
+			/* nothing left to start, caller waits for the rest */
+			if (!caller || (exec->running == 0U)) {
+				break;
+			}
+			nvgpu_init_exec_wait(exec);
+			continue;
+		}
+
+		i = nvgpu_init_exec_pick(exec, todo, caller);
+		if (i < exec->num_steps) {
+			nvgpu_init_exec_run_step(exec, i, worker);
+		} else {
+			nvgpu_init_exec_wait(exec);
+		}
+	}
+	nvgpu_mutex_release(&exec->lock);
+}
+
+static int nvgpu_init_worker_fn(void *arg)
+{
+	struct nvgpu_init_worker *worker = (struct nvgpu_init_worker *)arg;
+
+	nvgpu_init_exec_loop(worker->exec, worker->id);
+
+	return 0;
+}
+
+static void nvgpu_init_exec_start_workers(struct nvgpu_init_exec *exec)
+{
+	struct gk20a *g = exec->g;
+	u32 num = min3(g->init_workers, NVGPU_INIT_MAX_WORKERS,
+			exec->num_async);
+	u32 i;
+	int err;
+
+	if (num == 0U) {
+		return;
+	}
+
+	err = nvgpu_cond_init(&exec->cond);
+	if (err != 0) {
+		nvgpu_warn(g, "init workers disabled, cond init err=%d", err);
+		return;
+	}
+	exec->cond_valid = true;
+
+	for (i = 0U; i < num; i++) {
+		exec->workers[i].exec = exec;
+		exec->workers[i].id = nvgpu_safe_add_u32(i, 1U);
+		err = nvgpu_thread_create(&exec->workers[i].thread,
+				&exec->workers[i], nvgpu_init_worker_fn,
+				"nvgpu_init");
+		if (err != 0) {
+			/* the calling thread runs whatever is left */
+			nvgpu_warn(g, "init worker %u not started err=%d",
+				i, err);
+			break;
+		}
+		exec->num_workers = nvgpu_safe_add_u32(exec->num_workers, 1U);
+	}
+}
+
+int nvgpu_init_run_table(struct gk20a *g,
+		const struct nvgpu_init_table_t *table, u32 num_steps,
+		struct nvgpu_init_profile *profile)
+{
+	struct nvgpu_init_exec exec;
+	u32 i;
+	int err;
+
+	if ((profile == NULL) || (num_steps > NVGPU_INIT_TABLE_MAX_STEPS)) {
+		nvgpu_err(g, "invalid init table: %u steps", num_steps);
+		return -EINVAL;
+	}
+
+	(void) memset(profile, 0, sizeof(*profile));
+	(void) memset(&exec, 0, sizeof(exec));
+	exec.g = g;
+	exec.table = table;
+	exec.num_steps = num_steps;
+	exec.profile = profile;
+	exec.failed = num_steps;
+	profile->num_steps = num_steps;
+	profile->failed_step = num_steps;
+
+	err = nvgpu_init_exec_prepare(&exec);
+	if (err != 0) {
+		return err;
+	}
+
+	nvgpu_mutex_init(&exec.lock);
+	nvgpu_atomic_set(&exec.gen, 0);
+
+	exec.start_ns = nvgpu_current_time_ns();
+
+	nvgpu_init_exec_start_workers(&exec);
+	nvgpu_init_exec_loop(&exec, 0U);
+
+	for (i = 0U; i < exec.num_workers; i++) {
+		nvgpu_thread_join(&exec.workers[i].thread);
+	}
+
+	profile->wall_ns = nvgpu_current_time_ns() - exec.start_ns;
+	profile->num_workers = exec.num_workers;
+	profile->failed_step = exec.failed;
+	for (i = 0U; i < num_steps; i++) {
+		if ((exec.pending & BIT64(i)) != 0ULL) {
+			/* aborted after a failure */
+			profile->steps[i].skipped = true;
+		}
+		profile->busy_ns += profile->steps[i].duration_ns;
+	}
+
+	nvgpu_mutex_destroy(&exec.lock);
+	if (exec.cond_valid) {
+		nvgpu_cond_destroy(&exec.cond);
+	}
+
+	if (exec.failed < num_steps) {
+		nvgpu_err(g, "init aborted at %s err=%d",
+			table[exec.failed].name, exec.err);
+	}
+
+	return exec.err;
+}
+
+const struct nvgpu_init_profile *nvgpu_init_get_profile(struct gk20a *g,
+		u32 stage)
+{
+	if (stage >= NVGPU_INIT_STAGE_MAX) {
+		return NULL;
+	}
+
+	return &g->init_profile[stage];
+}
+
 static int nvgpu_early_init(struct gk20a *g)
 {
 	int err = 0;
-	size_t i;
 
 	/*
 	 * This cannot be static because we use the func ptrs as initializers
@@ -766,27 +1115,10 @@ static int nvgpu_early_init(struct gk20a *g)
 		NVGPU_INIT_TABLE_ENTRY(g->ops.grmgr.init_gr_manager, NO_FLAG),
 	};
 
-	for (i = 0; i < ARRAY_SIZE(nvgpu_early_init_table); i++) {
-		if (!needs_init(g, nvgpu_early_init_table[i].func,
-				nvgpu_early_init_table[i].enable_flag)) {
-			nvgpu_log_info(g,
-				"Skipping initializing %s (enable_flag=%u func=%p)",
-				   nvgpu_early_init_table[i].name,
-				   nvgpu_early_init_table[i].enable_flag,
-				   nvgpu_early_init_table[i].func);
-		} else {
-			nvgpu_log_info(g, "Initializing %s",
-					   nvgpu_early_init_table[i].name);
-			err = nvgpu_early_init_table[i].func(g);
-			if (err != 0) {
-				nvgpu_err(g, "Failed initialization for: %s",
-					  nvgpu_early_init_table[i].name);
-				goto done;
-			}
-		}
-	}
+	err = nvgpu_init_run_table(g, nvgpu_early_init_table,
+			(u32)ARRAY_SIZE(nvgpu_early_init_table),
+			&g->init_profile[NVGPU_INIT_STAGE_EARLY]);
 
-done:
 	return err;
 }
 
@@ -895,7 +1227,16 @@ int nvgpu_finalize_poweron(struct gk20a *g)
 		NVGPU_INIT_TABLE_ENTRY(nvgpu_nvs_init, NO_FLAG),
 		NVGPU_INIT_TABLE_ENTRY(g->ops.therm.elcg_init_idle_filters,
 				       NO_FLAG),
-		NVGPU_INIT_TABLE_ENTRY(&nvgpu_netlist_init_ctx_vars, NO_FLAG),
+		/*
+		 * Netlist parsing only loads and parses firmware, it does not
+		 * depend on any step above and nvgpu_gr_alloc() below is its
+		 * first consumer. It may start as soon as the table starts and
+		 * complete before an earlier step fails; it is idempotent
+		 * (netlist_valid) and freed by gr remove, so a failed poweron
+		 * leaves nothing behind that a retry or teardown cannot handle.
+		 */
+		NVGPU_INIT_TABLE_ASYNC_ENTRY(&nvgpu_netlist_init_ctx_vars,
+				NO_FLAG, NVGPU_INIT_STEP_NETLIST, NO_DEPS),
 		/* prepare portion of sw required for enable hw */
 		NVGPU_INIT_TABLE_ENTRY(&nvgpu_gr_alloc, NO_FLAG),
 		NVGPU_INIT_TABLE_ENTRY(&nvgpu_gr_enable_hw, NO_FLAG),
@@ -991,27 +1332,14 @@ int nvgpu_finalize_poweron(struct gk20a *g)
 #endif
 #endif
 	};
-	size_t i;
 
 	nvgpu_log_fn(g, " ");
 
-	for (i = 0; i < ARRAY_SIZE(nvgpu_init_table); i++) {
-		if (!needs_init(g, nvgpu_init_table[i].func,
-				nvgpu_init_table[i].enable_flag)) {
-			nvgpu_log_info(g, "Skipping initializing %s (enable_flag=%u func=%p)",
-				       nvgpu_init_table[i].name,
-				       nvgpu_init_table[i].enable_flag,
-				       nvgpu_init_table[i].func);
-		} else {
-			nvgpu_log_info(g, "Initializing %s",
-				       nvgpu_init_table[i].name);
-			err = nvgpu_init_table[i].func(g);
-			if (err != 0) {
-				nvgpu_err(g, "Failed initialization for: %s",
-					  nvgpu_init_table[i].name);
-				goto done;
-			}
-		}
+	err = nvgpu_init_run_table(g, nvgpu_init_table,
+			(u32)ARRAY_SIZE(nvgpu_init_table),
+			&g->init_profile[NVGPU_INIT_STAGE_FINALIZE]);
+	if (err != 0) {
+		goto done;
 	}
 
 	nvgpu_print_enabled_flags(g);
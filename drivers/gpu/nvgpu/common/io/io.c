@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -25,6 +25,9 @@
 #include <nvgpu/bug.h>
 #include <nvgpu/gk20a.h>
 #include <nvgpu/nvgpu_init.h>
+#include <nvgpu/timers.h>
+#include <nvgpu/errno.h>
+#include <nvgpu/static_analysis.h>
 
 static void nvgpu_warn_on_no_regs(struct gk20a *g, u32 r)
 {
@@ -162,3 +165,73 @@ u32 nvgpu_func_readl(struct gk20a *g, u32 r)
 	return nvgpu_readl(g,
 		nvgpu_safe_add_u32(r, g->ops.func.get_full_phys_offset(g)));
 }
+
+int nvgpu_reg_batch_validate(struct gk20a *g,
+		const struct nvgpu_reg_batch *batch)
+{
+	const u32 *e;
+	u32 i;
+
+	if ((batch->count != 0U) && (batch->table == NULL)) {
+		return -EINVAL;
+	}
+
+	if ((batch->stride == 0U) || (batch->value >= batch->stride)) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < batch->count; i++) {
+		e = &batch->table[(size_t)i * batch->stride];
+		if ((e[0] & 0x3U) != 0U) {
+			nvgpu_err(g, "unaligned reg 0x%x in batch", e[0]);
+			return -EINVAL;
+		}
+		if ((g->regs_size != 0ULL) && !nvgpu_io_valid_reg(g, e[0])) {
+			nvgpu_err(g, "reg 0x%x outside of BAR0", e[0]);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+void nvgpu_writel_batch(struct gk20a *g, const struct nvgpu_reg_batch *batch)
+{
+	const u32 *e = batch->table;
+	s64 start_ns;
+	u32 i;
+
+	if (batch->count == 0U) {
+		return;
+	}
+
+	if (unlikely(!g->regs)) {
+		nvgpu_warn_on_no_regs(g, e[0]);
+		nvgpu_log(g, gpu_dbg_reg, "batch of %u (failed)", batch->count);
+		return;
+	}
+
+	start_ns = nvgpu_current_time_ns();
+
+	/* Order prior memory writes against the first register write. */
+	nvgpu_wmb();
+	for (i = 0U; i < batch->count; i++) {
+		nvgpu_os_writel_relaxed(e[batch->value], g->regs + e[0]);
+		nvgpu_log(g, gpu_dbg_reg, "r=0x%x v=0x%x", e[0], e[batch->value]);
+		e += batch->stride;
+	}
+	nvgpu_wmb();
+
+	nvgpu_atomic64_inc(&g->reg_batches);
+	nvgpu_atomic64_add((long)batch->count, &g->reg_batch_writes);
+	nvgpu_atomic64_add((long)nvgpu_safe_sub_s64(nvgpu_current_time_ns(),
+			start_ns), &g->reg_batch_ns);
+}
+
+void nvgpu_reg_batch_get_stats(struct gk20a *g,
+		struct nvgpu_reg_batch_stats *stats)
+{
+	stats->batches = (u64)nvgpu_atomic64_read(&g->reg_batches);
+	stats->writes = (u64)nvgpu_atomic64_read(&g->reg_batch_writes);
+	stats->time_ns = (u64)nvgpu_atomic64_read(&g->reg_batch_ns);
+}
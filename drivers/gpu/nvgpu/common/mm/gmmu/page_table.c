@@ -38,6 +38,7 @@
 #include <nvgpu/static_analysis.h>
 #include <nvgpu/errata.h>
 #include <nvgpu/power_features/pg.h>
+#include <nvgpu/swhist.h>
 
 #ifdef CONFIG_NVGPU_TRACE
 #define nvgpu_gmmu_dbg(g, attrs, fmt, args...)				\
@@ -960,6 +961,7 @@ static int nvgpu_gmmu_update_page_table(struct vm_gk20a *vm,
 					struct nvgpu_gmmu_attrs *attrs)
 {
 	struct gk20a *g = gk20a_from_vm(vm);
+	s64 start_ns;
 	u32 page_size;
 	int err;
 
@@ -984,6 +986,7 @@ static int nvgpu_gmmu_update_page_table(struct vm_gk20a *vm,
 	nvgpu_gmmu_update_page_table_dbg_print(g, attrs, vm, sgt,
 				space_to_skip, virt_addr, length, page_size);
 
+	start_ns = nvgpu_swhist_begin();
 	err = nvgpu_gmmu_do_update_page_table(vm,
 					      sgt,
 					      space_to_skip,
@@ -995,6 +998,7 @@ static int nvgpu_gmmu_update_page_table(struct vm_gk20a *vm,
 	}
 
 	nvgpu_mb();
+	nvgpu_swhist_end(g, NVGPU_SWHIST_PT_UPDATE, start_ns);
 
 #ifdef CONFIG_NVGPU_TRACE
 	nvgpu_gmmu_dbg(g, attrs, "%-5s Done!",
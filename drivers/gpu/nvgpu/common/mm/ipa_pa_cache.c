@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2021-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -21,32 +21,77 @@
  */
 #include <nvgpu/gk20a.h>
 #include <nvgpu/timers.h>
+#include <nvgpu/static_analysis.h>
 #include <nvgpu/ipa_pa_cache.h>
 
+/* Index of the first descriptor starting above ipa. */
+static u32 ipa_pa_cache_upper_bound(struct nvgpu_ipa_pa_cache *ipa_cache,
+				u64 ipa)
+{
+	u32 lo = 0U;
+	u32 hi = ipa_cache->num_ipa_desc;
+	u32 mid;
+
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (ipa_cache->ipa[mid].ipa_base <= ipa) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void ipa_pa_cache_remove(struct nvgpu_ipa_pa_cache *ipa_cache,
+				u32 first, u32 count)
+{
+	u32 i;
+
+	for (i = first; (i + count) < ipa_cache->num_ipa_desc; i++) {
+		ipa_cache->ipa[i] = ipa_cache->ipa[i + count];
+	}
+	ipa_cache->num_ipa_desc -= count;
+}
+
+static void ipa_pa_cache_insert(struct nvgpu_ipa_pa_cache *ipa_cache,
+				u32 idx, const struct nvgpu_ipa_desc *desc)
+{
+	u32 i;
+
+	for (i = ipa_cache->num_ipa_desc; i > idx; i--) {
+		ipa_cache->ipa[i] = ipa_cache->ipa[i - 1U];
+	}
+	ipa_cache->ipa[idx] = *desc;
+	ipa_cache->num_ipa_desc++;
+}
+
 static u64 nvgpu_ipa_to_pa_cache_lookup(struct gk20a *g, u64 ipa,
 				u64 *pa_len)
 {
 	struct nvgpu_ipa_desc *desc;
 	struct nvgpu_ipa_pa_cache *ipa_cache;
-	u32 i = 0U;
-	u64 pa = 0UL;
+	u32 i;
+	u64 offset;
 
 	ipa_cache = &(g->ipa_pa_cache);
-	desc = &(ipa_cache->ipa[0]);
+	i = ipa_pa_cache_upper_bound(ipa_cache, ipa);
+	if (i == 0U) {
+		return 0U;
+	}
 
-	for (i = 0; i < ipa_cache->num_ipa_desc; ++i, ++desc) {
-		if (ipa >= desc->ipa_base &&
-				(ipa < (desc->ipa_base + desc->ipa_size))) {
-			pa = ipa - desc->ipa_base + desc->pa_base;
-			if (pa_len != NULL) {
-				*pa_len = desc->ipa_size -(ipa - desc->ipa_base);
-			}
+	desc = &(ipa_cache->ipa[i - 1U]);
+	offset = ipa - desc->ipa_base;
+	if (offset >= desc->ipa_size) {
+		return 0U;
+	}
 
-			return pa;
-		}
+	if (pa_len != NULL) {
+		*pa_len = desc->ipa_size - offset;
 	}
 
-	return 0U;
+	return nvgpu_safe_add_u64(desc->pa_base, offset);
 }
 
 u64 nvgpu_ipa_to_pa_cache_lookup_locked(struct gk20a *g, u64 ipa,
@@ -59,6 +104,13 @@ u64 nvgpu_ipa_to_pa_cache_lookup_locked(struct gk20a *g, u64 ipa,
 	nvgpu_rwsem_down_read(&(ipa_cache->ipa_pa_rw_lock));
 	pa = nvgpu_ipa_to_pa_cache_lookup(g, ipa, pa_len);
 	nvgpu_rwsem_up_read(&(ipa_cache->ipa_pa_rw_lock));
+
+	if (pa != 0UL) {
+		nvgpu_atomic64_inc(&ipa_cache->hits);
+	} else {
+		nvgpu_atomic64_inc(&ipa_cache->misses);
+	}
+
 	return pa;
 }
 
@@ -66,8 +118,20 @@ void nvgpu_ipa_to_pa_add_to_cache(struct gk20a *g, u64 ipa, u64 pa,
 				struct nvgpu_hyp_ipa_pa_info *info)
 {
 	struct nvgpu_ipa_pa_cache *ipa_cache;
-	struct nvgpu_ipa_desc *desc = NULL;
+	struct nvgpu_ipa_desc *prev, *next;
+	struct nvgpu_ipa_desc desc;
 	u64 pa_cached = 0U;
+	u64 ipa_end;
+	u32 first, last, victim;
+
+	if (info->size == 0ULL) {
+		return;
+	}
+
+	desc.ipa_base = nvgpu_safe_sub_u64(ipa, info->offset);
+	desc.ipa_size = info->size;
+	desc.pa_base = info->base;
+	ipa_end = nvgpu_safe_add_u64(desc.ipa_base, desc.ipa_size);
 
 	ipa_cache = &(g->ipa_pa_cache);
 	nvgpu_rwsem_down_write(&(ipa_cache->ipa_pa_rw_lock));
@@ -81,16 +145,72 @@ void nvgpu_ipa_to_pa_add_to_cache(struct gk20a *g, u64 ipa, u64 pa,
 		return;
 	}
 
-        if (ipa_cache->num_ipa_desc >= MAX_IPA_PA_CACHE) {
-                desc = &ipa_cache->ipa[nvgpu_current_time_ns() %
-			MAX_IPA_PA_CACHE];
-        } else {
-                desc = &ipa_cache->ipa[ipa_cache->num_ipa_desc++];
-        }
+	/* Drop stale descriptors overlapping the new range. */
+	first = ipa_pa_cache_upper_bound(ipa_cache, desc.ipa_base);
+	if (first > 0U) {
+		prev = &(ipa_cache->ipa[first - 1U]);
+		if ((desc.ipa_base - prev->ipa_base) < prev->ipa_size) {
+			first--;
+		}
+	}
+	last = ipa_pa_cache_upper_bound(ipa_cache, ipa_end - 1ULL);
+	if (last > first) {
+		nvgpu_atomic64_add((long)(last - first),
+				&ipa_cache->replaced);
+		ipa_pa_cache_remove(ipa_cache, first, last - first);
+	}
+
+	/* Merge with neighbours contiguous in both IPA and PA. */
+	if (first > 0U) {
+		prev = &(ipa_cache->ipa[first - 1U]);
+		if ((nvgpu_safe_add_u64(prev->ipa_base, prev->ipa_size) ==
+				desc.ipa_base) &&
+		    (nvgpu_safe_add_u64(prev->pa_base, prev->ipa_size) ==
+				desc.pa_base)) {
+			desc.ipa_base = prev->ipa_base;
+			desc.pa_base = prev->pa_base;
+			desc.ipa_size = nvgpu_safe_add_u64(desc.ipa_size,
+					prev->ipa_size);
+			first--;
+			ipa_pa_cache_remove(ipa_cache, first, 1U);
+		}
+	}
+	if (first < ipa_cache->num_ipa_desc) {
+		next = &(ipa_cache->ipa[first]);
+		if ((ipa_end == next->ipa_base) &&
+		    (nvgpu_safe_add_u64(desc.pa_base, desc.ipa_size) ==
+				next->pa_base)) {
+			desc.ipa_size = nvgpu_safe_add_u64(desc.ipa_size,
+					next->ipa_size);
+			ipa_pa_cache_remove(ipa_cache, first, 1U);
+		}
+	}
+
+	if (ipa_cache->num_ipa_desc >= MAX_IPA_PA_CACHE) {
+		victim = (u32)((u64)nvgpu_current_time_ns() %
+				MAX_IPA_PA_CACHE);
+		ipa_pa_cache_remove(ipa_cache, victim, 1U);
+		if (victim < first) {
+			first--;
+		}
+		nvgpu_atomic64_inc(&ipa_cache->evictions);
+	}
 
-	desc->ipa_base = ipa - info->offset;
-        desc->ipa_size = info->size;
-        desc->pa_base = info->base;
+	ipa_pa_cache_insert(ipa_cache, first, &desc);
 	nvgpu_rwsem_up_write(&(ipa_cache->ipa_pa_rw_lock));
+}
 
+void nvgpu_ipa_pa_cache_get_stats(struct gk20a *g,
+		struct nvgpu_ipa_pa_cache_stats *stats)
+{
+	struct nvgpu_ipa_pa_cache *ipa_cache = &(g->ipa_pa_cache);
+
+	stats->hits = (u64)nvgpu_atomic64_read(&ipa_cache->hits);
+	stats->misses = (u64)nvgpu_atomic64_read(&ipa_cache->misses);
+	stats->evictions = (u64)nvgpu_atomic64_read(&ipa_cache->evictions);
+	stats->replaced = (u64)nvgpu_atomic64_read(&ipa_cache->replaced);
+
+	nvgpu_rwsem_down_read(&(ipa_cache->ipa_pa_rw_lock));
+	stats->entries = ipa_cache->num_ipa_desc;
+	nvgpu_rwsem_up_read(&(ipa_cache->ipa_pa_rw_lock));
 }
@@ -21,6 +21,8 @@
  */
 
 #include <nvgpu/bug.h>
+#include <nvgpu/errno.h>
+#include <nvgpu/log.h>
 #include <nvgpu/kmem.h>
 #include <nvgpu/nvgpu_mem.h>
 #include <nvgpu/nvgpu_sgt.h>
@@ -29,6 +31,17 @@
 #include <nvgpu/gk20a.h>
 #include <nvgpu/pramin.h>
 #include <nvgpu/string.h>
+#ifdef CONFIG_NVGPU_DGPU
+#include <nvgpu/ce_app.h>
+#include <nvgpu/fence.h>
+#include <nvgpu/page_allocator.h>
+#include <nvgpu/sizes.h>
+
+/* Vidmem copies and fills from this size on go to the copy engine. */
+#define NVGPU_MEM_OP_CE_MIN_SIZE	SZ_64K
+/* Bounce buffer size for vidmem to vidmem copies through PRAMIN. */
+#define NVGPU_MEM_OP_BOUNCE_SIZE	(SZ_4K * 4U)
+#endif
 
 /*
  * Make sure to use the right coherency aperture if you use this function! This
@@ -246,6 +259,338 @@ void nvgpu_memset(struct gk20a *g, struct nvgpu_mem *mem, u64 offset,
 	}
 }
 
+static bool nvgpu_mem_op_range_valid(struct nvgpu_mem *mem, u64 offset,
+		u64 size)
+{
+	if (((offset & 3ULL) != 0ULL) || ((size & 3ULL) != 0ULL)) {
+		return false;
+	}
+
+	return (offset <= mem->size) && (size <= (mem->size - offset));
+}
+
+static bool nvgpu_mem_op_mem_valid(struct nvgpu_mem *mem)
+{
+	if (nvgpu_mem_is_sysmem(mem)) {
+		return mem->cpu_va != NULL;
+	}
+#ifdef CONFIG_NVGPU_DGPU
+	if (mem->aperture == APERTURE_VIDMEM) {
+		return mem->vidmem_alloc != NULL;
+	}
+#endif
+	return false;
+}
+
+/* Overlapping copies within one buffer are not supported. */
+static bool nvgpu_mem_op_overlaps(const struct nvgpu_mem_op *op)
+{
+	return (op->src == op->dst) &&
+		(op->src_offset < (op->dst_offset + op->size)) &&
+		(op->dst_offset < (op->src_offset + op->size));
+}
+
+static int nvgpu_mem_op_check(const struct nvgpu_mem_op *op)
+{
+	if ((op->dst == NULL) || !nvgpu_mem_op_mem_valid(op->dst) ||
+	    !nvgpu_mem_op_range_valid(op->dst, op->dst_offset, op->size)) {
+		return -EINVAL;
+	}
+
+	if (op->type == NVGPU_MEM_OP_FILL) {
+		return ((op->c & ~0xffU) != 0U) ? -EINVAL : 0;
+	}
+
+	if ((op->type != NVGPU_MEM_OP_COPY) || (op->src == NULL) ||
+	    !nvgpu_mem_op_mem_valid(op->src) ||
+	    !nvgpu_mem_op_range_valid(op->src, op->src_offset, op->size)) {
+		return -EINVAL;
+	}
+
+	return nvgpu_mem_op_overlaps(op) ? -EINVAL : 0;
+}
+
+/*
+ * Extend op with next if next continues it: same kind and buffers, both
+ * ranges adjacent and, for fills, the same value.
+ */
+static bool nvgpu_mem_op_merge(struct nvgpu_mem_op *op,
+		const struct nvgpu_mem_op *next)
+{
+	if ((next->type != op->type) || (next->dst != op->dst) ||
+	    (next->dst_offset != (op->dst_offset + op->size))) {
+		return false;
+	}
+
+	if (op->type == NVGPU_MEM_OP_FILL) {
+		if (next->c != op->c) {
+			return false;
+		}
+	} else if ((next->src != op->src) ||
+		   (next->src_offset != (op->src_offset + op->size))) {
+		return false;
+	}
+
+	op->size += next->size;
+	if ((op->type == NVGPU_MEM_OP_COPY) && nvgpu_mem_op_overlaps(op)) {
+		op->size -= next->size;
+		return false;
+	}
+
+	return true;
+}
+
+#ifdef CONFIG_NVGPU_DGPU
+static bool nvgpu_mem_ce_usable(struct gk20a *g, u64 size)
+{
+	return (size >= NVGPU_MEM_OP_CE_MIN_SIZE) && (g->ce_app != NULL) &&
+		(g->mm.vidmem.ce_ctx_id != NVGPU_CE_INVAL_CTX_ID);
+}
+
+/* Find the sgl holding the given offset of a vidmem buffer. */
+static void *nvgpu_mem_vidmem_sgl(struct gk20a *g, struct nvgpu_mem *mem,
+		u64 *offset)
+{
+	struct nvgpu_sgt *sgt = &mem->vidmem_alloc->sgt;
+	void *sgl;
+
+	nvgpu_sgt_for_each_sgl(sgl, sgt) {
+		u64 len = nvgpu_sgt_get_length(sgt, sgl);
+
+		if (*offset < len) {
+			break;
+		}
+		*offset -= len;
+	}
+
+	return sgl;
+}
+
+/*
+ * Run a vidmem to vidmem copy or a vidmem fill on the copy engine, one
+ * submit per physically contiguous piece, and wait for the last one.
+ */
+static int nvgpu_mem_ce_op(struct gk20a *g, const struct nvgpu_mem_op *op)
+{
+	struct nvgpu_sgt *dst_sgt = &op->dst->vidmem_alloc->sgt;
+	struct nvgpu_sgt *src_sgt = NULL;
+	struct nvgpu_fence_type *fence_out = NULL;
+	struct nvgpu_fence_type *last_fence = NULL;
+	u64 dst_off = op->dst_offset;
+	u64 src_off = op->src_offset;
+	u64 size = op->size;
+	void *dst_sgl, *src_sgl = NULL;
+	u32 payload = 0U;
+	u32 launch_flags = NVGPU_CE_DST_LOCATION_LOCAL_FB;
+	u32 request = NVGPU_CE_MEMSET;
+	int err = 0;
+
+	dst_sgl = nvgpu_mem_vidmem_sgl(g, op->dst, &dst_off);
+	if (op->type == NVGPU_MEM_OP_COPY) {
+		src_sgt = &op->src->vidmem_alloc->sgt;
+		src_sgl = nvgpu_mem_vidmem_sgl(g, op->src, &src_off);
+		launch_flags |= NVGPU_CE_SRC_LOCATION_LOCAL_FB;
+		request = NVGPU_CE_PHYS_MODE_TRANSFER;
+	} else {
+		payload = op->c * 0x01010101U;
+	}
+
+	while (size != 0ULL) {
+		u64 dst_len, src_len = U64_MAX, src_pa = 0ULL, n;
+
+		BUG_ON(dst_sgl == NULL);
+		dst_len = nvgpu_sgt_get_length(dst_sgt, dst_sgl) - dst_off;
+		if (src_sgt != NULL) {
+			BUG_ON(src_sgl == NULL);
+			src_len = nvgpu_sgt_get_length(src_sgt, src_sgl) -
+				src_off;
+			src_pa = nvgpu_sgt_get_phys(g, src_sgt, src_sgl) +
+				src_off;
+		}
+		n = min3(size, dst_len, src_len);
+
+		err = nvgpu_ce_execute_ops(g, g->mm.vidmem.ce_ctx_id, src_pa,
+				nvgpu_sgt_get_phys(g, dst_sgt, dst_sgl) + dst_off,
+				n, payload, launch_flags, request, 0U,
+				&fence_out);
+		if (err != 0) {
+			break;
+		}
+
+		if (last_fence != NULL) {
+			nvgpu_fence_put(last_fence);
+		}
+		last_fence = fence_out;
+		size -= n;
+
+		dst_off += n;
+		if (dst_off == nvgpu_sgt_get_length(dst_sgt, dst_sgl)) {
+			dst_sgl = nvgpu_sgt_get_next(dst_sgt, dst_sgl);
+			dst_off = 0ULL;
+		}
+		if (src_sgt != NULL) {
+			src_off += n;
+			if (src_off == nvgpu_sgt_get_length(src_sgt, src_sgl)) {
+				src_sgl = nvgpu_sgt_get_next(src_sgt, src_sgl);
+				src_off = 0ULL;
+			}
+		}
+	}
+
+	if (last_fence != NULL) {
+		int wait_err = nvgpu_fence_wait(g, last_fence,
+				nvgpu_get_poll_timeout(g));
+
+		nvgpu_fence_put(last_fence);
+		if (err == 0) {
+			err = wait_err;
+		}
+	}
+
+	return err;
+}
+
+/*
+ * Copy between two vidmem buffers through a sysmem bounce buffer, a PRAMIN
+ * window pass on each side per chunk.
+ */
+static int nvgpu_mem_vidmem_copy(struct gk20a *g,
+		const struct nvgpu_mem_op *op)
+{
+	u64 chunk = min(op->size, U64(NVGPU_MEM_OP_BOUNCE_SIZE));
+	u64 done = 0ULL;
+	void *buf;
+
+	buf = nvgpu_kmalloc(g, chunk);
+	if (buf == NULL) {
+		return -ENOMEM;
+	}
+
+	while (done < op->size) {
+		u64 n = min(chunk, op->size - done);
+
+		nvgpu_pramin_rd_n(g, op->src, op->src_offset + done, n, buf);
+		nvgpu_pramin_wr_n(g, op->dst, op->dst_offset + done, n, buf);
+		done += n;
+	}
+
+	nvgpu_kfree(g, buf);
+
+	return 0;
+}
+
+static int nvgpu_mem_vidmem_op(struct gk20a *g, const struct nvgpu_mem_op *op)
+{
+	bool src_vidmem = (op->type == NVGPU_MEM_OP_COPY) &&
+		(op->src->aperture == APERTURE_VIDMEM);
+	int err = 0;
+
+	if ((op->type == NVGPU_MEM_OP_FILL) || src_vidmem) {
+		/* Fall back to PRAMIN if the copy engine is not up. */
+		if (nvgpu_mem_ce_usable(g, op->size) &&
+		    (nvgpu_mem_ce_op(g, op) == 0)) {
+			return 0;
+		}
+	}
+
+	if (op->type == NVGPU_MEM_OP_FILL) {
+		nvgpu_pramin_memset(g, op->dst, op->dst_offset, op->size,
+				op->c * 0x01010101U);
+	} else if (src_vidmem) {
+		err = nvgpu_mem_vidmem_copy(g, op);
+	} else {
+		nvgpu_pramin_wr_n(g, op->dst, op->dst_offset, op->size,
+				(u8 *)op->src->cpu_va + op->src_offset);
+	}
+
+	if ((err == 0) && !op->dst->skip_wmb) {
+		nvgpu_wmb();
+	}
+
+	return err;
+}
+#endif
+
+static int nvgpu_mem_do_op(struct gk20a *g, const struct nvgpu_mem_op *op)
+{
+	if (op->size == 0ULL) {
+		return 0;
+	}
+
+#ifdef CONFIG_NVGPU_DGPU
+	if (op->dst->aperture == APERTURE_VIDMEM) {
+		return nvgpu_mem_vidmem_op(g, op);
+	}
+
+	if ((op->type == NVGPU_MEM_OP_COPY) &&
+	    (op->src->aperture == APERTURE_VIDMEM)) {
+		nvgpu_pramin_rd_n(g, op->src, op->src_offset, op->size,
+				(u8 *)op->dst->cpu_va + op->dst_offset);
+		return 0;
+	}
+#endif
+
+	if (op->type == NVGPU_MEM_OP_FILL) {
+		(void) memset((u8 *)op->dst->cpu_va + op->dst_offset,
+				(int)op->c, op->size);
+	} else {
+		nvgpu_memcpy((u8 *)op->dst->cpu_va + op->dst_offset,
+				(u8 *)op->src->cpu_va + op->src_offset,
+				op->size);
+	}
+
+	return 0;
+}
+
+int nvgpu_mem_ops_submit(struct gk20a *g, const struct nvgpu_mem_op *ops,
+		u32 num_ops)
+{
+	struct nvgpu_mem_op cur;
+	u32 i;
+	int err;
+
+	if ((ops == NULL) || (num_ops == 0U)) {
+		return 0;
+	}
+
+	for (i = 0U; i < num_ops; i++) {
+		err = nvgpu_mem_op_check(&ops[i]);
+		if (err != 0) {
+			nvgpu_err(g, "bad nvgpu_mem op %u", i);
+			return err;
+		}
+	}
+
+	cur = ops[0];
+	for (i = 1U; i < num_ops; i++) {
+		if (!nvgpu_mem_op_merge(&cur, &ops[i])) {
+			err = nvgpu_mem_do_op(g, &cur);
+			if (err != 0) {
+				return err;
+			}
+			cur = ops[i];
+		}
+	}
+
+	return nvgpu_mem_do_op(g, &cur);
+}
+
+int nvgpu_mem_copy(struct gk20a *g, struct nvgpu_mem *dst, u64 dst_offset,
+		struct nvgpu_mem *src, u64 src_offset, u64 size)
+{
+	struct nvgpu_mem_op op = {
+		.type = NVGPU_MEM_OP_COPY,
+		.dst = dst,
+		.dst_offset = dst_offset,
+		.src = src,
+		.src_offset = src_offset,
+		.c = 0U,
+		.size = size,
+	};
+
+	return nvgpu_mem_ops_submit(g, &op, 1U);
+}
+
 static void *nvgpu_mem_phys_sgl_next(void *sgl)
 {
 	struct nvgpu_mem_sgl *sgl_impl = (struct nvgpu_mem_sgl *)sgl;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -26,6 +26,8 @@
 #include <nvgpu/nvgpu_sgt.h>
 #include <nvgpu/nvgpu_sgt_os.h>
 #include <nvgpu/log.h>
+#include <nvgpu/errno.h>
+#include <nvgpu/static_analysis.h>
 
 void *nvgpu_sgt_get_next(struct nvgpu_sgt *sgt, void *sgl)
 {
@@ -48,6 +50,68 @@ u64 nvgpu_sgt_ipa_to_pa(struct gk20a *g, struct nvgpu_sgt *sgt,
 	return sgt->ops->sgl_ipa_to_pa(g, sgl, ipa, pa_len);
 }
 
+int nvgpu_sgt_ipa_to_pa_batch(struct gk20a *g, struct nvgpu_sgt *sgt,
+		struct nvgpu_sgt_pa_range *ranges, u32 max_ranges,
+		u32 *num_ranges)
+{
+	struct nvgpu_sgt_pa_range *last = NULL;
+	void *sgl;
+	u64 ipa, pa, pa_len, remaining, chunk;
+	u32 n = 0U;
+	int err = 0;
+
+	nvgpu_sgt_for_each_sgl(sgl, sgt) {
+		ipa = nvgpu_sgt_get_ipa(g, sgt, sgl);
+		remaining = nvgpu_sgt_get_length(sgt, sgl);
+
+		while (remaining > 0ULL) {
+			pa_len = 0ULL;
+			pa = nvgpu_sgt_ipa_to_pa(g, sgt, sgl, ipa, &pa_len);
+			if (pa_len == 0ULL) {
+				/*
+				 * Without IPA translation the IPA is returned
+				 * and pa_len is left untouched: the rest of
+				 * the entry is contiguous. A translation which
+				 * failed returns 0 and no length.
+				 */
+				if (pa != ipa) {
+					nvgpu_err(g, "ipa 0x%llx not translated",
+						ipa);
+					err = -EINVAL;
+					goto done;
+				}
+				pa_len = remaining;
+			} else if (pa == 0ULL) {
+				nvgpu_err(g, "ipa 0x%llx translated to 0", ipa);
+				err = -EINVAL;
+				goto done;
+			}
+			chunk = min(pa_len, remaining);
+
+			if ((last != NULL) &&
+			    (nvgpu_safe_add_u64(last->pa, last->length) == pa)) {
+				last->length = nvgpu_safe_add_u64(last->length,
+						chunk);
+			} else if (n < max_ranges) {
+				last = &ranges[n];
+				last->pa = pa;
+				last->length = chunk;
+				n++;
+			} else {
+				err = -ENOSPC;
+				goto done;
+			}
+
+			ipa = nvgpu_safe_add_u64(ipa, chunk);
+			remaining -= chunk;
+		}
+	}
+
+done:
+	*num_ranges = n;
+	return err;
+}
+
 u64 nvgpu_sgt_get_dma(struct nvgpu_sgt *sgt, void *sgl)
 {
 	return sgt->ops->sgl_dma(sgl);
@@ -32,6 +32,7 @@
 #include <nvgpu/string.h>
 #include <nvgpu/netlist_defs.h>
 #include <nvgpu/static_analysis.h>
+#include <nvgpu/timers.h>
 
 #include "netlist_priv.h"
 
@@ -79,18 +80,70 @@ u32 *nvgpu_netlist_alloc_u32_list(struct gk20a *g,
 	return u32l->l;
 }
 
+/*
+ * Point a list at the region data in the retained netlist image. The data is
+ * copied into a zero padded buffer only when the region is misaligned for the
+ * list elements or too short to hold all @count elements.
+ */
+static void *nvgpu_netlist_map_list(struct gk20a *g, u8 *src, u32 len,
+			u32 count, size_t elem_size)
+{
+	struct nvgpu_netlist_vars *netlist_vars = g->netlist_vars;
+	u64 size = nvgpu_safe_mult_u64(count, elem_size);
+	u8 *l;
+
+	if ((((uintptr_t)src % sizeof(u32)) == 0UL) && (size <= len)) {
+		netlist_vars->stats.bytes_saved =
+			nvgpu_safe_add_u64(netlist_vars->stats.bytes_saved,
+					size);
+		return src;
+	}
+
+	l = nvgpu_kzalloc(g, size);
+	if (l == NULL) {
+		return NULL;
+	}
+
+	size = (size < len) ? size : len;
+	nvgpu_memcpy(l, src, size);
+	netlist_vars->stats.bytes_copied =
+		nvgpu_safe_add_u64(netlist_vars->stats.bytes_copied, size);
+
+	return l;
+}
+
+static bool nvgpu_netlist_list_is_view(struct gk20a *g, const void *l)
+{
+	struct nvgpu_firmware *fw = g->netlist_vars->fw;
+	uintptr_t start, addr = (uintptr_t)l;
+
+	if (fw == NULL) {
+		return false;
+	}
+
+	start = (uintptr_t)fw->data;
+	return (addr >= start) && ((addr - start) < fw->size);
+}
+
+static void nvgpu_netlist_kfree(struct gk20a *g, void *l)
+{
+	if (!nvgpu_netlist_list_is_view(g, l)) {
+		nvgpu_kfree(g, l);
+	}
+}
+
 static int nvgpu_netlist_alloc_load_u32_list(struct gk20a *g, u8 *src, u32 len,
 			struct netlist_u32_list *u32_list)
 {
 	u32_list->count = nvgpu_safe_add_u32(len,
 				nvgpu_safe_cast_u64_to_u32(sizeof(u32) - 1UL))
 							/ U32(sizeof(u32));
-	if (nvgpu_netlist_alloc_u32_list(g, u32_list) == NULL) {
+	u32_list->l = nvgpu_netlist_map_list(g, src, len, u32_list->count,
+				sizeof(*u32_list->l));
+	if (u32_list->l == NULL) {
 		return -ENOMEM;
 	}
 
-	nvgpu_memcpy((u8 *)u32_list->l, src, len);
-
 	return 0;
 }
 
@@ -98,12 +151,12 @@ static int nvgpu_netlist_alloc_load_av_list(struct gk20a *g, u8 *src, u32 len,
 			struct netlist_av_list *av_list)
 {
 	av_list->count = len / U32(sizeof(struct netlist_av));
-	if (nvgpu_netlist_alloc_av_list(g, av_list) == NULL) {
+	av_list->l = nvgpu_netlist_map_list(g, src, len, av_list->count,
+				sizeof(*av_list->l));
+	if (av_list->l == NULL) {
 		return -ENOMEM;
 	}
 
-	nvgpu_memcpy((u8 *)av_list->l, src, len);
-
 	return 0;
 }
 
@@ -111,12 +164,12 @@ static int nvgpu_netlist_alloc_load_av_list64(struct gk20a *g, u8 *src, u32 len,
 			struct netlist_av64_list *av64_list)
 {
 	av64_list->count = len / U32(sizeof(struct netlist_av64));
-	if (nvgpu_netlist_alloc_av64_list(g, av64_list) == NULL) {
+	av64_list->l = nvgpu_netlist_map_list(g, src, len, av64_list->count,
+				sizeof(*av64_list->l));
+	if (av64_list->l == NULL) {
 		return -ENOMEM;
 	}
 
-	nvgpu_memcpy((u8 *)av64_list->l, src, len);
-
 	return 0;
 }
 
@@ -124,12 +177,12 @@ static int nvgpu_netlist_alloc_load_aiv_list(struct gk20a *g, u8 *src, u32 len,
 			struct netlist_aiv_list *aiv_list)
 {
 	aiv_list->count = len / U32(sizeof(struct netlist_aiv));
-	if (nvgpu_netlist_alloc_aiv_list(g, aiv_list) == NULL) {
+	aiv_list->l = nvgpu_netlist_map_list(g, src, len, aiv_list->count,
+				sizeof(*aiv_list->l));
+	if (aiv_list->l == NULL) {
 		return -ENOMEM;
 	}
 
-	nvgpu_memcpy((u8 *)aiv_list->l, src, len);
-
 	return 0;
 }
 
@@ -563,6 +616,113 @@ clean_up:
 	return err;
 }
 
+/*
+ * Free a list unless it is a view into the netlist image, and forget it.
+ * A candidate image that is rejected does not necessarily have the same
+ * regions as the next one, so no stale view or count may be left behind.
+ */
+#define NETLIST_RELEASE_LIST(g, list)				\
+	do {							\
+		nvgpu_netlist_kfree((g), (list).l);		\
+		(list).l = NULL;				\
+		(list).count = 0U;				\
+	} while (false)
+
+static void nvgpu_netlist_free_lists(struct gk20a *g,
+			struct nvgpu_netlist_vars *netlist_vars)
+{
+	NETLIST_RELEASE_LIST(g, netlist_vars->ucode.fecs.inst);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ucode.fecs.data);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ucode.gpccs.inst);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ucode.gpccs.data);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_bundle_init);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_bundle64_init);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_veid_bundle_init);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_method_init);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_ctx_load);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_non_ctx_load);
+#if defined(CONFIG_NVGPU_NON_FUSA)
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_non_ctx_local_compute_load);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_non_ctx_global_compute_load);
+#ifdef CONFIG_NVGPU_GRAPHICS
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_non_ctx_local_gfx_load);
+	NETLIST_RELEASE_LIST(g, netlist_vars->sw_non_ctx_global_gfx_load);
+#endif
+#endif
+#ifdef CONFIG_NVGPU_DEBUGGER
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.sys);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.gpc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.tpc);
+#ifdef CONFIG_NVGPU_GRAPHICS
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.zcull_gpc);
+#endif
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.ppc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_sys);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_gpc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_tpc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_ppc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_sys);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.fbp);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_gpc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.fbp_router);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.gpc_router);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_ltc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_fbpa);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_sys_router);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_pma);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_rop);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_ucgpc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.etpc);
+#if defined(CONFIG_NVGPU_NON_FUSA)
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.sys_compute);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.gpc_compute);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.tpc_compute);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.ppc_compute);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.etpc_compute);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.lts_bc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.lts_uc);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.sys_gfx);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.gpc_gfx);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.tpc_gfx);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.ppc_gfx);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.etpc_gfx);
+#endif
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.pm_cau);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_sys_control);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_fbp_control);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_gpc_control);
+	NETLIST_RELEASE_LIST(g, netlist_vars->ctxsw_regs.perf_pma_control);
+#endif /* CONFIG_NVGPU_DEBUGGER */
+
+	if (netlist_vars->fw != NULL) {
+		nvgpu_release_firmware(g, netlist_vars->fw);
+		netlist_vars->fw = NULL;
+	}
+}
+
+static bool nvgpu_netlist_header_is_valid(struct nvgpu_firmware *fw)
+{
+	struct netlist_image *netlist = (struct netlist_image *)(uintptr_t)
+							fw->data;
+	u64 size = sizeof(struct netlist_image_header);
+
+	if ((fw->size < size) || (((uintptr_t)fw->data % sizeof(u32)) != 0UL)) {
+		return false;
+	}
+
+	size = nvgpu_safe_add_u64(size, nvgpu_safe_mult_u64(
+			netlist->header.regions, sizeof(struct netlist_region)));
+	return size <= fw->size;
+}
+
+static bool nvgpu_netlist_region_is_valid(struct nvgpu_firmware *fw,
+			struct netlist_region *region)
+{
+	u64 end = nvgpu_safe_add_u64(region->data_offset, region->data_size);
+
+	return end <= fw->size;
+}
+
 static bool nvgpu_netlist_is_valid(int net, u32 major_v, u32 major_v_hw)
 {
 	if ((net != NETLIST_FINAL) && (major_v != major_v_hw)) {
@@ -571,6 +731,34 @@ static bool nvgpu_netlist_is_valid(int net, u32 major_v, u32 major_v_hw)
 	return true;
 }
 
+/*
+ * The register init lists are written with nvgpu_writel_batch(), which does
+ * not check individual entries. Check them once here instead.
+ */
+static bool nvgpu_netlist_reg_lists_are_valid(struct gk20a *g,
+		struct nvgpu_netlist_vars *netlist_vars)
+{
+	struct nvgpu_reg_batch non_ctx = {
+		.table = (const u32 *)(const void *)
+				netlist_vars->sw_non_ctx_load.l,
+		.count = netlist_vars->sw_non_ctx_load.count,
+		.stride = (u32)(sizeof(struct netlist_av) / sizeof(u32)),
+		.value = (u32)(offsetof(struct netlist_av, value) /
+				sizeof(u32)),
+	};
+	struct nvgpu_reg_batch ctx = {
+		.table = (const u32 *)(const void *)
+				netlist_vars->sw_ctx_load.l,
+		.count = netlist_vars->sw_ctx_load.count,
+		.stride = (u32)(sizeof(struct netlist_aiv) / sizeof(u32)),
+		.value = (u32)(offsetof(struct netlist_aiv, value) /
+				sizeof(u32)),
+	};
+
+	return (nvgpu_reg_batch_validate(g, &non_ctx) == 0) &&
+		(nvgpu_reg_batch_validate(g, &ctx) == 0);
+}
+
 static int nvgpu_netlist_init_ctx_vars_fw(struct gk20a *g)
 {
 	struct nvgpu_netlist_vars *netlist_vars = g->netlist_vars;
@@ -579,6 +767,7 @@ static int nvgpu_netlist_init_ctx_vars_fw(struct gk20a *g)
 	char name[MAX_NETLIST_NAME];
 	u32 i, major_v = ~U32(0U), major_v_hw, netlist_num;
 	int net, max_netlist_num, err = -ENOENT;
+	s64 start_ns;
 
 	nvgpu_log_fn(g, " ");
 
@@ -601,18 +790,36 @@ static int nvgpu_netlist_init_ctx_vars_fw(struct gk20a *g)
 			continue;
 		}
 
-		netlist_fw = nvgpu_request_firmware(g, name, 0);
+		netlist_fw = nvgpu_request_firmware(g, name,
+				NVGPU_REQUEST_FIRMWARE_READ_ONLY);
 		if (netlist_fw == NULL) {
 			nvgpu_warn(g, "failed to load netlist %s", name);
 			continue;
 		}
 
+		/* Lists are views into the image, keep it until deinit. */
+		netlist_vars->fw = netlist_fw;
+		(void) memset(&netlist_vars->stats, 0,
+				sizeof(netlist_vars->stats));
+		start_ns = nvgpu_current_time_ns();
+
 		netlist = (struct netlist_image *)(uintptr_t)netlist_fw->data;
+		if (!nvgpu_netlist_header_is_valid(netlist_fw)) {
+			nvgpu_err(g, "corrupt netlist %s", name);
+			goto clean_up;
+		}
 
 		for (i = 0; i < netlist->header.regions; i++) {
 			u8 *src = ((u8 *)netlist + netlist->regions[i].data_offset);
 			u32 size = netlist->regions[i].data_size;
 
+			if (!nvgpu_netlist_region_is_valid(netlist_fw,
+					&netlist->regions[i])) {
+				nvgpu_err(g, "netlist %s region %u out of bounds",
+					name, netlist->regions[i].region_id);
+				goto clean_up;
+			}
+
 			 err = nvgpu_netlist_handle_region_id(g,
 					netlist->regions[i].region_id,
 					src, size, &major_v, &netlist_num,
@@ -622,83 +829,35 @@ static int nvgpu_netlist_init_ctx_vars_fw(struct gk20a *g)
 			}
 		}
 
+		netlist_vars->stats.regions = netlist->header.regions;
+		netlist_vars->stats.parse_ns = nvgpu_safe_cast_s64_to_u64(
+			nvgpu_safe_sub_s64(nvgpu_current_time_ns(), start_ns));
+
 		if (!nvgpu_netlist_is_valid(net, major_v, major_v_hw)) {
 			nvgpu_log_info(g, "skip %s: major_v 0x%08x doesn't match hw 0x%08x",
 				name, major_v, major_v_hw);
 			goto clean_up;
 		}
 
+		if (!nvgpu_netlist_reg_lists_are_valid(g, netlist_vars)) {
+			nvgpu_err(g, "netlist %s: invalid register list", name);
+			goto clean_up;
+		}
+
 		g->netlist_valid = true;
 
-		nvgpu_release_firmware(g, netlist_fw);
+		nvgpu_log_info(g, "netlist %s: %u regions in %llu ns, "
+			"%llu bytes in place, %llu bytes copied", name,
+			netlist_vars->stats.regions,
+			netlist_vars->stats.parse_ns,
+			netlist_vars->stats.bytes_saved,
+			netlist_vars->stats.bytes_copied);
 		nvgpu_log_fn(g, "done");
 		goto done;
 
 clean_up:
 		g->netlist_valid = false;
-		nvgpu_kfree(g, netlist_vars->ucode.fecs.inst.l);
-		nvgpu_kfree(g, netlist_vars->ucode.fecs.data.l);
-		nvgpu_kfree(g, netlist_vars->ucode.gpccs.inst.l);
-		nvgpu_kfree(g, netlist_vars->ucode.gpccs.data.l);
-		nvgpu_kfree(g, netlist_vars->sw_bundle_init.l);
-		nvgpu_kfree(g, netlist_vars->sw_bundle64_init.l);
-		nvgpu_kfree(g, netlist_vars->sw_veid_bundle_init.l);
-		nvgpu_kfree(g, netlist_vars->sw_method_init.l);
-		nvgpu_kfree(g, netlist_vars->sw_ctx_load.l);
-		nvgpu_kfree(g, netlist_vars->sw_non_ctx_load.l);
-#if defined(CONFIG_NVGPU_NON_FUSA)
-		nvgpu_kfree(g, netlist_vars->sw_non_ctx_local_compute_load.l);
-		nvgpu_kfree(g, netlist_vars->sw_non_ctx_global_compute_load.l);
-#ifdef CONFIG_NVGPU_GRAPHICS
-		nvgpu_kfree(g, netlist_vars->sw_non_ctx_local_gfx_load.l);
-		nvgpu_kfree(g, netlist_vars->sw_non_ctx_global_gfx_load.l);
-#endif
-#endif
-#ifdef CONFIG_NVGPU_DEBUGGER
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.sys.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.tpc.l);
-#ifdef CONFIG_NVGPU_GRAPHICS
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.zcull_gpc.l);
-#endif
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.ppc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_sys.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_gpc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_tpc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_ppc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_sys.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.fbp.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_gpc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.fbp_router.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc_router.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_ltc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_fbpa.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_sys_router.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_pma.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_rop.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_ucgpc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.etpc.l);
-#if defined(CONFIG_NVGPU_NON_FUSA)
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.sys_compute.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc_compute.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.tpc_compute.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.ppc_compute.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.etpc_compute.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.lts_bc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.lts_uc.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.sys_gfx.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc_gfx.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.tpc_gfx.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.ppc_gfx.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.etpc_gfx.l);
-#endif
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_cau.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_sys_control.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_fbp_control.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_gpc_control.l);
-		nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_pma_control.l);
-#endif /* CONFIG_NVGPU_DEBUGGER */
-		nvgpu_release_firmware(g, netlist_fw);
+		nvgpu_netlist_free_lists(g, netlist_vars);
 		err = -ENOENT;
 	}
 
@@ -755,74 +914,17 @@ void nvgpu_netlist_deinit_ctx_vars(struct gk20a *g)
 	}
 
 	g->netlist_valid = false;
-	nvgpu_kfree(g, netlist_vars->ucode.fecs.inst.l);
-	nvgpu_kfree(g, netlist_vars->ucode.fecs.data.l);
-	nvgpu_kfree(g, netlist_vars->ucode.gpccs.inst.l);
-	nvgpu_kfree(g, netlist_vars->ucode.gpccs.data.l);
-	nvgpu_kfree(g, netlist_vars->sw_bundle_init.l);
-	nvgpu_kfree(g, netlist_vars->sw_bundle64_init.l);
-	nvgpu_kfree(g, netlist_vars->sw_veid_bundle_init.l);
-	nvgpu_kfree(g, netlist_vars->sw_method_init.l);
-	nvgpu_kfree(g, netlist_vars->sw_ctx_load.l);
-	nvgpu_kfree(g, netlist_vars->sw_non_ctx_load.l);
-#if defined(CONFIG_NVGPU_NON_FUSA)
-	nvgpu_kfree(g, netlist_vars->sw_non_ctx_local_compute_load.l);
-	nvgpu_kfree(g, netlist_vars->sw_non_ctx_global_compute_load.l);
-#ifdef CONFIG_NVGPU_GRAPHICS
-	nvgpu_kfree(g, netlist_vars->sw_non_ctx_local_gfx_load.l);
-	nvgpu_kfree(g, netlist_vars->sw_non_ctx_global_gfx_load.l);
-#endif
-#endif
-#ifdef CONFIG_NVGPU_DEBUGGER
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.sys.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.tpc.l);
-#ifdef CONFIG_NVGPU_GRAPHICS
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.zcull_gpc.l);
-#endif
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.ppc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_sys.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_gpc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_tpc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_ppc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_sys.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.fbp.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_gpc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.fbp_router.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc_router.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_ltc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_fbpa.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_sys_router.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_pma.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_rop.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_ucgpc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.etpc.l);
-
-#if defined(CONFIG_NVGPU_NON_FUSA)
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.sys_compute.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc_compute.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.tpc_compute.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.ppc_compute.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.etpc_compute.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.lts_bc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.lts_uc.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.sys_gfx.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.gpc_gfx.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.tpc_gfx.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.ppc_gfx.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.etpc_gfx.l);
-#endif
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.pm_cau.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_sys_control.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_fbp_control.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_gpc_control.l);
-	nvgpu_kfree(g, netlist_vars->ctxsw_regs.perf_pma_control.l);
-#endif /* CONFIG_NVGPU_DEBUGGER */
-
+	nvgpu_netlist_free_lists(g, netlist_vars);
 	nvgpu_kfree(g, netlist_vars);
 	g->netlist_vars = NULL;
 }
 
+void nvgpu_netlist_get_stats(struct gk20a *g,
+			struct nvgpu_netlist_stats *stats)
+{
+	*stats = g->netlist_vars->stats;
+}
+
 struct netlist_av_list *nvgpu_netlist_get_sw_non_ctx_load_av_list(
 							struct gk20a *g)
 {
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -24,7 +24,9 @@
 #define NVGPU_NETLIST_PRIV_H
 
 #include <nvgpu/types.h>
+#include <nvgpu/netlist.h>
 
+struct nvgpu_firmware;
 struct netlist_u32_list;
 struct netlist_av_list;
 struct netlist_av64_list;
@@ -126,6 +128,13 @@ struct netlist_gr_ucode {
 struct nvgpu_netlist_vars {
 	bool dynamic;
 
+	/*
+	 * Netlist image the lists below point into. Held until the lists are
+	 * freed; only lists copied out of misaligned regions own their memory.
+	 */
+	struct nvgpu_firmware *fw;
+	struct nvgpu_netlist_stats stats;
+
 	u32 regs_base_index;
 	u32 buffer_size;
 
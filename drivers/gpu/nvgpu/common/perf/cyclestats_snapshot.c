@@ -206,6 +206,100 @@ nvgpu_css_gr_search_client(struct nvgpu_list_node *clients, u32 perfmon)
 	return NULL;
 }
 
+/* bind or unbind the perfmon ids of a client in the owner table */
+static void css_gr_bind_client(struct gk20a_cs_snapshot *data,
+				struct gk20a_cs_snapshot_client *client,
+				bool bind)
+{
+	u32 i;
+
+	if (client->perfmon_count == 0U ||
+	    client->perfmon_start >= CSS_MAX_PERFMON_IDS ||
+	    client->perfmon_count >
+			CSS_MAX_PERFMON_IDS - client->perfmon_start) {
+		return;
+	}
+
+	for (i = client->perfmon_start;
+	     i < client->perfmon_start + client->perfmon_count; i++) {
+		if (bind) {
+			data->perfmon_clients[i] = client;
+		} else if (data->perfmon_clients[i] == client) {
+			data->perfmon_clients[i] = NULL;
+		}
+	}
+}
+
+/* check that fifo offset points to an entry inside of the client buffer */
+static bool css_gr_fifo_offset_valid(struct gk20a_cs_snapshot_fifo *dst,
+				u32 offs)
+{
+	return offs >= dst->start && offs < dst->end &&
+		((offs - dst->start) %
+			U32(sizeof(struct gk20a_cs_snapshot_fifo_entry))) == 0U;
+}
+
+/*
+ * Copy a run of count entries which belong to the same client and are
+ * contiguous in the HW buffer. The client fifo may wrap, so at most two
+ * copies are needed. Entries which do not fit are dropped and accounted
+ * as software overflows. Returns the number of copied entries.
+ */
+static u32 css_gr_copy_run(struct gk20a *g,
+			struct gk20a_cs_snapshot_client *cur,
+			const struct gk20a_cs_snapshot_fifo_entry *src,
+			u32 count)
+{
+	struct gk20a_cs_snapshot_fifo *dst = cur->snapshot;
+	struct gk20a_cs_snapshot_fifo_entry *head;
+	const u32 esize = U32(sizeof(*src));
+	u32 size, put, get, avail, n, first;
+
+	size = (dst->end - dst->start) / esize;
+	put = dst->put;
+	get = dst->get;
+
+	if (dst->end <= dst->start || size < 2U ||
+	    !css_gr_fifo_offset_valid(dst, put)) {
+		avail = 0U;
+	} else {
+		put = (put - dst->start) / esize;
+		/* one entry is kept unused to tell full from empty */
+		if (css_gr_fifo_offset_valid(dst, get)) {
+			get = (get - dst->start) / esize;
+			avail = (get + size - put - 1U) % size;
+		} else {
+			avail = size - 1U;
+		}
+	}
+
+	n = min(count, avail);
+	if (n > 0U) {
+		head = CSS_FIFO_ENTRY(dst, dst->start);
+		first = min(n, size - put);
+
+		nvgpu_memcpy((u8 *)(head + put), (const u8 *)src,
+				(size_t)first * esize);
+		if (n > first) {
+			nvgpu_memcpy((u8 *)head, (const u8 *)(src + first),
+					(size_t)(n - first) * esize);
+		}
+
+		/* entries must be visible before the client sees new put */
+		nvgpu_wmb();
+		dst->put = dst->start + ((put + n) % size) * esize;
+	}
+
+	if (n < count) {
+		/* no data copy, no pointer updates */
+		dst->sw_overflow_events_occured += count - n;
+		nvgpu_warn(g, "cyclestats: perfmon %u soft overflow, %u dropped",
+						src->perfmon_id, count - n);
+	}
+
+	return n;
+}
+
 static int css_gr_flush_snapshots(struct nvgpu_channel *ch)
 {
 	struct gk20a *g = ch->g;
@@ -217,17 +311,9 @@ static int css_gr_flush_snapshots(struct nvgpu_channel *ch)
 
 	/* variables for iterating over HW entries */
 	u32 sid;
+	u32 run;
 	struct gk20a_cs_snapshot_fifo_entry *src;
 
-	/* due to data sharing with userspace we allowed update only */
-	/* overflows and put field in the fifo header                */
-	struct gk20a_cs_snapshot_fifo *dst;
-	struct gk20a_cs_snapshot_fifo_entry *dst_get;
-	struct gk20a_cs_snapshot_fifo_entry *dst_put;
-	struct gk20a_cs_snapshot_fifo_entry *dst_nxt;
-	struct gk20a_cs_snapshot_fifo_entry *dst_head;
-	struct gk20a_cs_snapshot_fifo_entry *dst_tail;
-
 	if (!css) {
 		return -EINVAL;
 	}
@@ -249,7 +335,9 @@ static int css_gr_flush_snapshots(struct nvgpu_channel *ch)
 	if (hw_overflow) {
 		nvgpu_list_for_each_entry(cur, &css->clients,
 				gk20a_cs_snapshot_client, list) {
-			cur->snapshot->hw_overflow_events_occured++;
+			if (cur->snapshot) {
+				cur->snapshot->hw_overflow_events_occured++;
+			}
 		}
 
 		nvgpu_warn(g, "cyclestats: hardware overflow detected");
@@ -258,82 +346,36 @@ static int css_gr_flush_snapshots(struct nvgpu_channel *ch)
 	/* process all items in HW buffer */
 	sid = 0;
 	completed = 0;
-	cur = NULL;
-	dst = NULL;
-	dst_put = NULL;
 	src = css->hw_get;
 
-	/* proceed all completed records */
+	/* proceed all completed records, one client run at a time */
 	while (sid < pending && 0 == src->zero0) {
-		/* we may have a new perfmon_id which required to */
-		/* switch to a new client -> let's forget current */
-		if (cur && !CONTAINS_PERFMON(cur, src->perfmon_id)) {
-			s64 tmp_ptr = (char *)dst_put - (char *)dst;
-
-			nvgpu_assert(tmp_ptr < (s64)U32_MAX);
-			dst->put = U32(tmp_ptr);
-			dst = NULL;
-			cur = NULL;
-		}
-
-		/* now we have to select a new current client         */
-		/* the client selection rate depends from experiment  */
-		/* activity but on Android usually happened 1-2 times */
-		if (!cur) {
-			cur = nvgpu_css_gr_search_client(&css->clients,
-							src->perfmon_id);
-			if (cur) {
-				/* found - setup all required data */
-				dst = cur->snapshot;
-				dst_get = CSS_FIFO_ENTRY(dst, dst->get);
-				dst_put = CSS_FIFO_ENTRY(dst, dst->put);
-				dst_head = CSS_FIFO_ENTRY(dst, dst->start);
-				dst_tail = CSS_FIFO_ENTRY(dst, dst->end);
-
-				dst_nxt = dst_put + 1;
-				if (dst_nxt == dst_tail) {
-					dst_nxt = dst_head;
-				}
-			} else {
-				/* client not found - skipping this entry */
-				nvgpu_warn(g, "cyclestats: orphaned perfmon %u",
-							src->perfmon_id);
-				goto next_hw_fifo_entry;
-			}
+		cur = css->perfmon_clients[src->perfmon_id];
+
+		/* extend the run while the records are completed, belong */
+		/* to the same client and do not wrap in the HW buffer    */
+		run = 1U;
+		while (sid + run < pending && src + run < css->hw_end &&
+		       0 == src[run].zero0 &&
+		       css->perfmon_clients[src[run].perfmon_id] == cur) {
+			run++;
 		}
 
-		/* check for software overflows */
-		if (dst_nxt == dst_get) {
-			/* no data copy, no pointer updates */
-			dst->sw_overflow_events_occured++;
-			nvgpu_warn(g, "cyclestats: perfmon %u soft overflow",
-							src->perfmon_id);
+		if (cur && cur->snapshot) {
+			completed += css_gr_copy_run(g, cur, src, run);
 		} else {
-			*dst_put = *src;
-			completed++;
-
-			dst_put = dst_nxt++;
-
-			if (dst_nxt == dst_tail) {
-				dst_nxt = dst_head;
-			}
+			/* client not found - skipping these entries */
+			nvgpu_warn(g, "cyclestats: orphaned perfmon %u, %u entries",
+						src->perfmon_id, run);
 		}
 
-next_hw_fifo_entry:
-		sid++;
-		if (++src >= css->hw_end) {
+		sid += run;
+		src += run;
+		if (src >= css->hw_end) {
 			src = css->hw_snapshot;
 		}
 	}
 
-	/* update client put pointer if necessary */
-	if (cur && dst) {
-		s64 tmp_ptr = (char *)dst_put - (char *)dst;
-
-		nvgpu_assert(tmp_ptr < (s64)U32_MAX);
-		dst->put = U32(tmp_ptr);
-	}
-
 	/* re-set HW buffer after processing taking wrapping into account */
 	if (css->hw_get < src) {
 		(void) memset(css->hw_get, 0xff,
@@ -405,6 +447,8 @@ static int css_gr_free_client_data(struct gk20a *g,
 		nvgpu_list_del(&client->list);
 	}
 
+	css_gr_bind_client(data, client, false);
+
 	if (client->perfmon_start && client->perfmon_count
 					&& g->ops.css.release_perfmon_ids) {
 		if (client->perfmon_count != g->ops.css.release_perfmon_ids(data,
@@ -498,6 +542,12 @@ int nvgpu_css_attach(struct nvgpu_channel *ch,
 		goto failed;
 	}
 
+	/*
+	 * perfmon ids are known only now: in virtual case the server assigns
+	 * them while the snapshot buffer gets enabled
+	 */
+	css_gr_bind_client(g->cs_data, cs_client, true);
+
 	if (perfmon_start) {
 		*perfmon_start = cs_client->perfmon_start;
 	}
@@ -31,6 +31,9 @@
 #include <nvgpu/gk20a.h>
 #include <nvgpu/nvgpu_init.h>
 #include <nvgpu/string.h>
+#include <nvgpu/barrier.h>
+#include <nvgpu/lock.h>
+#include <nvgpu/static_analysis.h>
 #include <nvgpu/pmu/seq.h>
 #include <nvgpu/pmu/queue.h>
 #include <nvgpu/pmu/cmd.h>
@@ -565,8 +568,8 @@ int nvgpu_pmu_cmd_post(struct gk20a *g, struct pmu_cmd *cmd,
 		return -EINVAL;
 	}
 
-	err = nvgpu_pmu_seq_acquire(g, pmu->sequences, &seq, callback,
-				    cb_param);
+	err = nvgpu_pmu_seq_acquire(g, pmu->sequences, &seq, cmd->hdr.unit_id,
+				    callback, cb_param);
 	if (err != 0) {
 		return err;
 	}
@@ -637,62 +640,16 @@ exit:
 	return err;
 }
 
-int nvgpu_pmu_rpc_execute(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
-	u16 size_rpc, u16 size_scratch, pmu_callback caller_cb,
-	void *caller_cb_param, bool is_copy_back)
+static int pmu_rpc_cmd_post(struct nvgpu_pmu *pmu,
+	struct nv_pmu_rpc_header *rpc, u16 size_rpc, u16 size_scratch,
+	pmu_callback callback, struct rpc_handler_payload *rpc_payload)
 {
 	struct gk20a *g = pmu->g;
 	struct pmu_cmd cmd;
 	struct pmu_payload payload;
-	struct rpc_handler_payload *rpc_payload = NULL;
-	pmu_callback callback = NULL;
-	void *rpc_buff = NULL;
-	int status = 0;
-
-	if (nvgpu_can_busy(g) == 0) {
-		return 0;
-	}
-
-	if (!nvgpu_pmu_get_fw_ready(g, pmu)) {
-		nvgpu_warn(g, "PMU is not ready to process RPC");
-		status = EINVAL;
-		goto exit;
-	}
-
-	if (caller_cb == NULL) {
-		rpc_payload = nvgpu_kzalloc(g,
-			sizeof(struct rpc_handler_payload) + size_rpc);
-		if (rpc_payload == NULL) {
-			status = ENOMEM;
-			goto exit;
-		}
-
-		rpc_payload->rpc_buff = (u8 *)rpc_payload +
-			sizeof(struct rpc_handler_payload);
-		rpc_payload->is_mem_free_set =
-			is_copy_back ? false : true;
-
-		/* assign default RPC handler*/
-		callback = nvgpu_pmu_rpc_handler;
-	} else {
-		if (caller_cb_param == NULL) {
-			nvgpu_err(g, "Invalid cb param addr");
-			status = EINVAL;
-			goto exit;
-		}
-		rpc_payload = nvgpu_kzalloc(g,
-			sizeof(struct rpc_handler_payload));
-		if (rpc_payload == NULL) {
-			status = ENOMEM;
-			goto exit;
-		}
-		rpc_payload->rpc_buff = caller_cb_param;
-		rpc_payload->is_mem_free_set = true;
-		callback = caller_cb;
-		WARN_ON(is_copy_back);
-	}
+	void *rpc_buff = rpc_payload->rpc_buff;
+	int status;
 
-	rpc_buff = rpc_payload->rpc_buff;
 	(void) memset(&cmd, 0, sizeof(struct pmu_cmd));
 	(void) memset(&payload, 0, sizeof(struct pmu_payload));
 
@@ -712,33 +669,152 @@ int nvgpu_pmu_rpc_execute(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
 	if (status != 0) {
 		nvgpu_err(g, "Failed to execute RPC status=0x%x, func=0x%x",
 				status, rpc->function);
-		goto cleanup;
 	}
 
-	/*
-	 * Option act like blocking call, which waits till RPC request
-	 * executes on PMU & copy back processed data to rpc_buff
-	 * to read data back in nvgpu
-	 */
-	if (is_copy_back) {
-		/* wait till RPC execute in PMU & ACK */
-		if (nvgpu_pmu_wait_fw_ack_status(g, pmu,
-				nvgpu_get_poll_timeout(g),
-				&rpc_payload->complete, 1U) != 0) {
-			nvgpu_err(g, "PMU wait timeout expired.");
-			status = -ETIMEDOUT;
-			goto cleanup;
-		}
-		/* copy back data to caller */
-		nvgpu_memcpy((u8 *)rpc, (u8 *)rpc_buff, size_rpc);
+	return status;
+}
+
+void nvgpu_pmu_rpc_complete(struct gk20a *g,
+	struct rpc_handler_payload *rpc_payload)
+{
+	if (!rpc_payload->pooled) {
+		rpc_payload->complete = true;
+
 		/* free allocated memory */
-		nvgpu_kfree(g, rpc_payload);
+		if (rpc_payload->is_mem_free_set) {
+			nvgpu_kfree(g, rpc_payload);
+		}
+		return;
+	}
+
+	nvgpu_pmu_rpc_pool_complete(g, g->pmu->rpc_pool, rpc_payload);
+}
+
+int nvgpu_pmu_rpc_post(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
+	u16 size_rpc, u16 size_scratch, bool is_copy_back, u64 *fence)
+{
+	struct gk20a *g = pmu->g;
+	struct nvgpu_pmu_rpc_pool *pool = pmu->rpc_pool;
+	struct nvgpu_pmu_rpc_slot *slot;
+	void *rpc_buff = NULL;
+	int status;
+
+	*fence = 0ULL;
+
+	if (nvgpu_can_busy(g) == 0) {
+		return 0;
+	}
+
+	if (!nvgpu_pmu_get_fw_ready(g, pmu) || (pool == NULL)) {
+		nvgpu_warn(g, "PMU is not ready to process RPC");
+		return -EINVAL;
+	}
+
+	if (size_rpc > NVGPU_PMU_RPC_SLAB_SIZE) {
+		rpc_buff = nvgpu_kzalloc(g, size_rpc);
+		if (rpc_buff == NULL) {
+			return -ENOMEM;
+		}
 	}
 
+	slot = nvgpu_pmu_rpc_pool_claim(g, pool);
+	if (slot == NULL) {
+		nvgpu_kfree(g, rpc_buff);
+		return -EBUSY;
+	}
+
+	if (rpc_buff != NULL) {
+		slot->payload.rpc_buff = rpc_buff;
+		slot->payload.free_rpc_buff = true;
+	} else {
+		slot->payload.rpc_buff = slot->buff;
+	}
+	slot->payload.size_rpc = size_rpc;
+	slot->payload.copy_back = is_copy_back ? (void *)rpc : NULL;
+
+	status = pmu_rpc_cmd_post(pmu, rpc, size_rpc, size_scratch,
+			nvgpu_pmu_rpc_handler, &slot->payload);
+	if (status != 0) {
+		/* release the slot, nothing will complete it */
+		slot->payload.copy_back = NULL;
+		nvgpu_pmu_rpc_complete(g, &slot->payload);
+		return status;
+	}
+
+	*fence = slot->fence;
 	return 0;
+}
+
+int nvgpu_pmu_rpc_wait(struct nvgpu_pmu *pmu, u64 fence, u32 timeout_ms)
+{
+	return nvgpu_pmu_rpc_pool_wait(pmu->g, pmu->rpc_pool, fence,
+			timeout_ms);
+}
+
+int nvgpu_pmu_rpc_wait_all(struct nvgpu_pmu *pmu, u32 timeout_ms)
+{
+	return nvgpu_pmu_rpc_pool_wait_all(pmu->g, pmu->rpc_pool, timeout_ms);
+}
+
+static int pmu_rpc_execute_cb(struct nvgpu_pmu *pmu,
+	struct nv_pmu_rpc_header *rpc, u16 size_rpc, u16 size_scratch,
+	pmu_callback caller_cb, void *caller_cb_param)
+{
+	struct gk20a *g = pmu->g;
+	struct rpc_handler_payload *rpc_payload = NULL;
+	int status;
+
+	if (caller_cb_param == NULL) {
+		nvgpu_err(g, "Invalid cb param addr");
+		return -EINVAL;
+	}
+
+	rpc_payload = nvgpu_kzalloc(g, sizeof(struct rpc_handler_payload));
+	if (rpc_payload == NULL) {
+		return -ENOMEM;
+	}
+	rpc_payload->rpc_buff = caller_cb_param;
+	rpc_payload->is_mem_free_set = true;
+
+	status = pmu_rpc_cmd_post(pmu, rpc, size_rpc, size_scratch,
+			caller_cb, rpc_payload);
+	if (status != 0) {
+		nvgpu_kfree(g, rpc_payload);
+	}
 
-cleanup:
-	nvgpu_kfree(g, rpc_payload);
-exit:
 	return status;
 }
+
+int nvgpu_pmu_rpc_execute(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
+	u16 size_rpc, u16 size_scratch, pmu_callback caller_cb,
+	void *caller_cb_param, bool is_copy_back)
+{
+	struct gk20a *g = pmu->g;
+	u64 fence;
+	int status;
+
+	if (caller_cb != NULL) {
+		if (nvgpu_can_busy(g) == 0) {
+			return 0;
+		}
+		if (!nvgpu_pmu_get_fw_ready(g, pmu)) {
+			nvgpu_warn(g, "PMU is not ready to process RPC");
+			return -EINVAL;
+		}
+		WARN_ON(is_copy_back);
+		return pmu_rpc_execute_cb(pmu, rpc, size_rpc, size_scratch,
+				caller_cb, caller_cb_param);
+	}
+
+	status = nvgpu_pmu_rpc_post(pmu, rpc, size_rpc, size_scratch,
+			is_copy_back, &fence);
+	if ((status != 0) || !is_copy_back) {
+		return status;
+	}
+
+	/*
+	 * Option act like blocking call, which waits till RPC request
+	 * executes on PMU & copy back processed data to rpc
+	 */
+	return nvgpu_pmu_rpc_wait(pmu, fence, nvgpu_get_poll_timeout(g));
+}
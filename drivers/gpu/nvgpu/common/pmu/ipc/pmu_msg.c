@@ -33,6 +33,7 @@
 #include <nvgpu/pmu/pmu_pg.h>
 #include <nvgpu/pmu/fw.h>
 #include <nvgpu/pmu/seq.h>
+#include <nvgpu/pmu/cmd.h>
 
 static int pmu_payload_extract(struct nvgpu_pmu *pmu, struct pmu_sequence *seq)
 {
@@ -632,12 +633,7 @@ void nvgpu_pmu_rpc_handler(struct gk20a *g, struct pmu_msg *msg,
 	pmu_rpc_handler(g, msg, rpc, rpc_payload);
 
 exit:
-	rpc_payload->complete = true;
-
-	/* free allocated memory */
-	if (rpc_payload->is_mem_free_set) {
-		nvgpu_kfree(g, rpc_payload);
-	}
+	nvgpu_pmu_rpc_complete(g, rpc_payload);
 }
 
 void pmu_wait_message_cond(struct nvgpu_pmu *pmu, u32 timeout_ms,
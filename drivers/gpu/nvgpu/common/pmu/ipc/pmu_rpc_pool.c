@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/lock.h>
+#include <nvgpu/log.h>
+#include <nvgpu/barrier.h>
+#include <nvgpu/string.h>
+#include <nvgpu/static_analysis.h>
+#include <nvgpu/pmu.h>
+#include <nvgpu/pmu/rpc_pool.h>
+
+void nvgpu_pmu_rpc_pool_complete(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool, struct rpc_handler_payload *payload)
+{
+	nvgpu_mutex_acquire(&pool->lock);
+	if (payload->copy_back != NULL) {
+		nvgpu_memcpy((u8 *)payload->copy_back,
+			(u8 *)payload->rpc_buff, payload->size_rpc);
+		payload->copy_back = NULL;
+	}
+	if (payload->free_rpc_buff) {
+		nvgpu_kfree(g, payload->rpc_buff);
+		payload->rpc_buff = NULL;
+		payload->free_rpc_buff = false;
+	}
+	/* the slot may be reused as soon as it is complete */
+	nvgpu_smp_wmb();
+	payload->complete = true;
+	nvgpu_mutex_release(&pool->lock);
+}
+
+/* Give up on the RPC of a slot, called with the pool lock held. */
+static void pmu_rpc_slot_abandon(struct gk20a *g,
+	struct nvgpu_pmu_rpc_slot *slot)
+{
+	if (!slot->abandoned) {
+		nvgpu_err(g, "PMU RPC fence %llu timed out, slot abandoned",
+			slot->fence);
+	}
+	slot->payload.copy_back = NULL;
+	slot->abandoned = true;
+}
+
+/*
+ * If the RPC which last used the slot is still in flight, wait for it
+ * outside of the lock as the wait may run the PMU ISR, which completes RPCs.
+ *
+ * A slot whose RPC timed out stays owned by the PMU sequence until the RPC
+ * completes, so it is abandoned and its fence is skipped rather than
+ * waited for again. Claiming only fails once every slot is abandoned.
+ */
+struct nvgpu_pmu_rpc_slot *nvgpu_pmu_rpc_pool_claim(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool)
+{
+	struct nvgpu_pmu_rpc_slot *slot;
+	u32 skipped = 0U;
+	u64 fence;
+	int err;
+
+	nvgpu_mutex_acquire(&pool->lock);
+	while (true) {
+		fence = nvgpu_safe_add_u64(pool->last_fence, 1ULL);
+		slot = &pool->slots[fence % NVGPU_PMU_RPC_ASYNC_WINDOW];
+		if ((slot->fence == 0ULL) || slot->payload.complete) {
+			break;
+		}
+
+		if (slot->abandoned) {
+			/* skip the fence, the slot is still in use */
+			pool->last_fence = fence;
+			skipped = nvgpu_safe_add_u32(skipped, 1U);
+			if (skipped >= NVGPU_PMU_RPC_ASYNC_WINDOW) {
+				nvgpu_mutex_release(&pool->lock);
+				nvgpu_err(g, "all RPC slots abandoned");
+				return NULL;
+			}
+			continue;
+		}
+		nvgpu_mutex_release(&pool->lock);
+
+		err = pool->wait_ack(g, nvgpu_get_poll_timeout(g),
+				&slot->payload.complete, 1U);
+
+		nvgpu_mutex_acquire(&pool->lock);
+		if ((err != 0) && !slot->payload.complete) {
+			pmu_rpc_slot_abandon(g, slot);
+		}
+	}
+
+	pool->last_fence = fence;
+	slot->fence = fence;
+	slot->abandoned = false;
+	(void) memset(&slot->payload, 0, sizeof(slot->payload));
+	slot->payload.pooled = true;
+	nvgpu_mutex_release(&pool->lock);
+
+	return slot;
+}
+
+int nvgpu_pmu_rpc_pool_wait(struct gk20a *g, struct nvgpu_pmu_rpc_pool *pool,
+	u64 fence, u32 timeout_ms)
+{
+	struct nvgpu_pmu_rpc_slot *slot;
+	int status;
+
+	if ((fence == 0ULL) || (pool == NULL)) {
+		return 0;
+	}
+
+	slot = &pool->slots[fence % NVGPU_PMU_RPC_ASYNC_WINDOW];
+
+	/*
+	 * The fence completed and its slot was reused, or it was skipped
+	 * because the slot was abandoned by an older fence.
+	 */
+	nvgpu_mutex_acquire(&pool->lock);
+	if ((slot->fence != fence) || slot->payload.complete) {
+		nvgpu_mutex_release(&pool->lock);
+		return 0;
+	}
+	if (slot->abandoned) {
+		nvgpu_mutex_release(&pool->lock);
+		return -ETIMEDOUT;
+	}
+	nvgpu_mutex_release(&pool->lock);
+
+	/*
+	 * If the slot is reused while waiting, this waits for the newer RPC.
+	 * That only delays the return, the slot is only reused once the RPC
+	 * of this fence has completed.
+	 */
+	status = pool->wait_ack(g, timeout_ms, &slot->payload.complete, 1U);
+	if (status == 0) {
+		return 0;
+	}
+
+	nvgpu_mutex_acquire(&pool->lock);
+	if ((slot->fence == fence) && !slot->payload.complete) {
+		/* the caller gives up on the response */
+		pmu_rpc_slot_abandon(g, slot);
+		status = -ETIMEDOUT;
+	} else {
+		status = 0;
+	}
+	nvgpu_mutex_release(&pool->lock);
+
+	return status;
+}
+
+int nvgpu_pmu_rpc_pool_wait_all(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool, u32 timeout_ms)
+{
+	u64 first, last, fence;
+	int status;
+
+	if (pool == NULL) {
+		return 0;
+	}
+
+	nvgpu_mutex_acquire(&pool->lock);
+	last = pool->last_fence;
+	nvgpu_mutex_release(&pool->lock);
+
+	first = (last > NVGPU_PMU_RPC_ASYNC_WINDOW) ?
+		(last - NVGPU_PMU_RPC_ASYNC_WINDOW + 1ULL) : 1ULL;
+
+	for (fence = first; fence <= last; fence++) {
+		status = nvgpu_pmu_rpc_pool_wait(g, pool, fence, timeout_ms);
+		if (status != 0) {
+			return status;
+		}
+	}
+
+	return 0;
+}
+
+void nvgpu_pmu_rpc_pool_sw_setup(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool)
+{
+	u32 i;
+
+	nvgpu_log_fn(g, " ");
+
+	if (pool == NULL) {
+		return;
+	}
+
+	nvgpu_mutex_acquire(&pool->lock);
+	for (i = 0U; i < NVGPU_PMU_RPC_ASYNC_WINDOW; i++) {
+		struct rpc_handler_payload *payload = &pool->slots[i].payload;
+
+		if (payload->free_rpc_buff) {
+			nvgpu_kfree(g, payload->rpc_buff);
+		}
+		(void) memset(payload, 0, sizeof(*payload));
+		payload->pooled = true;
+		payload->complete = true;
+		pool->slots[i].abandoned = false;
+	}
+	nvgpu_mutex_release(&pool->lock);
+}
+
+int nvgpu_pmu_rpc_pool_init(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool **pool_p, nvgpu_pmu_rpc_wait_ack_fn wait_ack)
+{
+	struct nvgpu_pmu_rpc_pool *pool;
+
+	nvgpu_log_fn(g, " ");
+
+	if (*pool_p != NULL) {
+		/* skip alloc/reinit for unrailgate sequence */
+		nvgpu_pmu_dbg(g, "skip RPC pool init for unrailgate sequence");
+		return 0;
+	}
+
+	pool = (struct nvgpu_pmu_rpc_pool *)
+		nvgpu_kzalloc(g, sizeof(struct nvgpu_pmu_rpc_pool));
+	if (pool == NULL) {
+		return -ENOMEM;
+	}
+
+	nvgpu_mutex_init(&pool->lock);
+	pool->wait_ack = wait_ack;
+
+	*pool_p = pool;
+	return 0;
+}
+
+void nvgpu_pmu_rpc_pool_deinit(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool)
+{
+	u32 i;
+
+	nvgpu_log_fn(g, " ");
+
+	if (pool == NULL) {
+		return;
+	}
+
+	for (i = 0U; i < NVGPU_PMU_RPC_ASYNC_WINDOW; i++) {
+		if (pool->slots[i].payload.free_rpc_buff) {
+			nvgpu_kfree(g, pool->slots[i].payload.rpc_buff);
+		}
+	}
+
+	nvgpu_mutex_destroy(&pool->lock);
+	nvgpu_kfree(g, pool);
+}
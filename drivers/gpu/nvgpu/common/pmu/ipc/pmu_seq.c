@@ -21,7 +21,6 @@
  */
 
 #include <nvgpu/pmu/seq.h>
-#include <nvgpu/bitops.h>
 #include <nvgpu/errno.h>
 #include <nvgpu/kmem.h>
 #include <nvgpu/bug.h>
@@ -41,8 +40,7 @@ void nvgpu_pmu_sequences_sw_setup(struct gk20a *g, struct nvgpu_pmu *pmu,
 
 	(void) memset(sequences->seq, 0,
 		sizeof(struct pmu_sequence) * PMU_MAX_NUM_SEQUENCES);
-	(void) memset(sequences->pmu_seq_tbl, 0,
-		sizeof(sequences->pmu_seq_tbl));
+	nvgpu_falcon_seq_alloc_init(&sequences->ids, PMU_MAX_NUM_SEQUENCES);
 
 	for (i = 0; i < PMU_MAX_NUM_SEQUENCES; i++) {
 		sequences->seq[i].id = (u8)i;
@@ -66,7 +64,7 @@ int nvgpu_pmu_sequences_init(struct gk20a *g, struct nvgpu_pmu *pmu,
 	}
 
 	sequences = (struct pmu_sequences *)
-		nvgpu_kzalloc(g, sizeof(struct pmu_sequences));
+		nvgpu_big_zalloc(g, sizeof(struct pmu_sequences));
 	if (sequences == NULL) {
 		err = -ENOMEM;
 		goto exit;
@@ -76,12 +74,10 @@ int nvgpu_pmu_sequences_init(struct gk20a *g, struct nvgpu_pmu *pmu,
 		nvgpu_kzalloc(g, PMU_MAX_NUM_SEQUENCES *
 			sizeof(struct pmu_sequence));
 	if (sequences->seq == NULL) {
-		nvgpu_kfree(g, sequences);
+		nvgpu_big_free(g, sequences);
 		return -ENOMEM;
 	}
 
-	nvgpu_mutex_init(&sequences->pmu_seq_lock);
-
 	*sequences_p = sequences;
 exit:
 	return err;
@@ -98,11 +94,10 @@ void nvgpu_pmu_sequences_deinit(struct gk20a *g, struct nvgpu_pmu *pmu,
 		return;
 	}
 
-	nvgpu_mutex_destroy(&sequences->pmu_seq_lock);
 	if (sequences->seq != NULL) {
 		nvgpu_kfree(g, sequences->seq);
 	}
-	nvgpu_kfree(g, sequences);
+	nvgpu_big_free(g, sequences);
 }
 
 void nvgpu_pmu_seq_payload_free(struct gk20a *g, struct pmu_sequence *seq)
@@ -118,23 +113,17 @@ void nvgpu_pmu_seq_payload_free(struct gk20a *g, struct pmu_sequence *seq)
 
 int nvgpu_pmu_seq_acquire(struct gk20a *g,
 			  struct pmu_sequences *sequences,
-			  struct pmu_sequence **pseq,
+			  struct pmu_sequence **pseq, u8 unit_id,
 			  pmu_callback callback, void *cb_params)
 {
 	struct pmu_sequence *seq;
-	unsigned long index;
+	u32 index;
 
-	nvgpu_mutex_acquire(&sequences->pmu_seq_lock);
-	index = find_first_zero_bit(sequences->pmu_seq_tbl,
-				sizeof(sequences->pmu_seq_tbl));
-	if (index >= sizeof(sequences->pmu_seq_tbl)) {
+	if (nvgpu_falcon_seq_acquire(&sequences->ids, unit_id,
+			&index) != 0) {
 		nvgpu_err(g, "no free sequence available");
-		nvgpu_mutex_release(&sequences->pmu_seq_lock);
 		return -EAGAIN;
 	}
-	nvgpu_assert(index <= U32_MAX);
-	nvgpu_set_bit((u32)index, sequences->pmu_seq_tbl);
-	nvgpu_mutex_release(&sequences->pmu_seq_lock);
 
 	seq = &sequences->seq[index];
 	seq->state = PMU_SEQ_STATE_PENDING;
@@ -152,16 +141,26 @@ void nvgpu_pmu_seq_release(struct gk20a *g,
 			   struct pmu_sequences *sequences,
 			   struct pmu_sequence *seq)
 {
-	(void)g;
+	bool completed = (seq->state == PMU_SEQ_STATE_USED);
+
+	if (seq->state == PMU_SEQ_STATE_FREE) {
+		/* response for a sequence which was never posted */
+		nvgpu_err(g, "release of free sequence %u", (u32)seq->id);
+		return;
+	}
 
 	seq->state	= PMU_SEQ_STATE_FREE;
 	seq->callback	= NULL;
 	seq->cb_params	= NULL;
 	seq->out_payload = NULL;
 
-	nvgpu_mutex_acquire(&sequences->pmu_seq_lock);
-	nvgpu_clear_bit(seq->id, sequences->pmu_seq_tbl);
-	nvgpu_mutex_release(&sequences->pmu_seq_lock);
+	nvgpu_falcon_seq_release(g, &sequences->ids, seq->id, completed);
+}
+
+void nvgpu_pmu_seq_get_latency(struct pmu_sequences *sequences, u8 unit_id,
+				struct nvgpu_swhist_data *data)
+{
+	nvgpu_falcon_seq_get_latency(&sequences->ids, unit_id, data);
 }
 
 u16 nvgpu_pmu_seq_get_fbq_out_offset(struct pmu_sequence *seq)
@@ -259,9 +259,10 @@ int nvgpu_pmu_perf_changeseq_set_clks(struct gk20a *g,
 	change_input.flags = (u32)CTRL_PERF_CHANGE_SEQ_CHANGE_FORCE;
 	change_input.vf_points_cache_counter = 0xFFFFFFFFU;
 
-	status = nvgpu_pmu_perf_vfe_get_freq_margin(g, &fmargin_mhz);
+	status = nvgpu_pmu_perf_vfe_get_margins(g, &fmargin_mhz, &vmargin_uv);
 	if (status != 0) {
-		nvgpu_err(g, "Failed to fetch Fmargin status=0x%x", status);
+		nvgpu_err(g, "Failed to fetch Fmargin/Vmargin status=0x%x",
+			status);
 		return status;
 	}
 
@@ -269,12 +270,6 @@ int nvgpu_pmu_perf_changeseq_set_clks(struct gk20a *g,
 	status = nvgpu_pmu_clk_domain_freq_to_volt(g, gpcclk_domain,
 	&gpcclk_clkmhz, &gpcclk_voltuv, CTRL_VOLT_DOMAIN_LOGIC);
 
-	status = nvgpu_pmu_perf_vfe_get_volt_margin(g, &vmargin_uv);
-	if (status != 0) {
-		nvgpu_err(g, "Failed to fetch Vmargin status=0x%x", status);
-		return status;
-	}
-
 	gpcclk_voltuv += vmargin_uv;
 	status = nvgpu_pmu_volt_get_vmin_vmax_ps35(g, &vmin_uv, &vmax_uv);
 	if (status != 0) {
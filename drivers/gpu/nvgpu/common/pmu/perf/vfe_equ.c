@@ -918,56 +918,65 @@ int perf_vfe_equ_pmu_setup(struct gk20a *g)
 	return status;
 }
 
-int nvgpu_pmu_perf_vfe_get_volt_margin(struct gk20a *g, u32 *vmargin_uv)
+static int vfe_equ_post_eval(struct gk20a *g, u8 equ_idx, u8 output_type,
+	struct nv_pmu_rpc_struct_perf_vfe_eval *rpc)
 {
 	struct nvgpu_pmu *pmu = g->pmu;
-	struct nv_pmu_rpc_struct_perf_vfe_eval rpc;
 	int status = 0;
-	u8 vmargin_idx;
+	u64 fence;
 
-	vmargin_idx = nvgpu_pmu_volt_get_vmargin_ps35(g);
-	if (vmargin_idx == 0U) {
-		return 0;
-	}
-
-	(void) memset(&rpc, 0, sizeof(rpc));
-	rpc.data.equ_idx = vmargin_idx;
-	rpc.data.output_type = CTRL_PERF_VFE_EQU_OUTPUT_TYPE_VOLT_DELTA_UV;
-	rpc.data.var_count = 0U;
-	PMU_RPC_EXECUTE_CPB(status, pmu, PERF, VFE_EQU_EVAL, &rpc, 0);
+	(void) memset(rpc, 0, sizeof(*rpc));
+	rpc->data.equ_idx = equ_idx;
+	rpc->data.output_type = output_type;
+	rpc->data.var_count = 0U;
+	PMU_RPC_POST_CPB(status, pmu, PERF, VFE_EQU_EVAL, rpc, 0, &fence);
 	if (status != 0) {
-		nvgpu_err(g, "Failed to execute RPC status=0x%x",
-			status);
-		return status;
+		nvgpu_err(g, "Failed to post RPC status=0x%x", status);
 	}
 
-	*vmargin_uv = rpc.data.result.voltu_v;
 	return status;
 }
 
-int nvgpu_pmu_perf_vfe_get_freq_margin(struct gk20a *g, u32 *fmargin_mhz)
+int nvgpu_pmu_perf_vfe_get_margins(struct gk20a *g, u32 *fmargin_mhz,
+	u32 *vmargin_uv)
 {
-	struct nvgpu_pmu *pmu = g->pmu;
-	struct nv_pmu_rpc_struct_perf_vfe_eval rpc;
+	struct nv_pmu_rpc_struct_perf_vfe_eval frpc, vrpc;
+	u8 fmargin_idx = nvgpu_pmu_clk_fll_get_fmargin_idx(g);
+	u8 vmargin_idx = nvgpu_pmu_volt_get_vmargin_ps35(g);
 	int status = 0;
-	u8 fmargin_idx;
+	int err;
 
-	fmargin_idx = nvgpu_pmu_clk_fll_get_fmargin_idx(g);
-	if (fmargin_idx == 0U) {
+	if ((fmargin_idx == 0U) && (vmargin_idx == 0U)) {
 		return 0;
 	}
 
-	(void) memset(&rpc, 0, sizeof(rpc));
-	rpc.data.equ_idx = fmargin_idx;
-	rpc.data.output_type = CTRL_PERF_VFE_EQU_OUTPUT_TYPE_FREQ_MHZ;
-	rpc.data.var_count = 0U;
-	PMU_RPC_EXECUTE_CPB(status, pmu, PERF, VFE_EQU_EVAL, &rpc, 0);
+	/* Both equations are evaluated in one round trip to the PMU. */
+	if (fmargin_idx != 0U) {
+		status = vfe_equ_post_eval(g, fmargin_idx,
+				CTRL_PERF_VFE_EQU_OUTPUT_TYPE_FREQ_MHZ, &frpc);
+	}
+	if ((status == 0) && (vmargin_idx != 0U)) {
+		status = vfe_equ_post_eval(g, vmargin_idx,
+				CTRL_PERF_VFE_EQU_OUTPUT_TYPE_VOLT_DELTA_UV,
+				&vrpc);
+	}
+
+	/* The responses are copied back to the stack, always wait. */
+	err = nvgpu_pmu_rpc_wait_all(g->pmu, nvgpu_get_poll_timeout(g));
+	if (err != 0) {
+		nvgpu_err(g, "VFE margin RPCs failed status=0x%x", err);
+		status = (status != 0) ? status : err;
+	}
 	if (status != 0) {
-		nvgpu_err(g, "Failed to execute RPC status=0x%x",
-			status);
 		return status;
 	}
 
-	*fmargin_mhz = rpc.data.result.voltu_v;
-	return status;
+	if (fmargin_idx != 0U) {
+		*fmargin_mhz = frpc.data.result.voltu_v;
+	}
+	if (vmargin_idx != 0U) {
+		*vmargin_uv = vrpc.data.result.voltu_v;
+	}
+
+	return 0;
 }
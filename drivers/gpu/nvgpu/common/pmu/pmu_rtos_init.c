@@ -38,6 +38,7 @@
 
 #include <nvgpu/pmu/mutex.h>
 #include <nvgpu/pmu/seq.h>
+#include <nvgpu/pmu/cmd.h>
 #include <nvgpu/pmu/lsfm.h>
 #include <nvgpu/pmu/super_surface.h>
 #include <nvgpu/pmu/pmu_perfmon.h>
@@ -183,6 +184,7 @@ static void remove_pmu_support(struct nvgpu_pmu *pmu)
 	nvgpu_pmu_pg_deinit(g, pmu, pmu->pg);
 #endif
 	nvgpu_pmu_sequences_deinit(g, pmu, pmu->sequences);
+	nvgpu_pmu_rpc_pool_deinit(g, pmu->rpc_pool);
 	nvgpu_pmu_mutexe_deinit(g, pmu, pmu->mutexes);
 	nvgpu_pmu_fw_deinit(g, pmu, pmu->fw);
 	nvgpu_pmu_deinitialize_perfmon(g, pmu);
@@ -200,6 +202,9 @@ static int pmu_sw_setup(struct gk20a *g, struct nvgpu_pmu *pmu )
 	/* set default value to sequences */
 	nvgpu_pmu_sequences_sw_setup(g, pmu, pmu->sequences);
 
+	/* drop RPCs lost with the previous PMU instance */
+	nvgpu_pmu_rpc_pool_sw_setup(g, pmu->rpc_pool);
+
 #ifdef CONFIG_NVGPU_POWER_PG
 	if (g->can_elpg) {
 		err = nvgpu_pmu_pg_sw_setup(g, pmu, pmu->pg);
@@ -492,6 +497,12 @@ exit:
 	return err;
 }
 
+static int pmu_rpc_wait_ack(struct gk20a *g, u32 timeout_ms, void *var,
+	u8 val)
+{
+	return nvgpu_pmu_wait_fw_ack_status(g, g->pmu, timeout_ms, var, val);
+}
+
 int nvgpu_pmu_rtos_early_init(struct gk20a *g, struct nvgpu_pmu *pmu)
 {
 	int err = 0;
@@ -519,6 +530,12 @@ int nvgpu_pmu_rtos_early_init(struct gk20a *g, struct nvgpu_pmu *pmu)
 		goto init_failed;
 	}
 
+	err = nvgpu_pmu_rpc_pool_init(g, &pmu->rpc_pool,
+			pmu_rpc_wait_ack);
+	if (err != 0) {
+		goto init_failed;
+	}
+
 #ifdef CONFIG_NVGPU_POWER_PG
 	if (g->can_elpg) {
 		err = nvgpu_pmu_pg_init(g, pmu, &pmu->pg);
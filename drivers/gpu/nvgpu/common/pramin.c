@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -27,6 +27,7 @@
 #include <nvgpu/io.h>
 #include <nvgpu/gk20a.h>
 #include <nvgpu/bug.h>
+#include <nvgpu/string.h>
 
 /*
  * This typedef is for functions that get called during the access_batched()
@@ -35,18 +36,55 @@
 typedef void (*pramin_access_batch_fn)(struct gk20a *g, u64 start, u64 words,
 				       u32 **arg);
 
+/*
+ * Return the byte offset of the given sgl offset in the BAR0 window,
+ * reprogramming the window only if it does not already cover the offset.
+ * Called with pramin_window_lock held.
+ */
+static u32 nvgpu_pramin_window(struct gk20a *g, struct nvgpu_mem *mem,
+		struct nvgpu_sgt *sgt, void *sgl, u64 offset)
+{
+	struct mm_gk20a *mm = &g->mm;
+	u64 addr = nvgpu_sgt_get_phys(g, sgt, sgl) + offset;
+	u32 window = mm->pramin_window;
+	u32 byteoff;
+
+	if (mm->pramin_window_valid &&
+	    (mm->pramin_window_aperture == mem->aperture) &&
+	    (addr >= mm->pramin_window_base) &&
+	    ((addr - mm->pramin_window_base) < U64(SZ_1M))) {
+		mm->pramin_stats.hits++;
+		return U32(addr - mm->pramin_window_base);
+	}
+
+	mm->pramin_stats.misses++;
+	byteoff = g->ops.bus.set_bar0_window(g, mem, sgt, sgl,
+				      offset / sizeof(u32));
+	if (mm->pramin_window != window) {
+		mm->pramin_stats.switches++;
+	}
+
+	mm->pramin_window_base = addr - byteoff;
+	mm->pramin_window_aperture = mem->aperture;
+	mm->pramin_window_valid = true;
+
+	return byteoff;
+}
+
 /*
  * The PRAMIN range is 1 MB, must change base addr if a buffer crosses that.
  * This same loop is used for read/write/memset. Offset and size in bytes.
- * One call to "loop" is done per range, with "arg" supplied.
+ * One call to "loop" is done per range, with "arg" supplied. With "sync" the
+ * last register is read back to make sure the writes have landed.
  */
 static void nvgpu_pramin_access_batched(struct gk20a *g, struct nvgpu_mem *mem,
-		u64 offset, u64 size, pramin_access_batch_fn loop, u32 **arg)
+		u64 offset, u64 size, pramin_access_batch_fn loop, u32 **arg,
+		bool sync)
 {
 	struct nvgpu_page_alloc *alloc = NULL;
 	struct nvgpu_sgt *sgt;
 	void *sgl;
-	u64 byteoff, start_reg, until_end, n;
+	u64 byteoff, start_reg = 0ULL, until_end, n;
 
 	/*
 	 * TODO: Vidmem is not accesible through pramin on shutdown path.
@@ -71,15 +109,19 @@ static void nvgpu_pramin_access_batched(struct gk20a *g, struct nvgpu_mem *mem,
 		}
 	}
 
+	/*
+	 * The window is held for the whole access so that chunks of the same
+	 * buffer are not interleaved with other users moving the window.
+	 */
+	nvgpu_mutex_acquire(&g->mm.pramin_window_lock);
+
 	while (size != 0U) {
 		u64 sgl_len;
 
 		BUG_ON(sgl == NULL);
 		sgl_len = nvgpu_sgt_get_length(sgt, sgl);
 
-		nvgpu_mutex_acquire(&g->mm.pramin_window_lock);
-		byteoff = g->ops.bus.set_bar0_window(g, mem, sgt, sgl,
-					      offset / sizeof(u32));
+		byteoff = nvgpu_pramin_window(g, mem, sgt, sgl, offset);
 		start_reg = g->ops.pramin.data032_r(byteoff / sizeof(u32));
 		until_end = U64(SZ_1M) - (byteoff & (U64(SZ_1M) - 1U));
 
@@ -87,11 +129,6 @@ static void nvgpu_pramin_access_batched(struct gk20a *g, struct nvgpu_mem *mem,
 
 		loop(g, start_reg, n / sizeof(u32), arg);
 
-		/* read back to synchronize accesses */
-		(void) gk20a_readl(g, start_reg);
-
-		nvgpu_mutex_release(&g->mm.pramin_window_lock);
-
 		size -= n;
 
 		if (n == (sgl_len - offset)) {
@@ -101,6 +138,16 @@ static void nvgpu_pramin_access_batched(struct gk20a *g, struct nvgpu_mem *mem,
 			offset += n;
 		}
 	}
+
+	/*
+	 * Read back to synchronize accesses. Window updates are ordered
+	 * behind the earlier writes, so one read back at the end is enough.
+	 */
+	if (sync && (start_reg != 0ULL)) {
+		(void) gk20a_readl(g, start_reg);
+	}
+
+	nvgpu_mutex_release(&g->mm.pramin_window_lock);
 }
 
 static void nvgpu_pramin_access_batch_rd_n(struct gk20a *g,
@@ -124,7 +171,7 @@ void nvgpu_pramin_rd_n(struct gk20a *g, struct nvgpu_mem *mem,
 	u32 *dest_u32 = dest;
 
 	return nvgpu_pramin_access_batched(g, mem, start, size,
-			nvgpu_pramin_access_batch_rd_n, &dest_u32);
+			nvgpu_pramin_access_batch_rd_n, &dest_u32, false);
 }
 
 static void nvgpu_pramin_access_batch_wr_n(struct gk20a *g,
@@ -148,7 +195,7 @@ void nvgpu_pramin_wr_n(struct gk20a *g, struct nvgpu_mem *mem,
 	u32 *src_u32 = src;
 
 	return nvgpu_pramin_access_batched(g, mem, start, size,
-			nvgpu_pramin_access_batch_wr_n, &src_u32);
+			nvgpu_pramin_access_batch_wr_n, &src_u32, true);
 }
 
 static void nvgpu_pramin_access_batch_set(struct gk20a *g,
@@ -170,10 +217,21 @@ void nvgpu_pramin_memset(struct gk20a *g, struct nvgpu_mem *mem,
 	u32 *p = &w;
 
 	return nvgpu_pramin_access_batched(g, mem, start, size,
-			nvgpu_pramin_access_batch_set, &p);
+			nvgpu_pramin_access_batch_set, &p, true);
+}
+
+void nvgpu_pramin_get_stats(struct gk20a *g, struct nvgpu_pramin_stats *stats)
+{
+	nvgpu_mutex_acquire(&g->mm.pramin_window_lock);
+	*stats = g->mm.pramin_stats;
+	nvgpu_mutex_release(&g->mm.pramin_window_lock);
 }
+
 void nvgpu_init_pramin(struct mm_gk20a *mm)
 {
 	mm->pramin_window = 0;
+	mm->pramin_window_base = 0ULL;
+	mm->pramin_window_valid = false;
+	(void) memset(&mm->pramin_stats, 0, sizeof(mm->pramin_stats));
 	nvgpu_mutex_init(&mm->pramin_window_lock);
 }
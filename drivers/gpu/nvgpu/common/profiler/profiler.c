@@ -88,6 +88,7 @@ void nvgpu_profiler_free(struct nvgpu_profiler_object *prof)
 
 	nvgpu_profiler_unbind_context(prof);
 	nvgpu_profiler_free_pma_stream(prof);
+	nvgpu_regops_plan_cache_flush(prof);
 
 	nvgpu_list_del(&prof->prof_obj_entry);
 	prof->gpu_instance_id = 0U;
@@ -1054,6 +1055,7 @@ static void nvgpu_profiler_destroy_regops_allowlist(struct nvgpu_profiler_object
 	nvgpu_log(prof->g, gpu_dbg_prof, "Allowlist map destroy for handle %u",
 		prof->prof_handle);
 
+	nvgpu_regops_plan_cache_flush(prof);
 	nvgpu_kfree(prof->g, prof->map);
 }
 
@@ -26,6 +26,7 @@
 #include <nvgpu/bsearch.h>
 #include <nvgpu/bug.h>
 #include <nvgpu/io.h>
+#include <nvgpu/kmem.h>
 #include <nvgpu/gk20a.h>
 #include <nvgpu/regops.h>
 #include <nvgpu/gr/gr_instances.h>
@@ -88,6 +89,87 @@ static bool validate_reg_ops(struct gk20a *g,
 			    bool valid_ctx,
 			    u32 *flags);
 
+static int exec_regop_global(struct gk20a *g, struct nvgpu_dbg_reg_op *op)
+{
+	u32 data32_lo = 0, data32_hi = 0;
+	bool skip_read_lo, skip_read_hi;
+
+	switch (op->op) {
+
+	case REGOP(READ_32):
+		op->value_hi = 0;
+		op->value_lo = gk20a_readl(g, op->offset);
+		nvgpu_log(g, gpu_dbg_gpu_dbg, "read_32 0x%08x from 0x%08x",
+			   op->value_lo, op->offset);
+
+		break;
+
+	case REGOP(READ_64):
+		op->value_lo = gk20a_readl(g, op->offset);
+		op->value_hi =
+			gk20a_readl(g, op->offset + 4U);
+
+		nvgpu_log(g, gpu_dbg_gpu_dbg, "read_64 0x%08x:%08x from 0x%08x",
+			   op->value_hi, op->value_lo,
+			   op->offset);
+	break;
+
+	case REGOP(WRITE_32):
+	case REGOP(WRITE_64):
+		/* some of this appears wonky/unnecessary but
+		   we've kept it for compat with existing
+		   debugger code.  just in case... */
+		skip_read_lo = skip_read_hi = false;
+		if (op->and_n_mask_lo == ~(u32)0) {
+			data32_lo = op->value_lo;
+			skip_read_lo = true;
+		}
+
+		if ((op->op == REGOP(WRITE_64)) &&
+		    (op->and_n_mask_hi == ~(u32)0)) {
+			data32_hi = op->value_hi;
+			skip_read_hi = true;
+		}
+
+		/* read first 32bits */
+		if (skip_read_lo == false) {
+			data32_lo = gk20a_readl(g, op->offset);
+			data32_lo &= ~op->and_n_mask_lo;
+			data32_lo |= op->value_lo;
+		}
+
+		/* if desired, read second 32bits */
+		if ((op->op == REGOP(WRITE_64)) &&
+		    !skip_read_hi) {
+			data32_hi = gk20a_readl(g, op->offset + 4U);
+			data32_hi &= ~op->and_n_mask_hi;
+			data32_hi |= op->value_hi;
+		}
+
+		/* now update first 32bits */
+		gk20a_writel(g, op->offset, data32_lo);
+		nvgpu_log(g, gpu_dbg_gpu_dbg, "Wrote 0x%08x to 0x%08x ",
+			   data32_lo, op->offset);
+		/* if desired, update second 32bits */
+		if (op->op == REGOP(WRITE_64)) {
+			gk20a_writel(g, op->offset + 4U, data32_hi);
+			nvgpu_log(g, gpu_dbg_gpu_dbg, "Wrote 0x%08x to 0x%08x ",
+				   data32_hi, op->offset + 4U);
+
+		}
+
+
+		break;
+
+	/* shouldn't happen as we've already screened */
+	default:
+		BUG();
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 int exec_regops_gk20a(struct gk20a *g,
 		      struct nvgpu_tsg *tsg,
 		      struct nvgpu_dbg_reg_op *ops,
@@ -98,8 +180,6 @@ int exec_regops_gk20a(struct gk20a *g,
 {
 	int err = 0;
 	unsigned int i;
-	u32 data32_lo = 0, data32_hi = 0;
-	bool skip_read_lo, skip_read_hi;
 
 	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gpu_dbg, " ");
 
@@ -126,79 +206,9 @@ int exec_regops_gk20a(struct gk20a *g,
 			continue;
 		}
 
-		switch (ops[i].op) {
-
-		case REGOP(READ_32):
-			ops[i].value_hi = 0;
-			ops[i].value_lo = gk20a_readl(g, ops[i].offset);
-			nvgpu_log(g, gpu_dbg_gpu_dbg, "read_32 0x%08x from 0x%08x",
-				   ops[i].value_lo, ops[i].offset);
-
-			break;
-
-		case REGOP(READ_64):
-			ops[i].value_lo = gk20a_readl(g, ops[i].offset);
-			ops[i].value_hi =
-				gk20a_readl(g, ops[i].offset + 4U);
-
-			nvgpu_log(g, gpu_dbg_gpu_dbg, "read_64 0x%08x:%08x from 0x%08x",
-				   ops[i].value_hi, ops[i].value_lo,
-				   ops[i].offset);
-		break;
-
-		case REGOP(WRITE_32):
-		case REGOP(WRITE_64):
-			/* some of this appears wonky/unnecessary but
-			   we've kept it for compat with existing
-			   debugger code.  just in case... */
-			skip_read_lo = skip_read_hi = false;
-			if (ops[i].and_n_mask_lo == ~(u32)0) {
-				data32_lo = ops[i].value_lo;
-				skip_read_lo = true;
-			}
-
-			if ((ops[i].op == REGOP(WRITE_64)) &&
-			    (ops[i].and_n_mask_hi == ~(u32)0)) {
-				data32_hi = ops[i].value_hi;
-				skip_read_hi = true;
-			}
-
-			/* read first 32bits */
-			if (skip_read_lo == false) {
-				data32_lo = gk20a_readl(g, ops[i].offset);
-				data32_lo &= ~ops[i].and_n_mask_lo;
-				data32_lo |= ops[i].value_lo;
-			}
-
-			/* if desired, read second 32bits */
-			if ((ops[i].op == REGOP(WRITE_64)) &&
-			    !skip_read_hi) {
-				data32_hi = gk20a_readl(g, ops[i].offset + 4U);
-				data32_hi &= ~ops[i].and_n_mask_hi;
-				data32_hi |= ops[i].value_hi;
-			}
-
-			/* now update first 32bits */
-			gk20a_writel(g, ops[i].offset, data32_lo);
-			nvgpu_log(g, gpu_dbg_gpu_dbg, "Wrote 0x%08x to 0x%08x ",
-				   data32_lo, ops[i].offset);
-			/* if desired, update second 32bits */
-			if (ops[i].op == REGOP(WRITE_64)) {
-				gk20a_writel(g, ops[i].offset + 4U, data32_hi);
-				nvgpu_log(g, gpu_dbg_gpu_dbg, "Wrote 0x%08x to 0x%08x ",
-					   data32_hi, ops[i].offset + 4U);
-
-			}
-
-
-			break;
-
-		/* shouldn't happen as we've already screened */
-		default:
-			BUG();
-			err = -EINVAL;
+		err = exec_regop_global(g, &ops[i]);
+		if (err != 0) {
 			goto clean_up;
-			break;
 		}
 	}
 
@@ -405,6 +415,328 @@ static int translate_regops_without_profiler(struct gk20a *g,
 
 #endif /* CONFIG_NVGPU_MIG */
 
+/*
+ * One op of a plan: the op as submitted, used to match later submissions,
+ * and the result of validating it.
+ */
+struct nvgpu_regops_plan_op {
+	u32 offset;
+	u32 group_mask;
+	u32 sub_group_mask;
+	u8 op;
+	u8 type;
+	u8 quad;
+
+	/* Offset, type and status after validation and translation */
+	u8 status;
+	u8 xlat_type;
+	u32 xlat_offset;
+};
+
+/*
+ * Global ops executed together: either a single op or a run of READ_32 ops
+ * at consecutive offsets.
+ */
+struct nvgpu_regops_plan_step {
+	u32 first;
+	u32 count;
+};
+
+struct nvgpu_regops_plan {
+	u64 hash;
+	u32 num_ops;
+	/* NVGPU_REG_OP_FLAG_MODE_* flags the ops were validated with */
+	u32 mode;
+	/* Flags set by validation, i.e. NVGPU_REG_OP_FLAG_ALL_PASSED */
+	u32 result_flags;
+	bool valid_ctx;
+	bool allow_all;
+	u32 ctx_rd_count;
+	u32 ctx_wr_count;
+	u32 num_steps;
+	struct nvgpu_regops_plan_step *steps;
+	struct nvgpu_regops_plan_op *ops;
+};
+
+#define REGOPS_PLAN_MODE_MASK	(NVGPU_REG_OP_FLAG_MODE_ALL_OR_NONE | \
+				 NVGPU_REG_OP_FLAG_MODE_CONTINUE_ON_ERROR)
+
+static inline u64 regops_plan_hash_u32(u64 hash, u32 v)
+{
+	/* FNV-1a, one 32-bit word at a time */
+	return (hash ^ (u64)v) * 0x100000001b3ULL;
+}
+
+static u64 regops_plan_hash(struct nvgpu_dbg_reg_op *ops, u32 num_ops)
+{
+	u64 hash = 0xcbf29ce484222325ULL;
+	u32 i;
+
+	for (i = 0U; i < num_ops; i++) {
+		hash = regops_plan_hash_u32(hash, ops[i].offset);
+		hash = regops_plan_hash_u32(hash, ((u32)ops[i].op << 16U) |
+				((u32)ops[i].type << 8U) | (u32)ops[i].quad);
+		hash = regops_plan_hash_u32(hash, ops[i].group_mask);
+		hash = regops_plan_hash_u32(hash, ops[i].sub_group_mask);
+	}
+
+	return hash;
+}
+
+static bool regops_plan_matches(struct gk20a *g,
+		struct nvgpu_regops_plan *plan, u64 hash,
+		struct nvgpu_dbg_reg_op *ops, u32 num_ops,
+		bool valid_ctx, u32 flags)
+{
+	u32 i;
+
+	if ((plan->hash != hash) || (plan->num_ops != num_ops) ||
+			(plan->valid_ctx != valid_ctx) ||
+			(plan->allow_all != g->allow_all) ||
+			(plan->mode != (flags & REGOPS_PLAN_MODE_MASK))) {
+		return false;
+	}
+
+	for (i = 0U; i < num_ops; i++) {
+		struct nvgpu_regops_plan_op *p = &plan->ops[i];
+
+		if ((p->offset != ops[i].offset) || (p->op != ops[i].op) ||
+				(p->type != ops[i].type) ||
+				(p->quad != ops[i].quad) ||
+				(p->group_mask != ops[i].group_mask) ||
+				(p->sub_group_mask != ops[i].sub_group_mask)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void regops_plan_build_steps(struct nvgpu_regops_plan *plan)
+{
+	struct nvgpu_regops_plan_step *step = NULL;
+	struct nvgpu_regops_plan_op *prev = NULL;
+	u32 i;
+
+	plan->num_steps = 0U;
+
+	for (i = 0U; i < plan->num_ops; i++) {
+		struct nvgpu_regops_plan_op *p = &plan->ops[i];
+
+		/* ctx ops are executed separately, failed ops not at all */
+		if ((p->xlat_type != REGOP(TYPE_GLOBAL)) ||
+				(p->status != REGOP(STATUS_SUCCESS))) {
+			prev = NULL;
+			continue;
+		}
+
+		if ((prev != NULL) && (p->op == REGOP(READ_32)) &&
+				(prev->op == REGOP(READ_32)) &&
+				(p->xlat_offset == prev->xlat_offset + 4U)) {
+			step->count++;
+		} else {
+			step = &plan->steps[plan->num_steps++];
+			step->first = i;
+			step->count = 1U;
+		}
+		prev = p;
+	}
+}
+
+int nvgpu_regops_plan_create(struct gk20a *g,
+		struct nvgpu_profiler_object *prof,
+		struct nvgpu_dbg_reg_op *ops,
+		u32 num_ops,
+		bool valid_ctx,
+		u32 *flags,
+		struct nvgpu_regops_plan **plan_out)
+{
+	struct nvgpu_regops_plan *plan;
+	u32 ctx_rd_count = 0, ctx_wr_count = 0;
+	u32 in_flags = *flags;
+	size_t size;
+	u32 i;
+
+	*plan_out = NULL;
+
+	size = sizeof(*plan) +
+		(size_t)num_ops * (sizeof(*plan->ops) + sizeof(*plan->steps));
+	plan = nvgpu_kzalloc(g, size);
+	if (plan == NULL) {
+		return -ENOMEM;
+	}
+	plan->ops = (struct nvgpu_regops_plan_op *)(void *)&plan[1];
+	plan->steps = (struct nvgpu_regops_plan_step *)(void *)
+			&plan->ops[num_ops];
+
+	plan->hash = regops_plan_hash(ops, num_ops);
+	plan->num_ops = num_ops;
+	plan->mode = in_flags & REGOPS_PLAN_MODE_MASK;
+	plan->valid_ctx = valid_ctx;
+	plan->allow_all = g->allow_all;
+
+	for (i = 0U; i < num_ops; i++) {
+		plan->ops[i].offset = ops[i].offset;
+		plan->ops[i].group_mask = ops[i].group_mask;
+		plan->ops[i].sub_group_mask = ops[i].sub_group_mask;
+		plan->ops[i].op = ops[i].op;
+		plan->ops[i].type = ops[i].type;
+		plan->ops[i].quad = ops[i].quad;
+	}
+
+	if (!validate_reg_ops(g, prof, &ctx_rd_count, &ctx_wr_count,
+			ops, num_ops, valid_ctx, flags)) {
+		nvgpu_kfree(g, plan);
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < num_ops; i++) {
+		plan->ops[i].status = ops[i].status;
+		plan->ops[i].xlat_type = ops[i].type;
+		plan->ops[i].xlat_offset = ops[i].offset;
+	}
+	plan->result_flags = (*flags) & ~in_flags;
+	plan->ctx_rd_count = ctx_rd_count;
+	plan->ctx_wr_count = ctx_wr_count;
+
+	regops_plan_build_steps(plan);
+
+	nvgpu_log(g, gpu_dbg_gpu_dbg, "regops plan: %u ops, %u global steps",
+		num_ops, plan->num_steps);
+
+	*plan_out = plan;
+	return 0;
+}
+
+void nvgpu_regops_plan_free(struct gk20a *g, struct nvgpu_regops_plan *plan)
+{
+	nvgpu_kfree(g, plan);
+}
+
+static int regops_plan_exec_native(struct gk20a *g, struct nvgpu_tsg *tsg,
+		struct nvgpu_regops_plan *plan,
+		struct nvgpu_dbg_reg_op *ops, u32 *flags)
+{
+	u32 i, j;
+	int err = 0;
+
+	if ((plan->ctx_wr_count | plan->ctx_rd_count) != 0U) {
+		if (!gr_context_info_available(g)) {
+			nvgpu_err(g, "gr context data not available");
+			return -ENODEV;
+		}
+	}
+
+	for (i = 0U; i < plan->num_steps; i++) {
+		struct nvgpu_regops_plan_step *step = &plan->steps[i];
+
+		if (step->count == 1U) {
+			err = exec_regop_global(g, &ops[step->first]);
+			if (err != 0) {
+				return err;
+			}
+			continue;
+		}
+
+		for (j = step->first; j < step->first + step->count; j++) {
+			ops[j].value_hi = 0;
+			ops[j].value_lo = gk20a_readl(g, ops[j].offset);
+		}
+		nvgpu_log(g, gpu_dbg_gpu_dbg, "read_32 x%u from 0x%08x",
+			step->count, ops[step->first].offset);
+	}
+
+	if ((plan->ctx_wr_count | plan->ctx_rd_count) != 0U) {
+		err = gr_gk20a_exec_ctx_ops(tsg, ops, plan->num_ops,
+					    plan->ctx_wr_count,
+					    plan->ctx_rd_count, flags);
+		if (err != 0) {
+			nvgpu_warn(g, "failed to perform ctx ops");
+		}
+	}
+
+	return err;
+}
+
+int nvgpu_regops_plan_exec(struct gk20a *g,
+		struct nvgpu_tsg *tsg,
+		struct nvgpu_regops_plan *plan,
+		struct nvgpu_dbg_reg_op *ops,
+		u32 num_ops,
+		u32 *flags)
+{
+	u32 i;
+	int err;
+
+	if (!regops_plan_matches(g, plan, regops_plan_hash(ops, num_ops),
+			ops, num_ops, tsg != NULL, *flags)) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < num_ops; i++) {
+		ops[i].status = plan->ops[i].status;
+		ops[i].type = plan->ops[i].xlat_type;
+		ops[i].offset = plan->ops[i].xlat_offset;
+	}
+	*flags |= plan->result_flags;
+
+	if (g->is_virtual) {
+		err = g->ops.regops.exec_regops(g, tsg, ops, num_ops,
+				plan->ctx_wr_count, plan->ctx_rd_count, flags);
+	} else {
+		err = regops_plan_exec_native(g, tsg, plan, ops, flags);
+	}
+
+	nvgpu_log(g, gpu_dbg_gpu_dbg, "ret=%d", err);
+	return err;
+}
+
+static struct nvgpu_regops_plan *regops_plan_cache_lookup(
+		struct nvgpu_profiler_object *prof,
+		struct nvgpu_dbg_reg_op *ops, u32 num_ops,
+		bool valid_ctx, u32 flags)
+{
+	u64 hash = regops_plan_hash(ops, num_ops);
+	u32 i;
+
+	for (i = 0U; i < NVGPU_PROFILER_REGOPS_PLAN_CACHE_SIZE; i++) {
+		struct nvgpu_regops_plan *plan = prof->regops_plans[i];
+
+		if ((plan != NULL) && regops_plan_matches(prof->g, plan, hash,
+				ops, num_ops, valid_ctx, flags)) {
+			return plan;
+		}
+	}
+
+	return NULL;
+}
+
+static void regops_plan_cache_insert(struct nvgpu_profiler_object *prof,
+		struct nvgpu_regops_plan *plan)
+{
+	u32 slot = prof->regops_plan_next;
+
+	if (prof->regops_plans[slot] != NULL) {
+		nvgpu_regops_plan_free(prof->g, prof->regops_plans[slot]);
+	}
+	prof->regops_plans[slot] = plan;
+	prof->regops_plan_next =
+		(slot + 1U) % NVGPU_PROFILER_REGOPS_PLAN_CACHE_SIZE;
+}
+
+void nvgpu_regops_plan_cache_flush(struct nvgpu_profiler_object *prof)
+{
+	u32 i;
+
+	for (i = 0U; i < NVGPU_PROFILER_REGOPS_PLAN_CACHE_SIZE; i++) {
+		if (prof->regops_plans[i] != NULL) {
+			nvgpu_regops_plan_free(prof->g, prof->regops_plans[i]);
+			prof->regops_plans[i] = NULL;
+		}
+	}
+	prof->regops_plan_next = 0U;
+}
+
 int nvgpu_regops_exec(struct gk20a *g,
 		struct nvgpu_tsg *tsg,
 		struct nvgpu_profiler_object *prof,
@@ -418,6 +750,40 @@ int nvgpu_regops_exec(struct gk20a *g,
 
 	nvgpu_log(g, gpu_dbg_fn | gpu_dbg_gpu_dbg, " ");
 
+	/*
+	 * Profilers submit the same ops every sampling interval; validate
+	 * them once and reuse the result.
+	 */
+	if (prof != NULL) {
+		struct nvgpu_regops_plan *plan;
+
+		plan = regops_plan_cache_lookup(prof, ops, num_ops,
+				tsg != NULL, *flags);
+		if (plan == NULL) {
+			err = nvgpu_regops_plan_create(g, prof, ops, num_ops,
+					tsg != NULL, flags, &plan);
+			if (err == -EINVAL) {
+				nvgpu_err(g, "invalid op(s)");
+				return err;
+			}
+			if (err == 0) {
+				regops_plan_cache_insert(prof, plan);
+			}
+		}
+
+		/* Without a plan fall back to validating in place. */
+		if (plan != NULL) {
+			err = nvgpu_regops_plan_exec(g, tsg, plan, ops, num_ops,
+					flags);
+			if (err != 0) {
+				nvgpu_warn(g, "failed to perform regops, err=%d",
+					err);
+			}
+			return err;
+		}
+		err = 0;
+	}
+
 	ok = validate_reg_ops(g, prof, &ctx_rd_count, &ctx_wr_count,
 		ops, num_ops, tsg != NULL, flags);
 	if (!ok) {
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/swhist.h>
+#include <nvgpu/bitops.h>
+#include <nvgpu/debug.h>
+#include <nvgpu/os_sched.h>
+#include <nvgpu/static_analysis.h>
+#include <nvgpu/string.h>
+#include <nvgpu/timers.h>
+
+static const char *const swhist_probe_names[NVGPU_SWHIST_NUM_PROBES] = {
+	[NVGPU_SWHIST_SUBMIT]		= "submit",
+	[NVGPU_SWHIST_RUNLIST_UPDATE]	= "runlist_update",
+	[NVGPU_SWHIST_PREEMPT]		= "preempt",
+	[NVGPU_SWHIST_PT_UPDATE]	= "pt_update",
+};
+
+u32 nvgpu_swhist_bucket(u64 ns)
+{
+	u32 bucket;
+
+	if (ns <= 1ULL) {
+		return 0U;
+	}
+
+	bucket = (u32)nvgpu_safe_sub_u64(nvgpu_fls((unsigned long)ns), 1UL);
+
+	return min(bucket, NVGPU_SWHIST_BUCKETS - 1U);
+}
+
+static struct nvgpu_swhist_shard *swhist_shard(struct gk20a *g,
+		struct nvgpu_swhist *h)
+{
+	u32 tid = (u32)nvgpu_current_tid(g);
+
+	return &h->shards[tid & (NVGPU_SWHIST_SHARDS - 1U)];
+}
+
+void nvgpu_swhist_record(struct gk20a *g, struct nvgpu_swhist *h, u64 ns)
+{
+	struct nvgpu_swhist_shard *shard = swhist_shard(g, h);
+	long val = (long)min(ns, U64_MAX >> 1U);
+	long max = nvgpu_atomic64_read(&shard->max_ns);
+	long cur;
+
+	nvgpu_atomic64_inc(&shard->buckets[nvgpu_swhist_bucket(ns)]);
+	nvgpu_atomic64_inc(&shard->count);
+	nvgpu_atomic64_add(val, &shard->sum_ns);
+
+	while (val > max) {
+		cur = nvgpu_atomic64_cmpxchg(&shard->max_ns, max, val);
+		if (cur == max) {
+			break;
+		}
+		max = cur;
+	}
+}
+
+s64 nvgpu_swhist_begin(void)
+{
+	return nvgpu_current_time_ns();
+}
+
+void nvgpu_swhist_end(struct gk20a *g, enum nvgpu_swhist_probe probe,
+		s64 start_ns)
+{
+	s64 delta = nvgpu_current_time_ns() - start_ns;
+
+	nvgpu_swhist_record(g, &g->swhist[probe],
+			(delta > 0) ? (u64)delta : 0ULL);
+}
+
+void nvgpu_swhist_read(struct nvgpu_swhist *h, struct nvgpu_swhist_data *data)
+{
+	struct nvgpu_swhist_shard *shard;
+	u64 max;
+	u32 s, i;
+
+	(void) memset(data, 0, sizeof(*data));
+
+	for (s = 0U; s < NVGPU_SWHIST_SHARDS; s++) {
+		shard = &h->shards[s];
+
+		for (i = 0U; i < NVGPU_SWHIST_BUCKETS; i++) {
+			data->buckets[i] = nvgpu_safe_add_u64(
+				data->buckets[i],
+				(u64)nvgpu_atomic64_read(&shard->buckets[i]));
+		}
+		data->count = nvgpu_safe_add_u64(data->count,
+				(u64)nvgpu_atomic64_read(&shard->count));
+		data->sum_ns = nvgpu_safe_add_u64(data->sum_ns,
+				(u64)nvgpu_atomic64_read(&shard->sum_ns));
+		max = (u64)nvgpu_atomic64_read(&shard->max_ns);
+		data->max_ns = max(data->max_ns, max);
+	}
+}
+
+void nvgpu_swhist_read_probe(struct gk20a *g, enum nvgpu_swhist_probe probe,
+		struct nvgpu_swhist_data *data)
+{
+	nvgpu_swhist_read(&g->swhist[probe], data);
+}
+
+void nvgpu_swhist_merge(struct nvgpu_swhist_data *dst,
+		const struct nvgpu_swhist_data *src)
+{
+	u32 i;
+
+	for (i = 0U; i < NVGPU_SWHIST_BUCKETS; i++) {
+		dst->buckets[i] = nvgpu_safe_add_u64(dst->buckets[i],
+				src->buckets[i]);
+	}
+	dst->count = nvgpu_safe_add_u64(dst->count, src->count);
+	dst->sum_ns = nvgpu_safe_add_u64(dst->sum_ns, src->sum_ns);
+	dst->max_ns = max(dst->max_ns, src->max_ns);
+}
+
+u64 nvgpu_swhist_percentile(const struct nvgpu_swhist_data *data, u32 pct)
+{
+	u64 total = 0ULL;
+	u64 rank, seen = 0ULL;
+	u32 i;
+
+	for (i = 0U; i < NVGPU_SWHIST_BUCKETS; i++) {
+		total = nvgpu_safe_add_u64(total, data->buckets[i]);
+	}
+	if (total == 0ULL) {
+		return 0ULL;
+	}
+
+	/* rank of the sample at the percentile, 1 based */
+	rank = nvgpu_safe_mult_u64(total, (u64)min(pct, 100U));
+	rank = max(nvgpu_safe_add_u64(rank, 99ULL) / 100ULL, 1ULL);
+
+	for (i = 0U; i < NVGPU_SWHIST_BUCKETS - 1U; i++) {
+		seen = nvgpu_safe_add_u64(seen, data->buckets[i]);
+		if (seen >= rank) {
+			break;
+		}
+	}
+
+	if (i == NVGPU_SWHIST_BUCKETS - 1U) {
+		return data->max_ns;
+	}
+
+	return min(nvgpu_safe_sub_u64(BIT64(i + 1U), 1ULL), data->max_ns);
+}
+
+void nvgpu_swhist_reset(struct nvgpu_swhist *h)
+{
+	struct nvgpu_swhist_shard *shard;
+	u32 s, i;
+
+	for (s = 0U; s < NVGPU_SWHIST_SHARDS; s++) {
+		shard = &h->shards[s];
+
+		for (i = 0U; i < NVGPU_SWHIST_BUCKETS; i++) {
+			nvgpu_atomic64_set(&shard->buckets[i], 0);
+		}
+		nvgpu_atomic64_set(&shard->count, 0);
+		nvgpu_atomic64_set(&shard->sum_ns, 0);
+		nvgpu_atomic64_set(&shard->max_ns, 0);
+	}
+}
+
+const char *nvgpu_swhist_probe_name(enum nvgpu_swhist_probe probe)
+{
+	if ((u32)probe >= (u32)NVGPU_SWHIST_NUM_PROBES) {
+		return "unknown";
+	}
+
+	return swhist_probe_names[probe];
+}
+
+void nvgpu_swhist_print_header(struct nvgpu_debug_context *o)
+{
+	gk20a_debug_output(o, "%-16s %10s %10s %10s %10s %10s",
+			"probe", "count", "avg(ns)", "p50", "p99", "max");
+}
+
+void nvgpu_swhist_print_data(struct nvgpu_debug_context *o, const char *name,
+		const struct nvgpu_swhist_data *data)
+{
+	u32 i;
+
+	gk20a_debug_output(o, "%-16s %10llu %10llu %10llu %10llu %10llu",
+		name, data->count,
+		(data->count != 0ULL) ? (data->sum_ns / data->count) : 0ULL,
+		nvgpu_swhist_percentile(data, 50U),
+		nvgpu_swhist_percentile(data, 99U),
+		data->max_ns);
+
+	for (i = 0U; i < NVGPU_SWHIST_BUCKETS; i++) {
+		if (data->buckets[i] != 0ULL) {
+			gk20a_debug_output(o, "  >= 2^%-2u ns %10llu",
+				i, data->buckets[i]);
+		}
+	}
+}
+
+void nvgpu_swhist_print(struct gk20a *g, struct nvgpu_debug_context *o)
+{
+	struct nvgpu_swhist_data data;
+	u32 p;
+
+	nvgpu_swhist_print_header(o);
+
+	for (p = 0U; p < (u32)NVGPU_SWHIST_NUM_PROBES; p++) {
+		nvgpu_swhist_read(&g->swhist[p], &data);
+		nvgpu_swhist_print_data(o,
+			nvgpu_swhist_probe_name((enum nvgpu_swhist_probe)p),
+			&data);
+	}
+}
@@ -108,6 +108,7 @@
 #include "hal/priv_ring/priv_ring_ga10b.h"
 #include "hal/priv_ring/priv_ring_ga100.h"
 #include "hal/power_features/cg/ga100_gating_reglist.h"
+#include "hal/power_features/cg/ga100_gating_batch.h"
 #include "hal/cbc/cbc_gv11b.h"
 #include "hal/cbc/cbc_tu104.h"
 #include "hal/cbc/cbc_ga100.h"
@@ -575,6 +576,7 @@ static const struct gops_gr_zbc ga100_ops_gr_zbc = {
 	.add_color = gp10b_gr_zbc_add_color,
 	.add_depth = gp10b_gr_zbc_add_depth,
 	.set_table = nvgpu_gr_zbc_set_table,
+	.set_table_batch = nvgpu_gr_zbc_set_table_batch,
 	.query_table = nvgpu_gr_zbc_query_table,
 	.add_stencil = gv11b_gr_zbc_add_stencil,
 	.get_gpcs_swdx_dss_zbc_c_format_reg = gv11b_gr_zbc_get_gpcs_swdx_dss_zbc_c_format_reg,
@@ -961,32 +963,32 @@ static const struct gops_nvdec ga100_ops_nvdec = {
 };
 
 static const struct gops_cg ga100_ops_cg = {
-	.slcg_bus_load_gating_prod = ga100_slcg_bus_load_gating_prod,
-	.slcg_ce2_load_gating_prod = ga100_slcg_ce2_load_gating_prod,
-	.slcg_chiplet_load_gating_prod = ga100_slcg_chiplet_load_gating_prod,
-	.slcg_fb_load_gating_prod = ga100_slcg_fb_load_gating_prod,
+	.slcg_bus_load_gating_prod = ga100_slcg_bus_load_gating_batch,
+	.slcg_ce2_load_gating_prod = ga100_slcg_ce2_load_gating_batch,
+	.slcg_chiplet_load_gating_prod = ga100_slcg_chiplet_load_gating_batch,
+	.slcg_fb_load_gating_prod = ga100_slcg_fb_load_gating_batch,
 	.slcg_fifo_load_gating_prod = NULL,
 	.slcg_runlist_load_gating_prod = ga100_slcg_runlist_load_gating_prod,
 	.slcg_gr_load_gating_prod = ga100_slcg_gr_load_gating_prod,
-	.slcg_ltc_load_gating_prod = ga100_slcg_ltc_load_gating_prod,
-	.slcg_perf_load_gating_prod = ga100_slcg_perf_load_gating_prod,
-	.slcg_priring_load_gating_prod = ga100_slcg_priring_load_gating_prod,
-	.slcg_pmu_load_gating_prod = ga100_slcg_pmu_load_gating_prod,
-	.slcg_therm_load_gating_prod = ga100_slcg_therm_load_gating_prod,
-	.slcg_xbar_load_gating_prod = ga100_slcg_xbar_load_gating_prod,
-	.slcg_hshub_load_gating_prod = ga100_slcg_hshub_load_gating_prod,
-	.slcg_timer_load_gating_prod = ga100_slcg_timer_load_gating_prod,
-	.blcg_bus_load_gating_prod = ga100_blcg_bus_load_gating_prod,
-	.blcg_ce_load_gating_prod = ga100_blcg_ce_load_gating_prod,
-	.blcg_fb_load_gating_prod = ga100_blcg_fb_load_gating_prod,
+	.slcg_ltc_load_gating_prod = ga100_slcg_ltc_load_gating_batch,
+	.slcg_perf_load_gating_prod = ga100_slcg_perf_load_gating_batch,
+	.slcg_priring_load_gating_prod = ga100_slcg_priring_load_gating_batch,
+	.slcg_pmu_load_gating_prod = ga100_slcg_pmu_load_gating_batch,
+	.slcg_therm_load_gating_prod = ga100_slcg_therm_load_gating_batch,
+	.slcg_xbar_load_gating_prod = ga100_slcg_xbar_load_gating_batch,
+	.slcg_hshub_load_gating_prod = ga100_slcg_hshub_load_gating_batch,
+	.slcg_timer_load_gating_prod = ga100_slcg_timer_load_gating_batch,
+	.blcg_bus_load_gating_prod = ga100_blcg_bus_load_gating_batch,
+	.blcg_ce_load_gating_prod = ga100_blcg_ce_load_gating_batch,
+	.blcg_fb_load_gating_prod = ga100_blcg_fb_load_gating_batch,
 	.blcg_fifo_load_gating_prod = NULL,
 	.blcg_runlist_load_gating_prod = ga100_blcg_runlist_load_gating_prod,
 	.blcg_gr_load_gating_prod = ga100_blcg_gr_load_gating_prod,
-	.blcg_ltc_load_gating_prod = ga100_blcg_ltc_load_gating_prod,
-	.blcg_pmu_load_gating_prod = ga100_blcg_pmu_load_gating_prod,
-	.blcg_xbar_load_gating_prod = ga100_blcg_xbar_load_gating_prod,
-	.blcg_hshub_load_gating_prod = ga100_blcg_hshub_load_gating_prod,
-	.elcg_ce_load_gating_prod = ga100_elcg_ce_load_gating_prod,
+	.blcg_ltc_load_gating_prod = ga100_blcg_ltc_load_gating_batch,
+	.blcg_pmu_load_gating_prod = ga100_blcg_pmu_load_gating_batch,
+	.blcg_xbar_load_gating_prod = ga100_blcg_xbar_load_gating_batch,
+	.blcg_hshub_load_gating_prod = ga100_blcg_hshub_load_gating_batch,
+	.elcg_ce_load_gating_prod = ga100_elcg_ce_load_gating_batch,
 };
 
 static const struct gops_fifo ga100_ops_fifo = {
@@ -1380,6 +1382,8 @@ static const struct gops_clk_arb ga100_ops_clk_arb = {
 	.get_arbiter_f_points = gv100_get_arbiter_f_points,
 	.get_arbiter_clk_range = gv100_get_arbiter_clk_range,
 	.get_arbiter_clk_default = gv100_get_arbiter_clk_default,
+	.get_arbiter_slave_clks = gv100_get_arbiter_slave_clks,
+	.get_arbiter_pstate_range = gv100_get_arbiter_pstate_range,
 	.get_current_pstate = nvgpu_clk_arb_get_current_pstate,
 	.arbiter_clk_init = gv100_init_clk_arbiter,
 	.clk_arb_run_arbiter_cb = gv100_clk_arb_run_arbiter_cb,
@@ -74,6 +74,7 @@
 #include "hal/class/class_gm20b.h"
 #include "hal/priv_ring/priv_ring_gm20b.h"
 #include "hal/power_features/cg/gm20b_gating_reglist.h"
+#include "hal/power_features/cg/gm20b_gating_batch.h"
 #include "hal/cbc/cbc_gm20b.h"
 #include "hal/therm/therm_gm20b.h"
 #include "hal/ltc/ltc_gm20b.h"
@@ -304,6 +305,7 @@ static const struct gops_gr_zbc gm20b_ops_gr_zbc = {
 	.add_color = gm20b_gr_zbc_add_color,
 	.add_depth = gm20b_gr_zbc_add_depth,
 	.set_table = nvgpu_gr_zbc_set_table,
+	.set_table_batch = nvgpu_gr_zbc_set_table_batch,
 	.query_table = nvgpu_gr_zbc_query_table,
 	.add_stencil = NULL,
 	.get_gpcs_swdx_dss_zbc_c_format_reg = NULL,
@@ -549,25 +551,25 @@ static const struct gops_fb gm20b_ops_fb = {
 };
 
 static const struct gops_cg gm20b_ops_cg = {
-	.slcg_bus_load_gating_prod = gm20b_slcg_bus_load_gating_prod,
-	.slcg_ce2_load_gating_prod = gm20b_slcg_ce2_load_gating_prod,
-	.slcg_chiplet_load_gating_prod = gm20b_slcg_chiplet_load_gating_prod,
-	.slcg_fb_load_gating_prod = gm20b_slcg_fb_load_gating_prod,
-	.slcg_fifo_load_gating_prod = gm20b_slcg_fifo_load_gating_prod,
-	.slcg_gr_load_gating_prod = gm20b_slcg_gr_load_gating_prod,
-	.slcg_ltc_load_gating_prod = gm20b_slcg_ltc_load_gating_prod,
-	.slcg_perf_load_gating_prod = gm20b_slcg_perf_load_gating_prod,
-	.slcg_priring_load_gating_prod = gm20b_slcg_priring_load_gating_prod,
-	.slcg_pmu_load_gating_prod = gm20b_slcg_pmu_load_gating_prod,
-	.slcg_therm_load_gating_prod = gm20b_slcg_therm_load_gating_prod,
-	.slcg_xbar_load_gating_prod = gm20b_slcg_xbar_load_gating_prod,
-	.blcg_bus_load_gating_prod = gm20b_blcg_bus_load_gating_prod,
-	.blcg_fb_load_gating_prod = gm20b_blcg_fb_load_gating_prod,
-	.blcg_fifo_load_gating_prod = gm20b_blcg_fifo_load_gating_prod,
-	.blcg_gr_load_gating_prod = gm20b_blcg_gr_load_gating_prod,
-	.blcg_ltc_load_gating_prod = gm20b_blcg_ltc_load_gating_prod,
-	.blcg_xbar_load_gating_prod = gm20b_blcg_xbar_load_gating_prod,
-	.blcg_pmu_load_gating_prod = gm20b_blcg_pmu_load_gating_prod,
+	.slcg_bus_load_gating_prod = gm20b_slcg_bus_load_gating_batch,
+	.slcg_ce2_load_gating_prod = gm20b_slcg_ce2_load_gating_batch,
+	.slcg_chiplet_load_gating_prod = gm20b_slcg_chiplet_load_gating_batch,
+	.slcg_fb_load_gating_prod = gm20b_slcg_fb_load_gating_batch,
+	.slcg_fifo_load_gating_prod = gm20b_slcg_fifo_load_gating_batch,
+	.slcg_gr_load_gating_prod = gm20b_slcg_gr_load_gating_batch,
+	.slcg_ltc_load_gating_prod = gm20b_slcg_ltc_load_gating_batch,
+	.slcg_perf_load_gating_prod = gm20b_slcg_perf_load_gating_batch,
+	.slcg_priring_load_gating_prod = gm20b_slcg_priring_load_gating_batch,
+	.slcg_pmu_load_gating_prod = gm20b_slcg_pmu_load_gating_batch,
+	.slcg_therm_load_gating_prod = gm20b_slcg_therm_load_gating_batch,
+	.slcg_xbar_load_gating_prod = gm20b_slcg_xbar_load_gating_batch,
+	.blcg_bus_load_gating_prod = gm20b_blcg_bus_load_gating_batch,
+	.blcg_fb_load_gating_prod = gm20b_blcg_fb_load_gating_batch,
+	.blcg_fifo_load_gating_prod = gm20b_blcg_fifo_load_gating_batch,
+	.blcg_gr_load_gating_prod = gm20b_blcg_gr_load_gating_batch,
+	.blcg_ltc_load_gating_prod = gm20b_blcg_ltc_load_gating_batch,
+	.blcg_xbar_load_gating_prod = gm20b_blcg_xbar_load_gating_batch,
+	.blcg_pmu_load_gating_prod = gm20b_blcg_pmu_load_gating_batch,
 };
 
 static const struct gops_fifo gm20b_ops_fifo = {
@@ -73,6 +73,7 @@
 #include "hal/priv_ring/priv_ring_gv11b.h"
 #include "hal/gr/config/gr_config_gv100.h"
 #include "hal/power_features/cg/gv11b_gating_reglist.h"
+#include "hal/power_features/cg/gv11b_gating_batch.h"
 #ifdef CONFIG_NVGPU_COMPRESSION
 #include "hal/cbc/cbc_gp10b.h"
 #include "hal/cbc/cbc_gv11b.h"
@@ -466,6 +467,7 @@ static const struct gops_gr_zbc gv11b_ops_gr_zbc = {
 	.add_color = gp10b_gr_zbc_add_color,
 	.add_depth = gp10b_gr_zbc_add_depth,
 	.set_table = nvgpu_gr_zbc_set_table,
+	.set_table_batch = nvgpu_gr_zbc_set_table_batch,
 	.query_table = nvgpu_gr_zbc_query_table,
 	.add_stencil = gv11b_gr_zbc_add_stencil,
 	.get_gpcs_swdx_dss_zbc_c_format_reg = gv11b_gr_zbc_get_gpcs_swdx_dss_zbc_c_format_reg,
@@ -819,29 +821,29 @@ static const struct gops_fb gv11b_ops_fb = {
 };
 
 static const struct gops_cg gv11b_ops_cg = {
-	.slcg_bus_load_gating_prod = gv11b_slcg_bus_load_gating_prod,
-	.slcg_ce2_load_gating_prod = gv11b_slcg_ce2_load_gating_prod,
-	.slcg_chiplet_load_gating_prod = gv11b_slcg_chiplet_load_gating_prod,
-	.slcg_fb_load_gating_prod = gv11b_slcg_fb_load_gating_prod,
-	.slcg_fifo_load_gating_prod = gv11b_slcg_fifo_load_gating_prod,
-	.slcg_gr_load_gating_prod = gv11b_slcg_gr_load_gating_prod,
-	.slcg_ltc_load_gating_prod = gv11b_slcg_ltc_load_gating_prod,
-	.slcg_perf_load_gating_prod = gv11b_slcg_perf_load_gating_prod,
-	.slcg_priring_load_gating_prod = gv11b_slcg_priring_load_gating_prod,
-	.slcg_pmu_load_gating_prod = gv11b_slcg_pmu_load_gating_prod,
-	.slcg_therm_load_gating_prod = gv11b_slcg_therm_load_gating_prod,
-	.slcg_xbar_load_gating_prod = gv11b_slcg_xbar_load_gating_prod,
-	.slcg_hshub_load_gating_prod = gv11b_slcg_hshub_load_gating_prod,
-	.slcg_acb_load_gating_prod = gv11b_slcg_acb_load_gating_prod,
-	.blcg_bus_load_gating_prod = gv11b_blcg_bus_load_gating_prod,
-	.blcg_ce_load_gating_prod = gv11b_blcg_ce_load_gating_prod,
-	.blcg_fb_load_gating_prod = gv11b_blcg_fb_load_gating_prod,
-	.blcg_fifo_load_gating_prod = gv11b_blcg_fifo_load_gating_prod,
-	.blcg_gr_load_gating_prod = gv11b_blcg_gr_load_gating_prod,
-	.blcg_ltc_load_gating_prod = gv11b_blcg_ltc_load_gating_prod,
-	.blcg_pmu_load_gating_prod = gv11b_blcg_pmu_load_gating_prod,
-	.blcg_xbar_load_gating_prod = gv11b_blcg_xbar_load_gating_prod,
-	.blcg_hshub_load_gating_prod = gv11b_blcg_hshub_load_gating_prod,
+	.slcg_bus_load_gating_prod = gv11b_slcg_bus_load_gating_batch,
+	.slcg_ce2_load_gating_prod = gv11b_slcg_ce2_load_gating_batch,
+	.slcg_chiplet_load_gating_prod = gv11b_slcg_chiplet_load_gating_batch,
+	.slcg_fb_load_gating_prod = gv11b_slcg_fb_load_gating_batch,
+	.slcg_fifo_load_gating_prod = gv11b_slcg_fifo_load_gating_batch,
+	.slcg_gr_load_gating_prod = gv11b_slcg_gr_load_gating_batch,
+	.slcg_ltc_load_gating_prod = gv11b_slcg_ltc_load_gating_batch,
+	.slcg_perf_load_gating_prod = gv11b_slcg_perf_load_gating_batch,
+	.slcg_priring_load_gating_prod = gv11b_slcg_priring_load_gating_batch,
+	.slcg_pmu_load_gating_prod = gv11b_slcg_pmu_load_gating_batch,
+	.slcg_therm_load_gating_prod = gv11b_slcg_therm_load_gating_batch,
+	.slcg_xbar_load_gating_prod = gv11b_slcg_xbar_load_gating_batch,
+	.slcg_hshub_load_gating_prod = gv11b_slcg_hshub_load_gating_batch,
+	.slcg_acb_load_gating_prod = gv11b_slcg_acb_load_gating_batch,
+	.blcg_bus_load_gating_prod = gv11b_blcg_bus_load_gating_batch,
+	.blcg_ce_load_gating_prod = gv11b_blcg_ce_load_gating_batch,
+	.blcg_fb_load_gating_prod = gv11b_blcg_fb_load_gating_batch,
+	.blcg_fifo_load_gating_prod = gv11b_blcg_fifo_load_gating_batch,
+	.blcg_gr_load_gating_prod = gv11b_blcg_gr_load_gating_batch,
+	.blcg_ltc_load_gating_prod = gv11b_blcg_ltc_load_gating_batch,
+	.blcg_pmu_load_gating_prod = gv11b_blcg_pmu_load_gating_batch,
+	.blcg_xbar_load_gating_prod = gv11b_blcg_xbar_load_gating_batch,
+	.blcg_hshub_load_gating_prod = gv11b_blcg_hshub_load_gating_batch,
 };
 
 static const struct gops_fifo gv11b_ops_fifo = {
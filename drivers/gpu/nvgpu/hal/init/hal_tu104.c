@@ -51,6 +51,7 @@
 #include "hal/priv_ring/priv_ring_gp10b.h"
 #include "hal/priv_ring/priv_ring_gv11b.h"
 #include "hal/power_features/cg/tu104_gating_reglist.h"
+#include "hal/power_features/cg/tu104_gating_batch.h"
 #include "hal/cbc/cbc_gv11b.h"
 #include "hal/cbc/cbc_tu104.h"
 #include "hal/therm/therm_gm20b.h"
@@ -503,6 +504,7 @@ static const struct gops_gr_zbc tu104_ops_gr_zbc = {
 	.add_color = gp10b_gr_zbc_add_color,
 	.add_depth = gp10b_gr_zbc_add_depth,
 	.set_table = nvgpu_gr_zbc_set_table,
+	.set_table_batch = nvgpu_gr_zbc_set_table_batch,
 	.query_table = nvgpu_gr_zbc_query_table,
 	.add_stencil = gv11b_gr_zbc_add_stencil,
 	.get_gpcs_swdx_dss_zbc_c_format_reg = gv11b_gr_zbc_get_gpcs_swdx_dss_zbc_c_format_reg,
@@ -871,28 +873,28 @@ static const struct gops_nvdec tu104_ops_nvdec = {
 };
 
 static const struct gops_cg tu104_ops_cg = {
-	.slcg_bus_load_gating_prod = tu104_slcg_bus_load_gating_prod,
-	.slcg_ce2_load_gating_prod = tu104_slcg_ce2_load_gating_prod,
-	.slcg_chiplet_load_gating_prod = tu104_slcg_chiplet_load_gating_prod,
-	.slcg_fb_load_gating_prod = tu104_slcg_fb_load_gating_prod,
-	.slcg_fifo_load_gating_prod = tu104_slcg_fifo_load_gating_prod,
-	.slcg_gr_load_gating_prod = tu104_slcg_gr_load_gating_prod,
-	.slcg_ltc_load_gating_prod = tu104_slcg_ltc_load_gating_prod,
-	.slcg_perf_load_gating_prod = tu104_slcg_perf_load_gating_prod,
-	.slcg_priring_load_gating_prod = tu104_slcg_priring_load_gating_prod,
-	.slcg_pmu_load_gating_prod = tu104_slcg_pmu_load_gating_prod,
-	.slcg_therm_load_gating_prod = tu104_slcg_therm_load_gating_prod,
-	.slcg_xbar_load_gating_prod = tu104_slcg_xbar_load_gating_prod,
-	.slcg_hshub_load_gating_prod = tu104_slcg_hshub_load_gating_prod,
-	.blcg_bus_load_gating_prod = tu104_blcg_bus_load_gating_prod,
-	.blcg_ce_load_gating_prod = tu104_blcg_ce_load_gating_prod,
-	.blcg_fb_load_gating_prod = tu104_blcg_fb_load_gating_prod,
-	.blcg_fifo_load_gating_prod = tu104_blcg_fifo_load_gating_prod,
-	.blcg_gr_load_gating_prod = tu104_blcg_gr_load_gating_prod,
-	.blcg_ltc_load_gating_prod = tu104_blcg_ltc_load_gating_prod,
-	.blcg_pmu_load_gating_prod = tu104_blcg_pmu_load_gating_prod,
-	.blcg_xbar_load_gating_prod = tu104_blcg_xbar_load_gating_prod,
-	.blcg_hshub_load_gating_prod = tu104_blcg_hshub_load_gating_prod,
+	.slcg_bus_load_gating_prod = tu104_slcg_bus_load_gating_batch,
+	.slcg_ce2_load_gating_prod = tu104_slcg_ce2_load_gating_batch,
+	.slcg_chiplet_load_gating_prod = tu104_slcg_chiplet_load_gating_batch,
+	.slcg_fb_load_gating_prod = tu104_slcg_fb_load_gating_batch,
+	.slcg_fifo_load_gating_prod = tu104_slcg_fifo_load_gating_batch,
+	.slcg_gr_load_gating_prod = tu104_slcg_gr_load_gating_batch,
+	.slcg_ltc_load_gating_prod = tu104_slcg_ltc_load_gating_batch,
+	.slcg_perf_load_gating_prod = tu104_slcg_perf_load_gating_batch,
+	.slcg_priring_load_gating_prod = tu104_slcg_priring_load_gating_batch,
+	.slcg_pmu_load_gating_prod = tu104_slcg_pmu_load_gating_batch,
+	.slcg_therm_load_gating_prod = tu104_slcg_therm_load_gating_batch,
+	.slcg_xbar_load_gating_prod = tu104_slcg_xbar_load_gating_batch,
+	.slcg_hshub_load_gating_prod = tu104_slcg_hshub_load_gating_batch,
+	.blcg_bus_load_gating_prod = tu104_blcg_bus_load_gating_batch,
+	.blcg_ce_load_gating_prod = tu104_blcg_ce_load_gating_batch,
+	.blcg_fb_load_gating_prod = tu104_blcg_fb_load_gating_batch,
+	.blcg_fifo_load_gating_prod = tu104_blcg_fifo_load_gating_batch,
+	.blcg_gr_load_gating_prod = tu104_blcg_gr_load_gating_batch,
+	.blcg_ltc_load_gating_prod = tu104_blcg_ltc_load_gating_batch,
+	.blcg_pmu_load_gating_prod = tu104_blcg_pmu_load_gating_batch,
+	.blcg_xbar_load_gating_prod = tu104_blcg_xbar_load_gating_batch,
+	.blcg_hshub_load_gating_prod = tu104_blcg_hshub_load_gating_batch,
 };
 
 static const struct gops_fifo tu104_ops_fifo = {
@@ -1266,6 +1268,8 @@ static const struct gops_clk_arb tu104_ops_clk_arb = {
 	.get_arbiter_f_points = gv100_get_arbiter_f_points,
 	.get_arbiter_clk_range = gv100_get_arbiter_clk_range,
 	.get_arbiter_clk_default = gv100_get_arbiter_clk_default,
+	.get_arbiter_slave_clks = gv100_get_arbiter_slave_clks,
+	.get_arbiter_pstate_range = gv100_get_arbiter_pstate_range,
 	.get_current_pstate = nvgpu_clk_arb_get_current_pstate,
 	.arbiter_clk_init = gv100_init_clk_arbiter,
 	.clk_arb_run_arbiter_cb = gv100_clk_arb_run_arbiter_cb,
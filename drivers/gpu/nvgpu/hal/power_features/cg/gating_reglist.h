@@ -1,6 +1,6 @@
 /*
  *
- * Copyright (c) 2018-2020, NVIDIA Corporation. All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA Corporation. All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -26,6 +26,7 @@
 #define NVGPU_CG_GATING_REGLIST_H
 
 #include <nvgpu/types.h>
+#include <nvgpu/io.h>
 
 struct gating_desc {
 	u32 addr;
@@ -33,4 +34,38 @@ struct gating_desc {
 	u32 disable;
 };
 
+/*
+ * Write the prod or disable values of a gating table as one register batch.
+ */
+static inline void nvgpu_gating_desc_load(struct gk20a *g,
+		const struct gating_desc *desc, u32 size, bool prod)
+{
+	struct nvgpu_reg_batch batch = {
+		.table = (const u32 *)(const void *)desc,
+		.count = size,
+		.stride = (u32)(sizeof(struct gating_desc) / sizeof(u32)),
+		.value = prod ?
+			(u32)(offsetof(struct gating_desc, prod) / sizeof(u32)) :
+			(u32)(offsetof(struct gating_desc, disable) / sizeof(u32)),
+	};
+
+	nvgpu_writel_batch(g, &batch);
+}
+
+/*
+ * Define <name>_load_gating_batch(), a batched equivalent of the generated
+ * <name>_load_gating_prod(). The table is taken from the generated
+ * <name>_get_gating_prod() and <name>_gating_prod_size() so the generated
+ * reglist files stay as produced. Only tables which are written without
+ * per-instance filtering may be loaded this way.
+ */
+#define NVGPU_GATING_BATCH_LOADER(name, can_flag)			\
+void name##_load_gating_batch(struct gk20a *g, bool prod)		\
+{									\
+	if (nvgpu_is_enabled(g, (can_flag))) {				\
+		nvgpu_gating_desc_load(g, name##_get_gating_prod(),	\
+				name##_gating_prod_size(), prod);	\
+	}								\
+}
+
 #endif /* NVGPU_CG_GATING_REGLIST_H */
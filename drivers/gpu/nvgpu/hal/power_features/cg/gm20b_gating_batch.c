@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <nvgpu/types.h>
+#include <nvgpu/enabled.h>
+#include <nvgpu/io.h>
+
+#include "gating_reglist.h"
+#include "gm20b_gating_reglist.h"
+#include "gm20b_gating_batch.h"
+
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_bus, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_ce2, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_chiplet, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_fb, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_fifo, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_gr, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_ltc, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_perf, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_priring, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_pmu, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_therm, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_slcg_xbar, NVGPU_GPU_CAN_SLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_bus, NVGPU_GPU_CAN_BLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_fb, NVGPU_GPU_CAN_BLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_fifo, NVGPU_GPU_CAN_BLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_gr, NVGPU_GPU_CAN_BLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_ltc, NVGPU_GPU_CAN_BLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_pmu, NVGPU_GPU_CAN_BLCG)
+NVGPU_GATING_BATCH_LOADER(gm20b_blcg_xbar, NVGPU_GPU_CAN_BLCG)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -165,6 +165,57 @@ struct nvgpu_clk_arb_debug {
 };
 #endif
 
+/* VF table rebuild statistics */
+struct nvgpu_clk_arb_vf_stats {
+	/* VF tables built and swapped in */
+	u64 rebuilds;
+	/* updates which found the constraints of the current table unchanged */
+	u64 skipped;
+	/* F-points whose slave clocks were looked up */
+	u64 points_resolved;
+};
+
+/* Limits a VF table is built for */
+struct nvgpu_clk_arb_vf_limits {
+	u16 gpc2clk_min;
+	u16 gpc2clk_max;
+	u16 p0_min;
+	u16 p0_max;
+};
+
+/* Queries used to fill the VF cache, backed by the clk and clk_arb HALs */
+struct nvgpu_clk_arb_vf_source {
+	/* Fetch the latest VF curve from the PMU */
+	int (*refresh_vf_points)(struct gk20a *g);
+	int (*get_f_points)(struct gk20a *g, u32 *num_points,
+			u16 *freqs_in_mhz);
+	/* Fill in the slave clocks of point->gpc_mhz */
+	int (*get_slave_clks)(struct gk20a *g,
+			struct nvgpu_clk_vf_point *point);
+};
+
+/*
+ * GPC2CLK F-points and the slave clocks of each point. The F-points are
+ * queried on the first build after the cache is invalidated, the slave
+ * clocks of a point the first time it falls inside the GPC2CLK range.
+ * Both depend on the VF curve, so the VF points are refreshed from the PMU
+ * through nvgpu_clk_arb_vf_cache_refresh(), which drops the points which
+ * moved.
+ */
+struct nvgpu_clk_arb_vf_cache {
+	u16 *f_points;
+	u32 num_points;
+	/* F-points queried after a VF curve refresh */
+	u16 *refresh_f_points;
+	/* gpc_mhz is 0 until the point is resolved */
+	struct nvgpu_clk_vf_point *points;
+	bool valid;
+	/* Set once a table was built from the cache with these limits */
+	bool built;
+	struct nvgpu_clk_arb_vf_limits limits;
+	struct nvgpu_clk_arb_vf_stats stats;
+};
+
 struct nvgpu_clk_arb_target {
 	u16 mclk;
 	u16 gpc2clk;
@@ -223,6 +274,7 @@ struct nvgpu_clk_arb {
 	u32 mclk_f_numpoints;
 	u16 *gpc2clk_f_points;
 	u32 gpc2clk_f_numpoints;
+	struct nvgpu_clk_arb_vf_cache vf_cache;
 
 	nvgpu_atomic64_t alarm_mask;
 	struct nvgpu_clk_notification_queue notification_queue;
@@ -295,6 +347,23 @@ void nvgpu_clk_arb_worker_enqueue(struct gk20a *g,
 		struct nvgpu_clk_arb_work_item *work_item);
 
 int nvgpu_clk_arb_update_vf_table(struct nvgpu_clk_arb *arb);
+void nvgpu_clk_arb_invalidate_vf_table(struct nvgpu_clk_arb *arb);
+
+int nvgpu_clk_arb_vf_cache_init(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache);
+void nvgpu_clk_arb_vf_cache_deinit(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache);
+void nvgpu_clk_arb_vf_cache_invalidate(struct nvgpu_clk_arb_vf_cache *cache);
+int nvgpu_clk_arb_vf_cache_refresh(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_source *src);
+bool nvgpu_clk_arb_vf_cache_is_current(struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_limits *limits);
+int nvgpu_clk_arb_vf_cache_build(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_source *src,
+		const struct nvgpu_clk_arb_vf_limits *limits,
+		struct nvgpu_clk_vf_table *table);
 
 int nvgpu_clk_arb_worker_init(struct gk20a *g);
 
@@ -1,7 +1,7 @@
 /*
  * Cycle stats snapshots support
  *
- * Copyright (c) 2016-2017, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -127,6 +127,8 @@ gk20a_cs_snapshot_client_from_list(struct nvgpu_list_node *node)
 /* cycle stats snapshot control structure for one HW entry and many clients */
 struct gk20a_cs_snapshot {
 	unsigned long perfmon_ids[PM_BITMAP_SIZE];
+	/* owner of each perfmon id, NULL when the id is not attached */
+	struct gk20a_cs_snapshot_client	*perfmon_clients[CSS_MAX_PERFMON_IDS];
 	struct nvgpu_list_node	clients;
 	struct nvgpu_mem	hw_memdesc;
 	/* pointer to allocated cpu_va memory where GPU place data */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -275,6 +275,17 @@ struct nvgpu_ecc {
 	struct nvgpu_mutex stats_lock;
 	/** Contains the number of error statistics. */
 	int stats_count;
+	/** Incremented on every addition to or removal from stats_list. */
+	u32 stats_gen;
+	/**
+	 * Flat index of stats_list, rebuilt by the first snapshot after the
+	 * list changed. Protected by stats_lock.
+	 */
+	struct nvgpu_ecc_stat **stats_index;
+	/** Number of valid entries of stats_index. */
+	u32 stats_index_count;
+	/** Value of stats_gen stats_index was built at. */
+	u32 stats_index_gen;
 	/**
 	 * Indicates if ECC initialization (counters allocation and sysfs
 	 * setup) is completed.
@@ -282,6 +293,20 @@ struct nvgpu_ecc {
 	bool initialized;
 };
 
+/**
+ * Snapshot of all error counters, see nvgpu_ecc_snapshot().
+ */
+struct nvgpu_ecc_snapshot {
+	/** Generation of the counter list the snapshot was taken at. */
+	u32 gen;
+	/** Number of counters in the snapshot. */
+	u32 count;
+	/** Number of entries counters can hold, set by the caller. */
+	u32 size;
+	/** Counter values, indexed by the position of the counter. */
+	u32 *counters;
+};
+
 /**
  * @brief Allocates, initializes an error counter with specified name.
  *
@@ -371,6 +396,53 @@ void nvgpu_ecc_remove_support(struct gk20a *g);
  */
 int nvgpu_ecc_finalize_support(struct gk20a *g);
 
+/**
+ * @brief Copy all error counters in one pass.
+ *
+ * @param g [in] The GPU driver struct.
+ * @param snap [in,out] Snapshot with size and counters set by the caller.
+ *
+ * Copies the value of every counter of the stats_list into snap->counters,
+ * in a fixed order which only changes when a counter is added or removed.
+ * snap->gen identifies that order; the name of the counter at a position is
+ * read with nvgpu_ecc_snapshot_stat_name(). Each counter value is read
+ * once, the counters keep counting while the snapshot is taken.
+ *
+ * @return 0 in case of success, snap->count is set to the number of counters.
+ * @return -ENOSPC if snap->size is smaller than the number of counters, which
+ *	   is returned in snap->count.
+ * @return -ENOMEM if the counter index could not be allocated.
+ */
+int nvgpu_ecc_snapshot(struct gk20a *g, struct nvgpu_ecc_snapshot *snap);
+
+/**
+ * @brief Compute the counter increments between two snapshots.
+ *
+ * @param prev [in] Older snapshot.
+ * @param cur [in] Newer snapshot.
+ * @param delta [out] Increment of each counter, cur->count entries.
+ *
+ * Counters wrap at 32 bits, an increment is computed modulo 2^32.
+ *
+ * @return 0 in case of success.
+ * @return -EINVAL if the snapshots were taken with different counter lists.
+ */
+int nvgpu_ecc_snapshot_delta(const struct nvgpu_ecc_snapshot *prev,
+		const struct nvgpu_ecc_snapshot *cur, u32 *delta);
+
+/**
+ * @brief Name of the counter at a snapshot position.
+ *
+ * @param g [in] The GPU driver struct.
+ * @param snap [in] Snapshot taken with nvgpu_ecc_snapshot().
+ * @param index [in] Position of the counter in the snapshot.
+ *
+ * @return Name of the counter, NULL if the counter list changed since the
+ *	   snapshot was taken or index is out of range.
+ */
+const char *nvgpu_ecc_snapshot_stat_name(struct gk20a *g,
+		const struct nvgpu_ecc_snapshot *snap, u32 index);
+
 #ifdef CONFIG_NVGPU_SYSFS
 int nvgpu_ecc_sysfs_init(struct gk20a *g);
 void nvgpu_ecc_sysfs_remove(struct gk20a *g);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -65,6 +65,13 @@ int nvgpu_engine_mem_queue_pop(struct nvgpu_falcon *flcn,
 	u32 *bytes_read);
 int nvgpu_engine_mem_queue_push(struct nvgpu_falcon *flcn,
 	struct nvgpu_engine_mem_queue *queue, void *data, u32 size);
+/*
+ * Write count commands contiguously and publish them with a single head
+ * update. Returns -EAGAIN, writing nothing, if they do not all fit.
+ */
+int nvgpu_engine_mem_queue_push_batch(struct nvgpu_falcon *flcn,
+	struct nvgpu_engine_mem_queue *queue, void *const *data,
+	const u32 *size, u32 count);
 void nvgpu_engine_mem_queue_free(struct nvgpu_engine_mem_queue **queue_p);
 u32 nvgpu_engine_mem_queue_get_size(struct nvgpu_engine_mem_queue *queue);
 
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NVGPU_FALCON_SEQ_H
+#define NVGPU_FALCON_SEQ_H
+
+#include <nvgpu/types.h>
+#include <nvgpu/atomic.h>
+#include <nvgpu/swhist.h>
+
+struct gk20a;
+
+/**
+ * @file
+ *
+ * Sequence ID allocator for falcon command queues.
+ *
+ * Every command posted to a falcon (PMU, GSP) carries a sequence ID which the
+ * falcon echoes back in the response. IDs are tracked in a bitmap of atomic
+ * words, fronted by a small cache of recently released IDs, so that neither
+ * acquire nor release needs a lock. The allocator also records the time from
+ * acquire to completion of every sequence in a latency histogram per caller
+ * supplied tag (the unit ID of the command).
+ */
+
+/** Maximum number of sequence IDs, sequence IDs are u8 in falcon headers. */
+#define NVGPU_FALCON_SEQ_MAX_IDS	256U
+/** Number of IDs tracked by one bitmap word. */
+#define NVGPU_FALCON_SEQ_WORD_BITS	32U
+/** Number of bitmap words. */
+#define NVGPU_FALCON_SEQ_TBL_WORDS	\
+	(NVGPU_FALCON_SEQ_MAX_IDS / NVGPU_FALCON_SEQ_WORD_BITS)
+/** Number of recently released IDs kept aside for reuse. */
+#define NVGPU_FALCON_SEQ_CACHE_SIZE	4U
+/**
+ * Number of latency histograms. Unit IDs of firmware commands are below it,
+ * larger tags (test units) share the last histogram.
+ */
+#define NVGPU_FALCON_SEQ_MAX_TAGS	64U
+
+/** Sequence ID allocator. */
+struct nvgpu_falcon_seq_alloc {
+	/** Number of IDs handed out, at most #NVGPU_FALCON_SEQ_MAX_IDS. */
+	u32 num_ids;
+	/** Bitmap word to start the next search from. */
+	nvgpu_atomic_t hint;
+	/** Bitmap of IDs in use, or held in the cache. */
+	nvgpu_atomic_t tbl[NVGPU_FALCON_SEQ_TBL_WORDS];
+	/** Released IDs plus one, 0 for an empty slot. */
+	nvgpu_atomic_t cache[NVGPU_FALCON_SEQ_CACHE_SIZE];
+	/** Acquire time of each ID. */
+	s64 post_ns[NVGPU_FALCON_SEQ_MAX_IDS];
+	/** Latency histogram index of each ID. */
+	u8 tag[NVGPU_FALCON_SEQ_MAX_IDS];
+	/** Latency histograms indexed by tag. */
+	struct nvgpu_swhist lat[NVGPU_FALCON_SEQ_MAX_TAGS];
+};
+
+/**
+ * @brief Reset a sequence ID allocator.
+ *
+ * @param seqs [in]	Allocator to reset.
+ * @param num_ids [in]	Number of IDs to hand out, clamped to
+ *			#NVGPU_FALCON_SEQ_MAX_IDS.
+ *
+ * All IDs are marked free and the latency histograms are cleared. Must not
+ * run concurrently with any other call on the same allocator.
+ */
+void nvgpu_falcon_seq_alloc_init(struct nvgpu_falcon_seq_alloc *seqs,
+		u32 num_ids);
+
+/**
+ * @brief Acquire a free sequence ID.
+ *
+ * @param seqs [in]	Allocator.
+ * @param tag [in]	Tag the latency of this sequence is accounted to.
+ * @param id [out]	Acquired ID.
+ *
+ * @return 0 on success, -EAGAIN if all IDs are in use.
+ */
+int nvgpu_falcon_seq_acquire(struct nvgpu_falcon_seq_alloc *seqs, u8 tag,
+		u32 *id);
+
+/**
+ * @brief Release a sequence ID.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param seqs [in]	Allocator.
+ * @param id [in]	ID to release, must have been acquired.
+ * @param completed [in]	The falcon responded to the sequence; record
+ *				its latency for the tag given at acquire.
+ */
+void nvgpu_falcon_seq_release(struct gk20a *g,
+		struct nvgpu_falcon_seq_alloc *seqs, u32 id, bool completed);
+
+/**
+ * @brief Read the latency histogram of a tag.
+ *
+ * @param seqs [in]	Allocator.
+ * @param tag [in]	Tag to read.
+ * @param data [out]	Filled with a copy of the histogram.
+ */
+void nvgpu_falcon_seq_get_latency(struct nvgpu_falcon_seq_alloc *seqs,
+		u8 tag, struct nvgpu_swhist_data *data);
+
+#endif /* NVGPU_FALCON_SEQ_H */
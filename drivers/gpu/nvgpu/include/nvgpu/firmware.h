@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2016-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -37,6 +37,51 @@ struct gk20a;
 #define NVGPU_REQUEST_FIRMWARE_NO_WARN		BIT32(0)
 /** Do not attempt loading from path <SOC_NAME>. */
 #define NVGPU_REQUEST_FIRMWARE_NO_SOC		BIT32(1)
+/**
+ * Return a shared read-only view of the cached firmware image instead of a
+ * private copy. The caller must not modify the data.
+ */
+#define NVGPU_REQUEST_FIRMWARE_READ_ONLY	BIT32(2)
+
+/**
+ * Default size of idle firmware images retained by the LRU policy. Idle
+ * images stay pinned in kernel memory on Linux, so only keep about what
+ * one poweron of an iGPU reloads (netlist and ctxsw ucode).
+ */
+#define NVGPU_FIRMWARE_CACHE_DEFAULT_BUDGET	(2UL * 1024UL * 1024UL)
+
+/** Firmware image cache eviction policies. */
+enum nvgpu_firmware_cache_policy {
+	/** Drop the cached image as soon as its last user releases it. */
+	NVGPU_FIRMWARE_CACHE_RELEASE = 0,
+	/** Retain all cached images until the cache is flushed. */
+	NVGPU_FIRMWARE_CACHE_KEEP,
+	/**
+	 * Retain idle images up to a byte budget, evicting the least recently
+	 * used image first.
+	 */
+	NVGPU_FIRMWARE_CACHE_LRU,
+};
+
+/** Firmware image cache statistics. */
+struct nvgpu_firmware_cache_stats {
+	/** Requests served from an already cached image. */
+	u64 hits;
+	/** Requests which had to load the image from the filesystem. */
+	u64 misses;
+	/** Cached images dropped by the eviction policy or a flush. */
+	u64 evictions;
+	/** Total time spent loading images on cache misses. */
+	u64 load_ns;
+	/** Total bytes of images loaded into the cache. */
+	u64 bytes_loaded;
+	/** Total bytes copied out of the cache for writable requests. */
+	u64 bytes_copied;
+	/** Bytes currently held by the cache. */
+	u64 cached_bytes;
+	/** Images currently held by the cache. */
+	u32 entries;
+};
 
 /** Structure to store firmware blob. */
 struct nvgpu_firmware {
@@ -44,6 +89,8 @@ struct nvgpu_firmware {
 	u8 *data;
 	/** Firmware data size. */
 	size_t size;
+	/** OS specific cache entry backing this firmware, if any. */
+	void *priv;
 };
 
 /**
@@ -62,6 +109,10 @@ struct nvgpu_firmware {
  *   it to caller.
  * - nvgpu_firmware will have pointer to fw data which will be filled with the
  *   data of ucode. Size of this ucode will be saved to nvgpu_firmware->size.
+ * - Images are cached across requests. With
+ *   #NVGPU_REQUEST_FIRMWARE_READ_ONLY the data points into the cached image
+ *   shared by all such requests; otherwise it is a private copy which the
+ *   caller may modify.
  *
  * @return Pointer to allocated nvgpu_firmware structure in case of success or
  * else NULL.
@@ -79,4 +130,35 @@ struct nvgpu_firmware *nvgpu_request_firmware(struct gk20a *g,
  */
 void nvgpu_release_firmware(struct gk20a *g, struct nvgpu_firmware *fw);
 
+/**
+ * @brief Select the eviction policy of the firmware image cache.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param policy [in]	Eviction policy, see #nvgpu_firmware_cache_policy.
+ * @param budget [in]	Bytes of idle images to retain with
+ *			#NVGPU_FIRMWARE_CACHE_LRU; ignored otherwise.
+ *
+ * Idle images which no longer fit the new policy are evicted right away.
+ */
+void nvgpu_firmware_cache_set_policy(struct gk20a *g,
+		enum nvgpu_firmware_cache_policy policy, size_t budget);
+
+/**
+ * @brief Read the firmware image cache statistics.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param stats [out]	Filled with a snapshot of the cache statistics.
+ */
+void nvgpu_firmware_cache_get_stats(struct gk20a *g,
+		struct nvgpu_firmware_cache_stats *stats);
+
+/**
+ * @brief Evict all idle images from the firmware image cache.
+ *
+ * @param g [in]	The GPU driver struct.
+ *
+ * Images still referenced by an unreleased #nvgpu_firmware stay cached.
+ */
+void nvgpu_firmware_cache_flush(struct gk20a *g);
+
 #endif /* NVGPU_FIRMWARE_H */
@@ -164,7 +164,9 @@ enum nvgpu_profiler_pm_reservation_scope;
 #include <nvgpu/fifo.h>
 #include <nvgpu/sched.h>
 #include <nvgpu/ipa_pa_cache.h>
+#include <nvgpu/swhist.h>
 #include <nvgpu/mig.h>
+#include <nvgpu/nvgpu_init.h>
 
 #include <nvgpu/gpu_ops.h>
 
@@ -548,6 +550,21 @@ struct gk20a {
 	/** User disabled timeouts */
 	bool timeouts_disabled_by_user;
 
+	/** Worker threads used to run async init table steps */
+	u32 init_workers;
+	/** Timing of the last early/finalize poweron init table runs */
+	struct nvgpu_init_profile init_profile[NVGPU_INIT_STAGE_MAX];
+
+	/** Register batches written, see nvgpu_writel_batch() */
+	nvgpu_atomic64_t reg_batches;
+	/** Registers written by register batches */
+	nvgpu_atomic64_t reg_batch_writes;
+
+	/** Latency histograms of the always-on probe points */
+	struct nvgpu_swhist swhist[NVGPU_SWHIST_NUM_PROBES];
+	/** Time spent writing register batches */
+	nvgpu_atomic64_t reg_batch_ns;
+
 #ifdef CONFIG_NVGPU_CHANNEL_WDT
 	unsigned int ch_wdt_init_limit_ms;
 	u32 ctxsw_wdt_period_us;
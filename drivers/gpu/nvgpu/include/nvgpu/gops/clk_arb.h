@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2020-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -23,6 +23,8 @@
 #define NVGPU_GOPS_CLK_ARB_H
 
 #ifdef CONFIG_NVGPU_CLK_ARB
+struct nvgpu_clk_slave_freq;
+
 struct gops_clk_arb {
 	int (*clk_arb_init_arbiter)(struct gk20a *g);
 	int (*arbiter_clk_init)(struct gk20a *g);
@@ -34,6 +36,11 @@ struct gops_clk_arb {
 			u16 *min_mhz, u16 *max_mhz);
 	int (*get_arbiter_clk_default)(struct gk20a *g, u32 api_domain,
 			u16 *default_mhz);
+	/* Fill in the slave clocks of setfllclk->gpc_mhz. */
+	int (*get_arbiter_slave_clks)(struct gk20a *g,
+			struct nvgpu_clk_slave_freq *setfllclk);
+	int (*get_arbiter_pstate_range)(struct gk20a *g, u32 pstate,
+			u32 api_domain, u16 *min_mhz, u16 *max_mhz);
 	void (*clk_arb_run_arbiter_cb)(struct nvgpu_clk_arb *arb);
 	/* This function is inherently unsafe to call while
 	 *  arbiter is running arbiter must be blocked
@@ -1149,6 +1149,9 @@ struct gops_gr_zbc {
 	int (*set_table)(struct gk20a *g,
 		struct nvgpu_gr_zbc *zbc,
 		struct nvgpu_gr_zbc_entry *zbc_val);
+	int (*set_table_batch)(struct gk20a *g,
+		struct nvgpu_gr_zbc *zbc,
+		struct nvgpu_gr_zbc_entry **zbc_vals, u32 count);
 	int (*query_table)(struct gk20a *g,
 		struct nvgpu_gr_zbc *zbc,
 		struct nvgpu_gr_zbc_query_params *query_params);
@@ -349,6 +349,11 @@ u32 nvgpu_gr_ctx_get_sm_diversity_config(struct nvgpu_gr_ctx *gr_ctx);
  * Local golden image copy is saved while creating first graphics context
  * buffer. Subsequent graphics contexts can be initialized by loading
  * golden image into new context with this function.
+ *
+ * Context independent ctxsw header fields are baked into a variant of
+ * local golden image the first time a configuration is seen, so that
+ * later contexts with same configuration are initialized with a single
+ * bulk copy.
  */
 void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
 	struct nvgpu_gr_ctx *gr_ctx,
@@ -366,6 +371,9 @@ void nvgpu_gr_ctx_load_golden_ctx_image(struct gk20a *g,
  * This function will prepare patch context buffer for writes. This
  * function must be called before calling #nvgpu_gr_ctx_patch_write()
  * to add entries into the buffer.
+ *
+ * Patch entries written after this call are staged in CPU memory and
+ * copied into patch context buffer in bulk.
  */
 void nvgpu_gr_ctx_patch_write_begin(struct gk20a *g,
 	struct nvgpu_gr_ctx *gr_ctx,
@@ -379,9 +387,9 @@ void nvgpu_gr_ctx_patch_write_begin(struct gk20a *g,
  * @param update_patch_count [in]	Boolean flag to update data count
  *                                      in patch context.
  *
- * This function will write final data count into patch context image
- * after all entries have been written by calling
- * #nvgpu_gr_ctx_patch_write().
+ * This function will flush all staged entries into patch context buffer
+ * and write final data count into patch context image after all entries
+ * have been written by calling #nvgpu_gr_ctx_patch_write().
  */
 void nvgpu_gr_ctx_patch_write_end(struct gk20a *g,
 	struct nvgpu_gr_ctx *gr_ctx,
@@ -26,9 +26,10 @@
 #ifdef CONFIG_NVGPU_FECS_TRACE
 
 #include <nvgpu/types.h>
-#include <nvgpu/list.h>
+#include <nvgpu/atomic.h>
 #include <nvgpu/lock.h>
 #include <nvgpu/periodic_timer.h>
+#include <nvgpu/gr/fecs_trace_ctx.h>
 
 /*
  * If HW circular buffer is getting too many "buffer full" conditions,
@@ -38,6 +39,12 @@
 #define GK20A_FECS_TRACE_FRAME_PERIOD_NS	(1000000000ULL/60ULL)
 #define GK20A_FECS_TRACE_PTIMER_SHIFT		5
 
+/*
+ * Number of FECS records consumed before the read index is handed back
+ * to FECS and readers are woken up.
+ */
+#define NVGPU_FECS_TRACE_POLL_BATCH		64
+
 #define NVGPU_GPU_CTXSW_TAG_SOF                     0x00U
 #define NVGPU_GPU_CTXSW_TAG_CTXSW_REQ_BY_HOST       0x01U
 #define NVGPU_GPU_CTXSW_TAG_FE_ACK                  0x02U
@@ -66,15 +73,36 @@ struct nvgpu_gr_ctx;
 struct nvgpu_tsg;
 struct vm_area_struct;
 
+struct nvgpu_fecs_trace_stats {
+	/* FECS records consumed */
+	u64 records;
+	/* trace entries generated from FECS records */
+	u64 entries;
+	/* trace entries the consumer could not take */
+	u64 dropped;
+	/* FECS records with bad magic */
+	u64 invalid;
+	/* polls that found records to consume */
+	u64 polls;
+	/* records consumed per second over the last poll interval */
+	u64 records_per_sec;
+	/* entries in context_ptr -> pid table */
+	u32 contexts;
+};
+
 struct nvgpu_gr_fecs_trace {
-	struct nvgpu_list_node context_list;
-	struct nvgpu_mutex list_lock;
+	/* context_ptr -> pid table */
+	struct nvgpu_gr_fecs_trace_ctx_table ctx_table;
 
 	struct nvgpu_mutex poll_lock;
 	struct nvgpu_periodic_timer poll_timer;
 
 	struct nvgpu_mutex enable_lock;
 	u32 enable_count;
+
+	/* protected by poll_lock */
+	struct nvgpu_fecs_trace_stats stats;
+	s64 last_poll_ns;
 };
 
 struct nvgpu_fecs_trace_record {
@@ -118,23 +146,6 @@ struct nvgpu_gpu_ctxsw_trace_filter {
 	u64 tag_bits[(NVGPU_GPU_CTXSW_FILTER_SIZE + 63) / 64];
 };
 
-struct nvgpu_fecs_trace_context_entry {
-	u32 context_ptr;
-
-	pid_t pid;
-	u32 vmid;
-
-	struct nvgpu_list_node entry;
-};
-
-static inline struct nvgpu_fecs_trace_context_entry *
-nvgpu_fecs_trace_context_entry_from_entry(struct nvgpu_list_node *node)
-{
-	return (struct nvgpu_fecs_trace_context_entry *)
-		((uintptr_t)node -
-		offsetof(struct nvgpu_fecs_trace_context_entry, entry));
-};
-
 int nvgpu_gr_fecs_trace_init(struct gk20a *g);
 int nvgpu_gr_fecs_trace_deinit(struct gk20a *g);
 
@@ -145,13 +156,13 @@ bool nvgpu_gr_fecs_trace_is_valid_record(struct gk20a *g,
 	struct nvgpu_fecs_trace_record *r);
 
 int nvgpu_gr_fecs_trace_add_context(struct gk20a *g, u32 context_ptr,
-	pid_t pid, u32 vmid, struct nvgpu_list_node *list);
-void nvgpu_gr_fecs_trace_remove_context(struct gk20a *g, u32 context_ptr,
-	struct nvgpu_list_node *list);
-void nvgpu_gr_fecs_trace_remove_contexts(struct gk20a *g,
-	struct nvgpu_list_node *list);
+	pid_t pid, u32 vmid);
+void nvgpu_gr_fecs_trace_remove_context(struct gk20a *g, u32 context_ptr);
+void nvgpu_gr_fecs_trace_remove_contexts(struct gk20a *g);
 void nvgpu_gr_fecs_trace_find_pid(struct gk20a *g, u32 context_ptr,
-	struct nvgpu_list_node *list, pid_t *pid, u32 *vmid);
+	pid_t *pid, u32 *vmid);
+void nvgpu_gr_fecs_trace_get_stats(struct gk20a *g,
+	struct nvgpu_fecs_trace_stats *stats);
 
 size_t nvgpu_gr_fecs_trace_buffer_size(struct gk20a *g);
 int nvgpu_gr_fecs_trace_max_entries(struct gk20a *g,
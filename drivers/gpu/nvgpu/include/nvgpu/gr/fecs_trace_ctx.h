@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NVGPU_GR_FECS_TRACE_CTX_H
+#define NVGPU_GR_FECS_TRACE_CTX_H
+
+#include <nvgpu/types.h>
+#include <nvgpu/atomic.h>
+#include <nvgpu/lock.h>
+
+/*
+ * Number of slots in the context_ptr -> pid hash table. The table is never
+ * filled beyond 3/4 so that probe sequences stay short.
+ */
+#define NVGPU_FECS_TRACE_CTX_TABLE_SHIFT	12U
+#define NVGPU_FECS_TRACE_CTX_TABLE_SIZE		\
+	(1U << NVGPU_FECS_TRACE_CTX_TABLE_SHIFT)
+#define NVGPU_FECS_TRACE_CTX_TABLE_MAX		\
+	((NVGPU_FECS_TRACE_CTX_TABLE_SIZE / 4U) * 3U)
+
+struct gk20a;
+
+struct nvgpu_fecs_trace_context_entry {
+	/* 0 if slot is free */
+	u32 context_ptr;
+
+	pid_t pid;
+	u32 vmid;
+};
+
+/*
+ * Open addressing (linear probing) context_ptr -> pid table.
+ * Updates are serialized by lock and bracketed by seq, which is odd while an
+ * update is in progress. Entry fields are stored with NV_WRITE_ONCE().
+ * Lookups first try without the lock, reading entries with NV_READ_ONCE(),
+ * and take the lock only if an update was in progress or seq moved
+ * underneath them.
+ */
+struct nvgpu_gr_fecs_trace_ctx_table {
+	struct nvgpu_fecs_trace_context_entry *entries;
+	u32 count;
+	nvgpu_atomic_t seq;
+	struct nvgpu_mutex lock;
+};
+
+int nvgpu_gr_fecs_trace_ctx_table_init(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table);
+void nvgpu_gr_fecs_trace_ctx_table_deinit(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table);
+int nvgpu_gr_fecs_trace_ctx_table_add(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr,
+	pid_t pid, u32 vmid);
+void nvgpu_gr_fecs_trace_ctx_table_remove(struct gk20a *g,
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr);
+void nvgpu_gr_fecs_trace_ctx_table_clear(
+	struct nvgpu_gr_fecs_trace_ctx_table *table);
+bool nvgpu_gr_fecs_trace_ctx_table_find(
+	struct nvgpu_gr_fecs_trace_ctx_table *table, u32 context_ptr,
+	pid_t *pid, u32 *vmid);
+u32 nvgpu_gr_fecs_trace_ctx_table_count(
+	struct nvgpu_gr_fecs_trace_ctx_table *table);
+
+#endif /* NVGPU_GR_FECS_TRACE_CTX_H */
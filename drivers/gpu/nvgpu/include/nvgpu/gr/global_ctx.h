@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -302,6 +302,81 @@ void nvgpu_gr_global_ctx_load_local_golden_image(struct gk20a *g,
 void nvgpu_gr_global_ctx_deinit_local_golden_image(struct gk20a *g,
 	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image);
 
+/** Golden image variant has CDE enabled. */
+#define NVGPU_GR_GLOBAL_CTX_VARIANT_CDE			BIT32(0)
+/** Golden image variant has priv access map set to allow all. */
+#define NVGPU_GR_GLOBAL_CTX_VARIANT_ALLOW_ALL		BIT32(1)
+/** Golden image variant has boosted clock frequencies. */
+#define NVGPU_GR_GLOBAL_CTX_VARIANT_BOOST		BIT32(2)
+
+/** Number of golden image variant keys, one slot per key is kept. */
+#define NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX		BIT32(3)
+
+/**
+ * Local golden image variant usage statistics.
+ */
+struct nvgpu_gr_global_ctx_variant_stats {
+	/** Number of variants currently cached. */
+	u32 variants;
+	/** Bytes of memory held by cached variants. */
+	size_t bytes;
+	/** Number of context loads served from a cached variant. */
+	u64 hits;
+	/** Number of context loads without a cached variant. */
+	u64 misses;
+};
+
+/**
+ * @brief Load cached golden image variant into target memory.
+ *
+ * @param g [in]			Pointer to GPU driver struct.
+ * @param local_golden_image [in]	Pointer to local golden context image struct.
+ * @param key [in]			Variant key, NVGPU_GR_GLOBAL_CTX_VARIANT_*.
+ * @param target_mem [in]		Pointer to target memory.
+ *
+ * A variant is a copy of local golden image with all context independent
+ * ctxsw header fields for configuration #key already applied. If a variant
+ * for #key is cached, this function copies it into #target_mem with one
+ * bulk write.
+ *
+ * @return true if variant was found and loaded, false otherwise. In the
+ *         latter case #target_mem is untouched.
+ */
+bool nvgpu_gr_global_ctx_load_local_golden_image_variant(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	u32 key, struct nvgpu_mem *target_mem);
+
+/**
+ * @brief Save golden image variant from source memory.
+ *
+ * @param g [in]			Pointer to GPU driver struct.
+ * @param local_golden_image [in]	Pointer to local golden context image struct.
+ * @param key [in]			Variant key, NVGPU_GR_GLOBAL_CTX_VARIANT_*.
+ * @param source_mem [in]		Pointer to source memory.
+ *
+ * This function captures #source_mem as the variant for #key. #source_mem
+ * must hold local golden image with only the context independent fields
+ * for #key applied. Variants are dropped when local golden image is
+ * re-initialized.
+ *
+ * @return 0 in case of success, < 0 in case of failure.
+ * @retval -EINVAL if #key is not a valid variant key.
+ * @retval -ENOMEM if variant memory allocation fails.
+ */
+int nvgpu_gr_global_ctx_save_local_golden_image_variant(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	u32 key, struct nvgpu_mem *source_mem);
+
+/**
+ * @brief Get golden image variant statistics.
+ *
+ * @param local_golden_image [in]	Pointer to local golden context image struct.
+ * @param stats [out]			Pointer to statistics struct.
+ */
+void nvgpu_gr_global_ctx_get_variant_stats(
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image,
+	struct nvgpu_gr_global_ctx_variant_stats *stats);
+
 #ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
 /**
  * @brief Compare two local golden images.
@@ -319,6 +394,9 @@ void nvgpu_gr_global_ctx_deinit_local_golden_image(struct gk20a *g,
  * has been captured correctly or not. To verify, common.gr unit
  * will capture the golden image twice and compare.
  *
+ * Images are compared in bulk; word level differences are walked and
+ * logged only on mismatch.
+ *
  * @return true in case both the golden images match, false otherwise.
  */
 bool nvgpu_gr_global_ctx_compare_golden_images(struct gk20a *g,
@@ -326,6 +404,22 @@ bool nvgpu_gr_global_ctx_compare_golden_images(struct gk20a *g,
 	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image1,
 	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image2,
 	size_t size);
+
+/**
+ * @brief Verify local golden image against its checksum.
+ *
+ * @param g [in]			Pointer to GPU driver struct.
+ * @param local_golden_image [in]	Pointer to local golden context image struct.
+ *
+ * A 64-bit checksum is computed and saved with local golden image when it
+ * is initialized. This function recomputes the checksum and compares it
+ * with the saved one, so an image can be re-verified without a second
+ * copy to compare against.
+ *
+ * @return true if checksum matches, false otherwise.
+ */
+bool nvgpu_gr_global_ctx_verify_local_golden_image(struct gk20a *g,
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image);
 #endif
 
 #ifdef NVGPU_UNITTEST_FAULT_INJECTION_ENABLEMENT
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -26,6 +26,8 @@
 #ifdef CONFIG_NVGPU_DEBUGGER
 
 #include <nvgpu/types.h>
+#include <nvgpu/lock.h>
+#include <nvgpu/thread.h>
 
 struct gk20a;
 struct ctxsw_buf_offset_map_entry;
@@ -37,12 +39,35 @@ struct ctxsw_buf_offset_map_entry {
 };
 
 struct nvgpu_gr_hwpm_map {
+	struct gk20a *g;
+
 	u32 pm_ctxsw_image_size;
 
 	u32 count;
 	struct ctxsw_buf_offset_map_entry *map;
 
+	/*
+	 * Open addressed hash table of the map entries keyed by register
+	 * address, with 1 << (32 - hash_shift) slots. Unused slots have
+	 * an address of ~0.
+	 */
+	struct ctxsw_buf_offset_map_entry *hash;
+	u32 hash_shift;
+	/* Longest probe sequence of any entry in the hash table */
+	u32 hash_max_probe;
+
+	/*
+	 * Set once the map and hash table are built. They are not modified
+	 * afterwards, so lookups read them without taking the lock.
+	 */
 	bool init;
+
+	/* Serializes building the map */
+	struct nvgpu_mutex lock;
+	/* Thread building the map in the background after GR init */
+	struct nvgpu_thread build_thread;
+	bool build_thread_started;
+	struct nvgpu_gr_config *build_config;
 };
 
 int nvgpu_gr_hwpm_map_init(struct gk20a *g, struct nvgpu_gr_hwpm_map **hwpm_map,
@@ -52,6 +77,10 @@ void nvgpu_gr_hwpm_map_deinit(struct gk20a *g,
 
 u32 nvgpu_gr_hwpm_map_get_size(struct nvgpu_gr_hwpm_map *hwpm_map);
 
+int nvgpu_gr_hwpm_map_build_async(struct gk20a *g,
+	struct nvgpu_gr_hwpm_map *hwpm_map, struct nvgpu_gr_config *config);
+void nvgpu_gr_hwpm_map_wait_build(struct nvgpu_gr_hwpm_map *hwpm_map);
+
 int nvgpu_gr_hwmp_map_find_priv_offset(struct gk20a *g,
 	struct nvgpu_gr_hwpm_map *hwpm_map,
 	u32 addr, u32 *priv_offset, struct nvgpu_gr_config *config);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -293,6 +293,25 @@ size_t nvgpu_gr_obj_ctx_get_golden_image_size(
 bool nvgpu_gr_obj_ctx_is_golden_image_ready(
 	struct nvgpu_gr_obj_ctx_golden_image *golden_image);
 
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+/**
+ * @brief Re-verify golden context image.
+ *
+ * @param g [in]		Pointer to GPU driver struct.
+ * @param golden_image [in]	Pointer to golden context image struct.
+ *
+ * This function checks local golden context image against the checksum
+ * saved when it was captured. It is used when GR is brought up again and
+ * the existing golden context image is going to be reused.
+ *
+ * @return 0 if golden context image is not ready yet or is intact,
+ *         < 0 otherwise.
+ * @retval -EINVAL if golden context image does not match its checksum.
+ */
+int nvgpu_gr_obj_ctx_verify_golden_image(struct gk20a *g,
+	struct nvgpu_gr_obj_ctx_golden_image *golden_image);
+#endif
+
 /**
  * @brief Initialize object context.
  *
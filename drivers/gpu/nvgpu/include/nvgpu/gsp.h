@@ -68,4 +68,7 @@ void nvgpu_gsp_isr_support(struct gk20a *g, struct nvgpu_gsp *gsp, bool enable);
 int nvgpu_gsp_wait_for_priv_lockdown_release(struct nvgpu_gsp *gsp,
 		signed int timeoutms);
 int nvgpu_gsp_runlist_submit(struct gk20a *g, struct nvgpu_runlist *runlist);
+/* Submit several runlists to the GSP in one command batch. */
+int nvgpu_gsp_runlists_submit(struct gk20a *g,
+		struct nvgpu_runlist **runlists, u32 count);
 #endif /* NVGPU_GSP */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -282,4 +282,75 @@ void nvgpu_func_writel(struct gk20a *g, u32 r, u32 v);
  */
 u32 nvgpu_func_readl(struct gk20a *g, u32 r);
 
+/**
+ * Precompiled table of register writes.
+ *
+ * The table is an array of @a count entries of @a stride 32-bit words each.
+ * The first word of every entry is the BAR0 register offset and the word at
+ * index @a value is the value to write. This lets existing tables such as
+ * struct gating_desc or struct netlist_av be written without repacking them.
+ */
+struct nvgpu_reg_batch {
+	/** First word of the first entry. */
+	const u32 *table;
+	/** Number of entries in the table. */
+	u32 count;
+	/** Size of an entry in 32-bit words. */
+	u32 stride;
+	/** Index of the value word within an entry. */
+	u32 value;
+};
+
+/** Accumulated register batch statistics. */
+struct nvgpu_reg_batch_stats {
+	/** Number of batches written. */
+	u64 batches;
+	/** Number of registers written by batches. */
+	u64 writes;
+	/** Total time spent writing batches. */
+	u64 time_ns;
+};
+
+/**
+ * @brief Validate a register batch.
+ *
+ * @param g [in]		GPU super structure.
+ * @param batch [in]		Register batch to validate.
+ *
+ * - Check the table layout and that every register offset is word aligned
+ *   and, once BAR0 is mapped, falls into the BAR0 range.
+ *
+ * nvgpu_writel_batch() does not check individual entries, so tables built at
+ * run time should be validated once when they are created.
+ *
+ * @return 0 if the batch is valid, -EINVAL otherwise.
+ */
+int nvgpu_reg_batch_validate(struct gk20a *g,
+		const struct nvgpu_reg_batch *batch);
+
+/**
+ * @brief Write a precompiled table of registers.
+ *
+ * @param g [in]		GPU super structure.
+ * @param batch [in]		Register batch to write.
+ *
+ * - Write all entries of the batch in table order with relaxed writes,
+ *   issuing a single write barrier after the last one. The BAR0 mapping is
+ *   checked once for the whole batch.
+ *
+ * @return None.
+ */
+void nvgpu_writel_batch(struct gk20a *g, const struct nvgpu_reg_batch *batch);
+
+/**
+ * @brief Read the accumulated register batch statistics.
+ *
+ * @param g [in]		GPU super structure.
+ * @param stats [out]		Filled with the statistics.
+ *
+ * @return None.
+ */
+void nvgpu_reg_batch_get_stats(struct gk20a *g,
+		struct nvgpu_reg_batch_stats *stats);
+
 #endif /* NVGPU_IO_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2021-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -24,6 +24,7 @@
 #define NVGPU_IPAPACACHE_H
 
 #include <nvgpu/rwsem.h>
+#include <nvgpu/atomic.h>
 
 struct nvgpu_hyp_ipa_pa_info {
 	u64 base;
@@ -41,15 +42,70 @@ struct nvgpu_ipa_desc {
 	u64 pa_base;
 };
 
+/** IPA to PA cache statistics, see nvgpu_ipa_pa_cache_get_stats(). */
+struct nvgpu_ipa_pa_cache_stats {
+	/** Lookups which found a translation. */
+	u64 hits;
+	/** Lookups which found no translation. */
+	u64 misses;
+	/** Descriptors dropped to make room for new ones in a full cache. */
+	u64 evictions;
+	/** Stale descriptors dropped because a new range overlapped them. */
+	u64 replaced;
+	/** Descriptors currently cached. */
+	u32 entries;
+};
+
+/*
+ * The descriptors are kept sorted by IPA and do not overlap, so a lookup is
+ * a binary search. Descriptors contiguous in both IPA and PA are merged on
+ * insertion, so a single lookup returns the whole physically contiguous run
+ * following the IPA.
+ */
 struct nvgpu_ipa_pa_cache {
 	struct nvgpu_rwsem ipa_pa_rw_lock;
 	struct nvgpu_ipa_desc ipa[MAX_IPA_PA_CACHE];
 	u32 num_ipa_desc;
+	nvgpu_atomic64_t hits;
+	nvgpu_atomic64_t misses;
+	nvgpu_atomic64_t evictions;
+	nvgpu_atomic64_t replaced;
 };
 
+/**
+ * @brief Look up the translation of an IPA in the cache.
+ *
+ * @param g [in]	The GPU.
+ * @param ipa [in]	Intermediate physical address to translate.
+ * @param pa_len [out]	If not NULL, set on a hit to the length of the
+ *			physically contiguous range starting at \a ipa.
+ *
+ * @return Physical address of \a ipa, 0 if not cached.
+ */
 u64 nvgpu_ipa_to_pa_cache_lookup_locked(struct gk20a *g, u64 ipa,
 		u64 *pa_len);
 
+/**
+ * @brief Cache the translation of an IPA range.
+ *
+ * @param g [in]	The GPU.
+ * @param ipa [in]	Intermediate physical address which was translated.
+ * @param pa [in]	Physical address of \a ipa.
+ * @param info [in]	Physical chunk holding \a pa, as reported by the
+ *			hypervisor: base PA, offset of \a pa and size.
+ *
+ * Cached descriptors overlapping the new range are dropped and counted as
+ * replaced. When the cache is full one descriptor is evicted.
+ */
 void nvgpu_ipa_to_pa_add_to_cache(struct gk20a *g, u64 ipa,
 		u64 pa, struct nvgpu_hyp_ipa_pa_info *info);
+
+/**
+ * @brief Read the IPA to PA cache statistics.
+ *
+ * @param g [in]	The GPU.
+ * @param stats [out]	Filled with the current statistics.
+ */
+void nvgpu_ipa_pa_cache_get_stats(struct gk20a *g,
+		struct nvgpu_ipa_pa_cache_stats *stats);
 #endif /* NVGPU_IPAPACACHE_H */
@@ -167,6 +167,7 @@
 #include <nvgpu/sizes.h>
 #include <nvgpu/mmu_fault.h>
 #include <nvgpu/fb.h>
+#include <nvgpu/pramin.h>
 
 struct gk20a;
 struct vm_gk20a;
@@ -381,6 +382,14 @@ struct mm_gk20a {
 	 * the contiguous 1MB VIDMEM memory block.
 	 */
 	u32 pramin_window;
+	/** VIDMEM address covered by the start of the current window. */
+	u64 pramin_window_base;
+	/** Aperture of the memory the current window was set for. */
+	enum nvgpu_aperture pramin_window_aperture;
+	/** Whether the window base and aperture are valid. */
+	bool pramin_window_valid;
+	/** Window hit/miss statistics. */
+	struct nvgpu_pramin_stats pramin_stats;
 	/** Lock to serialize pramin access request. */
 	struct nvgpu_mutex pramin_window_lock;
 
@@ -524,7 +533,7 @@ void nvgpu_init_mm_ce_context(struct gk20a *g);
  *
  * MM init:
  * - MM S/W init:
- *   - Resets the current pramin window index to 0.
+ *   - Resets the current pramin window index, cached window and statistics.
  *   - Initializes the vidmem page allocator with size, flags and etc.
  *   - Allocates vidmem memory for acr blob from bootstrap region.
  *   - Creates the CE vidmem clear thread for vidmem clear operations
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2011-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -99,6 +99,20 @@ struct netlist_u32_list {
 	u32 count;
 };
 
+/**
+ * Netlist firmware parsing statistics.
+ */
+struct nvgpu_netlist_stats {
+	/** Bytes of lists used in place from the netlist firmware image. */
+	u64 bytes_saved;
+	/** Bytes of lists copied out of misaligned or truncated regions. */
+	u64 bytes_copied;
+	/** Time spent parsing the netlist firmware image in ns. */
+	u64 parse_ns;
+	/** Number of regions in the netlist firmware image. */
+	u32 regions;
+};
+
 /**
  * @brief Allocates memory for netlist bundles and populates
  * ctx region info from ctx firmware file.
@@ -125,6 +139,17 @@ int nvgpu_netlist_init_ctx_vars(struct gk20a *g);
  *
  */
 void nvgpu_netlist_deinit_ctx_vars(struct gk20a *g);
+/**
+ * @brief Read the netlist firmware parsing statistics.
+ *
+ * Netlist bundles are views into the retained netlist firmware image; they
+ * are only copied when a region is not aligned for its element type.
+ *
+ * @param g [in]		Pointer to GPU driver struct.
+ * @param stats [out]		Filled with the statistics of the last parse.
+ */
+void nvgpu_netlist_get_stats(struct gk20a *g,
+			struct nvgpu_netlist_stats *stats);
 /**
  * @brief Allocates memory for netlist av list bundle.
  *
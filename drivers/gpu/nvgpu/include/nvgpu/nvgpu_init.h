@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -28,6 +28,92 @@
 struct gk20a;
 struct nvgpu_ref;
 
+/**
+ * Maximum number of entries in an init table.
+ */
+#define NVGPU_INIT_TABLE_MAX_STEPS	64U
+
+/**
+ * Maximum number of worker threads used to run async init steps.
+ */
+#define NVGPU_INIT_MAX_WORKERS		4U
+
+/**
+ * Default number of init worker threads for OS layers that enable them.
+ */
+#define NVGPU_INIT_DEFAULT_WORKERS	2U
+
+/**
+ * Init table stages, used to index the init profiles.
+ */
+#define NVGPU_INIT_STAGE_EARLY		0U
+#define NVGPU_INIT_STAGE_FINALIZE	1U
+#define NVGPU_INIT_STAGE_MAX		2U
+
+typedef int (*nvgpu_init_func_t)(struct gk20a *g);
+
+/**
+ * Init table entry.
+ *
+ * A synchronous entry (async == false) runs on the calling thread after all
+ * entries before it in the table have completed.
+ *
+ * An async entry may run on an init worker thread as soon as the entries
+ * named in #deps have completed, possibly before synchronous entries that
+ * precede it in the table. It must complete before any synchronous entry
+ * that follows it in the table starts, so an async entry is placed right
+ * before the first entry that consumes its result.
+ */
+struct nvgpu_init_table_t {
+	/** Init function, step is skipped if NULL. */
+	nvgpu_init_func_t func;
+	/** Name for logs and the init profile. */
+	const char *name;
+	/** Step is skipped unless this enabled flag is set (0 for none). */
+	u32 enable_flag;
+	/** Non zero id that async entries can depend on. */
+	u32 id;
+	/** BIT64() mask of step ids this async entry depends on. */
+	u64 deps;
+	/** Entry may run on a worker thread. */
+	bool async;
+};
+
+/**
+ * Timing of a single init table entry.
+ */
+struct nvgpu_init_step_profile {
+	/** Entry name. */
+	const char *name;
+	/** Start time relative to the start of the table, in ns. */
+	s64 start_ns;
+	/** Wall time of the step, in ns. */
+	s64 duration_ns;
+	/** Return value of the step. */
+	int err;
+	/** 0 for the calling thread, otherwise worker index + 1. */
+	u32 worker;
+	/** Step did not run (not needed, or aborted after a failure). */
+	bool skipped;
+};
+
+/**
+ * Timing of an init table run.
+ */
+struct nvgpu_init_profile {
+	/** Number of valid entries in steps. */
+	u32 num_steps;
+	/** Number of worker threads used. */
+	u32 num_workers;
+	/** Wall time of the whole table, in ns. */
+	s64 wall_ns;
+	/** Sum of step wall times, i.e. time of a serial run, in ns. */
+	s64 busy_ns;
+	/** Index of the first failing step, num_steps if none failed. */
+	u32 failed_step;
+	struct nvgpu_init_step_profile steps[NVGPU_INIT_TABLE_MAX_STEPS];
+};
+
 /**
  * @file
  * @page unit-init Unit Init
@@ -131,6 +217,48 @@ int nvgpu_early_poweron(struct gk20a *g);
  */
 int nvgpu_finalize_poweron(struct gk20a *g);
 
+/**
+ * @brief Run an init table
+ *
+ * @param g [in]		The GPU
+ * @param table [in]		Init table entries.
+ * @param num_steps [in]	Number of entries in \a table.
+ * @param profile [out]		Per step timing.
+ *
+ * Runs the entries of \a table honouring the ordering rules described for
+ * #nvgpu_init_table_t. Synchronous entries run on the calling thread, async
+ * entries are shared between the calling thread and up to g->init_workers
+ * worker threads. Without workers the table runs in table order.
+ *
+ * Once a step fails no new steps are started, steps already running are
+ * waited for and the error of the failing step with the lowest table index
+ * is returned, regardless of the order in which the failures happened.
+ *
+ * Unlike a serial run, an async entry placed after the failing step may
+ * already have run to completion when the failure happens, and its effects
+ * are not undone. Async entries must therefore be idempotent and released
+ * by the regular teardown path.
+ *
+ * @return 0 in case of success, < 0 in case of failure.
+ * @retval -EINVAL if \a profile is NULL, the table is too large or an async
+ * entry depends on an entry that is not before it in the table.
+ */
+int nvgpu_init_run_table(struct gk20a *g,
+		const struct nvgpu_init_table_t *table, u32 num_steps,
+		struct nvgpu_init_profile *profile);
+
+/**
+ * @brief Get the init profile of a poweron stage
+ *
+ * @param g [in]	The GPU
+ * @param stage [in]	NVGPU_INIT_STAGE_EARLY or NVGPU_INIT_STAGE_FINALIZE.
+ *
+ * @return Timing of the last run of the stage's init table, NULL if \a stage
+ * is invalid.
+ */
+const struct nvgpu_init_profile *nvgpu_init_get_profile(struct gk20a *g,
+		u32 stage);
+
 /**
  * @brief Prepare driver for poweroff
  *
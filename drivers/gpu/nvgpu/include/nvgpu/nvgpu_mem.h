@@ -420,6 +420,74 @@ void nvgpu_mem_wr_n(struct gk20a *g, struct nvgpu_mem *mem, u64 offset,
 void nvgpu_memset(struct gk20a *g, struct nvgpu_mem *mem, u64 offset,
 		u32 c, u64 size);
 
+/** Kind of a vectored memory operation. */
+enum nvgpu_mem_op_type {
+	/** Copy between two nvgpu_mem buffers. */
+	NVGPU_MEM_OP_COPY = 0,
+	/** Fill a range with a constant byte value. */
+	NVGPU_MEM_OP_FILL,
+};
+
+/**
+ * One operation of a vectored memory access, see nvgpu_mem_ops_submit().
+ */
+struct nvgpu_mem_op {
+	/** Copy or fill. */
+	enum nvgpu_mem_op_type type;
+	/** Destination buffer. */
+	struct nvgpu_mem *dst;
+	/** Byte offset in #dst (32b-aligned). */
+	u64 dst_offset;
+	/** Source buffer of a copy, unused for a fill. */
+	struct nvgpu_mem *src;
+	/** Byte offset in #src (32b-aligned), unused for a fill. */
+	u64 src_offset;
+	/** Byte value of a fill, unused for a copy. */
+	u32 c;
+	/** Number of bytes (32b-aligned). */
+	u64 size;
+};
+
+/**
+ * @brief Run a list of copy and fill operations.
+ *
+ * @param[in] g		Pointer to GPU structure.
+ * @param[in] ops	Operations, run in list order.
+ * @param[in] num_ops	Number of operations.
+ *
+ * Consecutive operations which continue each other (same kind and buffers,
+ * adjacent ranges, same fill value) are merged and run as one. Each merged
+ * operation takes the cheapest path for its apertures: CPU memcpy/memset for
+ * sysmem, one PRAMIN window pass between sysmem and vidmem, and the copy
+ * engine for large vidmem copies and fills when it is available. Copies
+ * between overlapping ranges of the same buffer are not supported.
+ *
+ * All operations are checked before any is run.
+ *
+ * @return 0 in case of success, < 0 in case of failure.
+ * @retval -EINVAL if an operation has a bad buffer, range or fill value.
+ * @retval -ENOMEM if a vidmem to vidmem bounce buffer cannot be allocated.
+ */
+int nvgpu_mem_ops_submit(struct gk20a *g, const struct nvgpu_mem_op *ops,
+		u32 num_ops);
+
+/**
+ * @brief Copy size amount bytes from one memory to another.
+ *
+ * @param[in] g		Pointer to GPU structure.
+ * @param[in] dst	Pointer to destination nvgpu_mem structure.
+ * @param[in] dst_offset	Byte offset in dst (32b-aligned).
+ * @param[in] src	Pointer to source nvgpu_mem structure.
+ * @param[in] src_offset	Byte offset in src (32b-aligned).
+ * @param[in] size	Number of bytes to be copied (32b-aligned).
+ *
+ * Single operation nvgpu_mem_ops_submit().
+ *
+ * @return 0 in case of success, < 0 in case of failure.
+ */
+int nvgpu_mem_copy(struct gk20a *g, struct nvgpu_mem *dst, u64 dst_offset,
+		struct nvgpu_mem *src, u64 src_offset, u64 size);
+
 /**
  * @brief Request memory address.
  *
@@ -108,6 +108,21 @@ struct nvgpu_sgt {
 	void *sgl;
 };
 
+/**
+ * A physically contiguous range, see nvgpu_sgt_ipa_to_pa_batch().
+ */
+struct nvgpu_sgt_pa_range {
+	/**
+	 * Physical address of the start of the range.
+	 */
+	u64 pa;
+
+	/**
+	 * Length of the range in bytes.
+	 */
+	u64 length;
+};
+
 /**
  * This struct holds the necessary information for describing a struct
  * nvgpu_mem's scatter gather list.
@@ -232,6 +247,35 @@ u64 nvgpu_sgt_get_ipa(struct gk20a *g, struct nvgpu_sgt *sgt, void *sgl);
 u64 nvgpu_sgt_ipa_to_pa(struct gk20a *g, struct nvgpu_sgt *sgt,
 				void *sgl, u64 ipa, u64 *pa_len);
 
+/**
+ * @brief Translate all the entries of a scatter gather table to physical
+ *        address ranges.
+ *
+ * @param g          [in]	The GPU.
+ * @param sgt        [in]	Pointer to scatter gather table object.
+ * @param ranges     [out]	Array to fill with the physical ranges.
+ * @param max_ranges [in]	Number of elements of \a ranges.
+ * @param num_ranges [out]	Number of ranges filled in.
+ *
+ * - Walk the scatter gather list entries in order.
+ * - Translate the intermediate physical address of each entry with
+ *   nvgpu_sgt_ipa_to_pa(), once per physically contiguous chunk rather than
+ *   once per page.
+ * - Append each chunk to \a ranges, extending the last range instead when
+ *   the chunk directly follows it in physical memory.
+ *
+ * @return 0 on success.
+ * @retval -ENOSPC if \a ranges is too small; \a num_ranges is set to the
+ *         number of ranges translated so far.
+ * @retval -EINVAL if a translation fails: it returns a physical address of 0,
+ *         or reports no chunk length for a physical address other than the
+ *         IPA. \a num_ranges is set to the number of ranges translated so
+ *         far.
+ */
+int nvgpu_sgt_ipa_to_pa_batch(struct gk20a *g, struct nvgpu_sgt *sgt,
+		struct nvgpu_sgt_pa_range *ranges, u32 max_ranges,
+		u32 *num_ranges);
+
 /**
  * @brief Get the physical address associated with the scatter gather list.
  *
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -36,6 +36,7 @@
 #include <nvgpu/pmu/msg.h>
 #include <nvgpu/pmu/fw.h>
 #include <nvgpu/pmu/volt.h>
+#include <nvgpu/pmu/rpc_pool.h>
 
 struct pmu_sequences;
 struct pmu_mutexes;
@@ -215,12 +216,6 @@ struct nvgpu_clk_pmupstate;
 #define	PMU_BAR0_WRITE_FECSERR		10U
 
 #ifdef CONFIG_NVGPU_LS_PMU
-struct rpc_handler_payload {
-	void *rpc_buff;
-	bool is_mem_free_set;
-	bool complete;
-};
-
 struct pmu_rpc_desc {
 	void   *prpc;
 	u16 size_rpc;
@@ -409,6 +404,7 @@ struct nvgpu_pmu {
 	struct pmu_rtos_fw *fw;
 	struct pmu_queues queues;
 	struct pmu_sequences *sequences;
+	struct nvgpu_pmu_rpc_pool *rpc_pool;
 	struct pmu_mutexes *mutexes;
 
 	struct nvgpu_pmu_lsfm *lsfm;
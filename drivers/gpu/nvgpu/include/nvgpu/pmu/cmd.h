@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -28,6 +28,7 @@
 #include <nvgpu/pmu/pmuif/acr.h>
 #include <nvgpu/pmu/pmuif/pmgr.h>
 #include <nvgpu/pmu/pmuif/rpc.h>
+#include <nvgpu/pmu/rpc_pool.h>
 
 struct gk20a;
 struct pmu_payload;
@@ -62,6 +63,35 @@ int nvgpu_pmu_rpc_execute(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
 	u16 size_rpc, u16 size_scratch, pmu_callback caller_cb,
 	void *caller_cb_param, bool is_copy_back);
 
+/*
+ * Post an RPC without waiting for it. The RPC is copied to a preallocated
+ * buffer of the RPC pool. At most NVGPU_PMU_RPC_ASYNC_WINDOW RPCs are in
+ * flight; posting more waits for the oldest one to complete. An RPC which
+ * does not complete within the poll timeout is abandoned: its slot is
+ * skipped until the RPC completes, and its response is dropped.
+ *
+ * On success *fence identifies the RPC for nvgpu_pmu_rpc_wait(). It is 0 if
+ * nothing was posted because the GPU is going down. With is_copy_back the
+ * response is copied back to rpc on completion, so rpc must stay valid
+ * until the fence has been waited for.
+ */
+int nvgpu_pmu_rpc_post(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
+	u16 size_rpc, u16 size_scratch, bool is_copy_back, u64 *fence);
+
+/*
+ * Wait for a posted RPC to complete. On timeout the RPC is abandoned, the
+ * response is no longer copied back to the caller and -ETIMEDOUT is
+ * returned.
+ */
+int nvgpu_pmu_rpc_wait(struct nvgpu_pmu *pmu, u64 fence, u32 timeout_ms);
+
+/* Wait for all posted RPCs to complete. */
+int nvgpu_pmu_rpc_wait_all(struct nvgpu_pmu *pmu, u32 timeout_ms);
+
+/* Called by RPC handlers once the response has been processed. */
+void nvgpu_pmu_rpc_complete(struct gk20a *g,
+	struct rpc_handler_payload *rpc_payload);
+
 
 /* RPC */
 #define PMU_RPC_EXECUTE(_stat, _pmu, _unit, _func, _prpc, _size)\
@@ -91,6 +121,20 @@ int nvgpu_pmu_rpc_execute(struct nvgpu_pmu *pmu, struct nv_pmu_rpc_header *rpc,
 			(_size), NULL, NULL, true);	\
 	} while (false)
 
+/* RPC non-blocking, copies back data to _prpc once _fence is waited for */
+#define PMU_RPC_POST_CPB(_stat, _pmu, _unit, _func, _prpc, _size, _fence)\
+	do {                                                 \
+		(void) memset(&((_prpc)->hdr), 0, sizeof((_prpc)->hdr));\
+		\
+		(_prpc)->hdr.unit_id   = PMU_UNIT_##_unit;       \
+		(_prpc)->hdr.function = NV_PMU_RPC_ID_##_unit##_##_func;\
+		(_prpc)->hdr.flags    = 0x0;    \
+		\
+		_stat = nvgpu_pmu_rpc_post(_pmu, &((_prpc)->hdr),    \
+			(u16)(sizeof(*(_prpc)) - sizeof((_prpc)->scratch)),\
+			(_size), true, (_fence));	\
+	} while (false)
+
 /* RPC non-blocking with call_back handler option */
 #define PMU_RPC_EXECUTE_CB(_stat, _pmu, _unit, _func, _prpc, _size, _cb, _cbp)\
 	do {                                                 \
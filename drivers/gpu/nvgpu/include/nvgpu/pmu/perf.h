@@ -88,8 +88,9 @@ int nvgpu_pmu_perf_load(struct gk20a *g);
 
 int nvgpu_pmu_perf_vfe_get_s_param(struct gk20a *g, u64 *s_param);
 
-int nvgpu_pmu_perf_vfe_get_volt_margin(struct gk20a *g, u32 *vmargin_uv);
-int nvgpu_pmu_perf_vfe_get_freq_margin(struct gk20a *g, u32 *fmargin_mhz);
+/* Margins are left unchanged if the VBIOS has no equation for them. */
+int nvgpu_pmu_perf_vfe_get_margins(struct gk20a *g, u32 *fmargin_mhz,
+	u32 *vmargin_uv);
 
 int nvgpu_pmu_perf_changeseq_set_clks(struct gk20a *g,
 	struct nvgpu_clk_slave_freq *vf_point);
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NVGPU_PMU_RPC_POOL_H
+#define NVGPU_PMU_RPC_POOL_H
+
+#include <nvgpu/types.h>
+#include <nvgpu/lock.h>
+
+struct gk20a;
+
+/* Number of RPCs posted through the RPC pool which may be in flight. */
+#define NVGPU_PMU_RPC_ASYNC_WINDOW	16U
+/* Size of the preallocated RPC buffers, larger RPCs are allocated. */
+#define NVGPU_PMU_RPC_SLAB_SIZE		512U
+
+struct rpc_handler_payload {
+	void *rpc_buff;
+	bool is_mem_free_set;
+	bool complete;
+	/* Set for payloads owned by the RPC pool. */
+	bool pooled;
+	/* rpc_buff was allocated for this RPC and is freed on completion. */
+	bool free_rpc_buff;
+	/* Size of the RPC, copied back to copy_back on completion if set. */
+	u16 size_rpc;
+	void *copy_back;
+};
+
+/*
+ * Wait until the u8 at var equals val, processing PMU messages meanwhile,
+ * see nvgpu_pmu_wait_fw_ack_status().
+ */
+typedef int (*nvgpu_pmu_rpc_wait_ack_fn)(struct gk20a *g, u32 timeout_ms,
+	void *var, u8 val);
+
+/*
+ * RPC pool slot. Slots are used round robin in fence order, so the slot of
+ * fence f is slots[f % NVGPU_PMU_RPC_ASYNC_WINDOW].
+ */
+struct nvgpu_pmu_rpc_slot {
+	struct rpc_handler_payload payload;
+	/* Fence of the RPC which last used the slot, 0 if never used. */
+	u64 fence;
+	/*
+	 * The RPC timed out and its fence was given up. The slot is skipped
+	 * until the RPC completes late, its response is dropped.
+	 */
+	bool abandoned;
+	u64 buff[NVGPU_PMU_RPC_SLAB_SIZE / sizeof(u64)];
+};
+
+struct nvgpu_pmu_rpc_pool {
+	/* Protects the slots and the copy back of responses. */
+	struct nvgpu_mutex lock;
+	/* Fence of the last posted RPC. */
+	u64 last_fence;
+	nvgpu_pmu_rpc_wait_ack_fn wait_ack;
+	struct nvgpu_pmu_rpc_slot slots[NVGPU_PMU_RPC_ASYNC_WINDOW];
+};
+
+int nvgpu_pmu_rpc_pool_init(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool **pool_p, nvgpu_pmu_rpc_wait_ack_fn wait_ack);
+/* Drop the RPCs lost with a previous PMU instance. */
+void nvgpu_pmu_rpc_pool_sw_setup(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool);
+void nvgpu_pmu_rpc_pool_deinit(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool);
+
+/*
+ * Claim the slot of the next fence, waiting for the RPC which last used it.
+ * Returns NULL once every slot is abandoned.
+ */
+struct nvgpu_pmu_rpc_slot *nvgpu_pmu_rpc_pool_claim(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool);
+
+/*
+ * Complete the RPC of a pool payload: copy the response back unless the
+ * RPC was abandoned and release the slot.
+ */
+void nvgpu_pmu_rpc_pool_complete(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool, struct rpc_handler_payload *payload);
+
+/*
+ * Wait for the RPC of a fence. On timeout the RPC is abandoned and
+ * -ETIMEDOUT is returned.
+ */
+int nvgpu_pmu_rpc_pool_wait(struct gk20a *g, struct nvgpu_pmu_rpc_pool *pool,
+	u64 fence, u32 timeout_ms);
+
+/* Wait for the RPCs of all fences in the window. */
+int nvgpu_pmu_rpc_pool_wait_all(struct gk20a *g,
+	struct nvgpu_pmu_rpc_pool *pool, u32 timeout_ms);
+
+#endif /* NVGPU_PMU_RPC_POOL_H */
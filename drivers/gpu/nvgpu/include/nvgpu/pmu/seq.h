@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -24,7 +24,7 @@
 #define NVGPU_PMU_SEQ_H
 
 #include <nvgpu/flcnif_cmn.h>
-#include <nvgpu/lock.h>
+#include <nvgpu/falcon_seq.h>
 
 struct nvgpu_engine_fb_queue;
 struct nvgpu_mem;
@@ -33,9 +33,6 @@ struct gk20a;
 struct nvgpu_pmu;;
 
 #define PMU_MAX_NUM_SEQUENCES		(256U)
-#define PMU_SEQ_BIT_SHIFT		(5U)
-#define PMU_SEQ_TBL_SIZE	\
-		(PMU_MAX_NUM_SEQUENCES >> PMU_SEQ_BIT_SHIFT)
 
 typedef void (*pmu_callback)(struct gk20a *g, struct pmu_msg *msg, void *param,
 		u32 status);
@@ -88,8 +85,7 @@ struct pmu_sequence {
 
 struct pmu_sequences {
 	struct pmu_sequence *seq;
-	struct nvgpu_mutex pmu_seq_lock;
-	unsigned long pmu_seq_tbl[PMU_SEQ_TBL_SIZE];
+	struct nvgpu_falcon_seq_alloc ids;
 };
 
 void nvgpu_pmu_sequences_sw_setup(struct gk20a *g, struct nvgpu_pmu *pmu,
@@ -102,7 +98,7 @@ void nvgpu_pmu_sequences_deinit(struct gk20a *g, struct nvgpu_pmu *pmu,
 void nvgpu_pmu_seq_payload_free(struct gk20a *g, struct pmu_sequence *seq);
 int nvgpu_pmu_seq_acquire(struct gk20a *g,
 			  struct pmu_sequences *sequences,
-			  struct pmu_sequence **pseq,
+			  struct pmu_sequence **pseq, u8 unit_id,
 			  pmu_callback callback, void *cb_params);
 void nvgpu_pmu_seq_release(struct gk20a *g,
 			   struct pmu_sequences *sequences,
@@ -132,6 +128,8 @@ void nvgpu_pmu_seq_set_state(struct pmu_sequence *seq,
 			     enum pmu_seq_state state);
 struct pmu_sequence *nvgpu_pmu_sequences_get_seq(struct pmu_sequences *seqs,
 						 u8 id);
+void nvgpu_pmu_seq_get_latency(struct pmu_sequences *sequences, u8 unit_id,
+				struct nvgpu_swhist_data *data);
 void nvgpu_pmu_seq_callback(struct gk20a *g, struct pmu_sequence *seq,
 			    struct pmu_msg *msg, int err);
 
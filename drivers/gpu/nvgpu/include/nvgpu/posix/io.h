@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -72,6 +72,23 @@ struct nvgpu_posix_io_callbacks *nvgpu_posix_register_io(
 	struct gk20a *g,
 	struct nvgpu_posix_io_callbacks *io_callbacks);
 
+/*
+ * Count of BAR0 accesses made through the nvgpu IO accessors. Lets a unit
+ * test measure how many register accesses a sequence costs.
+ */
+struct nvgpu_posix_io_stats {
+	u64 reads;
+	/* All BAR0 writes, including relaxed ones. */
+	u64 writes;
+	u64 relaxed_writes;
+	/* Register space lookups which missed the page cache. */
+	u64 reg_space_walks;
+};
+
+void nvgpu_posix_io_get_stats(struct gk20a *g,
+	struct nvgpu_posix_io_stats *stats);
+void nvgpu_posix_io_reset_stats(struct gk20a *g);
+
 /**
  * The high 4 bits of the register mapped address are used for identify which
  * register aperture it tries to access.
@@ -135,6 +152,88 @@ void nvgpu_posix_io_record_access(struct gk20a *g,
 bool nvgpu_posix_io_check_sequence(struct gk20a *g,
 	struct nvgpu_reg_access *sequence, u32 size, bool strict);
 
+/*
+ * Register access trace.
+ *
+ * While tracing, every access made through the nvgpu IO accessors is
+ * appended to an in-memory trace together with the function which issued
+ * it. A trace can be saved to and loaded from a binary file and replayed
+ * against the current IO callbacks, e.g. to count and compare the register
+ * traffic of a code path between driver versions.
+ *
+ * The binary file holds a struct nvgpu_posix_io_trace_header, the entries
+ * and then the callsite names as NUL terminated strings, in host byte order.
+ */
+#define NVGPU_POSIX_IO_TRACE_MAGIC	0x4f49564eU	/* "NVIO" */
+#define NVGPU_POSIX_IO_TRACE_VERSION	1U
+
+#define NVGPU_POSIX_IO_TRACE_READ	0U
+#define NVGPU_POSIX_IO_TRACE_WRITE	1U
+
+/* Callsite id of accesses whose caller could not be resolved. */
+#define NVGPU_POSIX_IO_TRACE_NO_CALLSITE	0U
+
+struct nvgpu_posix_io_trace_header {
+	u32 magic;
+	u32 version;
+	u32 entry_size;
+	u32 callsites;
+	u64 entries;
+};
+
+struct nvgpu_posix_io_trace_entry {
+	u32 addr;
+	u32 value;
+	/* NVGPU_POSIX_REG_BAR0, NVGPU_POSIX_REG_BAR1 or _USERMODE. */
+	u8 aperture;
+	/* NVGPU_POSIX_IO_TRACE_READ or NVGPU_POSIX_IO_TRACE_WRITE. */
+	u8 dir;
+	u16 reserved;
+	/* Index into the callsite names of the trace. */
+	u32 callsite;
+};
+
+struct nvgpu_posix_io_trace_replay_stats {
+	u64 reads;
+	u64 writes;
+	/* Reads which returned a different value than recorded. */
+	u64 read_mismatches;
+};
+
+/*
+ * Start recording, dropping any previous trace. Returns 0 or -ENOMEM.
+ */
+int nvgpu_posix_io_trace_start(struct gk20a *g);
+void nvgpu_posix_io_trace_stop(struct gk20a *g);
+
+/*
+ * Entries of the current trace, NULL if there is none.
+ */
+const struct nvgpu_posix_io_trace_entry *nvgpu_posix_io_trace_entries(
+		struct gk20a *g, u64 *count);
+
+/*
+ * Name of a callsite: the nearest exported symbol of the function which
+ * issued the access. Returns NULL for an invalid id.
+ */
+const char *nvgpu_posix_io_trace_callsite(struct gk20a *g, u32 callsite);
+
+int nvgpu_posix_io_trace_save(struct gk20a *g, const char *path);
+
+/*
+ * Replace the current trace with the one stored at path. Recording is
+ * stopped. Returns 0, -ENOENT, -EINVAL for a malformed file or -ENOMEM.
+ */
+int nvgpu_posix_io_trace_load(struct gk20a *g, const char *path);
+
+/*
+ * Issue the accesses of the current trace through the IO accessors. Writes
+ * are written with the recorded values, reads are compared against them.
+ * Recording is stopped first. Returns 0, or -EINVAL if there is no trace.
+ */
+int nvgpu_posix_io_trace_replay(struct gk20a *g,
+		struct nvgpu_posix_io_trace_replay_stats *stats);
+
 #ifdef NVGPU_UNITTEST_FAULT_INJECTION_ENABLEMENT
 /**
  * @brief Get fault injection structure.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -26,9 +26,57 @@
 #include <nvgpu/types.h>
 #include <nvgpu/bitops.h>
 #include <nvgpu/log_common.h>
+#include <nvgpu/atomic.h>
 
 struct gk20a;
 
+/*
+ * Log site registry.
+ *
+ * Every nvgpu_log() call site gets a static descriptor placed in the
+ * nvgpu_log_sites linker section. The enabled byte of a site is checked
+ * inline before the logging function is called, so a site which is turned
+ * off costs a single predictable branch. Sites left at NVGPU_LOG_SITE_MASK
+ * follow the log mask of the GPU as before.
+ */
+#define NVGPU_LOG_SITES_SECTION		"nvgpu_log_sites"
+
+/** Site follows the log mask of the GPU. */
+#define NVGPU_LOG_SITE_MASK		0U
+/** Site always logs, regardless of the log mask. */
+#define NVGPU_LOG_SITE_ON		1U
+/** Site never logs. */
+#define NVGPU_LOG_SITE_OFF		2U
+
+/** Most arguments a message can have to be recorded in binary trace mode. */
+#define NVGPU_LOG_TRACE_MAX_ARGS	6U
+
+/**
+ * Static descriptor of a debug log call site.
+ */
+struct nvgpu_log_site {
+	/** Source file of the call site. */
+	const char *file;
+	/** Function of the call site. */
+	const char *func;
+	/** Format string of the message. */
+	const char *format;
+	/** Log mask of the message. */
+	u64 mask;
+	/** Number of messages emitted by the site. */
+	nvgpu_atomic64_t hits;
+	/** Whether the trace argument kinds below were parsed. */
+	nvgpu_atomic_t trace_state;
+	/** Line of the call site. */
+	int line;
+	/** One of NVGPU_LOG_SITE_MASK, NVGPU_LOG_SITE_ON, NVGPU_LOG_SITE_OFF. */
+	u8 enabled;
+	/** Number of recorded arguments, valid once trace_state is ready. */
+	u8 trace_nargs;
+	/** Kind of each recorded argument, valid once trace_state is ready. */
+	u8 trace_kinds[NVGPU_LOG_TRACE_MAX_ARGS];
+};
+
 __attribute__((format (printf, 5, 6)))
 void nvgpu_log_msg_impl(struct gk20a *g, const char *func_name, int line,
 			enum nvgpu_log_type type, const char *fmt, ...);
@@ -38,11 +86,178 @@ void nvgpu_log_dbg_impl(struct gk20a *g, u64 log_mask,
 			const char *func_name, int line,
 			const char *fmt, ...);
 
+__attribute__((format (printf, 3, 4)))
+void nvgpu_log_site_impl(struct gk20a *g, struct nvgpu_log_site *site,
+			 const char *fmt, ...);
+
+/**
+ * nvgpu_log_sites_count - Number of registered log sites
+ */
+u32 nvgpu_log_sites_count(void);
+
+/**
+ * nvgpu_log_site_get - Get a log site by index
+ *
+ * @index - Index below nvgpu_log_sites_count().
+ *
+ * Returns the descriptor or NULL for an invalid index.
+ */
+struct nvgpu_log_site *nvgpu_log_site_get(u32 index);
+
+/**
+ * nvgpu_log_sites_set - Change the state of log sites
+ *
+ * @func  - Function name to match, NULL matches every function.
+ * @line  - Line to match, 0 matches every line.
+ * @state - NVGPU_LOG_SITE_MASK, NVGPU_LOG_SITE_ON or NVGPU_LOG_SITE_OFF.
+ *
+ * Returns the number of changed sites.
+ */
+u32 nvgpu_log_sites_set(const char *func, int line, u8 state);
+
+/**
+ * nvgpu_log_sites_reset_hits - Clear the hit counters of all log sites
+ */
+void nvgpu_log_sites_reset_hits(void);
+
+/*
+ * Binary trace mode for debug messages.
+ *
+ * While trace mode is enabled, debug messages which pass the log mask are not
+ * formatted. Instead the timestamp, a call site id and the raw format
+ * arguments are recorded into a set of lock-free rings. Formatting is done
+ * when the events are read back. Messages with unsupported conversions or
+ * more than NVGPU_LOG_TRACE_MAX_ARGS arguments are still printed directly.
+ *
+ * The call site id of an event is the index of the site descriptor, see
+ * nvgpu_log_site_get(). Only sites of the driver itself can be recorded;
+ * messages from sites of other modules are printed directly as well.
+ *
+ * String arguments are copied into the event, together at most
+ * NVGPU_LOG_TRACE_STR_LEN - 1 bytes per event; longer strings are truncated.
+ */
+#define NVGPU_LOG_TRACE_RINGS		8U
+#define NVGPU_LOG_TRACE_STR_LEN		64U
+
+/**
+ * One recorded debug message.
+ */
+struct nvgpu_log_trace_event {
+	/** Time of the call in ns, see nvgpu_current_time_ns(). */
+	u64 timestamp;
+	/** Call site id, see nvgpu_log_trace_site(). */
+	u32 site;
+	/** Ring which recorded the event. */
+	u32 ring;
+	/** Raw format arguments, offsets into strs for string arguments. */
+	u64 args[NVGPU_LOG_TRACE_MAX_ARGS];
+	/** NUL terminated copies of the string arguments. */
+	char strs[NVGPU_LOG_TRACE_STR_LEN];
+};
+
+/**
+ * Trace mode statistics.
+ */
+struct nvgpu_log_trace_stats {
+	/** Events recorded into the rings. */
+	u64 events;
+	/** Events overwritten before they were read. */
+	u64 lost;
+	/** Messages printed directly since they could not be recorded. */
+	u64 fallbacks;
+};
+
+/**
+ * nvgpu_log_trace_enable - Enable binary trace mode
+ *
+ * @g           - The GPU.
+ * @ring_events - Number of events per ring, rounded up to a power of 2.
+ *
+ * The rings are allocated on the first enable and kept until the GPU is
+ * removed; later calls only turn recording back on.
+ *
+ * Returns 0 on success, -EINVAL for a zero size or -ENOMEM.
+ */
+int nvgpu_log_trace_enable(struct gk20a *g, u32 ring_events);
+
+/**
+ * nvgpu_log_trace_disable - Stop recording, go back to printing
+ */
+void nvgpu_log_trace_disable(struct gk20a *g);
+
+/**
+ * nvgpu_log_trace_read - Drain recorded events
+ *
+ * @g      - The GPU.
+ * @events - Output array.
+ * @count  - Size of the output array.
+ *
+ * Events of a ring are returned oldest first, rings one after another.
+ * Returns the number of events stored in @events.
+ */
+u32 nvgpu_log_trace_read(struct gk20a *g,
+			 struct nvgpu_log_trace_event *events, u32 count);
+
+/**
+ * nvgpu_log_trace_site - Look up a call site
+ *
+ * @site - Call site id of an event.
+ * @func - Function name of the call site.
+ * @line - Line of the call site.
+ * @fmt  - Format string of the call site.
+ *
+ * Returns 0 on success, -EINVAL for an unknown id.
+ */
+int nvgpu_log_trace_site(u32 site, const char **func, int *line,
+			 const char **fmt);
+
+/**
+ * nvgpu_log_trace_format - Format a recorded event
+ *
+ * @ev   - Event to format.
+ * @buf  - Output buffer.
+ * @size - Size of the output buffer.
+ *
+ * Output is truncated to the buffer size like snprintf().
+ * Returns 0 on success, -EINVAL for an unknown call site.
+ */
+int nvgpu_log_trace_format(const struct nvgpu_log_trace_event *ev,
+			   char *buf, size_t size);
+
+/**
+ * nvgpu_log_trace_decode - Drain and print recorded events
+ *
+ * Events are printed in timestamp order in the regular log format. Returns
+ * the number of printed events.
+ */
+u32 nvgpu_log_trace_decode(struct gk20a *g);
+
+/**
+ * nvgpu_log_trace_get_stats - Read trace mode statistics
+ */
+void nvgpu_log_trace_get_stats(struct gk20a *g,
+			       struct nvgpu_log_trace_stats *stats);
+
 /**
  * nvgpu_log_impl - Print a debug message
  */
 #define nvgpu_log_impl(g, log_mask, fmt, arg...)				\
-	nvgpu_log_dbg_impl(g, log_mask, __func__, __LINE__, fmt, ##arg)
+	do {								\
+		static struct nvgpu_log_site nvgpu_log_site_desc	\
+		__attribute__((used, aligned(8),			\
+			       section(NVGPU_LOG_SITES_SECTION))) = {	\
+			.file = __FILE__,				\
+			.func = __func__,				\
+			.format = fmt,					\
+			.mask = (log_mask),				\
+			.line = __LINE__,				\
+			.enabled = NVGPU_LOG_SITE_MASK,			\
+		};							\
+		if (nvgpu_log_site_desc.enabled != NVGPU_LOG_SITE_OFF) { \
+			nvgpu_log_site_impl(g, &nvgpu_log_site_desc,	\
+					    fmt, ##arg);		\
+		}							\
+	} while (false)
 
 /**
  * nvgpu_err_impl - Print an error
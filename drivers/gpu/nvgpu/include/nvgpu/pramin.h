@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -31,6 +31,15 @@ struct gk20a;
 struct mm_gk20a;
 struct nvgpu_mem;
 
+/** PRAMIN window statistics. */
+struct nvgpu_pramin_stats {
+	/** Accesses served by the current BAR0 window. */
+	u64 hits;
+	/** Accesses which needed the BAR0 window to be set. */
+	u64 misses;
+	/** Misses which moved the BAR0 window. */
+	u64 switches;
+};
 
 void nvgpu_pramin_rd_n(struct gk20a *g, struct nvgpu_mem *mem, u64 start,
 							u64 size, void *dest);
@@ -39,6 +48,8 @@ void nvgpu_pramin_wr_n(struct gk20a *g, struct nvgpu_mem *mem, u64 start,
 void nvgpu_pramin_memset(struct gk20a *g, struct nvgpu_mem *mem, u64 start,
 							u64 size, u32 w);
 
+void nvgpu_pramin_get_stats(struct gk20a *g, struct nvgpu_pramin_stats *stats);
+
 void nvgpu_init_pramin(struct mm_gk20a *mm);
 
 #endif
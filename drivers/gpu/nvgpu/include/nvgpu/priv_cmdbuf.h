@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -30,9 +30,46 @@ struct vm_gk20a;
 struct priv_cmd_entry;
 struct priv_cmd_queue;
 
+/*
+ * Occupancy of one priv cmdbuf size class. Slot counts are in units of
+ * slot_size words; a command larger than one slot takes several slots.
+ */
+struct nvgpu_priv_cmdbuf_class_stats {
+	u32 slot_size;
+	u32 slabs;
+	u32 max_slabs;
+	u32 slots_total;
+	u32 slots_used;
+	u32 slots_peak;
+	u32 grows;
+	u64 allocs;
+	u64 alloc_failures;
+};
+
+struct nvgpu_priv_cmdbuf_stats {
+	struct nvgpu_priv_cmdbuf_class_stats wait;
+	struct nvgpu_priv_cmdbuf_class_stats incr;
+};
+
+/*
+ * A growable queue adds slabs on demand when it runs out of space. Queues of
+ * deterministic channels must not allocate memory at submit time and are
+ * created with growable == false.
+ */
+#ifdef CONFIG_NVGPU_KERNEL_MODE_SUBMIT
 int nvgpu_priv_cmdbuf_queue_alloc(struct vm_gk20a *vm,
-		u32 job_count, struct priv_cmd_queue **queue);
+		u32 job_count, bool growable, struct priv_cmd_queue **queue);
+#endif
+/*
+ * Same as nvgpu_priv_cmdbuf_queue_alloc() with the wait and incr command sizes
+ * (in words) given by the caller instead of taken from the sync HALs.
+ */
+int nvgpu_priv_cmdbuf_queue_alloc_sized(struct vm_gk20a *vm,
+		u32 wait_size, u32 incr_size, u32 job_count, bool growable,
+		struct priv_cmd_queue **queue);
 void nvgpu_priv_cmdbuf_queue_free(struct priv_cmd_queue *q);
+void nvgpu_priv_cmdbuf_queue_get_stats(struct priv_cmd_queue *q,
+		struct nvgpu_priv_cmdbuf_stats *stats);
 
 int nvgpu_priv_cmdbuf_alloc(struct priv_cmd_queue *q, u32 size,
 		struct priv_cmd_entry **e);
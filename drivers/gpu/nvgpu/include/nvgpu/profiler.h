@@ -35,6 +35,10 @@ struct nvgpu_channel;
 struct nvgpu_tsg;
 struct nvgpu_pm_resource_register_range_map;
 enum nvgpu_pm_resource_hwpm_register_type;
+struct nvgpu_regops_plan;
+
+/* Number of regops plans cached per profiler object */
+#define NVGPU_PROFILER_REGOPS_PLAN_CACHE_SIZE	4U
 
 struct nvgpu_profiler_object {
 	struct gk20a *g;
@@ -122,6 +126,14 @@ struct nvgpu_profiler_object {
 	/* NVGPU_DBG_REG_OP_TYPE_* for each HWPM resource */
 	u32 reg_op_type[NVGPU_HWPM_REGISTER_TYPE_COUNT];
 
+	/*
+	 * Validated regops batches, see nvgpu_regops_plan_create().
+	 * Replaced round robin; flushed when the allowlist map changes.
+	 */
+	struct nvgpu_regops_plan *regops_plans[
+		NVGPU_PROFILER_REGOPS_PLAN_CACHE_SIZE];
+	u32 regops_plan_next;
+
 	/** GPU instance Id */
 	u32 gpu_instance_id;
 };
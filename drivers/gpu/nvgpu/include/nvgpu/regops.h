@@ -1,7 +1,7 @@
 /*
  * Tegra GK20A GPU Debugger Driver Register Ops
  *
- * Copyright (c) 2013-2021, NVIDIA CORPORATION. All rights reserved.
+ * Copyright (c) 2013-2022, NVIDIA CORPORATION. All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -31,6 +31,7 @@
 struct gk20a;
 struct nvgpu_tsg;
 struct nvgpu_profiler_object;
+struct nvgpu_regops_plan;
 
 /*
  * Register operations
@@ -101,6 +102,33 @@ int nvgpu_regops_exec(struct gk20a *g,
 		u32 num_ops,
 		u32 *flags);
 
+/*
+ * Regops plans
+ *
+ * A plan holds the result of validating and translating a batch of ops so
+ * that the same batch can be executed again without repeating the allowlist
+ * searches. Ops match a plan if their op, type, offset, quad and group masks
+ * are the same; values and masks of writes may differ. Global READ_32 ops at
+ * consecutive offsets are executed as one run.
+ *
+ * nvgpu_regops_exec() keeps a small cache of plans in each profiler object.
+ */
+int nvgpu_regops_plan_create(struct gk20a *g,
+		struct nvgpu_profiler_object *prof,
+		struct nvgpu_dbg_reg_op *ops,
+		u32 num_ops,
+		bool valid_ctx,
+		u32 *flags,
+		struct nvgpu_regops_plan **plan);
+int nvgpu_regops_plan_exec(struct gk20a *g,
+		struct nvgpu_tsg *tsg,
+		struct nvgpu_regops_plan *plan,
+		struct nvgpu_dbg_reg_op *ops,
+		u32 num_ops,
+		u32 *flags);
+void nvgpu_regops_plan_free(struct gk20a *g, struct nvgpu_regops_plan *plan);
+void nvgpu_regops_plan_cache_flush(struct nvgpu_profiler_object *prof);
+
 /* turn seriously unwieldy names -> something shorter */
 #define REGOP(x) NVGPU_DBG_REG_OP_##x
 
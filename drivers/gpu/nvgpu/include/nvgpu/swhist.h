@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef NVGPU_SWHIST_H
+#define NVGPU_SWHIST_H
+
+#include <nvgpu/types.h>
+#include <nvgpu/atomic.h>
+
+/**
+ * @file
+ *
+ * Always-on latency histograms.
+ *
+ * Unlike the swprofile sample ring, these take no lock and allocate nothing,
+ * so the probes stay enabled in production. A histogram counts latencies in
+ * power of two nanosecond buckets. Each histogram is split into a few shards
+ * picked by the recording thread, so that concurrent recorders mostly touch
+ * different cache lines; readers merge the shards.
+ */
+
+struct gk20a;
+struct nvgpu_debug_context;
+
+/** Number of log2 buckets; bucket i counts latencies in [2^i, 2^(i+1)) ns. */
+#define NVGPU_SWHIST_BUCKETS	32U
+/** Number of shards of each histogram, a power of 2. */
+#define NVGPU_SWHIST_SHARDS	4U
+
+/** Named probe points. */
+enum nvgpu_swhist_probe {
+	/** Channel gpfifo submit, ioctl to doorbell. */
+	NVGPU_SWHIST_SUBMIT = 0,
+	/** Runlist rebuild and submit to hardware. */
+	NVGPU_SWHIST_RUNLIST_UPDATE,
+	/** TSG preempt, request to completion. */
+	NVGPU_SWHIST_PREEMPT,
+	/** GMMU page table map or unmap. */
+	NVGPU_SWHIST_PT_UPDATE,
+	NVGPU_SWHIST_NUM_PROBES,
+};
+
+struct nvgpu_swhist_shard {
+	nvgpu_atomic64_t buckets[NVGPU_SWHIST_BUCKETS];
+	nvgpu_atomic64_t count;
+	nvgpu_atomic64_t sum_ns;
+	nvgpu_atomic64_t max_ns;
+};
+
+/** A lock free latency histogram. Zero filled memory is an empty one. */
+struct nvgpu_swhist {
+	struct nvgpu_swhist_shard shards[NVGPU_SWHIST_SHARDS];
+};
+
+/** Plain copy of a histogram, see nvgpu_swhist_read(). */
+struct nvgpu_swhist_data {
+	/** Number of samples per log2 bucket. */
+	u64 buckets[NVGPU_SWHIST_BUCKETS];
+	/** Number of samples. */
+	u64 count;
+	/** Sum of all samples. */
+	u64 sum_ns;
+	/** Largest sample. */
+	u64 max_ns;
+};
+
+/**
+ * @brief Bucket a latency is counted in.
+ *
+ * @param ns [in]	Latency in nanoseconds.
+ *
+ * @return floor(log2(ns)), 0 for 0 and 1, clamped to the last bucket.
+ */
+u32 nvgpu_swhist_bucket(u64 ns);
+
+/**
+ * @brief Record one latency sample.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param h [in]	Histogram.
+ * @param ns [in]	Latency in nanoseconds.
+ */
+void nvgpu_swhist_record(struct gk20a *g, struct nvgpu_swhist *h, u64 ns);
+
+/**
+ * @brief Start timing a probe.
+ *
+ * @return Start timestamp to pass to nvgpu_swhist_end().
+ */
+s64 nvgpu_swhist_begin(void);
+
+/**
+ * @brief Record the time elapsed since nvgpu_swhist_begin() for a probe.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param probe [in]	Probe point.
+ * @param start_ns [in]	Value returned by nvgpu_swhist_begin().
+ */
+void nvgpu_swhist_end(struct gk20a *g, enum nvgpu_swhist_probe probe,
+		s64 start_ns);
+
+/**
+ * @brief Copy a histogram.
+ *
+ * @param h [in]	Histogram.
+ * @param data [out]	Merged copy of all shards.
+ *
+ * Each counter is read once; samples recorded concurrently may show up in
+ * some of the totals and not yet in others.
+ */
+void nvgpu_swhist_read(struct nvgpu_swhist *h, struct nvgpu_swhist_data *data);
+
+/**
+ * @brief Copy the histogram of a probe.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param probe [in]	Probe point.
+ * @param data [out]	Merged copy of the probe's histogram.
+ */
+void nvgpu_swhist_read_probe(struct gk20a *g, enum nvgpu_swhist_probe probe,
+		struct nvgpu_swhist_data *data);
+
+/**
+ * @brief Add the samples of one histogram copy to another.
+ *
+ * @param dst [in,out]	Histogram copy to add to.
+ * @param src [in]	Histogram copy to add.
+ */
+void nvgpu_swhist_merge(struct nvgpu_swhist_data *dst,
+		const struct nvgpu_swhist_data *src);
+
+/**
+ * @brief Estimate a latency percentile.
+ *
+ * @param data [in]	Histogram copy.
+ * @param pct [in]	Percentile, 0 to 100.
+ *
+ * @return Upper bound of the bucket holding the percentile, capped at the
+ *	   largest sample; 0 for an empty histogram.
+ */
+u64 nvgpu_swhist_percentile(const struct nvgpu_swhist_data *data, u32 pct);
+
+/**
+ * @brief Clear a histogram.
+ *
+ * @param h [in]	Histogram.
+ *
+ * Samples recorded concurrently may be partly kept.
+ */
+void nvgpu_swhist_reset(struct nvgpu_swhist *h);
+
+/**
+ * @brief Name of a probe point.
+ *
+ * @param probe [in]	Probe point.
+ *
+ * @return Name of the probe, "unknown" if out of range.
+ */
+const char *nvgpu_swhist_probe_name(enum nvgpu_swhist_probe probe);
+
+/**
+ * @brief Print the column header of nvgpu_swhist_print_data().
+ *
+ * @param o [in]	Debug context to print to.
+ */
+void nvgpu_swhist_print_header(struct nvgpu_debug_context *o);
+
+/**
+ * @brief Print the summary and non empty buckets of a histogram copy.
+ *
+ * @param o [in]	Debug context to print to.
+ * @param name [in]	Name of the histogram.
+ * @param data [in]	Histogram copy.
+ */
+void nvgpu_swhist_print_data(struct nvgpu_debug_context *o, const char *name,
+		const struct nvgpu_swhist_data *data);
+
+/**
+ * @brief Print the summary and buckets of all probe histograms.
+ *
+ * @param g [in]	The GPU driver struct.
+ * @param o [in]	Debug context to print to.
+ */
+void nvgpu_swhist_print(struct gk20a *g, struct nvgpu_debug_context *o);
+
+#endif /* NVGPU_SWHIST_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (C) 2017-2021, NVIDIA Corporation.  All rights reserved.
+ * Copyright (C) 2017-2022, NVIDIA Corporation.  All rights reserved.
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -35,6 +35,9 @@
 #include <nvgpu/power_features/pg.h>
 #include <nvgpu/nvgpu_init.h>
 #include <nvgpu/tsg.h>
+#include <nvgpu/ecc.h>
+#include <nvgpu/swhist.h>
+#include <nvgpu/kmem.h>
 
 #include <linux/debugfs.h>
 #include <linux/seq_file.h>
@@ -274,6 +277,87 @@ static const struct file_operations railgate_residency_fops = {
 	.release	= single_release,
 };
 
+static int ecc_counters_show(struct seq_file *s, void *data)
+{
+	struct gk20a *g = s->private;
+	struct nvgpu_ecc_snapshot snap = { };
+	const char *name;
+	u32 i;
+	int err;
+
+	/* the first call returns the number of counters */
+	err = nvgpu_ecc_snapshot(g, &snap);
+	while (err == -ENOSPC) {
+		nvgpu_kfree(g, snap.counters);
+		snap.size = snap.count;
+		snap.counters = nvgpu_kcalloc(g, snap.size, sizeof(u32));
+		if (snap.counters == NULL)
+			return -ENOMEM;
+		err = nvgpu_ecc_snapshot(g, &snap);
+	}
+
+	for (i = 0; (err == 0) && (i < snap.count); i++) {
+		name = nvgpu_ecc_snapshot_stat_name(g, &snap, i);
+		if (name == NULL)
+			break;
+		seq_printf(s, "%s %u\n", name, snap.counters[i]);
+	}
+
+	nvgpu_kfree(g, snap.counters);
+	return err;
+}
+
+static int ecc_counters_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, ecc_counters_show, inode->i_private);
+}
+
+static const struct file_operations ecc_counters_fops = {
+	.open		= ecc_counters_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
+static int swhist_show(struct seq_file *s, void *data)
+{
+	struct gk20a *g = s->private;
+	struct nvgpu_debug_context o = {
+		.fn = gk20a_debug_write_to_seqfile,
+		.ctx = s,
+	};
+
+	nvgpu_swhist_print(g, &o);
+	return 0;
+}
+
+static int swhist_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, swhist_show, inode->i_private);
+}
+
+/* any write clears all probe histograms */
+static ssize_t swhist_write(struct file *file, const char __user *user_buf,
+		size_t count, loff_t *ppos)
+{
+	struct seq_file *s = file->private_data;
+	struct gk20a *g = s->private;
+	u32 i;
+
+	for (i = 0; i < NVGPU_SWHIST_NUM_PROBES; i++)
+		nvgpu_swhist_reset(&g->swhist[i]);
+
+	return count;
+}
+
+static const struct file_operations swhist_fops = {
+	.open		= swhist_open,
+	.read		= seq_read,
+	.write		= swhist_write,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
 static int gk20a_railgating_debugfs_init(struct gk20a *g)
 {
 	struct nvgpu_os_linux *l = nvgpu_os_linux_from_gk20a(g);
@@ -446,6 +530,10 @@ void gk20a_debug_init(struct gk20a *g, const char *debugfs_symlink)
 		dev, &gk20a_debug_fops);
 	debugfs_create_file("gr_status", S_IRUGO, l->debugfs,
 		dev, &gk20a_gr_debug_fops);
+	debugfs_create_file("ecc_counters", S_IRUGO, l->debugfs,
+		g, &ecc_counters_fops);
+	debugfs_create_file("swhist", S_IRUGO|S_IWUSR, l->debugfs,
+		g, &swhist_fops);
 	debugfs_create_u32("trace_cmdbuf", S_IRUGO|S_IWUSR,
 		l->debugfs, &gk20a_debug_trace_cmdbuf);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA CORPORATION. All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION. All rights reserved.
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -154,6 +154,44 @@ static int gk20a_fecs_trace_debugfs_write(void *arg, u64 *val)
 DEFINE_SIMPLE_ATTRIBUTE(gk20a_fecs_trace_debugfs_write_fops,
 	gk20a_fecs_trace_debugfs_write, NULL, "%llu\n");
 
+static int gk20a_fecs_trace_debugfs_stats_show(struct seq_file *s,
+	void *unused)
+{
+	struct gk20a *g = s->private;
+	struct nvgpu_fecs_trace_stats stats;
+
+	if (g->fecs_trace == NULL) {
+		return -ENODEV;
+	}
+
+	nvgpu_gr_fecs_trace_get_stats(g, &stats);
+
+	seq_printf(s, "records:         %llu\n", stats.records);
+	seq_printf(s, "entries:         %llu\n", stats.entries);
+	seq_printf(s, "dropped:         %llu\n", stats.dropped);
+	seq_printf(s, "invalid:         %llu\n", stats.invalid);
+	seq_printf(s, "polls:           %llu\n", stats.polls);
+	seq_printf(s, "records_per_sec: %llu\n", stats.records_per_sec);
+	seq_printf(s, "contexts:        %u\n", stats.contexts);
+
+	return 0;
+}
+
+static int gk20a_fecs_trace_debugfs_stats_open(struct inode *inode,
+	struct file *file)
+{
+	return single_open(file, gk20a_fecs_trace_debugfs_stats_show,
+		inode->i_private);
+}
+
+static const struct file_operations gk20a_fecs_trace_debugfs_stats_fops = {
+	.owner = THIS_MODULE,
+	.open = gk20a_fecs_trace_debugfs_stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
 int nvgpu_fecs_trace_init_debugfs(struct gk20a *g)
 {
 	struct nvgpu_os_linux *l = nvgpu_os_linux_from_gk20a(g);
@@ -164,6 +202,8 @@ int nvgpu_fecs_trace_init_debugfs(struct gk20a *g)
 		&gk20a_fecs_trace_debugfs_write_fops);
 	debugfs_create_file("ctxsw_trace_ring", 0600, l->debugfs, g,
 		&gk20a_fecs_trace_debugfs_ring_fops);
+	debugfs_create_file("ctxsw_trace_stats", 0400, l->debugfs, g,
+		&gk20a_fecs_trace_debugfs_stats_fops);
 
 	return 0;
 }
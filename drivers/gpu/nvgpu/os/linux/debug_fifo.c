@@ -27,6 +27,7 @@
 #include <nvgpu/engines.h>
 #include <nvgpu/device.h>
 #include <nvgpu/runlist.h>
+#include <nvgpu/priv_cmdbuf.h>
 
 static void *gk20a_fifo_sched_debugfs_seq_start(
 		struct seq_file *s, loff_t *pos)
@@ -139,6 +140,83 @@ static const struct file_operations gk20a_fifo_sched_debugfs_fops = {
 	.release = seq_release
 };
 
+#ifdef CONFIG_NVGPU_KERNEL_MODE_SUBMIT
+static int gk20a_fifo_priv_cmdbuf_debugfs_seq_show(
+		struct seq_file *s, void *v)
+{
+	struct gk20a *g = s->private;
+	struct nvgpu_fifo *f = &g->fifo;
+	struct nvgpu_channel *ch = v;
+	struct nvgpu_priv_cmdbuf_stats stats;
+	struct nvgpu_priv_cmdbuf_class_stats *cls[2] = {
+		&stats.wait, &stats.incr
+	};
+	const char *names[2] = { "wait", "incr" };
+	bool valid = false;
+	int i;
+
+	if (ch == f->channel) {
+		seq_puts(s, "chid     class slot  slabs    used     peak     total    allocs     fails    grows\n");
+		seq_puts(s, "               (words)\n");
+	}
+
+	if (nvgpu_channel_get(ch) == NULL)
+		return 0;
+
+	/* the queue is freed only after the last channel ref is dropped */
+	if (ch->priv_cmd_q != NULL) {
+		nvgpu_priv_cmdbuf_queue_get_stats(ch->priv_cmd_q, &stats);
+		valid = true;
+	}
+	nvgpu_channel_put(ch);
+
+	if (!valid)
+		return 0;
+
+	for (i = 0; i < 2; i++)
+		seq_printf(s, "%-8d %-5s %-5u %u/%-6u %-8u %-8u %-8u %-10llu %-8llu %-8u\n",
+			ch->chid, names[i],
+			cls[i]->slot_size,
+			cls[i]->slabs, cls[i]->max_slabs,
+			cls[i]->slots_used,
+			cls[i]->slots_peak,
+			cls[i]->slots_total,
+			cls[i]->allocs,
+			cls[i]->alloc_failures,
+			cls[i]->grows);
+
+	return 0;
+}
+
+static const struct seq_operations gk20a_fifo_priv_cmdbuf_debugfs_seq_ops = {
+	.start = gk20a_fifo_sched_debugfs_seq_start,
+	.next = gk20a_fifo_sched_debugfs_seq_next,
+	.stop = gk20a_fifo_sched_debugfs_seq_stop,
+	.show = gk20a_fifo_priv_cmdbuf_debugfs_seq_show
+};
+
+static int gk20a_fifo_priv_cmdbuf_debugfs_open(struct inode *inode,
+	struct file *file)
+{
+	int err;
+
+	err = seq_open(file, &gk20a_fifo_priv_cmdbuf_debugfs_seq_ops);
+	if (err)
+		return err;
+
+	((struct seq_file *)file->private_data)->private = inode->i_private;
+	return 0;
+};
+
+static const struct file_operations gk20a_fifo_priv_cmdbuf_debugfs_fops = {
+	.owner = THIS_MODULE,
+	.open = gk20a_fifo_priv_cmdbuf_debugfs_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = seq_release
+};
+#endif
+
 void gk20a_fifo_debugfs_init(struct gk20a *g)
 {
 	struct nvgpu_os_linux *l = nvgpu_os_linux_from_gk20a(g);
@@ -153,6 +231,10 @@ void gk20a_fifo_debugfs_init(struct gk20a *g)
 
 	debugfs_create_file("sched", 0600, fifo_root, g,
 		&gk20a_fifo_sched_debugfs_fops);
+#ifdef CONFIG_NVGPU_KERNEL_MODE_SUBMIT
+	debugfs_create_file("priv_cmdbuf", 0400, fifo_root, g,
+		&gk20a_fifo_priv_cmdbuf_debugfs_fops);
+#endif
 
 	nvgpu_debugfs_swprofile_init(g, fifo_root, &g->fifo.kickoff_profiler,
 				     "kickoff_profiler");
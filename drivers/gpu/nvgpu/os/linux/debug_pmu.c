@@ -19,7 +19,10 @@
 #include <nvgpu/pmu/debug.h>
 #include <nvgpu/pmu/pmu_pg.h>
 #include <nvgpu/pmu/fw.h>
+#include <nvgpu/pmu/seq.h>
 #include <nvgpu/nvgpu_init.h>
+#include <nvgpu/debug.h>
+#include <nvgpu/swhist.h>
 
 #include "debug_pmu.h"
 #include "os_linux.h"
@@ -472,6 +475,51 @@ static const struct file_operations security_fops = {
 	.release	= single_release,
 };
 
+static void ipc_latency_write(void *ctx, const char *str)
+{
+	seq_printf((struct seq_file *)ctx, "%s\n", str);
+}
+
+/* PMU command latency histograms, post to response, per unit */
+static int ipc_latency_show(struct seq_file *s, void *data)
+{
+	struct gk20a *g = s->private;
+	struct nvgpu_pmu *pmu = g->pmu;
+	struct nvgpu_debug_context o = {
+		.fn = ipc_latency_write,
+		.ctx = s,
+	};
+	struct nvgpu_swhist_data lat;
+	char name[16];
+	u32 unit;
+
+	if (pmu == NULL || pmu->sequences == NULL)
+		return 0;
+
+	nvgpu_swhist_print_header(&o);
+	for (unit = 0; unit < NVGPU_FALCON_SEQ_MAX_TAGS; unit++) {
+		nvgpu_pmu_seq_get_latency(pmu->sequences, (u8)unit, &lat);
+		if (lat.count == 0ULL)
+			continue;
+		(void) snprintf(name, sizeof(name), "unit 0x%02x", unit);
+		nvgpu_swhist_print_data(&o, name, &lat);
+	}
+
+	return 0;
+}
+
+static int ipc_latency_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, ipc_latency_show, inode->i_private);
+}
+
+static const struct file_operations ipc_latency_fops = {
+	.open		= ipc_latency_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
 int gk20a_pmu_debugfs_init(struct gk20a *g)
 {
 	struct dentry *d;
@@ -536,6 +584,12 @@ int gk20a_pmu_debugfs_init(struct gk20a *g)
 						&perfmon_events_count_fops);
 		if (!d)
 			goto err_out;
+
+		d = debugfs_create_file(
+			"pmu_ipc_latency", S_IRUGO, l->debugfs, g,
+						&ipc_latency_fops);
+		if (!d)
+			goto err_out;
 	}
 	return 0;
 err_out:
@@ -103,11 +103,15 @@ static void nvgpu_init_vars(struct gk20a *g)
 	nvgpu_mutex_init(&l->ctrl_privs_lock);
 	nvgpu_init_list_node(&l->ctrl_privs);
 
+	nvgpu_linux_fw_cache_init(g);
+
 	g->regs_saved = g->regs;
 	g->bar1_saved = g->bar1;
 
 	g->emc3d_ratio = EMC3D_DEFAULT_RATIO;
 
+	g->init_workers = NVGPU_INIT_DEFAULT_WORKERS;
+
 	/* Set DMA parameters to allow larger sgt lists */
 	dev->dma_parms = &l->dma_parms;
 	dma_set_max_seg_size(dev, UINT_MAX);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2017-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * This program is free software; you can redistribute it and/or modify it
  * under the terms and conditions of the GNU General Public License,
@@ -21,10 +21,29 @@
 #include <nvgpu/firmware.h>
 #include <nvgpu/gk20a.h>
 #include <nvgpu/string.h>
+#include <nvgpu/timers.h>
 
 #include "platform_gk20a.h"
 #include "os_linux.h"
 
+/*
+ * A firmware image held by the cache. Every nvgpu_firmware handed out for the
+ * image holds a reference.
+ */
+struct nvgpu_linux_fw_entry {
+	struct nvgpu_list_node node;
+	char *name;
+	const struct firmware *fw;
+	u32 refcount;
+};
+
+static inline struct nvgpu_linux_fw_entry *
+nvgpu_linux_fw_entry_from_node(struct nvgpu_list_node *node)
+{
+	return (struct nvgpu_linux_fw_entry *)
+		((uintptr_t)node - offsetof(struct nvgpu_linux_fw_entry, node));
+};
+
 static const struct firmware *do_request_firmware(struct device *dev,
 		const char *prefix, const char *fw_name, u32 flags)
 {
@@ -56,26 +75,12 @@ static const struct firmware *do_request_firmware(struct device *dev,
 	return fw;
 }
 
-/* This is a simple wrapper around request_firmware that takes 'fw_name' and
- * applies an IP specific relative path prefix to it. The caller is
- * responsible for calling nvgpu_release_firmware later. */
-struct nvgpu_firmware *nvgpu_request_firmware(struct gk20a *g,
-					      const char *fw_name,
-					      u32 flags)
+static const struct firmware *nvgpu_load_firmware(struct gk20a *g,
+		const char *fw_name, u32 flags)
 {
 	struct device *dev = dev_from_gk20a(g);
-	struct nvgpu_firmware *fw;
 	const struct firmware *linux_fw;
 
-	/* current->fs is NULL when calling from SYS_EXIT.
-	   Add a check here to prevent crash in request_firmware */
-	if (!current->fs || !fw_name)
-		return NULL;
-
-	fw = nvgpu_kzalloc(g, sizeof(*fw));
-	if (!fw)
-		return NULL;
-
 	linux_fw = do_request_firmware(dev, g->name, fw_name, flags);
 
 #ifdef CONFIG_TEGRA_GK20A
@@ -87,22 +92,204 @@ struct nvgpu_firmware *nvgpu_request_firmware(struct gk20a *g,
 	}
 #endif
 
-	if (!linux_fw)
+	return linux_fw;
+}
+
+static void nvgpu_linux_fw_entry_free(struct gk20a *g,
+		struct nvgpu_os_linux_fw_cache *cache,
+		struct nvgpu_linux_fw_entry *entry)
+{
+	nvgpu_list_del(&entry->node);
+	cache->stats.cached_bytes -= entry->fw->size;
+	cache->stats.entries--;
+	cache->stats.evictions++;
+
+	release_firmware(entry->fw);
+	nvgpu_kfree(g, entry->name);
+	nvgpu_kfree(g, entry);
+}
+
+/*
+ * Evict idle images the current policy does not retain. The list is walked
+ * from the most recently used image, so the LRU policy keeps the newest idle
+ * images which fit the budget. Called with the cache lock held.
+ */
+static void nvgpu_linux_fw_cache_trim(struct gk20a *g,
+		struct nvgpu_os_linux_fw_cache *cache, bool flush)
+{
+	struct nvgpu_linux_fw_entry *entry, *tmp;
+	size_t kept = 0;
+
+	nvgpu_list_for_each_entry_safe(entry, tmp, &cache->entries,
+			nvgpu_linux_fw_entry, node) {
+		if (entry->refcount)
+			continue;
+
+		if (!flush) {
+			if (cache->policy == NVGPU_FIRMWARE_CACHE_KEEP)
+				continue;
+			if (cache->policy == NVGPU_FIRMWARE_CACHE_LRU &&
+			    entry->fw->size <= cache->budget - kept) {
+				kept += entry->fw->size;
+				continue;
+			}
+		}
+
+		nvgpu_linux_fw_entry_free(g, cache, entry);
+	}
+}
+
+/* Called with the cache lock held. */
+static struct nvgpu_linux_fw_entry *nvgpu_linux_fw_cache_find(
+		struct nvgpu_os_linux_fw_cache *cache, const char *fw_name)
+{
+	struct nvgpu_linux_fw_entry *entry;
+
+	nvgpu_list_for_each_entry(entry, &cache->entries,
+			nvgpu_linux_fw_entry, node) {
+		if (!strcmp(entry->name, fw_name)) {
+			entry->refcount++;
+			nvgpu_list_move(&entry->node, &cache->entries);
+			cache->stats.hits++;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static struct nvgpu_linux_fw_entry *nvgpu_linux_fw_cache_get(struct gk20a *g,
+		struct nvgpu_os_linux_fw_cache *cache,
+		const char *fw_name, u32 flags)
+{
+	struct nvgpu_linux_fw_entry *entry, *cached;
+	size_t name_len = strlen(fw_name) + 1;
+	s64 start_ns;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	entry = nvgpu_linux_fw_cache_find(cache, fw_name);
+	nvgpu_mutex_release(&cache->lock);
+	if (entry)
+		return entry;
+
+	/*
+	 * request_firmware() can take long (or wait for a usermode helper),
+	 * so load without the lock to not hold up unrelated requests.
+	 */
+	start_ns = nvgpu_current_time_ns();
+
+	entry = nvgpu_kzalloc(g, sizeof(*entry));
+	if (!entry)
+		return NULL;
+
+	entry->name = nvgpu_kzalloc(g, name_len);
+	if (!entry->name)
 		goto err;
+	nvgpu_memcpy((u8 *)entry->name, (const u8 *)fw_name, name_len);
 
-	fw->data = nvgpu_kmalloc(g, linux_fw->size);
-	if (!fw->data)
-		goto err_release;
+	entry->fw = nvgpu_load_firmware(g, fw_name, flags);
+	if (!entry->fw)
+		goto err;
 
-	nvgpu_memcpy((u8 *)fw->data, (u8 *)linux_fw->data, linux_fw->size);
-	fw->size = linux_fw->size;
+	entry->refcount = 1;
 
-	release_firmware(linux_fw);
+	nvgpu_mutex_acquire(&cache->lock);
+	/* A concurrent request may have loaded the same image meanwhile */
+	cached = nvgpu_linux_fw_cache_find(cache, fw_name);
+	if (!cached) {
+		nvgpu_list_add(&entry->node, &cache->entries);
+		cache->stats.misses++;
+		cache->stats.entries++;
+		cache->stats.cached_bytes += entry->fw->size;
+		cache->stats.bytes_loaded += entry->fw->size;
+		cache->stats.load_ns +=
+			(u64)(nvgpu_current_time_ns() - start_ns);
+	}
+	nvgpu_mutex_release(&cache->lock);
+
+	if (!cached)
+		return entry;
+
+	release_firmware(entry->fw);
+	nvgpu_kfree(g, entry->name);
+	nvgpu_kfree(g, entry);
+	return cached;
+
+err:
+	nvgpu_kfree(g, entry->name);
+	nvgpu_kfree(g, entry);
+	return NULL;
+}
+
+static void nvgpu_linux_fw_cache_put(struct gk20a *g,
+		struct nvgpu_os_linux_fw_cache *cache,
+		struct nvgpu_linux_fw_entry *entry)
+{
+	nvgpu_mutex_acquire(&cache->lock);
+	if (!--entry->refcount)
+		nvgpu_linux_fw_cache_trim(g, cache, false);
+	nvgpu_mutex_release(&cache->lock);
+}
+
+void nvgpu_linux_fw_cache_init(struct gk20a *g)
+{
+	struct nvgpu_os_linux_fw_cache *cache =
+		&nvgpu_os_linux_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_init(&cache->lock);
+	nvgpu_init_list_node(&cache->entries);
+	cache->policy = NVGPU_FIRMWARE_CACHE_LRU;
+	cache->budget = NVGPU_FIRMWARE_CACHE_DEFAULT_BUDGET;
+}
+
+/* This is a wrapper around request_firmware that takes 'fw_name' and applies
+ * an IP specific relative path prefix to it. Loaded images are cached, so
+ * repeated requests (e.g. on every poweron) do not go back to the filesystem.
+ * The caller is responsible for calling nvgpu_release_firmware later. */
+struct nvgpu_firmware *nvgpu_request_firmware(struct gk20a *g,
+					      const char *fw_name,
+					      u32 flags)
+{
+	struct nvgpu_os_linux_fw_cache *cache =
+		&nvgpu_os_linux_from_gk20a(g)->fw_cache;
+	struct nvgpu_linux_fw_entry *entry;
+	struct nvgpu_firmware *fw;
+
+	/* current->fs is NULL when calling from SYS_EXIT.
+	   Add a check here to prevent crash in request_firmware */
+	if (!current->fs || !fw_name)
+		return NULL;
+
+	fw = nvgpu_kzalloc(g, sizeof(*fw));
+	if (!fw)
+		return NULL;
+
+	entry = nvgpu_linux_fw_cache_get(g, cache, fw_name, flags);
+	if (!entry)
+		goto err;
+
+	if (flags & NVGPU_REQUEST_FIRMWARE_READ_ONLY) {
+		fw->data = (u8 *)entry->fw->data;
+	} else {
+		fw->data = nvgpu_kmalloc(g, entry->fw->size);
+		if (!fw->data)
+			goto err_put;
+
+		nvgpu_memcpy(fw->data, (u8 *)entry->fw->data,
+			     entry->fw->size);
+
+		nvgpu_mutex_acquire(&cache->lock);
+		cache->stats.bytes_copied += entry->fw->size;
+		nvgpu_mutex_release(&cache->lock);
+	}
+
+	fw->size = entry->fw->size;
+	fw->priv = entry;
 
 	return fw;
 
-err_release:
-	release_firmware(linux_fw);
+err_put:
+	nvgpu_linux_fw_cache_put(g, cache, entry);
 err:
 	nvgpu_kfree(g, fw);
 	return NULL;
@@ -110,9 +297,49 @@ err:
 
 void nvgpu_release_firmware(struct gk20a *g, struct nvgpu_firmware *fw)
 {
+	struct nvgpu_linux_fw_entry *entry;
+
 	if(!fw)
 		return;
 
-	nvgpu_kfree(g, fw->data);
+	entry = fw->priv;
+	if (fw->data != entry->fw->data)
+		nvgpu_kfree(g, fw->data);
+	nvgpu_linux_fw_cache_put(g, &nvgpu_os_linux_from_gk20a(g)->fw_cache,
+				 entry);
 	nvgpu_kfree(g, fw);
 }
+
+void nvgpu_firmware_cache_set_policy(struct gk20a *g,
+		enum nvgpu_firmware_cache_policy policy, size_t budget)
+{
+	struct nvgpu_os_linux_fw_cache *cache =
+		&nvgpu_os_linux_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	cache->policy = policy;
+	cache->budget = budget;
+	nvgpu_linux_fw_cache_trim(g, cache, false);
+	nvgpu_mutex_release(&cache->lock);
+}
+
+void nvgpu_firmware_cache_get_stats(struct gk20a *g,
+		struct nvgpu_firmware_cache_stats *stats)
+{
+	struct nvgpu_os_linux_fw_cache *cache =
+		&nvgpu_os_linux_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	*stats = cache->stats;
+	nvgpu_mutex_release(&cache->lock);
+}
+
+void nvgpu_firmware_cache_flush(struct gk20a *g)
+{
+	struct nvgpu_os_linux_fw_cache *cache =
+		&nvgpu_os_linux_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	nvgpu_linux_fw_cache_trim(g, cache, true);
+	nvgpu_mutex_release(&cache->lock);
+}
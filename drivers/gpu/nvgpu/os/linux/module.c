@@ -1089,6 +1089,8 @@ void gk20a_remove_support(struct gk20a *g)
 
 	nvgpu_remove_usermode_support(g);
 
+	nvgpu_firmware_cache_flush(g);
+
 	nvgpu_free_enabled_flags(g);
 	nvgpu_free_errata_flags(g);
 
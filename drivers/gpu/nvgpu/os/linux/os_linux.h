@@ -22,6 +22,7 @@
 #include <linux/version.h>
 
 #include <nvgpu/gk20a.h>
+#include <nvgpu/firmware.h>
 #include <nvgpu/interrupts.h>
 
 #include "cde.h"
@@ -69,6 +70,16 @@ struct dgpu_thermal_alert {
         u32 event_delay;
 };
 
+/* Cache of firmware images shared across nvgpu_request_firmware() calls. */
+struct nvgpu_os_linux_fw_cache {
+	struct nvgpu_mutex lock;
+	/* Cached images, most recently used first. */
+	struct nvgpu_list_node entries;
+	enum nvgpu_firmware_cache_policy policy;
+	size_t budget;
+	struct nvgpu_firmware_cache_stats stats;
+};
+
 struct nvgpu_os_linux {
 	struct gk20a g;
 	struct device *dev;
@@ -94,6 +105,8 @@ struct nvgpu_os_linux {
 	/* guards modifications to the list and its contents */
 	struct nvgpu_mutex ctrl_privs_lock;
 
+	struct nvgpu_os_linux_fw_cache fw_cache;
+
 	struct devfreq *devfreq;
 
 	struct device_dma_parameters dma_parms;
@@ -156,6 +169,8 @@ static inline struct device *dev_from_gk20a(struct gk20a *g)
 	return nvgpu_os_linux_from_gk20a(g)->dev;
 }
 
+void nvgpu_linux_fw_cache_init(struct gk20a *g);
+
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5, 0, 0)
 #define totalram_size_in_mb (totalram_pages() >> (10 - (PAGE_SHIFT - 10)))
 #else
@@ -21,14 +21,20 @@
  */
 
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <stdlib.h>
 
 #include <nvgpu/types.h>
 #include <nvgpu/kmem.h>
 #include <nvgpu/firmware.h>
+#include <nvgpu/string.h>
+#include <nvgpu/timers.h>
 #include <nvgpu/gk20a.h>
 
+#include "os_posix.h"
+
 #define FW_MAX_PATH_SIZE 2048U
 
 #if defined(__QNX__)
@@ -37,15 +43,32 @@
 #define NVGPU_UNITTEST_UCODE_PATH "/firmware/gv11b/"
 #endif
 
+/*
+ * A firmware image mapped read-only from the filesystem. Every
+ * nvgpu_firmware handed out for the image holds a reference.
+ */
+struct nvgpu_posix_fw_entry {
+	struct nvgpu_list_node node;
+	char *path;
+	u8 *map;
+	size_t size;
+	u32 refcount;
+};
+
+static inline struct nvgpu_posix_fw_entry *
+nvgpu_posix_fw_entry_from_node(struct nvgpu_list_node *node)
+{
+	return (struct nvgpu_posix_fw_entry *)
+		((uintptr_t)node - offsetof(struct nvgpu_posix_fw_entry, node));
+};
+
 static int nvgpu_ucode_load(struct gk20a *g, const char *path,
-	struct nvgpu_firmware *ucode)
+	struct nvgpu_posix_fw_entry *entry)
 {
 	struct stat buf;
-	size_t bufsize;
-	ssize_t len;
+	void *map;
 	int fd = -1;
 	int ret = -1;
-	u8 *data, *data1;
 
 	fd = open(path, O_RDONLY);
 	if (fd < 0) {
@@ -62,62 +85,190 @@ static int nvgpu_ucode_load(struct gk20a *g, const char *path,
 		nvgpu_err(g, "fw: invalid buf.st_size");
 		goto done;
 	}
-	bufsize = (size_t)buf.st_size;
 
-	data = (u8 *)nvgpu_kmalloc(g, bufsize);
-	if (data == NULL) {
-		nvgpu_err(g, "fw: malloc failed");
+	map = mmap(NULL, (size_t)buf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		nvgpu_err(g, "fw: mmap failed");
 		goto done;
 	}
-	data1 = data;
 
-	while (bufsize > 0UL) {
-		len = read(fd, data, bufsize);
-		if (len < 0) {
-			ret = errno;
-			nvgpu_err(g, "fw: read failed");
-			goto err;
+	entry->map = (u8 *)map;
+	entry->size = (size_t)buf.st_size;
+	ret = 0;
+
+done:
+	if (fd >= 0) {
+		if (close(fd) != 0) {
+			nvgpu_err(g, "close() failed");
 		}
+	}
+
+	return ret;
+}
+
+static void nvgpu_posix_fw_entry_free(struct nvgpu_posix_fw_cache *cache,
+	struct nvgpu_posix_fw_entry *entry)
+{
+	nvgpu_list_del(&entry->node);
+	cache->stats.cached_bytes -= entry->size;
+	cache->stats.entries--;
+	cache->stats.evictions++;
 
-		if (len == 0) {
-			nvgpu_err(g, "fw load failed: read size mismatch");
-			ret = -1;
-			goto err;
+	(void) munmap(entry->map, entry->size);
+	free(entry->path);
+	free(entry);
+}
+
+/*
+ * Evict idle images the current policy does not retain. The list is walked
+ * from the most recently used image, so the LRU policy keeps the newest idle
+ * images which fit the budget. Called with the cache lock held.
+ */
+static void nvgpu_posix_fw_cache_trim(struct nvgpu_posix_fw_cache *cache,
+	bool flush)
+{
+	struct nvgpu_posix_fw_entry *entry, *tmp;
+	size_t kept = 0UL;
+
+	nvgpu_list_for_each_entry_safe(entry, tmp, &cache->entries,
+			nvgpu_posix_fw_entry, node) {
+		if (entry->refcount != 0U) {
+			continue;
+		}
+
+		if (!flush) {
+			if (cache->policy == NVGPU_FIRMWARE_CACHE_KEEP) {
+				continue;
+			}
+			if ((cache->policy == NVGPU_FIRMWARE_CACHE_LRU) &&
+				(entry->size <= (cache->budget - kept))) {
+				kept += entry->size;
+				continue;
+			}
 		}
 
-		data += len;
-		bufsize -= (size_t)len;
+		nvgpu_posix_fw_entry_free(cache, entry);
 	}
+}
 
-	ucode->data = data1;
-	ucode->size = (size_t)buf.st_size;
-	ret = 0;
-	goto done;
+/* Called with the cache lock held. */
+static struct nvgpu_posix_fw_entry *nvgpu_posix_fw_cache_find(
+	struct nvgpu_posix_fw_cache *cache, const char *path)
+{
+	struct nvgpu_posix_fw_entry *entry;
+
+	nvgpu_list_for_each_entry(entry, &cache->entries,
+			nvgpu_posix_fw_entry, node) {
+		if (strcmp(entry->path, path) == 0) {
+			entry->refcount++;
+			nvgpu_list_move(&entry->node, &cache->entries);
+			cache->stats.hits++;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static struct nvgpu_posix_fw_entry *nvgpu_posix_fw_cache_get(struct gk20a *g,
+	struct nvgpu_posix_fw_cache *cache, const char *path)
+{
+	struct nvgpu_posix_fw_entry *entry, *cached;
+	s64 start_ns;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	entry = nvgpu_posix_fw_cache_find(cache, path);
+	nvgpu_mutex_release(&cache->lock);
+	if (entry != NULL) {
+		return entry;
+	}
+
+	/* Load without the lock, unrelated requests are not held up */
+	start_ns = nvgpu_current_time_ns();
+
+	entry = calloc(1, sizeof(*entry));
+	if (entry == NULL) {
+		return NULL;
+	}
+
+	entry->path = strdup(path);
+	if (entry->path == NULL) {
+		goto err;
+	}
+
+	if (nvgpu_ucode_load(g, path, entry) != 0) {
+		goto err;
+	}
+
+	entry->refcount = 1U;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	/* A concurrent request may have loaded the same image meanwhile */
+	cached = nvgpu_posix_fw_cache_find(cache, path);
+	if (cached == NULL) {
+		nvgpu_list_add(&entry->node, &cache->entries);
+		cache->stats.misses++;
+		cache->stats.entries++;
+		cache->stats.cached_bytes += entry->size;
+		cache->stats.bytes_loaded += entry->size;
+		cache->stats.load_ns +=
+			(u64)(nvgpu_current_time_ns() - start_ns);
+	}
+	nvgpu_mutex_release(&cache->lock);
+
+	if (cached == NULL) {
+		return entry;
+	}
+
+	(void) munmap(entry->map, entry->size);
+	free(entry->path);
+	free(entry);
+	return cached;
 
 err:
-	nvgpu_kfree(g, data);
+	free(entry->path);
+	free(entry);
+	return NULL;
+}
 
-done:
-	if (fd >= 0) {
-		if (close(fd) != 0) {
-			nvgpu_err(g, "close() failed");
-		}
+static void nvgpu_posix_fw_cache_put(struct nvgpu_posix_fw_cache *cache,
+	struct nvgpu_posix_fw_entry *entry)
+{
+	nvgpu_mutex_acquire(&cache->lock);
+	entry->refcount--;
+	if (entry->refcount == 0U) {
+		nvgpu_posix_fw_cache_trim(cache, false);
 	}
+	nvgpu_mutex_release(&cache->lock);
+}
 
-	return ret;
+void nvgpu_posix_fw_cache_init(struct gk20a *g)
+{
+	struct nvgpu_posix_fw_cache *cache =
+		&nvgpu_os_posix_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_init(&cache->lock);
+	nvgpu_init_list_node(&cache->entries);
+	cache->policy = NVGPU_FIRMWARE_CACHE_LRU;
+	cache->budget = NVGPU_FIRMWARE_CACHE_DEFAULT_BUDGET;
+}
+
+void nvgpu_posix_fw_cache_fini(struct gk20a *g)
+{
+	nvgpu_firmware_cache_flush(g);
+	nvgpu_mutex_destroy(&nvgpu_os_posix_from_gk20a(g)->fw_cache.lock);
 }
 
 struct nvgpu_firmware *nvgpu_request_firmware(struct gk20a *g,
 					      const char *fw_name,
 					      u32 flags)
 {
+	struct nvgpu_posix_fw_cache *cache;
+	struct nvgpu_posix_fw_entry *entry;
 	struct nvgpu_firmware *fw;
 	char full_path[FW_MAX_PATH_SIZE] = "";
-	int ret;
 	size_t full_path_len;
 
-	(void)flags;
-
 	if (fw_name == NULL) {
 		return NULL;
 	}
@@ -146,13 +297,34 @@ struct nvgpu_firmware *nvgpu_request_firmware(struct gk20a *g,
 		goto err;
 	}
 
-	ret = nvgpu_ucode_load(g, full_path, fw);
-	if (ret != 0) {
+	cache = &nvgpu_os_posix_from_gk20a(g)->fw_cache;
+	entry = nvgpu_posix_fw_cache_get(g, cache, full_path);
+	if (entry == NULL) {
 		nvgpu_err(g, "failed to load %s ucode", fw_name);
 		goto err_fw;
 	}
+
+	if ((flags & NVGPU_REQUEST_FIRMWARE_READ_ONLY) != 0U) {
+		fw->data = entry->map;
+	} else {
+		fw->data = (u8 *)nvgpu_kmalloc(g, entry->size);
+		if (fw->data == NULL) {
+			nvgpu_err(g, "fw: malloc failed");
+			goto err_put;
+		}
+		nvgpu_memcpy(fw->data, entry->map, entry->size);
+
+		nvgpu_mutex_acquire(&cache->lock);
+		cache->stats.bytes_copied += entry->size;
+		nvgpu_mutex_release(&cache->lock);
+	}
+
+	fw->size = entry->size;
+	fw->priv = entry;
 	return fw;
 
+err_put:
+	nvgpu_posix_fw_cache_put(cache, entry);
 err_fw:
 	nvgpu_kfree(g, fw);
 err:
@@ -161,6 +333,46 @@ err:
 
 void nvgpu_release_firmware(struct gk20a *g, struct nvgpu_firmware *fw)
 {
-	nvgpu_kfree(g, fw->data);
+	struct nvgpu_posix_fw_entry *entry = fw->priv;
+
+	if (fw->data != entry->map) {
+		nvgpu_kfree(g, fw->data);
+	}
+	nvgpu_posix_fw_cache_put(&nvgpu_os_posix_from_gk20a(g)->fw_cache,
+		entry);
 	nvgpu_kfree(g, fw);
 }
+
+void nvgpu_firmware_cache_set_policy(struct gk20a *g,
+		enum nvgpu_firmware_cache_policy policy, size_t budget)
+{
+	struct nvgpu_posix_fw_cache *cache =
+		&nvgpu_os_posix_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	cache->policy = policy;
+	cache->budget = budget;
+	nvgpu_posix_fw_cache_trim(cache, false);
+	nvgpu_mutex_release(&cache->lock);
+}
+
+void nvgpu_firmware_cache_get_stats(struct gk20a *g,
+		struct nvgpu_firmware_cache_stats *stats)
+{
+	struct nvgpu_posix_fw_cache *cache =
+		&nvgpu_os_posix_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	*stats = cache->stats;
+	nvgpu_mutex_release(&cache->lock);
+}
+
+void nvgpu_firmware_cache_flush(struct gk20a *g)
+{
+	struct nvgpu_posix_fw_cache *cache =
+		&nvgpu_os_posix_from_gk20a(g)->fw_cache;
+
+	nvgpu_mutex_acquire(&cache->lock);
+	nvgpu_posix_fw_cache_trim(cache, true);
+	nvgpu_mutex_release(&cache->lock);
+}
@@ -20,10 +20,22 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <stdlib.h>
+#include <stddef.h>
+
 #include <nvgpu/posix/log.h>
 #include <nvgpu/types.h>
 
 #include <nvgpu/gk20a.h>
+#include <nvgpu/atomic.h>
+#include <nvgpu/barrier.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/lock.h>
+#include <nvgpu/log2.h>
+#include <nvgpu/timers.h>
+#include <nvgpu/string.h>
+
+#include "os_posix.h"
 
 /*
  * Define a length for log buffers. This is the buffer that the 'fmt, ...' part
@@ -62,6 +74,686 @@ static void __nvgpu_really_print_log(const char *gpu_name,
 	}
 }
 
+/*
+ * Binary trace mode. The call site id stored in the events is the index of
+ * the site descriptor in the nvgpu_log_sites section. The argument types of
+ * the format string are parsed on the first record and cached in the
+ * descriptor.
+ */
+#define LOG_TRACE_NSEC_PER_SEC	1000000000ULL
+#define LOG_TRACE_SPEC_LEN	32U
+/* Room for the "[sec.nsec] " timestamp prefix of decoded events. */
+#define LOG_TRACE_PREFIX_LEN	32U
+
+#define LOG_TRACE_SITE_EMPTY		0
+#define LOG_TRACE_SITE_BUSY		1
+#define LOG_TRACE_SITE_READY		2
+#define LOG_TRACE_SITE_UNSUPPORTED	3
+
+enum log_trace_arg {
+	LOG_TRACE_ARG_NONE = 0,
+	LOG_TRACE_ARG_INT,
+	LOG_TRACE_ARG_LONG,
+	LOG_TRACE_ARG_LLONG,
+	LOG_TRACE_ARG_SIZE,
+	LOG_TRACE_ARG_PTRDIFF,
+	LOG_TRACE_ARG_PTR,
+	LOG_TRACE_ARG_STR,
+	LOG_TRACE_ARG_DOUBLE,
+};
+
+/* One conversion of a format string. */
+struct log_trace_spec {
+	size_t len;
+	u32 stars;
+	enum log_trace_arg kind;
+};
+
+struct nvgpu_posix_log_trace_slot {
+	/* Index of the stored event + 1, 0 while the slot is written. */
+	nvgpu_atomic64_t seq;
+	struct nvgpu_log_trace_event ev;
+};
+
+struct nvgpu_posix_log_trace_ring {
+	nvgpu_atomic64_t head;
+	/* Next index to read, protected by read_lock. */
+	u64 tail;
+	struct nvgpu_posix_log_trace_slot *slots;
+};
+
+struct nvgpu_posix_log_trace {
+	nvgpu_atomic_t enabled;
+	u32 ring_events;
+	struct nvgpu_posix_log_trace_slot *slots;
+	struct nvgpu_posix_log_trace_ring rings[NVGPU_LOG_TRACE_RINGS];
+	nvgpu_atomic64_t fallbacks;
+	struct nvgpu_mutex read_lock;
+	u64 lost;
+};
+
+/*
+ * Bounds of the nvgpu_log_sites section, provided by the linker. Hidden so
+ * that each module only sees its own call sites.
+ */
+extern struct nvgpu_log_site __start_nvgpu_log_sites[]
+	__attribute__((weak, visibility("hidden")));
+extern struct nvgpu_log_site __stop_nvgpu_log_sites[]
+	__attribute__((weak, visibility("hidden")));
+
+static nvgpu_atomic_t log_trace_next_ring;
+static _Thread_local u32 log_trace_ring_id = U32_MAX;
+
+/*
+ * Parse the conversion starting at the '%' pointed by fmt. Returns false for
+ * conversions which cannot be recorded.
+ */
+static bool log_trace_parse_spec(const char *fmt, struct log_trace_spec *spec)
+{
+	const char *c = fmt + 1;
+	enum log_trace_arg len_kind = LOG_TRACE_ARG_INT;
+	bool long_double = false;
+
+	spec->stars = 0U;
+	spec->kind = LOG_TRACE_ARG_NONE;
+
+	if (*c == '%') {
+		spec->len = 2U;
+		return true;
+	}
+
+	while (*c != '\0' && strchr("-+ #0", *c) != NULL) {
+		c++;
+	}
+	if (*c == '*') {
+		spec->stars++;
+		c++;
+	}
+	while (*c >= '0' && *c <= '9') {
+		c++;
+	}
+	if (*c == '.') {
+		c++;
+		if (*c == '*') {
+			spec->stars++;
+			c++;
+		}
+		while (*c >= '0' && *c <= '9') {
+			c++;
+		}
+	}
+
+	switch (*c) {
+	case 'h':
+		c += (c[1] == 'h') ? 2 : 1;
+		break;
+	case 'l':
+		if (c[1] == 'l') {
+			len_kind = LOG_TRACE_ARG_LLONG;
+			c += 2;
+		} else {
+			len_kind = LOG_TRACE_ARG_LONG;
+			c++;
+		}
+		break;
+	case 'j':
+		len_kind = LOG_TRACE_ARG_LLONG;
+		c++;
+		break;
+	case 'z':
+		len_kind = LOG_TRACE_ARG_SIZE;
+		c++;
+		break;
+	case 't':
+		len_kind = LOG_TRACE_ARG_PTRDIFF;
+		c++;
+		break;
+	case 'L':
+		long_double = true;
+		c++;
+		break;
+	default:
+		break;
+	}
+
+	switch (*c) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'x':
+	case 'X':
+	case 'o':
+	case 'c':
+		spec->kind = len_kind;
+		break;
+	case 'p':
+		spec->kind = LOG_TRACE_ARG_PTR;
+		break;
+	case 's':
+		spec->kind = (len_kind == LOG_TRACE_ARG_INT) ?
+				LOG_TRACE_ARG_STR : LOG_TRACE_ARG_NONE;
+		break;
+	case 'f':
+	case 'F':
+	case 'e':
+	case 'E':
+	case 'g':
+	case 'G':
+	case 'a':
+	case 'A':
+		spec->kind = long_double ?
+				LOG_TRACE_ARG_NONE : LOG_TRACE_ARG_DOUBLE;
+		break;
+	default:
+		break;
+	}
+
+	if (spec->kind == LOG_TRACE_ARG_NONE) {
+		return false;
+	}
+
+	spec->len = (size_t)(c - fmt) + 1U;
+	return spec->len < LOG_TRACE_SPEC_LEN;
+}
+
+/*
+ * Parse the argument kinds of a format string. Returns false if the string
+ * has conversions which cannot be recorded or too many arguments.
+ */
+static bool log_trace_parse_fmt(const char *fmt, u8 *kinds, u32 *nargs)
+{
+	struct log_trace_spec spec;
+	const char *c = fmt;
+	u32 i;
+
+	*nargs = 0U;
+
+	while (*c != '\0') {
+		if (*c != '%') {
+			c++;
+			continue;
+		}
+		if (!log_trace_parse_spec(c, &spec)) {
+			return false;
+		}
+		if (spec.kind != LOG_TRACE_ARG_NONE) {
+			if (*nargs + spec.stars + 1U > NVGPU_LOG_TRACE_MAX_ARGS) {
+				return false;
+			}
+			for (i = 0U; i < spec.stars; i++) {
+				kinds[(*nargs)++] = LOG_TRACE_ARG_INT;
+			}
+			kinds[(*nargs)++] = (u8)spec.kind;
+		}
+		c += spec.len;
+	}
+
+	return true;
+}
+
+/*
+ * Get the argument kinds of a site, parsing them on the first record. A
+ * thread which races with the one caching them uses its own parse in
+ * scratch instead of waiting.
+ */
+static bool log_trace_site_kinds(struct nvgpu_log_site *site, u8 *scratch,
+				 const u8 **kinds, u32 *nargs)
+{
+	int state = nvgpu_atomic_read(&site->trace_state);
+	bool supported;
+
+	if (state == LOG_TRACE_SITE_READY) {
+		nvgpu_smp_rmb();
+		*kinds = site->trace_kinds;
+		*nargs = site->trace_nargs;
+		return true;
+	}
+	if (state == LOG_TRACE_SITE_UNSUPPORTED) {
+		return false;
+	}
+
+	supported = log_trace_parse_fmt(site->format, scratch, nargs);
+	*kinds = scratch;
+
+	if (nvgpu_atomic_cmpxchg(&site->trace_state, LOG_TRACE_SITE_EMPTY,
+			LOG_TRACE_SITE_BUSY) == LOG_TRACE_SITE_EMPTY) {
+		(void) memcpy(site->trace_kinds, scratch, *nargs);
+		site->trace_nargs = (u8)*nargs;
+		nvgpu_smp_wmb();
+		nvgpu_atomic_set(&site->trace_state, supported ?
+				LOG_TRACE_SITE_READY :
+				LOG_TRACE_SITE_UNSUPPORTED);
+	}
+
+	return supported;
+}
+
+/*
+ * Index of a site in the nvgpu_log_sites section of this module. Sites of
+ * other modules cannot be looked up by index and are not recorded.
+ */
+static bool log_trace_site_id(const struct nvgpu_log_site *site, u32 *id)
+{
+	if (__start_nvgpu_log_sites == NULL ||
+	    site < __start_nvgpu_log_sites ||
+	    site >= __stop_nvgpu_log_sites) {
+		return false;
+	}
+
+	*id = (u32)(site - __start_nvgpu_log_sites);
+	return true;
+}
+
+/*
+ * Copy a string argument into the event and return its offset in ev->strs.
+ * The string may be on the caller's stack or freed before the event is
+ * formatted, so it cannot be recorded by reference. Strings are truncated
+ * to the space left; once it is used up, further strings are empty.
+ */
+static u64 log_trace_copy_str(struct nvgpu_log_trace_event *ev, u32 *used,
+			      const char *str)
+{
+	u32 off = *used;
+	u32 n = 0U;
+
+	if (off >= NVGPU_LOG_TRACE_STR_LEN) {
+		/* Terminator of the last copied string. */
+		return (u64)(NVGPU_LOG_TRACE_STR_LEN - 1U);
+	}
+
+	if (str == NULL) {
+		str = "(null)";
+	}
+
+	while (off + n + 1U < NVGPU_LOG_TRACE_STR_LEN && str[n] != '\0') {
+		ev->strs[off + n] = str[n];
+		n++;
+	}
+	ev->strs[off + n] = '\0';
+	*used = off + n + 1U;
+
+	return (u64)off;
+}
+
+static bool log_trace_record(struct nvgpu_posix_log_trace *trace,
+			     struct nvgpu_log_site *site, va_list args)
+{
+	struct nvgpu_posix_log_trace_ring *ring;
+	struct nvgpu_posix_log_trace_slot *slot;
+	u8 scratch[NVGPU_LOG_TRACE_MAX_ARGS];
+	const u8 *kinds;
+	u64 idx;
+	u32 id, nargs, i;
+	u32 strs_used = 0U;
+	double d;
+
+	if (site == NULL || !log_trace_site_id(site, &id) ||
+	    !log_trace_site_kinds(site, scratch, &kinds, &nargs)) {
+		nvgpu_atomic64_inc(&trace->fallbacks);
+		return false;
+	}
+
+	if (log_trace_ring_id == U32_MAX) {
+		log_trace_ring_id = (u32)nvgpu_atomic_inc_return(
+				&log_trace_next_ring) % NVGPU_LOG_TRACE_RINGS;
+	}
+	ring = &trace->rings[log_trace_ring_id];
+
+	idx = (u64)nvgpu_atomic64_inc_return(&ring->head) - 1ULL;
+	slot = &ring->slots[idx & (trace->ring_events - 1U)];
+
+	nvgpu_atomic64_set(&slot->seq, 0);
+	nvgpu_smp_wmb();
+
+	slot->ev.timestamp = (u64)nvgpu_current_time_ns();
+	slot->ev.site = id;
+	slot->ev.ring = log_trace_ring_id;
+	for (i = 0U; i < nargs; i++) {
+		switch (kinds[i]) {
+		case LOG_TRACE_ARG_INT:
+			slot->ev.args[i] = (u64)(s64)va_arg(args, int);
+			break;
+		case LOG_TRACE_ARG_LONG:
+			slot->ev.args[i] = (u64)va_arg(args, long);
+			break;
+		case LOG_TRACE_ARG_LLONG:
+			slot->ev.args[i] = (u64)va_arg(args, long long);
+			break;
+		case LOG_TRACE_ARG_SIZE:
+			slot->ev.args[i] = (u64)va_arg(args, size_t);
+			break;
+		case LOG_TRACE_ARG_PTRDIFF:
+			slot->ev.args[i] = (u64)va_arg(args, ptrdiff_t);
+			break;
+		case LOG_TRACE_ARG_PTR:
+			slot->ev.args[i] = (u64)(uintptr_t)va_arg(args, void *);
+			break;
+		case LOG_TRACE_ARG_STR:
+			slot->ev.args[i] = log_trace_copy_str(&slot->ev,
+					&strs_used, va_arg(args, const char *));
+			break;
+		default:
+			d = va_arg(args, double);
+			(void) memcpy(&slot->ev.args[i], &d, sizeof(d));
+			break;
+		}
+	}
+
+	nvgpu_smp_wmb();
+	nvgpu_atomic64_set(&slot->seq, (long)(idx + 1ULL));
+
+	return true;
+}
+
+int nvgpu_log_trace_enable(struct gk20a *g, u32 ring_events)
+{
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_log_trace *trace = p->log_trace;
+	u32 i;
+
+	if (trace == NULL) {
+		if (ring_events == 0U || ring_events > (1U << 20)) {
+			return -EINVAL;
+		}
+
+		trace = nvgpu_kzalloc(g, sizeof(*trace));
+		if (trace == NULL) {
+			return -ENOMEM;
+		}
+
+		trace->ring_events = (u32)roundup_pow_of_two(ring_events);
+		trace->slots = nvgpu_kzalloc(g, sizeof(*trace->slots) *
+				trace->ring_events * NVGPU_LOG_TRACE_RINGS);
+		if (trace->slots == NULL) {
+			nvgpu_kfree(g, trace);
+			return -ENOMEM;
+		}
+
+		for (i = 0U; i < NVGPU_LOG_TRACE_RINGS; i++) {
+			trace->rings[i].slots =
+				&trace->slots[i * trace->ring_events];
+		}
+		nvgpu_mutex_init(&trace->read_lock);
+		p->log_trace = trace;
+	}
+
+	nvgpu_atomic_set(&trace->enabled, 1);
+
+	return 0;
+}
+
+void nvgpu_log_trace_disable(struct gk20a *g)
+{
+	struct nvgpu_posix_log_trace *trace =
+		nvgpu_os_posix_from_gk20a(g)->log_trace;
+
+	if (trace != NULL) {
+		nvgpu_atomic_set(&trace->enabled, 0);
+	}
+}
+
+void nvgpu_posix_log_trace_fini(struct gk20a *g)
+{
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_log_trace *trace = p->log_trace;
+
+	if (trace == NULL) {
+		return;
+	}
+
+	p->log_trace = NULL;
+	nvgpu_mutex_destroy(&trace->read_lock);
+	nvgpu_kfree(g, trace->slots);
+	nvgpu_kfree(g, trace);
+}
+
+static u32 log_trace_read_ring(struct nvgpu_posix_log_trace *trace,
+			       struct nvgpu_posix_log_trace_ring *ring,
+			       struct nvgpu_log_trace_event *events, u32 count)
+{
+	struct nvgpu_posix_log_trace_slot *slot;
+	u64 head = (u64)nvgpu_atomic64_read(&ring->head);
+	u64 seq, seq_after;
+	u32 n = 0U;
+
+	if (head - ring->tail > trace->ring_events) {
+		trace->lost += head - ring->tail - trace->ring_events;
+		ring->tail = head - trace->ring_events;
+	}
+
+	while (ring->tail < head && n < count) {
+		slot = &ring->slots[ring->tail & (trace->ring_events - 1U)];
+
+		seq = (u64)nvgpu_atomic64_read(&slot->seq);
+		if (seq < ring->tail + 1ULL) {
+			/* Still being written, pick it up on the next read. */
+			break;
+		}
+		nvgpu_smp_rmb();
+		events[n] = slot->ev;
+		nvgpu_smp_rmb();
+		seq_after = (u64)nvgpu_atomic64_read(&slot->seq);
+
+		if (seq == ring->tail + 1ULL && seq_after == seq) {
+			n++;
+		} else {
+			trace->lost++;
+		}
+		ring->tail++;
+	}
+
+	return n;
+}
+
+u32 nvgpu_log_trace_read(struct gk20a *g,
+			 struct nvgpu_log_trace_event *events, u32 count)
+{
+	struct nvgpu_posix_log_trace *trace =
+		nvgpu_os_posix_from_gk20a(g)->log_trace;
+	u32 i, n = 0U;
+
+	if (trace == NULL || events == NULL) {
+		return 0U;
+	}
+
+	nvgpu_mutex_acquire(&trace->read_lock);
+	for (i = 0U; i < NVGPU_LOG_TRACE_RINGS && n < count; i++) {
+		n += log_trace_read_ring(trace, &trace->rings[i],
+					 &events[n], count - n);
+	}
+	nvgpu_mutex_release(&trace->read_lock);
+
+	return n;
+}
+
+int nvgpu_log_trace_site(u32 site, const char **func, int *line,
+			 const char **fmt)
+{
+	struct nvgpu_log_site *s = nvgpu_log_site_get(site);
+
+	if (s == NULL) {
+		return -EINVAL;
+	}
+
+	*func = s->func;
+	*line = s->line;
+	*fmt = s->format;
+
+	return 0;
+}
+
+#define LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars, val)	\
+	(((nstars) == 0U) ? snprintf(out, size, spec, val) :		\
+	 (((nstars) == 1U) ?						\
+		snprintf(out, size, spec, (int)(star)[0], val) :	\
+		snprintf(out, size, spec, (int)(star)[0], (int)(star)[1], val)))
+
+static int log_trace_format_arg(char *out, size_t size, const char *spec,
+				const u64 *star, u32 nstars,
+				enum log_trace_arg kind, u64 arg,
+				const char *strs)
+{
+	double d;
+
+	switch (kind) {
+	case LOG_TRACE_ARG_INT:
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   (int)arg);
+	case LOG_TRACE_ARG_LONG:
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   (long)arg);
+	case LOG_TRACE_ARG_LLONG:
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   (long long)arg);
+	case LOG_TRACE_ARG_SIZE:
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   (size_t)arg);
+	case LOG_TRACE_ARG_PTRDIFF:
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   (ptrdiff_t)arg);
+	case LOG_TRACE_ARG_PTR:
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   (void *)(uintptr_t)arg);
+	case LOG_TRACE_ARG_STR:
+		if (arg >= NVGPU_LOG_TRACE_STR_LEN ||
+		    memchr(&strs[arg], '\0',
+			   NVGPU_LOG_TRACE_STR_LEN - (size_t)arg) == NULL) {
+			return -EINVAL;
+		}
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars,
+					   &strs[arg]);
+	default:
+		(void) memcpy(&d, &arg, sizeof(d));
+		return LOG_TRACE_PRINT_ARG(out, size, spec, star, nstars, d);
+	}
+}
+
+int nvgpu_log_trace_format(const struct nvgpu_log_trace_event *ev,
+			   char *buf, size_t size)
+{
+	struct nvgpu_log_site *site = nvgpu_log_site_get(ev->site);
+	struct log_trace_spec spec;
+	char spec_str[LOG_TRACE_SPEC_LEN];
+	u8 kinds[NVGPU_LOG_TRACE_MAX_ARGS];
+	const char *c;
+	size_t pos = 0U;
+	u32 nargs, arg = 0U;
+	int len;
+
+	if (site == NULL || size == 0U ||
+	    !log_trace_parse_fmt(site->format, kinds, &nargs)) {
+		return -EINVAL;
+	}
+
+	c = site->format;
+	while (*c != '\0' && pos + 1U < size) {
+		if (*c != '%') {
+			buf[pos++] = *c++;
+			continue;
+		}
+
+		/* The whole format string parsed above. */
+		(void) log_trace_parse_spec(c, &spec);
+		if (spec.kind == LOG_TRACE_ARG_NONE) {
+			buf[pos++] = '%';
+			c += spec.len;
+			continue;
+		}
+
+		(void) memcpy(spec_str, c, spec.len);
+		spec_str[spec.len] = '\0';
+		len = log_trace_format_arg(&buf[pos], size - pos, spec_str,
+				&ev->args[arg], spec.stars, spec.kind,
+				ev->args[arg + spec.stars], ev->strs);
+		arg += spec.stars + 1U;
+		c += spec.len;
+
+		if (len < 0) {
+			break;
+		}
+		pos += min((size_t)len, size - pos - 1U);
+	}
+	buf[pos] = '\0';
+
+	return 0;
+}
+
+static int log_trace_cmp(const void *a, const void *b)
+{
+	const struct nvgpu_log_trace_event *ea = a;
+	const struct nvgpu_log_trace_event *eb = b;
+
+	if (ea->timestamp != eb->timestamp) {
+		return (ea->timestamp < eb->timestamp) ? -1 : 1;
+	}
+	return 0;
+}
+
+u32 nvgpu_log_trace_decode(struct gk20a *g)
+{
+	struct nvgpu_posix_log_trace *trace =
+		nvgpu_os_posix_from_gk20a(g)->log_trace;
+	struct nvgpu_log_trace_event *events;
+	char log[LOG_BUFFER_LENGTH + LOG_TRACE_PREFIX_LEN];
+	char msg[LOG_BUFFER_LENGTH];
+	const char *func, *fmt;
+	u32 count, n, i;
+	int line;
+
+	if (trace == NULL) {
+		return 0U;
+	}
+
+	count = trace->ring_events * NVGPU_LOG_TRACE_RINGS;
+	events = nvgpu_kmalloc(g, sizeof(*events) * count);
+	if (events == NULL) {
+		return 0U;
+	}
+
+	n = nvgpu_log_trace_read(g, events, count);
+	qsort(events, n, sizeof(*events), log_trace_cmp);
+
+	for (i = 0U; i < n; i++) {
+		if (nvgpu_log_trace_site(events[i].site, &func, &line,
+					 &fmt) != 0 ||
+		    nvgpu_log_trace_format(&events[i], msg,
+					   sizeof(msg)) != 0) {
+			continue;
+		}
+		(void) snprintf(log, sizeof(log), "[%llu.%09llu] %s",
+				events[i].timestamp / LOG_TRACE_NSEC_PER_SEC,
+				events[i].timestamp % LOG_TRACE_NSEC_PER_SEC, msg);
+		__nvgpu_really_print_log(nvgpu_log_name(g), func, line,
+					 NVGPU_DEBUG, log);
+	}
+
+	nvgpu_kfree(g, events);
+
+	return n;
+}
+
+void nvgpu_log_trace_get_stats(struct gk20a *g,
+			       struct nvgpu_log_trace_stats *stats)
+{
+	struct nvgpu_posix_log_trace *trace =
+		nvgpu_os_posix_from_gk20a(g)->log_trace;
+	u32 i;
+
+	(void) memset(stats, 0, sizeof(*stats));
+	if (trace == NULL) {
+		return;
+	}
+
+	nvgpu_mutex_acquire(&trace->read_lock);
+	for (i = 0U; i < NVGPU_LOG_TRACE_RINGS; i++) {
+		stats->events +=
+			(u64)nvgpu_atomic64_read(&trace->rings[i].head);
+	}
+	stats->lost = trace->lost;
+	stats->fallbacks = (u64)nvgpu_atomic64_read(&trace->fallbacks);
+	nvgpu_mutex_release(&trace->read_lock);
+}
+
 __attribute__((format (printf, 5, 6)))
 void nvgpu_log_msg_impl(struct gk20a *g, const char *func_name, int line,
 			enum nvgpu_log_type type, const char *fmt, ...)
@@ -77,12 +769,36 @@ void nvgpu_log_msg_impl(struct gk20a *g, const char *func_name, int line,
 				 func_name, line, type, log);
 }
 
+static void log_dbg_vprint(struct gk20a *g, struct nvgpu_log_site *site,
+			   const char *func_name, int line,
+			   const char *fmt, va_list args)
+{
+	struct nvgpu_posix_log_trace *trace;
+	char log[LOG_BUFFER_LENGTH];
+	va_list trace_args;
+	bool recorded;
+
+	trace = nvgpu_os_posix_from_gk20a(g)->log_trace;
+	if (trace != NULL && nvgpu_atomic_read(&trace->enabled) != 0) {
+		va_copy(trace_args, args);
+		recorded = log_trace_record(trace, site, trace_args);
+		va_end(trace_args);
+		if (recorded) {
+			return;
+		}
+	}
+
+	(void) vsnprintf(log, LOG_BUFFER_LENGTH, fmt, args);
+
+	__nvgpu_really_print_log(nvgpu_log_name(g),
+				 func_name, line, NVGPU_DEBUG, log);
+}
+
 __attribute__((format (printf, 5, 6)))
 void nvgpu_log_dbg_impl(struct gk20a *g, u64 log_mask,
 			const char *func_name, int line,
 			const char *fmt, ...)
 {
-	char log[LOG_BUFFER_LENGTH];
 	va_list args;
 
 	if ((log_mask & g->log_mask) == 0) {
@@ -90,9 +806,73 @@ void nvgpu_log_dbg_impl(struct gk20a *g, u64 log_mask,
 	}
 
 	va_start(args, fmt);
-	(void) vsnprintf(log, LOG_BUFFER_LENGTH, fmt, args);
+	log_dbg_vprint(g, NULL, func_name, line, fmt, args);
 	va_end(args);
+}
 
-	__nvgpu_really_print_log(nvgpu_log_name(g),
-				 func_name, line, NVGPU_DEBUG, log);
+__attribute__((format (printf, 3, 4)))
+void nvgpu_log_site_impl(struct gk20a *g, struct nvgpu_log_site *site,
+			 const char *fmt, ...)
+{
+	va_list args;
+
+	if (site->enabled == NVGPU_LOG_SITE_MASK &&
+	    (site->mask & g->log_mask) == 0ULL) {
+		return;
+	}
+
+	nvgpu_atomic64_inc(&site->hits);
+
+	va_start(args, fmt);
+	log_dbg_vprint(g, site, site->func, site->line, fmt, args);
+	va_end(args);
+}
+
+u32 nvgpu_log_sites_count(void)
+{
+	if (__start_nvgpu_log_sites == NULL) {
+		return 0U;
+	}
+
+	return (u32)(__stop_nvgpu_log_sites - __start_nvgpu_log_sites);
+}
+
+struct nvgpu_log_site *nvgpu_log_site_get(u32 index)
+{
+	if (index >= nvgpu_log_sites_count()) {
+		return NULL;
+	}
+
+	return &__start_nvgpu_log_sites[index];
+}
+
+u32 nvgpu_log_sites_set(const char *func, int line, u8 state)
+{
+	struct nvgpu_log_site *site;
+	u32 i, n = 0U;
+
+	if (state > NVGPU_LOG_SITE_OFF) {
+		return 0U;
+	}
+
+	for (i = 0U; i < nvgpu_log_sites_count(); i++) {
+		site = &__start_nvgpu_log_sites[i];
+		if ((func != NULL && strcmp(site->func, func) != 0) ||
+		    (line != 0 && site->line != line)) {
+			continue;
+		}
+		site->enabled = state;
+		n++;
+	}
+
+	return n;
+}
+
+void nvgpu_log_sites_reset_hits(void)
+{
+	u32 i;
+
+	for (i = 0U; i < nvgpu_log_sites_count(); i++) {
+		nvgpu_atomic64_set(&__start_nvgpu_log_sites[i].hits, 0);
+	}
 }
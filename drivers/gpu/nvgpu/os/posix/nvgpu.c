@@ -235,6 +235,8 @@ struct gk20a *nvgpu_posix_probe(void)
 		goto fail_enabled_flags;
 	}
 
+	nvgpu_posix_fw_cache_init(g);
+
 	/*
 	 * Initialize a bunch of gv11b register values.
 	 */
@@ -274,6 +276,9 @@ void nvgpu_posix_cleanup(struct gk20a *g)
 {
 	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
 
+	nvgpu_posix_log_trace_fini(g);
+	nvgpu_posix_io_fini(g);
+	nvgpu_posix_fw_cache_fini(g);
 	nvgpu_kmem_fini(g, 0);
 	nvgpu_free_enabled_flags(g);
 	nvgpu_free_errata_flags(g);
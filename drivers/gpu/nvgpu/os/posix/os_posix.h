@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -24,8 +24,35 @@
 #define NVGPU_OS_POSIX_H
 
 #include <nvgpu/gk20a.h>
+#include <nvgpu/firmware.h>
+#include <nvgpu/posix/io.h>
 
 struct nvgpu_posix_io_callbacks;
+struct nvgpu_posix_io_trace;
+struct nvgpu_posix_log_trace;
+
+/*
+ * Register space lookup cache. The 32 bit register address space is split in
+ * directories of 4MB, each holding one slot per 4KB page. A page slot caches
+ * the register space serving the page; directories are allocated on demand.
+ */
+#define NVGPU_POSIX_IO_PAGE_SHIFT	12U
+#define NVGPU_POSIX_IO_DIR_SHIFT	22U
+#define NVGPU_POSIX_IO_DIRS		(1U << (32U - NVGPU_POSIX_IO_DIR_SHIFT))
+#define NVGPU_POSIX_IO_DIR_PAGES	\
+	(1U << (NVGPU_POSIX_IO_DIR_SHIFT - NVGPU_POSIX_IO_PAGE_SHIFT))
+
+/*
+ * Cache of read-only firmware image mappings shared across requests.
+ */
+struct nvgpu_posix_fw_cache {
+	struct nvgpu_mutex lock;
+	/* Cached images, most recently used first. */
+	struct nvgpu_list_node entries;
+	enum nvgpu_firmware_cache_policy policy;
+	size_t budget;
+	struct nvgpu_firmware_cache_stats stats;
+};
 
 struct nvgpu_os_posix {
 	struct gk20a g;
@@ -40,6 +67,7 @@ struct nvgpu_os_posix {
 	 * Memory-mapped register space for unit tests.
 	 */
 	struct nvgpu_list_node reg_space_head;
+	struct nvgpu_posix_io_reg_space **reg_space_pages[NVGPU_POSIX_IO_DIRS];
 	int error_code;
 
 
@@ -49,6 +77,16 @@ struct nvgpu_os_posix {
 	struct nvgpu_list_node recorder_head;
 	bool recording;
 
+	/*
+	 * Binary trace of all register accesses, see nvgpu_posix_io_trace_*.
+	 */
+	struct nvgpu_posix_io_trace *io_trace;
+
+	/*
+	 * BAR0 access counters.
+	 */
+	struct nvgpu_posix_io_stats io_stats;
+
 	/*
 	 * Parameters to change the behavior of MM-related functions
 	 */
@@ -62,6 +100,16 @@ struct nvgpu_os_posix {
 	bool is_silicon;
 	bool is_fpga;
 	bool is_simulation;
+
+	/*
+	 * Firmware image cache.
+	 */
+	struct nvgpu_posix_fw_cache fw_cache;
+
+	/*
+	 * Binary trace rings for debug messages, allocated on first enable.
+	 */
+	struct nvgpu_posix_log_trace *log_trace;
 };
 
 static inline struct nvgpu_os_posix *nvgpu_os_posix_from_gk20a(struct gk20a *g)
@@ -69,4 +117,9 @@ static inline struct nvgpu_os_posix *nvgpu_os_posix_from_gk20a(struct gk20a *g)
 	return container_of(g, struct nvgpu_os_posix, g);
 }
 
+void nvgpu_posix_fw_cache_init(struct gk20a *g);
+void nvgpu_posix_fw_cache_fini(struct gk20a *g);
+void nvgpu_posix_log_trace_fini(struct gk20a *g);
+void nvgpu_posix_io_fini(struct gk20a *g);
+
 #endif /* NVGPU_OS_POSIX_H */
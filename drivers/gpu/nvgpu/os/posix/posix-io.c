@@ -20,9 +20,20 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+/* For dladdr(). */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
 #include <nvgpu/io.h>
 #include <nvgpu/io_usermode.h>
 #include <nvgpu/bug.h>
+#include <nvgpu/string.h>
 
 #include <nvgpu/posix/io.h>
 #include <nvgpu/posix/posix-fault-injection.h>
@@ -31,6 +42,44 @@
 #include "os_posix.h"
 
 
+/*
+ * Register access trace. The callsite of an access is the first exported
+ * function on the stack outside of the IO accessors; static functions have
+ * no dynamic symbol and are skipped. Resolved return addresses are cached so
+ * dladdr() is only called the first time an address is seen.
+ */
+#define POSIX_IO_TRACE_FRAMES		16
+#define POSIX_IO_TRACE_FRAME_CACHE	1024U
+#define POSIX_IO_TRACE_MIN_ENTRIES	1024U
+/* Frame cache marker for frames which are not a callsite. */
+#define POSIX_IO_TRACE_SKIP_FRAME	U32_MAX
+
+struct posix_io_trace_frame {
+	void *addr;
+	u32 callsite;
+};
+
+struct nvgpu_posix_io_trace {
+	bool recording;
+	struct nvgpu_posix_io_trace_entry *entries;
+	u64 count;
+	u64 capacity;
+	char **callsites;
+	u32 ncallsites;
+	u32 callsites_capacity;
+	struct posix_io_trace_frame frames[POSIX_IO_TRACE_FRAME_CACHE];
+};
+
+static const char *const posix_io_trace_io_prefixes[] = {
+	"nvgpu_os_",
+	"nvgpu_posix_",
+	"nvgpu_readl",
+	"nvgpu_writel",
+	"nvgpu_bar1_",
+	"nvgpu_func_",
+	"nvgpu_usermode_",
+};
+
 #ifdef NVGPU_UNITTEST_FAULT_INJECTION_ENABLEMENT
 struct nvgpu_posix_fault_inj *nvgpu_readl_get_fault_injection(void)
 {
@@ -60,10 +109,144 @@ struct nvgpu_posix_io_callbacks *nvgpu_posix_register_io(
 	return old_io;
 }
 
+static u32 posix_io_trace_add_callsite(struct nvgpu_posix_io_trace *t,
+		const char *name)
+{
+	char **callsites;
+	u32 i;
+
+	for (i = 0U; i < t->ncallsites; i++) {
+		if (strcmp(t->callsites[i], name) == 0) {
+			return i;
+		}
+	}
+
+	if (t->ncallsites == t->callsites_capacity) {
+		callsites = realloc(t->callsites, sizeof(*callsites) *
+				(t->callsites_capacity * 2U));
+		if (callsites == NULL) {
+			return NVGPU_POSIX_IO_TRACE_NO_CALLSITE;
+		}
+		t->callsites = callsites;
+		t->callsites_capacity *= 2U;
+	}
+
+	t->callsites[t->ncallsites] = strdup(name);
+	if (t->callsites[t->ncallsites] == NULL) {
+		return NVGPU_POSIX_IO_TRACE_NO_CALLSITE;
+	}
+
+	return t->ncallsites++;
+}
+
+static u32 posix_io_trace_resolve(struct nvgpu_posix_io_trace *t, void *addr)
+{
+	Dl_info info;
+	size_t i;
+
+	if (dladdr(addr, &info) == 0 || info.dli_sname == NULL) {
+		return POSIX_IO_TRACE_SKIP_FRAME;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(posix_io_trace_io_prefixes); i++) {
+		if (strncmp(info.dli_sname, posix_io_trace_io_prefixes[i],
+			    strlen(posix_io_trace_io_prefixes[i])) == 0) {
+			return POSIX_IO_TRACE_SKIP_FRAME;
+		}
+	}
+
+	return posix_io_trace_add_callsite(t, info.dli_sname);
+}
+
+static u32 posix_io_trace_frame(struct nvgpu_posix_io_trace *t, void *addr)
+{
+	u32 hash = (u32)(((uintptr_t)addr >> 2) * 0x9E3779B1U);
+	struct posix_io_trace_frame *f;
+	u32 probe;
+
+	for (probe = 0U; probe < POSIX_IO_TRACE_FRAME_CACHE; probe++) {
+		f = &t->frames[(hash + probe) & (POSIX_IO_TRACE_FRAME_CACHE - 1U)];
+		if (f->addr == addr) {
+			return f->callsite;
+		}
+		if (f->addr == NULL) {
+			f->addr = addr;
+			f->callsite = posix_io_trace_resolve(t, addr);
+			return f->callsite;
+		}
+	}
+
+	return posix_io_trace_resolve(t, addr);
+}
+
+static u32 posix_io_trace_caller(struct nvgpu_posix_io_trace *t)
+{
+	void *frames[POSIX_IO_TRACE_FRAMES];
+	int i, n;
+	u32 callsite;
+
+	n = backtrace(frames, POSIX_IO_TRACE_FRAMES);
+
+	/* Skip this function and the recorder. */
+	for (i = 2; i < n; i++) {
+		callsite = posix_io_trace_frame(t, frames[i]);
+		if (callsite != POSIX_IO_TRACE_SKIP_FRAME) {
+			return callsite;
+		}
+	}
+
+	return NVGPU_POSIX_IO_TRACE_NO_CALLSITE;
+}
+
+static void __attribute__((noinline)) posix_io_trace_record(
+		struct nvgpu_os_posix *p, u64 aperture, u8 dir,
+		u32 addr, u32 value)
+{
+	struct nvgpu_posix_io_trace *t = p->io_trace;
+	struct nvgpu_posix_io_trace_entry *e;
+
+	if (t == NULL || !t->recording) {
+		return;
+	}
+
+	if (t->count == t->capacity) {
+		e = realloc(t->entries, sizeof(*e) * t->capacity * 2U);
+		if (e == NULL) {
+			/* Keep what was recorded so far. */
+			t->recording = false;
+			return;
+		}
+		t->entries = e;
+		t->capacity *= 2U;
+	}
+
+	e = &t->entries[t->count];
+	e->addr = addr;
+	e->value = value;
+	e->aperture = (u8)aperture;
+	e->dir = dir;
+	e->reserved = 0U;
+	e->callsite = posix_io_trace_caller(t);
+	t->count++;
+}
+
+void nvgpu_posix_io_get_stats(struct gk20a *g,
+	struct nvgpu_posix_io_stats *stats)
+{
+	*stats = nvgpu_os_posix_from_gk20a(g)->io_stats;
+}
+
+void nvgpu_posix_io_reset_stats(struct gk20a *g)
+{
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+
+	(void) memset(&p->io_stats, 0, sizeof(p->io_stats));
+}
+
 static void nvgpu_posix_writel(struct gk20a *g, u32 r, u32 v)
 {
-	struct nvgpu_posix_io_callbacks *callbacks =
-		nvgpu_os_posix_from_gk20a(g)->callbacks;
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_callbacks *callbacks = p->callbacks;
 
 	struct nvgpu_reg_access access = {
 		.addr = r,
@@ -74,13 +257,16 @@ static void nvgpu_posix_writel(struct gk20a *g, u32 r, u32 v)
 		BUG();
 	}
 
+	p->io_stats.writes++;
+	posix_io_trace_record(p, NVGPU_POSIX_REG_BAR0,
+			NVGPU_POSIX_IO_TRACE_WRITE, r, v);
 	callbacks->writel(g, &access);
 }
 
 static u32 nvgpu_posix_readl(struct gk20a *g, u32 r)
 {
-	struct nvgpu_posix_io_callbacks *callbacks =
-		nvgpu_os_posix_from_gk20a(g)->callbacks;
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_callbacks *callbacks = p->callbacks;
 
 	struct nvgpu_reg_access access = {
 		.addr = r,
@@ -98,15 +284,18 @@ static u32 nvgpu_posix_readl(struct gk20a *g, u32 r)
 		BUG();
 	}
 
+	p->io_stats.reads++;
 	callbacks->readl(g, &access);
+	posix_io_trace_record(p, NVGPU_POSIX_REG_BAR0,
+			NVGPU_POSIX_IO_TRACE_READ, r, access.value);
 
 	return access.value;
 }
 
 static void nvgpu_posix_bar1_writel(struct gk20a *g, u32 b, u32 v)
 {
-	struct nvgpu_posix_io_callbacks *callbacks =
-		nvgpu_os_posix_from_gk20a(g)->callbacks;
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_callbacks *callbacks = p->callbacks;
 
 	struct nvgpu_reg_access access = {
 		.addr = b,
@@ -117,13 +306,15 @@ static void nvgpu_posix_bar1_writel(struct gk20a *g, u32 b, u32 v)
 		BUG();
 	}
 
+	posix_io_trace_record(p, NVGPU_POSIX_REG_BAR1,
+			NVGPU_POSIX_IO_TRACE_WRITE, b, v);
 	callbacks->bar1_writel(g, &access);
 }
 
 static u32 nvgpu_posix_bar1_readl(struct gk20a *g, u32 b)
 {
-	struct nvgpu_posix_io_callbacks *callbacks =
-		nvgpu_os_posix_from_gk20a(g)->callbacks;
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_callbacks *callbacks = p->callbacks;
 
 	struct nvgpu_reg_access access = {
 		.addr = b,
@@ -135,14 +326,16 @@ static u32 nvgpu_posix_bar1_readl(struct gk20a *g, u32 b)
 	}
 
 	callbacks->bar1_readl(g, &access);
+	posix_io_trace_record(p, NVGPU_POSIX_REG_BAR1,
+			NVGPU_POSIX_IO_TRACE_READ, b, access.value);
 
 	return access.value;
 }
 
 void nvgpu_usermode_writel(struct gk20a *g, u32 r, u32 v)
 {
-	struct nvgpu_posix_io_callbacks *callbacks =
-		nvgpu_os_posix_from_gk20a(g)->callbacks;
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_callbacks *callbacks = p->callbacks;
 
 	struct nvgpu_reg_access access = {
 		.addr = r,
@@ -153,6 +346,8 @@ void nvgpu_usermode_writel(struct gk20a *g, u32 r, u32 v)
 		BUG();
 	}
 
+	posix_io_trace_record(p, NVGPU_POSIX_REG_USERMODE,
+			NVGPU_POSIX_IO_TRACE_WRITE, r, v);
 	callbacks->usermode_writel(g, &access);
 }
 
@@ -193,13 +388,71 @@ void nvgpu_os_writel(u32 v, uintptr_t addr)
 
 void nvgpu_os_writel_relaxed(u32 v, uintptr_t addr)
 {
+	struct gk20a *g = nvgpu_posix_current_device();
+
+	if ((addr >> NVGPU_POSIX_REG_SHIFT) == NVGPU_POSIX_REG_BAR0) {
+		nvgpu_os_posix_from_gk20a(g)->io_stats.relaxed_writes++;
+	}
 	nvgpu_os_writel(v, addr);
 }
 
+static struct nvgpu_posix_io_reg_space **posix_io_page_slot(
+		struct nvgpu_os_posix *p, u32 addr, bool alloc)
+{
+	u32 dir = addr >> NVGPU_POSIX_IO_DIR_SHIFT;
+	u32 page = (addr >> NVGPU_POSIX_IO_PAGE_SHIFT) &
+			(NVGPU_POSIX_IO_DIR_PAGES - 1U);
+
+	if (p->reg_space_pages[dir] == NULL) {
+		if (!alloc) {
+			return NULL;
+		}
+		/*
+		 * Not nvgpu_kzalloc(): lookups must not disturb kmem fault
+		 * injection used by the unit tests.
+		 */
+		p->reg_space_pages[dir] = calloc(NVGPU_POSIX_IO_DIR_PAGES,
+				sizeof(*p->reg_space_pages[dir]));
+		if (p->reg_space_pages[dir] == NULL) {
+			return NULL;
+		}
+	}
+
+	return &p->reg_space_pages[dir][page];
+}
+
+/* Drop cached lookups of all pages overlapping a register space. */
+static void posix_io_invalidate_pages(struct nvgpu_os_posix *p,
+		struct nvgpu_posix_io_reg_space *reg_space)
+{
+	struct nvgpu_posix_io_reg_space **slot;
+	u64 end = (u64)reg_space->base + reg_space->size;
+	u64 addr;
+
+	for (addr = reg_space->base & ~(BIT64(NVGPU_POSIX_IO_PAGE_SHIFT) - 1ULL);
+	     addr < end; addr += BIT64(NVGPU_POSIX_IO_PAGE_SHIFT)) {
+		slot = posix_io_page_slot(p, (u32)addr, false);
+		if (slot != NULL) {
+			*slot = NULL;
+		}
+	}
+}
+
+static void posix_io_free_pages(struct nvgpu_os_posix *p)
+{
+	u32 i;
+
+	for (i = 0U; i < NVGPU_POSIX_IO_DIRS; i++) {
+		free(p->reg_space_pages[i]);
+		p->reg_space_pages[i] = NULL;
+	}
+}
+
 void nvgpu_posix_io_init_reg_space(struct gk20a *g)
 {
 	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
 
+	posix_io_free_pages(p);
 	p->recording = false;
 	p->error_code = 0;
 	nvgpu_init_list_node(&p->reg_space_head);
@@ -239,13 +492,14 @@ int nvgpu_posix_io_register_reg_space(struct gk20a *g,
 	 * over the default reg lists.
 	 */
 	nvgpu_list_add(&reg_space->link, &p->reg_space_head);
+	posix_io_invalidate_pages(p, reg_space);
 	return 0;
 }
 
 void nvgpu_posix_io_unregister_reg_space(struct gk20a *g,
 		struct nvgpu_posix_io_reg_space *reg_space)
 {
-	(void)g;
+	posix_io_invalidate_pages(nvgpu_os_posix_from_gk20a(g), reg_space);
 	nvgpu_list_del(&reg_space->link);
 }
 
@@ -288,23 +542,54 @@ void nvgpu_posix_io_delete_reg_space(struct gk20a *g, u32 base)
 	nvgpu_kfree(g, reg_space);
 }
 
+static inline bool posix_io_space_contains(
+		struct nvgpu_posix_io_reg_space *reg_space, u32 addr)
+{
+	return (addr >= reg_space->base) &&
+		((addr - reg_space->base) < reg_space->size);
+}
+
 /*
  * Lookup a register space from a given address. If no register space is found
  * this is a bug similar to a translation fault.
+ *
+ * The page of the address caches the space found by the list walk. This is
+ * only done if no space ahead of it in the list overlaps the page, so that a
+ * cached space containing an address is always the one the walk would find.
  */
 struct nvgpu_posix_io_reg_space *nvgpu_posix_io_get_reg_space(struct gk20a *g,
 		u32 addr)
 {
 	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
 	struct nvgpu_posix_io_reg_space *reg_space;
+	struct nvgpu_posix_io_reg_space **slot;
+	u64 page = addr & ~(BIT64(NVGPU_POSIX_IO_PAGE_SHIFT) - 1ULL);
+	bool shadowed = false;
+
+	slot = posix_io_page_slot(p, addr, false);
+	if (slot != NULL && *slot != NULL &&
+	    posix_io_space_contains(*slot, addr)) {
+		return *slot;
+	}
 
+	p->io_stats.reg_space_walks++;
 	nvgpu_list_for_each_entry(reg_space, &p->reg_space_head,
 			nvgpu_posix_io_reg_space, link) {
-		u32 offset = addr - reg_space->base;
-
-		if ((addr >= reg_space->base) && (offset < reg_space->size)) {
+		if (posix_io_space_contains(reg_space, addr)) {
+			if (!shadowed) {
+				slot = posix_io_page_slot(p, addr, true);
+				if (slot != NULL) {
+					*slot = reg_space;
+				}
+			}
 			return reg_space;
 		}
+
+		if ((u64)reg_space->base <
+				page + BIT64(NVGPU_POSIX_IO_PAGE_SHIFT) &&
+		    page < (u64)reg_space->base + reg_space->size) {
+			shadowed = true;
+		}
 	}
 	p->error_code = -EFAULT;
 	nvgpu_err(g, "ABORT for address 0x%x", addr);
@@ -418,3 +703,278 @@ bool nvgpu_posix_io_check_sequence(struct gk20a *g,
 		return true;
 	}
 }
+
+static void posix_io_trace_free(struct nvgpu_posix_io_trace *t)
+{
+	u32 i;
+
+	for (i = 0U; i < t->ncallsites; i++) {
+		free(t->callsites[i]);
+	}
+	free(t->callsites);
+	free(t->entries);
+	free(t);
+}
+
+static struct nvgpu_posix_io_trace *posix_io_trace_alloc(u64 entries,
+		u32 callsites)
+{
+	struct nvgpu_posix_io_trace *t = calloc(1, sizeof(*t));
+
+	if (t == NULL) {
+		return NULL;
+	}
+
+	t->capacity = max(entries, (u64)POSIX_IO_TRACE_MIN_ENTRIES);
+	t->callsites_capacity = max(callsites, 16U);
+	t->entries = malloc(sizeof(*t->entries) * t->capacity);
+	t->callsites = calloc(t->callsites_capacity, sizeof(*t->callsites));
+	if (t->entries == NULL || t->callsites == NULL) {
+		posix_io_trace_free(t);
+		return NULL;
+	}
+
+	return t;
+}
+
+static void posix_io_trace_replace(struct nvgpu_os_posix *p,
+		struct nvgpu_posix_io_trace *t)
+{
+	if (p->io_trace != NULL) {
+		posix_io_trace_free(p->io_trace);
+	}
+	p->io_trace = t;
+}
+
+int nvgpu_posix_io_trace_start(struct gk20a *g)
+{
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_trace *t;
+
+	t = posix_io_trace_alloc(POSIX_IO_TRACE_MIN_ENTRIES, 0U);
+	if (t == NULL) {
+		return -ENOMEM;
+	}
+
+	/* Accesses without a resolvable caller use callsite 0. */
+	(void) posix_io_trace_add_callsite(t, "<unknown>");
+	if (t->ncallsites != 1U) {
+		posix_io_trace_free(t);
+		return -ENOMEM;
+	}
+
+	posix_io_trace_replace(p, t);
+	t->recording = true;
+
+	return 0;
+}
+
+void nvgpu_posix_io_trace_stop(struct gk20a *g)
+{
+	struct nvgpu_posix_io_trace *t = nvgpu_os_posix_from_gk20a(g)->io_trace;
+
+	if (t != NULL) {
+		t->recording = false;
+	}
+}
+
+const struct nvgpu_posix_io_trace_entry *nvgpu_posix_io_trace_entries(
+		struct gk20a *g, u64 *count)
+{
+	struct nvgpu_posix_io_trace *t = nvgpu_os_posix_from_gk20a(g)->io_trace;
+
+	*count = (t != NULL) ? t->count : 0ULL;
+
+	return (t != NULL) ? t->entries : NULL;
+}
+
+const char *nvgpu_posix_io_trace_callsite(struct gk20a *g, u32 callsite)
+{
+	struct nvgpu_posix_io_trace *t = nvgpu_os_posix_from_gk20a(g)->io_trace;
+
+	if (t == NULL || callsite >= t->ncallsites) {
+		return NULL;
+	}
+
+	return t->callsites[callsite];
+}
+
+int nvgpu_posix_io_trace_save(struct gk20a *g, const char *path)
+{
+	struct nvgpu_posix_io_trace *t = nvgpu_os_posix_from_gk20a(g)->io_trace;
+	struct nvgpu_posix_io_trace_header hdr;
+	FILE *f;
+	bool ok;
+	u32 i;
+
+	if (t == NULL) {
+		return -EINVAL;
+	}
+
+	f = fopen(path, "wb");
+	if (f == NULL) {
+		return -EIO;
+	}
+
+	hdr.magic = NVGPU_POSIX_IO_TRACE_MAGIC;
+	hdr.version = NVGPU_POSIX_IO_TRACE_VERSION;
+	hdr.entry_size = (u32)sizeof(*t->entries);
+	hdr.callsites = t->ncallsites;
+	hdr.entries = t->count;
+
+	ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1U;
+	if (ok && t->count != 0ULL) {
+		ok = fwrite(t->entries, sizeof(*t->entries), t->count, f) ==
+				t->count;
+	}
+	for (i = 0U; ok && i < t->ncallsites; i++) {
+		ok = fwrite(t->callsites[i], strlen(t->callsites[i]) + 1U, 1,
+				f) == 1U;
+	}
+
+	if (fclose(f) != 0) {
+		ok = false;
+	}
+
+	return ok ? 0 : -EIO;
+}
+
+static int posix_io_trace_read_name(FILE *f, char *buf, size_t size)
+{
+	size_t i;
+	int c;
+
+	for (i = 0; i < size; i++) {
+		c = fgetc(f);
+		if (c == EOF) {
+			return -EINVAL;
+		}
+		buf[i] = (char)c;
+		if (c == '\0') {
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+int nvgpu_posix_io_trace_load(struct gk20a *g, const char *path)
+{
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+	struct nvgpu_posix_io_trace_header hdr;
+	struct nvgpu_posix_io_trace *t = NULL;
+	char name[256];
+	FILE *f;
+	int err = -EINVAL;
+	u64 i;
+
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		return -ENOENT;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1U ||
+	    hdr.magic != NVGPU_POSIX_IO_TRACE_MAGIC ||
+	    hdr.version != NVGPU_POSIX_IO_TRACE_VERSION ||
+	    hdr.entry_size != (u32)sizeof(struct nvgpu_posix_io_trace_entry) ||
+	    hdr.callsites == 0U) {
+		goto out;
+	}
+
+	t = posix_io_trace_alloc(hdr.entries, hdr.callsites);
+	if (t == NULL) {
+		err = -ENOMEM;
+		goto out;
+	}
+
+	if (hdr.entries != 0ULL &&
+	    fread(t->entries, sizeof(*t->entries), hdr.entries, f) !=
+			hdr.entries) {
+		goto out;
+	}
+	t->count = hdr.entries;
+
+	for (i = 0ULL; i < hdr.callsites; i++) {
+		if (posix_io_trace_read_name(f, name, sizeof(name)) != 0) {
+			goto out;
+		}
+		t->callsites[i] = strdup(name);
+		if (t->callsites[i] == NULL) {
+			err = -ENOMEM;
+			goto out;
+		}
+		t->ncallsites++;
+	}
+
+	for (i = 0ULL; i < t->count; i++) {
+		if (t->entries[i].callsite >= t->ncallsites) {
+			goto out;
+		}
+	}
+
+	posix_io_trace_replace(p, t);
+	t = NULL;
+	err = 0;
+out:
+	if (t != NULL) {
+		posix_io_trace_free(t);
+	}
+	(void) fclose(f);
+	return err;
+}
+
+int nvgpu_posix_io_trace_replay(struct gk20a *g,
+		struct nvgpu_posix_io_trace_replay_stats *stats)
+{
+	struct nvgpu_posix_io_trace *t = nvgpu_os_posix_from_gk20a(g)->io_trace;
+	struct nvgpu_posix_io_trace_entry *e;
+	u64 i;
+	u32 v;
+
+	(void) memset(stats, 0, sizeof(*stats));
+
+	if (t == NULL) {
+		return -EINVAL;
+	}
+	t->recording = false;
+
+	for (i = 0ULL; i < t->count; i++) {
+		e = &t->entries[i];
+
+		if (e->dir == NVGPU_POSIX_IO_TRACE_WRITE) {
+			switch (e->aperture) {
+			case NVGPU_POSIX_REG_BAR0:
+				nvgpu_posix_writel(g, e->addr, e->value);
+				break;
+			case NVGPU_POSIX_REG_BAR1:
+				nvgpu_posix_bar1_writel(g, e->addr, e->value);
+				break;
+			default:
+				nvgpu_usermode_writel(g, e->addr, e->value);
+				break;
+			}
+			stats->writes++;
+			continue;
+		}
+
+		if (e->aperture == NVGPU_POSIX_REG_BAR1) {
+			v = nvgpu_posix_bar1_readl(g, e->addr);
+		} else {
+			v = nvgpu_posix_readl(g, e->addr);
+		}
+		stats->reads++;
+		if (v != e->value) {
+			stats->read_mismatches++;
+		}
+	}
+
+	return 0;
+}
+
+void nvgpu_posix_io_fini(struct gk20a *g)
+{
+	struct nvgpu_os_posix *p = nvgpu_os_posix_from_gk20a(g);
+
+	posix_io_free_pages(p);
+	posix_io_trace_replace(p, NULL);
+}
@@ -129,6 +129,7 @@
  *   - @ref SWUTS-acr
  *   - @ref SWUTS-ce
  *   - @ref SWUTS-cg
+ *   - @ref SWUTS-clk-arb
  *   - @ref SWUTS-init_test
  *   - @ref SWUTS-power_mgmt
  *   - @ref SWUTS-qnx-fuse
@@ -143,13 +144,16 @@
  *   - @ref SWUTS-gr-init-hal-gv11b
  *   - @ref SWUTS-gr-falcon
  *   - @ref SWUTS-gr-falcon-gm20b
+ *   - @ref SWUTS-gr-fecs-trace
  *   - @ref SWUTS-gr-fs-state
  *   - @ref SWUTS-gr-global-ctx
  *   - @ref SWUTS-gr-ctx
  *   - @ref SWUTS-gr-obj-ctx
  *   - @ref SWUTS-gr-config
+ *   - @ref SWUTS-gr-zbc
  *   - @ref SWUTS-ecc
  *   - @ref SWUTS-pmu
+ *   - @ref SWUTS-pmu-rpc-pool
  *   - @ref SWUTS-io
  *
  */
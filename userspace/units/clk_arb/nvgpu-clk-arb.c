@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <unit/io.h>
+#include <unit/unit.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/clk_arb.h>
+#include <nvgpu/pmu/perf.h>
+
+#include "nvgpu-clk-arb.h"
+
+/* F-points reported by the stub source: base, base + 100, ... MHz */
+#define TEST_F_POINTS		10U
+#define TEST_F_STEP_MHZ		100U
+
+static u16 f_base_mhz;
+/* Number of F-points reported, TEST_F_POINTS unless set */
+static u32 f_num_points;
+/* Moves the last F-point to this frequency if set */
+static u16 f_top_mhz;
+static u32 f_point_queries;
+static u32 slave_lookups;
+static u32 curve_refreshes;
+static int curve_refresh_err;
+
+static int stub_refresh_vf_points(struct gk20a *g)
+{
+	curve_refreshes++;
+	return curve_refresh_err;
+}
+
+static int stub_get_f_points(struct gk20a *g, u32 *num_points,
+		u16 *freqs_in_mhz)
+{
+	u32 n = (f_num_points != 0U) ? f_num_points : TEST_F_POINTS;
+	u32 i;
+
+	f_point_queries++;
+	for (i = 0U; i < n; i++) {
+		freqs_in_mhz[i] = (u16)(f_base_mhz + i * TEST_F_STEP_MHZ);
+	}
+	if (f_top_mhz != 0U) {
+		freqs_in_mhz[n - 1U] = f_top_mhz;
+	}
+	*num_points = n;
+
+	return 0;
+}
+
+static int stub_get_slave_clks(struct gk20a *g,
+		struct nvgpu_clk_vf_point *point)
+{
+	slave_lookups++;
+	point->sys_mhz = point->gpc_mhz / 2U;
+	point->xbar_mhz = point->gpc_mhz / 3U;
+	point->nvd_mhz = point->gpc_mhz / 4U;
+	point->host_mhz = point->gpc_mhz / 5U;
+
+	return 0;
+}
+
+static const struct nvgpu_clk_arb_vf_source stub_source = {
+	.refresh_vf_points = stub_refresh_vf_points,
+	.get_f_points = stub_get_f_points,
+	.get_slave_clks = stub_get_slave_clks,
+};
+
+/*
+ * Check that the table holds the F-points in [min, max] with the slave
+ * clocks of the stub and P0 support set per the P0 limits.
+ */
+static bool check_vf_table(struct unit_module *m,
+		struct nvgpu_clk_vf_table *table,
+		const struct nvgpu_clk_arb_vf_limits *limits,
+		u16 min_mhz, u16 max_mhz)
+{
+	struct nvgpu_clk_vf_point *point;
+	u32 expected = ((max_mhz - min_mhz) / TEST_F_STEP_MHZ) + 1U;
+	bool p0;
+	u32 i;
+	u16 f;
+
+	if (table->gpc2clk_num_points != expected) {
+		unit_err(m, "%u points, expected %u\n",
+			table->gpc2clk_num_points, expected);
+		return false;
+	}
+
+	for (i = 0U; i < expected; i++) {
+		point = &table->gpc2clk_points[i];
+		f = (u16)(min_mhz + i * TEST_F_STEP_MHZ);
+		p0 = (f >= limits->p0_min) && (f <= limits->p0_max);
+
+		if ((point->gpc_mhz != f) || (point->sys_mhz != f / 2U) ||
+		    (point->xbar_mhz != f / 3U) ||
+		    (point->nvd_mhz != f / 4U) ||
+		    (point->host_mhz != f / 5U) ||
+		    (point->clk_vf_point_pstates !=
+			(p0 ? BIT16(CTRL_PERF_PSTATE_P0) : 0U))) {
+			unit_err(m, "bad point %u: %u MHz\n", i, point->gpc_mhz);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Build the table unless the cache says the last build is still current. */
+static int update_vf_table(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_limits *limits,
+		struct nvgpu_clk_vf_table *table)
+{
+	if (nvgpu_clk_arb_vf_cache_is_current(cache, limits)) {
+		return 0;
+	}
+
+	(void) memset(table->gpc2clk_points, 0,
+		MAX_F_POINTS * sizeof(struct nvgpu_clk_vf_point));
+	return nvgpu_clk_arb_vf_cache_build(g, cache, &stub_source, limits,
+			table);
+}
+
+/* Same sequence as the VF table update callback of the arbiter. */
+static int run_vf_table_cb(struct gk20a *g,
+		struct nvgpu_clk_arb_vf_cache *cache,
+		const struct nvgpu_clk_arb_vf_limits *limits,
+		struct nvgpu_clk_vf_table *table)
+{
+	int err;
+
+	err = nvgpu_clk_arb_vf_cache_refresh(g, cache, &stub_source);
+	if (err != 0) {
+		return err;
+	}
+
+	return update_vf_table(g, cache, limits, table);
+}
+
+static void reset_stub_source(void)
+{
+	f_base_mhz = 500U;
+	f_num_points = 0U;
+	f_top_mhz = 0U;
+	f_point_queries = 0U;
+	slave_lookups = 0U;
+	curve_refreshes = 0U;
+	curve_refresh_err = 0;
+}
+
+int test_clk_arb_vf_cache(struct unit_module *m, struct gk20a *g,
+		void *args)
+{
+	struct nvgpu_clk_arb_vf_cache cache;
+	struct nvgpu_clk_arb_vf_limits limits;
+	struct nvgpu_clk_vf_table table;
+	int ret = UNIT_FAIL;
+
+	(void) memset(&table, 0, sizeof(table));
+	table.gpc2clk_points = nvgpu_kcalloc(g, MAX_F_POINTS,
+			sizeof(struct nvgpu_clk_vf_point));
+	if (table.gpc2clk_points == NULL) {
+		unit_return_fail(m, "table alloc failed\n");
+	}
+	if (nvgpu_clk_arb_vf_cache_init(g, &cache) != 0) {
+		nvgpu_kfree(g, table.gpc2clk_points);
+		unit_return_fail(m, "cache init failed\n");
+	}
+
+	reset_stub_source();
+	limits.gpc2clk_min = 700U;
+	limits.gpc2clk_max = 1200U;
+	limits.p0_min = 500U;
+	limits.p0_max = 1400U;
+
+	/* First build resolves the points in range only. */
+	if ((update_vf_table(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 700U, 1200U) ||
+	    (f_point_queries != 1U) || (slave_lookups != 6U)) {
+		unit_err(m, "initial build failed\n");
+		goto out;
+	}
+
+	/* Nothing changed: the last table is kept. */
+	if ((update_vf_table(g, &cache, &limits, &table) != 0) ||
+	    (cache.stats.skipped != 1U) || (cache.stats.rebuilds != 1U) ||
+	    (slave_lookups != 6U)) {
+		unit_err(m, "unchanged update rebuilt the table\n");
+		goto out;
+	}
+
+	/* Thermal cap: a narrower range needs no lookups. */
+	limits.gpc2clk_max = 1000U;
+	if ((update_vf_table(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 700U, 1000U) ||
+	    (slave_lookups != 6U)) {
+		unit_err(m, "capped update failed\n");
+		goto out;
+	}
+
+	/* Wider range: only the new points are resolved. */
+	limits.gpc2clk_min = 500U;
+	limits.gpc2clk_max = 1400U;
+	if ((update_vf_table(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 500U, 1400U) ||
+	    (slave_lookups != 10U)) {
+		unit_err(m, "widened update failed\n");
+		goto out;
+	}
+
+	/* P0 range change: flags are updated without lookups. */
+	limits.p0_max = 900U;
+	if ((update_vf_table(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 500U, 1400U) ||
+	    (slave_lookups != 10U) || (f_point_queries != 1U)) {
+		unit_err(m, "P0 update failed\n");
+		goto out;
+	}
+
+	/*
+	 * A VF curve refresh moves the F-points while the limits stay the
+	 * same. Without invalidation the old table is still reported current.
+	 */
+	f_base_mhz = 400U;
+	nvgpu_clk_arb_vf_cache_invalidate(&cache);
+	if (nvgpu_clk_arb_vf_cache_is_current(&cache, &limits)) {
+		unit_err(m, "invalidated cache reported current\n");
+		goto out;
+	}
+
+	/* The refreshed F-points are queried and resolved again. */
+	if ((update_vf_table(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 500U, 1300U) ||
+	    (f_point_queries != 2U) || (slave_lookups != 19U)) {
+		unit_err(m, "update after invalidate failed\n");
+		goto out;
+	}
+
+	unit_info(m, "%llu rebuilds, %llu skipped, %llu points resolved\n",
+		cache.stats.rebuilds, cache.stats.skipped,
+		cache.stats.points_resolved);
+	if ((cache.stats.rebuilds != 5U) || (cache.stats.skipped != 1U) ||
+	    (cache.stats.points_resolved != slave_lookups)) {
+		unit_err(m, "bad vf stats\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_clk_arb_vf_cache_deinit(g, &cache);
+	nvgpu_kfree(g, table.gpc2clk_points);
+	return ret;
+}
+
+int test_clk_arb_vf_table_cb(struct unit_module *m, struct gk20a *g,
+		void *args)
+{
+	struct nvgpu_clk_arb_vf_cache cache;
+	struct nvgpu_clk_arb_vf_limits limits;
+	struct nvgpu_clk_vf_table table;
+	struct nvgpu_clk_vf_point *top;
+	int ret = UNIT_FAIL;
+
+	(void) memset(&table, 0, sizeof(table));
+	table.gpc2clk_points = nvgpu_kcalloc(g, MAX_F_POINTS,
+			sizeof(struct nvgpu_clk_vf_point));
+	if (table.gpc2clk_points == NULL) {
+		unit_return_fail(m, "table alloc failed\n");
+	}
+	if (nvgpu_clk_arb_vf_cache_init(g, &cache) != 0) {
+		nvgpu_kfree(g, table.gpc2clk_points);
+		unit_return_fail(m, "cache init failed\n");
+	}
+
+	reset_stub_source();
+	limits.gpc2clk_min = 500U;
+	limits.gpc2clk_max = 1400U;
+	limits.p0_min = 500U;
+	limits.p0_max = 1400U;
+
+	/* An empty cache is filled by the update, not the refresh. */
+	if ((run_vf_table_cb(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 500U, 1400U) ||
+	    (curve_refreshes != 1U) || (f_point_queries != 1U) ||
+	    (slave_lookups != 10U)) {
+		unit_err(m, "initial update failed\n");
+		goto out;
+	}
+
+	/* The curve did not move: the last table is kept. */
+	if ((run_vf_table_cb(g, &cache, &limits, &table) != 0) ||
+	    (curve_refreshes != 2U) || (f_point_queries != 2U) ||
+	    (slave_lookups != 10U) || (cache.stats.skipped != 1U) ||
+	    (cache.stats.rebuilds != 1U)) {
+		unit_err(m, "unchanged curve rebuilt the table\n");
+		goto out;
+	}
+
+	/* Only the moved top F-point is looked up again. */
+	f_top_mhz = 1350U;
+	if ((run_vf_table_cb(g, &cache, &limits, &table) != 0) ||
+	    (table.gpc2clk_num_points != TEST_F_POINTS) ||
+	    (slave_lookups != 11U) || (cache.stats.rebuilds != 2U)) {
+		unit_err(m, "moved F-point not resolved\n");
+		goto out;
+	}
+	top = &table.gpc2clk_points[TEST_F_POINTS - 1U];
+	if ((top->gpc_mhz != 1350U) || (top->sys_mhz != 1350U / 2U) ||
+	    (top->host_mhz != 1350U / 5U)) {
+		unit_err(m, "bad moved point: %u MHz\n", top->gpc_mhz);
+		goto out;
+	}
+
+	/* The whole curve moves: every point in range is resolved again. */
+	f_top_mhz = 0U;
+	f_base_mhz = 400U;
+	if ((run_vf_table_cb(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 500U, 1300U) ||
+	    (f_point_queries != 4U) || (slave_lookups != 20U)) {
+		unit_err(m, "moved curve not resolved\n");
+		goto out;
+	}
+
+	/* A different number of F-points drops the whole cache. */
+	f_num_points = TEST_F_POINTS - 1U;
+	if ((run_vf_table_cb(g, &cache, &limits, &table) != 0) ||
+	    !check_vf_table(m, &table, &limits, 500U, 1200U) ||
+	    (f_point_queries != 6U) || (slave_lookups != 28U)) {
+		unit_err(m, "resized curve not queried again\n");
+		goto out;
+	}
+
+	/* A failed refresh leaves the cache and the table alone. */
+	curve_refresh_err = -EINVAL;
+	if ((run_vf_table_cb(g, &cache, &limits, &table) == 0) ||
+	    (f_point_queries != 6U) ||
+	    !nvgpu_clk_arb_vf_cache_is_current(&cache, &limits)) {
+		unit_err(m, "failed refresh changed the cache\n");
+		goto out;
+	}
+
+	if (cache.stats.points_resolved != slave_lookups) {
+		unit_err(m, "bad vf stats\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_clk_arb_vf_cache_deinit(g, &cache);
+	nvgpu_kfree(g, table.gpc2clk_points);
+	return ret;
+}
+
+struct unit_module_test clk_arb_tests[] = {
+	UNIT_TEST(clk_arb_vf_cache, test_clk_arb_vf_cache, NULL, 0),
+	UNIT_TEST(clk_arb_vf_table_cb, test_clk_arb_vf_table_cb, NULL, 0),
+};
+
+UNIT_MODULE(clk_arb, clk_arb_tests, UNIT_PRIO_NVGPU_TEST);
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @addtogroup SWUTS-clk-arb
+ * @{
+ *
+ * Software Unit Test Specification for clk-arb
+ */
+
+#ifndef UNIT_NVGPU_CLK_ARB_H
+#define UNIT_NVGPU_CLK_ARB_H
+
+struct gk20a;
+struct unit_module;
+
+/**
+ * Test specification for test_clk_arb_vf_cache
+ *
+ * Description: Test that the VF table cache of the clock arbiter only
+ * rebuilds when the limits change, looks up the slave clocks of each F-point
+ * once and picks up refreshed F-points after invalidation.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_clk_arb_vf_cache_init, nvgpu_clk_arb_vf_cache_deinit,
+ *          nvgpu_clk_arb_vf_cache_invalidate,
+ *          nvgpu_clk_arb_vf_cache_is_current, nvgpu_clk_arb_vf_cache_build
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * 1) Build a table for 700-1200 MHz from a stub source reporting 500-1400
+ *    MHz and check that only the 6 points in range were looked up.
+ * 2) Check that unchanged limits report the table as current.
+ * 3) Cap the maximum to 1000 MHz and check the table is rebuilt without
+ *    lookups.
+ * 4) Widen the range to 500-1400 MHz and check only the new points are
+ *    looked up.
+ * 5) Narrow the P0 range and check the P0 flags change without lookups.
+ * 6) Move the stub F-points to 400-1300 MHz, invalidate the cache and check
+ *    it is no longer current.
+ * 7) Rebuild and check the F-points were queried again and the table holds
+ *    the refreshed points.
+ * 8) Check the rebuild, skip and lookup counters.
+ *
+ * Output: Returns PASS if the tables and counters match, FAIL otherwise.
+ */
+int test_clk_arb_vf_cache(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for test_clk_arb_vf_table_cb
+ *
+ * Description: Test that the VF table update callback keeps the cached
+ * F-points across VF curve refreshes and only looks up the slave clocks of
+ * the F-points which moved.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_clk_arb_vf_cache_refresh,
+ *          nvgpu_clk_arb_vf_cache_is_current, nvgpu_clk_arb_vf_cache_build
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * 1) Run the callback sequence (curve refresh, then table update) on an
+ *    empty cache and check the 500-1400 MHz table is built with one
+ *    F-point query.
+ * 2) Run it again with an unchanged curve and check the table is kept
+ *    without lookups.
+ * 3) Move the top F-point to 1350 MHz and check the table is rebuilt with
+ *    a single lookup for the moved point.
+ * 4) Move the whole curve to 400-1300 MHz and check every point in range
+ *    is looked up again.
+ * 5) Drop one F-point from the curve and check the F-points are queried
+ *    again and the table holds the new points.
+ * 6) Make the curve refresh fail and check the callback fails without
+ *    touching the cache.
+ *
+ * Output: Returns PASS if the tables and counters match, FAIL otherwise.
+ */
+int test_clk_arb_vf_table_cb(struct unit_module *m, struct gk20a *g,
+		void *args);
+
+#endif /* UNIT_NVGPU_CLK_ARB_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -164,6 +164,116 @@ cleanup:
 	return ret;
 }
 
+int test_ecc_snapshot(struct unit_module *m, struct gk20a *g,
+		void *args)
+{
+	int ret = UNIT_FAIL;
+	struct nvgpu_ecc_stat *stats[3] = { NULL, NULL, NULL };
+	const char *names[3] = { "snap_a", "snap_b", "snap_c" };
+	u32 prev_counters[3], cur_counters[3], delta[3];
+	struct nvgpu_ecc_snapshot prev = { };
+	struct nvgpu_ecc_snapshot cur = { };
+	struct nvgpu_posix_fault_inj *kmem_fi =
+		nvgpu_kmem_get_fault_injection();
+	const char *name;
+	u32 i;
+
+	if (nvgpu_ecc_init_support(g) != 0) {
+		return UNIT_FAIL;
+	}
+
+	for (i = 0U; i < 3U; i++) {
+		if (nvgpu_ecc_counter_init(g, &stats[i], names[i]) != 0) {
+			unit_err(m, "counter init failed\n");
+			goto cleanup;
+		}
+	}
+
+	/*
+	 * Case #1:
+	 *  - Fail the allocation of the counter index.
+	 *  - "nvgpu_ecc_snapshot" should return -ENOMEM.
+	 */
+	nvgpu_posix_enable_fault_injection(kmem_fi, true, 0);
+	if (nvgpu_ecc_snapshot(g, &prev) != -ENOMEM) {
+		nvgpu_posix_enable_fault_injection(kmem_fi, false, 0);
+		unit_err(m, "index alloc failure not reported\n");
+		goto cleanup;
+	}
+	nvgpu_posix_enable_fault_injection(kmem_fi, false, 0);
+
+	/*
+	 * Case #2:
+	 *  - Snapshot without a buffer reports the number of counters.
+	 */
+	if ((nvgpu_ecc_snapshot(g, &prev) != -ENOSPC) || (prev.count != 3U)) {
+		unit_err(m, "counter count not reported\n");
+		goto cleanup;
+	}
+
+	/*
+	 * Case #3:
+	 *  - Snapshot all counters and read back their names.
+	 */
+	stats[1]->counter = 10U;
+	stats[2]->counter = U32_MAX;
+	prev.size = 3U;
+	prev.counters = prev_counters;
+	if (nvgpu_ecc_snapshot(g, &prev) != 0) {
+		unit_err(m, "snapshot failed\n");
+		goto cleanup;
+	}
+	for (i = 0U; i < 3U; i++) {
+		name = nvgpu_ecc_snapshot_stat_name(g, &prev, i);
+		if ((name == NULL) || (strcmp(name, names[i]) != 0) ||
+		    (prev.counters[i] != stats[i]->counter)) {
+			unit_err(m, "bad snapshot entry %u\n", i);
+			goto cleanup;
+		}
+	}
+	if (nvgpu_ecc_snapshot_stat_name(g, &prev, 3U) != NULL) {
+		unit_err(m, "name out of range\n");
+		goto cleanup;
+	}
+
+	/*
+	 * Case #4:
+	 *  - Count errors, snapshot again and compute the increments,
+	 *    including a counter which wrapped.
+	 */
+	stats[1]->counter += 5U;
+	stats[2]->counter += 2U;
+	cur.size = 3U;
+	cur.counters = cur_counters;
+	if ((nvgpu_ecc_snapshot(g, &cur) != 0) || (cur.gen != prev.gen) ||
+	    (nvgpu_ecc_snapshot_delta(&prev, &cur, delta) != 0) ||
+	    (delta[0] != 0U) || (delta[1] != 5U) || (delta[2] != 2U)) {
+		unit_err(m, "bad snapshot delta\n");
+		goto cleanup;
+	}
+
+	/*
+	 * Case #5:
+	 *  - Remove a counter, the old snapshot no longer matches.
+	 */
+	nvgpu_ecc_counter_deinit(g, &stats[1]);
+	if ((nvgpu_ecc_snapshot_stat_name(g, &prev, 0U) != NULL) ||
+	    (nvgpu_ecc_snapshot(g, &cur) != 0) || (cur.count != 2U) ||
+	    (nvgpu_ecc_snapshot_delta(&prev, &cur, delta) != -EINVAL)) {
+		unit_err(m, "stale snapshot accepted\n");
+		goto cleanup;
+	}
+
+	ret = UNIT_SUCCESS;
+
+cleanup:
+	for (i = 0U; i < 3U; i++) {
+		nvgpu_ecc_counter_deinit(g, &stats[i]);
+	}
+
+	return ret;
+}
+
 int test_ecc_free(struct unit_module *m, struct gk20a *g,
 		void *args)
 {
@@ -247,6 +357,7 @@ struct unit_module_test ecc_tests[] = {
 	UNIT_TEST(ecc_init_support,	test_ecc_init_support,		NULL, 0),
 	UNIT_TEST(ecc_finalize_support,	test_ecc_finalize_support,	NULL, 0),
 	UNIT_TEST(ecc_counter_init,	test_ecc_counter_init,		NULL, 0),
+	UNIT_TEST(ecc_snapshot,		test_ecc_snapshot,		NULL, 0),
 	UNIT_TEST(ecc_free,		test_ecc_free,			NULL, 0),
 };
 
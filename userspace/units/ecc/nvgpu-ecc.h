@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -123,6 +123,48 @@ int test_ecc_finalize_support(struct unit_module *m,
 int test_ecc_counter_init(struct unit_module *m,
 			struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_ecc_snapshot
+ *
+ * Description: Verify the ecc counter snapshot APIs.
+ *
+ * Test Type: Feature Based
+ *
+ * Targets: nvgpu_ecc_snapshot, nvgpu_ecc_snapshot_delta,
+ *          nvgpu_ecc_snapshot_stat_name
+ *
+ * Input: nvgpu_ecc_init_support
+ *
+ * Steps:
+ * - Invokes "nvgpu_ecc_init_support" and adds three counters.
+ * - Test case #1
+ *   - Inject memory allocation fault.
+ *   - "nvgpu_ecc_snapshot" should return -ENOMEM.
+ * - Test case #2
+ *   - Invokes "nvgpu_ecc_snapshot" with no buffer.
+ *   - It should return -ENOSPC and report three counters.
+ * - Test case #3
+ *   - Set counter values and take a snapshot.
+ *   - Verify the values, and the names returned by
+ *     "nvgpu_ecc_snapshot_stat_name" in order of addition.
+ * - Test case #4
+ *   - Increment counters, one of them past U32_MAX, and take a second
+ *     snapshot.
+ *   - "nvgpu_ecc_snapshot_delta" should return the increments.
+ * - Test case #5
+ *   - Remove a counter.
+ *   - The first snapshot's names are no longer returned and its delta with
+ *     a new snapshot fails with -EINVAL.
+ *
+ * Output:
+ * - UNIT_FAIL under the following conditions:
+ *   - "nvgpu_ecc_init_support" or "nvgpu_ecc_counter_init" failed.
+ *   - Any of the checks above failed.
+ * - UNIT_SUCCESS otherwise
+ */
+int test_ecc_snapshot(struct unit_module *m,
+			struct gk20a *g, void *args);
+
 /**
  * Test specification for: test_ecc_free
  *
@@ -28,6 +28,9 @@
 #include <nvgpu/posix/posix-fault-injection.h>
 
 #include <nvgpu/firmware.h>
+#include <nvgpu/falcon_seq.h>
+#include <nvgpu/engine_queue.h>
+#include <nvgpu/engine_mem_queue.h>
 #include <nvgpu/gk20a.h>
 #include <nvgpu/hal_init.h>
 #include <nvgpu/posix/io.h>
@@ -1347,6 +1350,265 @@ int test_falcon_irq(struct unit_module *m, struct gk20a *g, void *__args)
 	return UNIT_SUCCESS;
 }
 
+#define FALCON_SEQ_TEST_IDS		40U
+#define FALCON_SEQ_TEST_THREADS		4U
+#define FALCON_SEQ_TEST_LOOPS		10000U
+
+struct falcon_seq_test_ctx {
+	struct gk20a *g;
+	struct nvgpu_falcon_seq_alloc *seqs;
+	nvgpu_atomic_t *owner;
+	bool failed;
+	u8 tag;
+};
+
+static void *falcon_seq_test_thread(void *arg)
+{
+	struct falcon_seq_test_ctx *ctx = arg;
+	u32 i, id;
+
+	for (i = 0U; i < FALCON_SEQ_TEST_LOOPS; i++) {
+		if (nvgpu_falcon_seq_acquire(ctx->seqs, ctx->tag, &id) != 0) {
+			continue;
+		}
+		if ((id >= FALCON_SEQ_TEST_IDS) ||
+		    (nvgpu_atomic_cmpxchg(&ctx->owner[id], 0, 1) != 0)) {
+			ctx->failed = true;
+			break;
+		}
+		nvgpu_atomic_set(&ctx->owner[id], 0);
+		nvgpu_falcon_seq_release(ctx->g, ctx->seqs, id, true);
+	}
+
+	return NULL;
+}
+
+int test_falcon_seq_alloc(struct unit_module *m, struct gk20a *g,
+			  void *__args)
+{
+	struct nvgpu_falcon_seq_alloc *seqs;
+	struct falcon_seq_test_ctx ctx[FALCON_SEQ_TEST_THREADS];
+	pthread_t threads[FALCON_SEQ_TEST_THREADS];
+	nvgpu_atomic_t owner[FALCON_SEQ_TEST_IDS];
+	struct nvgpu_swhist_data lat;
+	bool seen[FALCON_SEQ_TEST_IDS] = { false };
+	int ret = UNIT_FAIL;
+	u32 i, id;
+
+	seqs = nvgpu_kzalloc(g, sizeof(*seqs));
+	if (seqs == NULL) {
+		unit_return_fail(m, "seq alloc failed\n");
+	}
+
+	nvgpu_falcon_seq_alloc_init(seqs, FALCON_SEQ_TEST_IDS);
+
+	/* every ID is handed out exactly once */
+	for (i = 0U; i < FALCON_SEQ_TEST_IDS; i++) {
+		if (nvgpu_falcon_seq_acquire(seqs, 1U, &id) != 0) {
+			unit_err(m, "acquire %u failed\n", i);
+			goto out;
+		}
+		if ((id >= FALCON_SEQ_TEST_IDS) || seen[id]) {
+			unit_err(m, "bad or duplicate id %u\n", id);
+			goto out;
+		}
+		seen[id] = true;
+	}
+	if (nvgpu_falcon_seq_acquire(seqs, 1U, &id) != -EAGAIN) {
+		unit_err(m, "acquire past num_ids succeeded\n");
+		goto out;
+	}
+
+	/* released IDs are reused, latency only counts completed ones */
+	nvgpu_falcon_seq_release(g, seqs, 7U, true);
+	nvgpu_falcon_seq_release(g, seqs, 33U, false);
+	for (i = 0U; i < 2U; i++) {
+		if ((nvgpu_falcon_seq_acquire(seqs, 2U, &id) != 0) ||
+		    ((id != 7U) && (id != 33U))) {
+			unit_err(m, "released id not reused\n");
+			goto out;
+		}
+	}
+	nvgpu_falcon_seq_get_latency(seqs, 1U, &lat);
+	if ((lat.count != 1U) || (lat.max_ns > lat.sum_ns)) {
+		unit_err(m, "bad latency stats\n");
+		goto out;
+	}
+	nvgpu_falcon_seq_get_latency(seqs, 2U, &lat);
+	if (lat.count != 0U) {
+		unit_err(m, "latency accounted to wrong tag\n");
+		goto out;
+	}
+
+	/* tags past the histogram array share the last histogram */
+	nvgpu_falcon_seq_release(g, seqs, 7U, false);
+	if ((nvgpu_falcon_seq_acquire(seqs, 0xF0U, &id) != 0) ||
+	    (id != 7U)) {
+		unit_err(m, "released id not reused\n");
+		goto out;
+	}
+	nvgpu_falcon_seq_release(g, seqs, id, true);
+	nvgpu_falcon_seq_get_latency(seqs,
+		(u8)(NVGPU_FALCON_SEQ_MAX_TAGS - 1U), &lat);
+	if (lat.count != 1U) {
+		unit_err(m, "large tag not folded into last histogram\n");
+		goto out;
+	}
+
+	/* concurrent acquire/release never hands out an ID twice */
+	nvgpu_falcon_seq_alloc_init(seqs, FALCON_SEQ_TEST_IDS);
+	for (i = 0U; i < FALCON_SEQ_TEST_IDS; i++) {
+		nvgpu_atomic_set(&owner[i], 0);
+	}
+	for (i = 0U; i < FALCON_SEQ_TEST_THREADS; i++) {
+		ctx[i].g = g;
+		ctx[i].seqs = seqs;
+		ctx[i].owner = owner;
+		ctx[i].failed = false;
+		ctx[i].tag = (u8)i;
+		if (pthread_create(&threads[i], NULL,
+				falcon_seq_test_thread, &ctx[i]) != 0) {
+			unit_err(m, "thread create failed\n");
+			goto out;
+		}
+	}
+	ret = UNIT_SUCCESS;
+	for (i = 0U; i < FALCON_SEQ_TEST_THREADS; i++) {
+		(void) pthread_join(threads[i], NULL);
+		nvgpu_falcon_seq_get_latency(seqs, (u8)i, &lat);
+		if (ctx[i].failed || (lat.count == 0U)) {
+			unit_err(m, "thread %u failed\n", i);
+			ret = UNIT_FAIL;
+		}
+	}
+
+	/* everything was released, all IDs are available again */
+	for (i = 0U; i < FALCON_SEQ_TEST_IDS; i++) {
+		if (nvgpu_falcon_seq_acquire(seqs, 0U, &id) != 0) {
+			unit_err(m, "id leaked\n");
+			ret = UNIT_FAIL;
+			break;
+		}
+	}
+
+out:
+	nvgpu_kfree(g, seqs);
+	return ret;
+}
+
+#ifdef CONFIG_NVGPU_ENGINE_QUEUE
+#define FALCON_QUEUE_TEST_OFFSET	0x1000U
+#define FALCON_QUEUE_TEST_SIZE		0x100U
+
+static u32 falcon_queue_head;
+static u32 falcon_queue_tail;
+static u32 falcon_queue_head_sets;
+
+static int falcon_queue_test_head(struct gk20a *g, u32 queue_id,
+				  u32 queue_index, u32 *head, bool set)
+{
+	if (set) {
+		falcon_queue_head = *head;
+		falcon_queue_head_sets++;
+	} else {
+		*head = falcon_queue_head;
+	}
+
+	return 0;
+}
+
+static int falcon_queue_test_tail(struct gk20a *g, u32 queue_id,
+				  u32 queue_index, u32 *tail, bool set)
+{
+	if (set) {
+		falcon_queue_tail = *tail;
+	} else {
+		*tail = falcon_queue_tail;
+	}
+
+	return 0;
+}
+
+int test_falcon_queue_push_batch(struct unit_module *m, struct gk20a *g,
+				 void *__args)
+{
+	struct nvgpu_engine_mem_queue_params params = {0};
+	struct nvgpu_engine_mem_queue *queue = NULL;
+	u8 cmd0[8], cmd1[10], cmd2[16], big[0x80];
+	void *data[] = { cmd0, cmd1, cmd2 };
+	const u32 size[] = { sizeof(cmd0), sizeof(cmd1), sizeof(cmd2) };
+	void *big_data[] = { big, big };
+	const u32 big_size[] = { sizeof(big), sizeof(big) };
+	u8 *dmem;
+	u32 pos, i;
+	int ret = UNIT_FAIL;
+
+	if (pmu_flcn == NULL || !pmu_flcn->is_falcon_supported) {
+		unit_return_fail(m, "test environment not initialized.");
+	}
+
+	falcon_queue_head = FALCON_QUEUE_TEST_OFFSET;
+	falcon_queue_tail = FALCON_QUEUE_TEST_OFFSET;
+	falcon_queue_head_sets = 0U;
+
+	params.g = g;
+	params.flcn_id = FALCON_ID_PMU;
+	params.queue_type = QUEUE_TYPE_DMEM;
+	params.offset = FALCON_QUEUE_TEST_OFFSET;
+	params.position = FALCON_QUEUE_TEST_OFFSET;
+	params.size = FALCON_QUEUE_TEST_SIZE;
+	params.oflag = OFLAG_WRITE;
+	params.queue_head = falcon_queue_test_head;
+	params.queue_tail = falcon_queue_test_tail;
+	if (nvgpu_engine_mem_queue_init(&queue, params) != 0) {
+		unit_return_fail(m, "queue init failed\n");
+	}
+
+	(void) memset(cmd0, 0xa0, sizeof(cmd0));
+	(void) memset(cmd1, 0xa1, sizeof(cmd1));
+	(void) memset(cmd2, 0xa2, sizeof(cmd2));
+
+	/* one head update for the whole batch */
+	if ((nvgpu_engine_mem_queue_push_batch(pmu_flcn, queue, data, size,
+			3U) != 0) || (falcon_queue_head_sets != 1U) ||
+	    (falcon_queue_head != FALCON_QUEUE_TEST_OFFSET + 8U + 12U + 16U)) {
+		unit_err(m, "batch push failed, head 0x%x, %u head sets\n",
+			 falcon_queue_head, falcon_queue_head_sets);
+		goto out;
+	}
+
+	/* commands are back to back at their aligned offsets */
+	dmem = (u8 *)utf_falcons[FALCON_ID_PMU]->dmem;
+	pos = FALCON_QUEUE_TEST_OFFSET;
+	for (i = 0U; i < 3U; i++) {
+		if (memcmp(dmem + pos, data[i], size[i]) != 0) {
+			unit_err(m, "command %u not in dmem\n", i);
+			goto out;
+		}
+		pos += NVGPU_ALIGN((u32)size[i], QUEUE_ALIGNMENT);
+	}
+
+	if ((nvgpu_engine_mem_queue_push_batch(pmu_flcn, queue, data, size,
+			0U) != 0) || (falcon_queue_head_sets != 1U)) {
+		unit_err(m, "empty batch touched the head\n");
+		goto out;
+	}
+
+	/* nothing is written when the batch does not fit as a whole */
+	if ((nvgpu_engine_mem_queue_push_batch(pmu_flcn, queue, big_data,
+			big_size, 2U) != -EAGAIN) ||
+	    (falcon_queue_head_sets != 1U) || (falcon_queue_head != pos)) {
+		unit_err(m, "oversized batch not rejected\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_engine_mem_queue_free(&queue);
+	return ret;
+}
+#endif
+
 struct unit_module_test falcon_tests[] = {
 	UNIT_TEST(falcon_sw_init_free, test_falcon_sw_init_free, NULL, 0),
 	UNIT_TEST(falcon_get_id, test_falcon_get_id, NULL, 0),
@@ -1366,6 +1628,11 @@ struct unit_module_test falcon_tests[] = {
 	UNIT_TEST(falcon_mailbox, test_falcon_mailbox, NULL, 0),
 	UNIT_TEST(falcon_bootstrap, test_falcon_bootstrap, NULL, 0),
 	UNIT_TEST(falcon_irq, test_falcon_irq, NULL, 0),
+	UNIT_TEST(falcon_seq_alloc, test_falcon_seq_alloc, NULL, 0),
+#ifdef CONFIG_NVGPU_ENGINE_QUEUE
+	UNIT_TEST(falcon_queue_push_batch, test_falcon_queue_push_batch,
+		  NULL, 0),
+#endif
 
 	/* Cleanup */
 	UNIT_TEST(falcon_free_test_env, free_falcon_test_env, NULL, 0),
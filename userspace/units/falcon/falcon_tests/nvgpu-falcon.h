@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -508,3 +508,66 @@ int test_falcon_mem_rw_inval_port(struct unit_module *m, struct gk20a *g,
  * otherwise.
  */
 int test_falcon_irq(struct unit_module *m, struct gk20a *g, void *__args);
+
+/**
+ * Test specification for: test_falcon_seq_alloc
+ *
+ * Description: The falcon sequence ID allocator shall hand out every ID at
+ * most once, reuse released IDs and account the latency of completed
+ * sequences to the tag given at acquire.
+ *
+ * Test Type: Feature, Error guessing
+ *
+ * Targets: nvgpu_falcon_seq_alloc_init, nvgpu_falcon_seq_acquire,
+ *	    nvgpu_falcon_seq_release, nvgpu_falcon_seq_get_latency
+ *
+ * Input: None.
+ *
+ * Steps:
+ * - Initialize an allocator with 40 IDs and acquire 40 IDs.
+ *   - Verify that all IDs are distinct and below 40.
+ *   - Verify that one more acquire fails with -EAGAIN.
+ * - Release one ID as completed and one as not completed.
+ *   - Verify that the next two acquires return these IDs.
+ *   - Verify that only the completed one is counted for its tag.
+ * - Release and acquire an ID with a tag past the histogram array and
+ *   complete it.
+ *   - Verify that it is counted in the last histogram.
+ * - Acquire and release IDs from 4 threads concurrently.
+ *   - Verify that no ID is owned by two threads at a time.
+ *   - Verify that all 40 IDs can be acquired afterwards.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_falcon_seq_alloc(struct unit_module *m, struct gk20a *g,
+			  void *__args);
+
+/**
+ * Test specification for: test_falcon_queue_push_batch
+ *
+ * Description: A batch of commands pushed to a falcon memory queue shall be
+ * written contiguously and published with a single queue head update.
+ *
+ * Test Type: Feature, Error guessing
+ *
+ * Targets: nvgpu_engine_mem_queue_init, nvgpu_engine_mem_queue_push_batch,
+ *	    nvgpu_engine_mem_queue_free
+ *
+ * Input: None.
+ *
+ * Steps:
+ * - Initialize a DMEM write queue on the emulated PMU falcon with head and
+ *   tail callbacks that count head updates.
+ * - Push a batch of three commands, one of non word-multiple size.
+ *   - Verify that the head was set once, past the three aligned commands.
+ *   - Verify that the falcon DMEM holds the three commands back to back.
+ * - Push an empty batch and verify that the head is not touched.
+ * - Push a batch larger than the free space.
+ *   - Verify that it fails with -EAGAIN and the head is not touched.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_falcon_queue_push_batch(struct unit_module *m, struct gk20a *g,
+				 void *__args);
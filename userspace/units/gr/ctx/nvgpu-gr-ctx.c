@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -57,6 +57,9 @@ int test_gr_ctx_error_injection(struct unit_module *m,
 	struct nvgpu_posix_fault_inj *kmem_fi =
 		nvgpu_kmem_get_fault_injection();
 	u64 low_hole = SZ_4K * 16UL;
+	struct nvgpu_mem *patch_mem;
+	u32 max_entries;
+	u32 i;
 
 	desc = nvgpu_gr_ctx_desc_alloc(g);
 	if (!desc) {
@@ -215,15 +218,40 @@ int test_gr_ctx_error_injection(struct unit_module *m,
 	gr_ctx->patch_ctx.data_count = 0;
 	nvgpu_gr_ctx_patch_write(g, gr_ctx, 0, 0, true);
 
+	/* Fill the rest of the patch buffer */
+	max_entries = nvgpu_safe_cast_u64_to_u32(
+			PATCH_CTX_ENTRIES_FROM_SIZE(DUMMY_SIZE) /
+			PATCH_CTX_SLOTS_REQUIRED_PER_ENTRY);
+	for (i = 1U; i < max_entries; i++) {
+		nvgpu_gr_ctx_patch_write(g, gr_ctx, i, ~i, true);
+	}
+
+	/* Writes are staged until the sequence is closed */
+	if (gr_ctx->patch_ctx.stage_count != max_entries) {
+		unit_return_fail(m, "patch writes not staged");
+	}
+
 	/*
 	 * Trigger patch write with NULL context, should fail.
-	 * We currently don't have API to read contents of patch buffer
-	 * hence can't verify yet.
 	 */
 	nvgpu_gr_ctx_patch_write(g, NULL, 0, 0xDEADBEEF, true);
 
 	nvgpu_gr_ctx_patch_write_end(g, gr_ctx, true);
 
+	/* All staged entries should be flushed into patch buffer */
+	if ((gr_ctx->patch_ctx.stage_count != 0U) ||
+	    (gr_ctx->patch_ctx.data_count != max_entries)) {
+		unit_return_fail(m, "patch writes not flushed");
+	}
+	patch_mem = nvgpu_gr_ctx_get_patch_ctx_mem(gr_ctx);
+	for (i = 0U; i < max_entries; i++) {
+		if ((nvgpu_mem_rd32(g, patch_mem, 2U * i) != i) ||
+		    (nvgpu_mem_rd32(g, patch_mem, 2U * i + 1U) !=
+		     ((i == 0U) ? 0U : ~i))) {
+			unit_return_fail(m, "patch entry %u mismatch", i);
+		}
+	}
+
 	/* cleanup */
 	nvgpu_gr_ctx_free_patch_ctx(g, vm, gr_ctx);
 	nvgpu_gr_ctx_free(g, gr_ctx, global_desc, vm);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -72,9 +72,10 @@ struct unit_module;
  * - Disable error injection and map, should pass.
  * - Increase data count in patch context beyond max, write should fail.
  * - Set data count to 0, write should pass.
- * - Trigger patch write with NULL context pointer. Should fail. But since
- *   we don't have any API to read contents of Patch buffer, can't be
- *   verified yet.
+ * - Fill the rest of patch buffer, writes should be staged in CPU memory.
+ * - Trigger patch write with NULL context pointer. Should fail.
+ * - Finish patch writes, staged entries should be flushed and every entry
+ *   in patch buffer should match the written addr/data pair.
  * - Cleanup all the local resources.
  *
  * Output: Returns PASS if the steps above were executed successfully. FAIL
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <unit/io.h>
+#include <unit/unit.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/atomic.h>
+#include <nvgpu/gr/fecs_trace_ctx.h>
+
+#include "nvgpu-gr-fecs-trace.h"
+
+#define TEST_VMID		1U
+#define TEST_NO_VMID		0xffffffffU
+
+static struct nvgpu_gr_fecs_trace_ctx_table test_table;
+
+/* Same hash as the driver, used to build colliding context_ptrs */
+static u32 test_ctx_hash(u32 context_ptr)
+{
+	return (u32)(((u64)context_ptr * 0x9E3779B1ULL) & 0xffffffffULL) >>
+		(32U - NVGPU_FECS_TRACE_CTX_TABLE_SHIFT);
+}
+
+/* Find n context_ptrs above *start whose home slot is slot */
+static void test_ctx_ptrs_for_slot(u32 slot, u32 *start, u32 *ptrs, u32 n)
+{
+	u32 p = *start;
+	u32 i;
+
+	for (i = 0U; i < n; i++) {
+		do {
+			p++;
+		} while (test_ctx_hash(p) != slot);
+		ptrs[i] = p;
+	}
+	*start = p;
+}
+
+static bool test_ctx_found(struct unit_module *m, struct gk20a *g,
+		u32 context_ptr, pid_t expected_pid)
+{
+	pid_t pid;
+	u32 vmid;
+
+	(void) nvgpu_gr_fecs_trace_ctx_table_find(&test_table, context_ptr,
+			&pid, &vmid);
+	if ((pid != expected_pid) || (vmid != TEST_VMID)) {
+		unit_err(m, "context_ptr=%x pid=%d vmid=%u, expected pid=%d\n",
+			context_ptr, pid, vmid, expected_pid);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_ctx_not_found(struct unit_module *m, struct gk20a *g,
+		u32 context_ptr)
+{
+	pid_t pid;
+	u32 vmid;
+
+	(void) nvgpu_gr_fecs_trace_ctx_table_find(&test_table, context_ptr,
+			&pid, &vmid);
+	if ((pid != 0) || (vmid != TEST_NO_VMID)) {
+		unit_err(m, "context_ptr=%x unexpectedly found\n",
+			context_ptr);
+		return false;
+	}
+
+	return true;
+}
+
+/* Check that ptrs[from..n) are found with pid (100 + index) */
+static bool test_ctx_check_range(struct unit_module *m, struct gk20a *g,
+		u32 *ptrs, u32 from, u32 n)
+{
+	u32 i;
+
+	for (i = 0U; i < n; i++) {
+		if ((i < from) ? !test_ctx_not_found(m, g, ptrs[i]) :
+				!test_ctx_found(m, g, ptrs[i],
+					(pid_t)(100U + i))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static int test_ctx_add_all(struct unit_module *m, struct gk20a *g,
+		u32 *ptrs, u32 n)
+{
+	u32 i;
+	int err;
+
+	for (i = 0U; i < n; i++) {
+		err = nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, ptrs[i],
+				(pid_t)(100U + i), TEST_VMID);
+		if (err != 0) {
+			unit_err(m, "failed to add context_ptr=%x\n", ptrs[i]);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+int test_gr_fecs_trace_ctx_table_collisions(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	int ret = UNIT_FAIL;
+	u32 ptrs[4];
+	u32 start = 0U;
+	u32 i;
+
+	if (nvgpu_gr_fecs_trace_ctx_table_init(g, &test_table) != 0) {
+		unit_return_fail(m, "context table init failed\n");
+	}
+
+	test_ctx_ptrs_for_slot(100U, &start, ptrs, 3U);
+	test_ctx_ptrs_for_slot(101U, &start, &ptrs[3], 1U);
+
+	if (test_ctx_add_all(m, g, ptrs, 4U) != 0) {
+		goto out;
+	}
+	if (!test_ctx_check_range(m, g, ptrs, 0U, 4U)) {
+		goto out;
+	}
+
+	/* Re-adding a context updates it in place */
+	if ((nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, ptrs[0], 42,
+			TEST_VMID) != 0) ||
+	    !test_ctx_found(m, g, ptrs[0], 42)) {
+		goto out;
+	}
+	if ((nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, ptrs[0], 100,
+			TEST_VMID) != 0)) {
+		goto out;
+	}
+
+	for (i = 0U; i < 4U; i++) {
+		nvgpu_gr_fecs_trace_ctx_table_remove(g, &test_table, ptrs[i]);
+		if (!test_ctx_check_range(m, g, ptrs, i + 1U, 4U)) {
+			unit_err(m, "lookup failed after removing %u\n", i);
+			goto out;
+		}
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_gr_fecs_trace_ctx_table_deinit(g, &test_table);
+	return ret;
+}
+
+int test_gr_fecs_trace_ctx_table_wraparound(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	int ret = UNIT_FAIL;
+	u32 count;
+	u32 ptrs[4];
+	u32 start = 0U;
+	u32 i;
+
+	if (nvgpu_gr_fecs_trace_ctx_table_init(g, &test_table) != 0) {
+		unit_return_fail(m, "context table init failed\n");
+	}
+
+	/* Occupies the last slot, then wraps to slots 0, 1 and 2 */
+	test_ctx_ptrs_for_slot(NVGPU_FECS_TRACE_CTX_TABLE_SIZE - 1U, &start,
+		ptrs, 3U);
+	test_ctx_ptrs_for_slot(0U, &start, &ptrs[3], 1U);
+
+	if (test_ctx_add_all(m, g, ptrs, 4U) != 0) {
+		goto out;
+	}
+	if (!test_ctx_check_range(m, g, ptrs, 0U, 4U)) {
+		goto out;
+	}
+
+	for (i = 0U; i < 4U; i++) {
+		nvgpu_gr_fecs_trace_ctx_table_remove(g, &test_table, ptrs[i]);
+		if (!test_ctx_check_range(m, g, ptrs, i + 1U, 4U)) {
+			unit_err(m, "lookup failed after removing %u\n", i);
+			goto out;
+		}
+	}
+
+	/* Removing an unknown context is a no-op */
+	nvgpu_gr_fecs_trace_ctx_table_remove(g, &test_table, ptrs[0]);
+
+	count = nvgpu_gr_fecs_trace_ctx_table_count(&test_table);
+	if (count != 0U) {
+		unit_err(m, "%u contexts left\n", count);
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_gr_fecs_trace_ctx_table_deinit(g, &test_table);
+	return ret;
+}
+
+int test_gr_fecs_trace_ctx_table_full(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	int ret = UNIT_FAIL;
+	u32 i;
+	int err;
+
+	if (nvgpu_gr_fecs_trace_ctx_table_init(g, &test_table) != 0) {
+		unit_return_fail(m, "context table init failed\n");
+	}
+
+	for (i = 1U; i <= NVGPU_FECS_TRACE_CTX_TABLE_MAX; i++) {
+		err = nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, i << 12U, 1,
+				TEST_VMID);
+		if (err != 0) {
+			unit_err(m, "failed to add context %u\n", i);
+			goto out;
+		}
+	}
+
+	err = nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, i << 12U, 1, TEST_VMID);
+	if (err != -ENOSPC) {
+		unit_err(m, "add to full table returned %d\n", err);
+		goto out;
+	}
+
+	err = nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, 1U << 12U, 2, TEST_VMID);
+	if ((err != 0) || !test_ctx_found(m, g, 1U << 12U, 2)) {
+		unit_err(m, "update in full table failed\n");
+		goto out;
+	}
+
+	if (nvgpu_gr_fecs_trace_ctx_table_add(g, &test_table, 0U, 1, TEST_VMID) !=
+			-EINVAL) {
+		unit_err(m, "context_ptr 0 accepted\n");
+		goto out;
+	}
+
+	nvgpu_gr_fecs_trace_ctx_table_clear(&test_table);
+	for (i = 1U; i <= NVGPU_FECS_TRACE_CTX_TABLE_MAX; i++) {
+		if (!test_ctx_not_found(m, g, i << 12U)) {
+			goto out;
+		}
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_gr_fecs_trace_ctx_table_deinit(g, &test_table);
+	return ret;
+}
+
+int test_gr_fecs_trace_ctx_table_update_in_progress(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	int ret = UNIT_FAIL;
+	u32 ptrs[2];
+	u32 start = 0U;
+
+	if (nvgpu_gr_fecs_trace_ctx_table_init(g, &test_table) != 0) {
+		unit_return_fail(m, "context table init failed\n");
+	}
+
+	test_ctx_ptrs_for_slot(200U, &start, ptrs, 2U);
+	if ((test_ctx_add_all(m, g, ptrs, 2U) != 0) ||
+	    !test_ctx_check_range(m, g, ptrs, 0U, 2U)) {
+		goto out;
+	}
+
+	/*
+	 * Leave the sequence odd as if a writer had been preempted inside an
+	 * update: lookups must not wait for it but fall back to the lock.
+	 */
+	nvgpu_atomic_inc(&test_table.seq);
+	if (!test_ctx_check_range(m, g, ptrs, 0U, 2U) ||
+	    !test_ctx_not_found(m, g, ptrs[1] + 1U)) {
+		unit_err(m, "lookup during update failed\n");
+		nvgpu_atomic_inc(&test_table.seq);
+		goto out;
+	}
+	nvgpu_atomic_inc(&test_table.seq);
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_gr_fecs_trace_ctx_table_deinit(g, &test_table);
+	return ret;
+}
+
+struct unit_module_test nvgpu_gr_fecs_trace_tests[] = {
+	UNIT_TEST(gr_fecs_trace_ctx_table_collisions,
+		test_gr_fecs_trace_ctx_table_collisions, NULL, 0),
+	UNIT_TEST(gr_fecs_trace_ctx_table_wraparound,
+		test_gr_fecs_trace_ctx_table_wraparound, NULL, 0),
+	UNIT_TEST(gr_fecs_trace_ctx_table_full,
+		test_gr_fecs_trace_ctx_table_full, NULL, 0),
+	UNIT_TEST(gr_fecs_trace_ctx_table_update_in_progress,
+		test_gr_fecs_trace_ctx_table_update_in_progress, NULL, 0),
+};
+
+UNIT_MODULE(nvgpu_gr_fecs_trace, nvgpu_gr_fecs_trace_tests, UNIT_PRIO_NVGPU_TEST);
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef UNIT_NVGPU_GR_FECS_TRACE_H
+#define UNIT_NVGPU_GR_FECS_TRACE_H
+
+#include <nvgpu/types.h>
+
+struct gk20a;
+struct unit_module;
+
+/** @addtogroup SWUTS-gr-fecs-trace
+ *  @{
+ *
+ * Software Unit Test Specification for common.gr.fecs_trace
+ */
+
+/**
+ * Test specification for: test_gr_fecs_trace_ctx_table_collisions.
+ *
+ * Description: Verify context_ptr -> pid lookups when several contexts
+ * hash to the same slot.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_gr_fecs_trace_ctx_table_add,
+ *          nvgpu_gr_fecs_trace_ctx_table_remove,
+ *          nvgpu_gr_fecs_trace_ctx_table_find
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Add three contexts with the same home slot and one context with the
+ *   next home slot, check that all of them are found.
+ * - Add the first context again with a new pid, check that the entry is
+ *   updated in place.
+ * - Remove the contexts one by one starting at the head of the probe run.
+ *   After each removal check that the removed context is not found and
+ *   that all remaining contexts are still found.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_gr_fecs_trace_ctx_table_collisions(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_gr_fecs_trace_ctx_table_wraparound.
+ *
+ * Description: Verify probe runs and backward shift deletion across the
+ * end of the table.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_gr_fecs_trace_ctx_table_add,
+ *          nvgpu_gr_fecs_trace_ctx_table_remove,
+ *          nvgpu_gr_fecs_trace_ctx_table_find,
+ *          nvgpu_gr_fecs_trace_ctx_table_count
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Add three contexts whose home is the last slot so that their probe run
+ *   wraps to slot 0, and one context whose home is slot 0.
+ * - Remove the context in the last slot and check that all others are
+ *   still found.
+ * - Remove the remaining contexts in the order they were added, checking
+ *   lookups after each removal.
+ * - Check that the context count is back to zero.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_gr_fecs_trace_ctx_table_wraparound(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_gr_fecs_trace_ctx_table_full.
+ *
+ * Description: Verify context table load limit.
+ *
+ * Test Type: Feature, Boundary values
+ *
+ * Targets: nvgpu_gr_fecs_trace_ctx_table_add,
+ *          nvgpu_gr_fecs_trace_ctx_table_clear,
+ *          nvgpu_gr_fecs_trace_ctx_table_find
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Add NVGPU_FECS_TRACE_CTX_TABLE_MAX contexts, all should succeed.
+ * - Adding one more should fail with -ENOSPC, updating an existing one
+ *   should still succeed.
+ * - Adding context_ptr 0 should fail with -EINVAL.
+ * - Remove all contexts and check that none of them is found.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_gr_fecs_trace_ctx_table_full(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_gr_fecs_trace_ctx_table_update_in_progress.
+ *
+ * Description: Verify lookups do not wait for an update in progress.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_gr_fecs_trace_ctx_table_find
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Add two contexts with the same home slot and check they are found.
+ * - Make the table sequence odd, as if a writer was preempted in the middle
+ *   of an update, and check that both contexts are still found and an
+ *   unknown context is not, without the lookup waiting on the sequence.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_gr_fecs_trace_ctx_table_update_in_progress(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+/**
+ * @}
+ */
+
+#endif /* UNIT_NVGPU_GR_FECS_TRACE_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -31,6 +31,8 @@
 #include <nvgpu/dma.h>
 #include <nvgpu/gr/gr.h>
 #include <nvgpu/gr/global_ctx.h>
+#include <nvgpu/timers.h>
+#include <nvgpu/sizes.h>
 
 #include <nvgpu/posix/posix-fault-injection.h>
 #include <nvgpu/posix/dma.h>
@@ -266,10 +268,237 @@ int test_gr_global_ctx_local_ctx_error_injection(struct unit_module *m,
 	return UNIT_SUCCESS;
 }
 
+static int dummy_l2_flush_success(struct gk20a *g, bool invalidate)
+{
+	return 0;
+}
+
+int test_gr_global_ctx_golden_image_variants(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	int err;
+	int ret = UNIT_FAIL;
+	u32 i;
+	bool found;
+	struct nvgpu_mem src = { };
+	struct nvgpu_mem dst = { };
+	struct nvgpu_gr_global_ctx_local_golden_image *local_golden_image = NULL;
+	struct nvgpu_gr_global_ctx_variant_stats stats;
+
+	g->ops.mm.cache.l2_flush = dummy_l2_flush_success;
+
+	if ((nvgpu_dma_alloc(g, DUMMY_SIZE, &src) != 0) ||
+	    (nvgpu_dma_alloc(g, DUMMY_SIZE, &dst) != 0)) {
+		unit_err(m, "failed to allocate dummy memory\n");
+		goto out;
+	}
+
+	err = nvgpu_gr_global_ctx_alloc_local_golden_image(g,
+			&local_golden_image, DUMMY_SIZE);
+	if (err != 0) {
+		unit_err(m, "failed to allocate local golden image\n");
+		goto out;
+	}
+
+	nvgpu_memset(g, &src, 0, 0x5A, DUMMY_SIZE);
+	nvgpu_gr_global_ctx_init_local_golden_image(g, local_golden_image,
+			&src, DUMMY_SIZE);
+
+	/* No variant cached yet, target memory must be untouched */
+	found = nvgpu_gr_global_ctx_load_local_golden_image_variant(g,
+			local_golden_image, NVGPU_GR_GLOBAL_CTX_VARIANT_CDE, &dst);
+	if (found || (nvgpu_mem_rd32(g, &dst, 0) != 0U)) {
+		unit_err(m, "unexpected variant hit\n");
+		goto out;
+	}
+
+	/* Bake a variant with one header field changed */
+	nvgpu_mem_wr32(g, &src, 1, 0xCDEU);
+	err = nvgpu_gr_global_ctx_save_local_golden_image_variant(g,
+			local_golden_image, NVGPU_GR_GLOBAL_CTX_VARIANT_CDE, &src);
+	if (err != 0) {
+		unit_err(m, "failed to save variant\n");
+		goto out;
+	}
+
+	found = nvgpu_gr_global_ctx_load_local_golden_image_variant(g,
+			local_golden_image, NVGPU_GR_GLOBAL_CTX_VARIANT_CDE, &dst);
+	if (!found || (nvgpu_mem_rd32(g, &dst, 0) != 0x5A5A5A5AU) ||
+	    (nvgpu_mem_rd32(g, &dst, 1) != 0xCDEU)) {
+		unit_err(m, "variant not loaded\n");
+		goto out;
+	}
+
+	/* Base image must not be affected by variants */
+	nvgpu_gr_global_ctx_load_local_golden_image(g, local_golden_image,
+			&dst);
+	if (nvgpu_mem_rd32(g, &dst, 1) != 0x5A5A5A5AU) {
+		unit_err(m, "base image modified\n");
+		goto out;
+	}
+
+	/* Saving same key again is a no-op */
+	err = nvgpu_gr_global_ctx_save_local_golden_image_variant(g,
+			local_golden_image, NVGPU_GR_GLOBAL_CTX_VARIANT_CDE, &src);
+	if (err != 0) {
+		unit_err(m, "failed to save duplicate variant\n");
+		goto out;
+	}
+
+	/* Every valid key gets a slot, a key out of range is rejected */
+	for (i = 0U; i < NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX; i++) {
+		err = nvgpu_gr_global_ctx_save_local_golden_image_variant(g,
+				local_golden_image, i, &src);
+		if (err != 0) {
+			unit_err(m, "failed to save variant %u\n", i);
+			goto out;
+		}
+	}
+	err = nvgpu_gr_global_ctx_save_local_golden_image_variant(g,
+			local_golden_image, NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX, &src);
+	if (err != -EINVAL) {
+		unit_err(m, "unexpected save result %d\n", err);
+		goto out;
+	}
+
+	nvgpu_gr_global_ctx_get_variant_stats(local_golden_image, &stats);
+	if ((stats.variants != NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX) ||
+	    (stats.bytes != NVGPU_GR_GLOBAL_CTX_VARIANTS_MAX * DUMMY_SIZE) ||
+	    (stats.hits != 1ULL) || (stats.misses != 1ULL)) {
+		unit_err(m, "unexpected stats\n");
+		goto out;
+	}
+
+	/* Re-init drops all variants */
+	nvgpu_gr_global_ctx_init_local_golden_image(g, local_golden_image,
+			&src, DUMMY_SIZE);
+	nvgpu_gr_global_ctx_get_variant_stats(local_golden_image, &stats);
+	if ((stats.variants != 0U) || (stats.bytes != 0U)) {
+		unit_err(m, "variants not dropped\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+
+out:
+	if (local_golden_image != NULL) {
+		nvgpu_gr_global_ctx_deinit_local_golden_image(g,
+				local_golden_image);
+	}
+	if (nvgpu_mem_is_valid(&src)) {
+		nvgpu_dma_free(g, &src);
+	}
+	if (nvgpu_mem_is_valid(&dst)) {
+		nvgpu_dma_free(g, &dst);
+	}
+	return ret;
+}
+
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+#define BENCH_IMAGE_SIZE	(SZ_1M)
+#define BENCH_LOOPS		16U
+
+int test_gr_global_ctx_compare_bench(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	int ret = UNIT_FAIL;
+	u32 i;
+	bool valid = true;
+	s64 start, compare_ns, checksum_ns;
+	struct nvgpu_mem mem = { };
+	struct nvgpu_gr_global_ctx_local_golden_image *image1 = NULL;
+	struct nvgpu_gr_global_ctx_local_golden_image *image2 = NULL;
+
+	if (nvgpu_dma_alloc(g, BENCH_IMAGE_SIZE, &mem) != 0) {
+		unit_err(m, "failed to allocate dummy memory\n");
+		goto out;
+	}
+	for (i = 0U; i < BENCH_IMAGE_SIZE / sizeof(u32); i++) {
+		nvgpu_mem_wr32(g, &mem, i, i * 0x9E3779B1U);
+	}
+
+	if ((nvgpu_gr_global_ctx_alloc_local_golden_image(g, &image1,
+			BENCH_IMAGE_SIZE) != 0) ||
+	    (nvgpu_gr_global_ctx_alloc_local_golden_image(g, &image2,
+			BENCH_IMAGE_SIZE) != 0)) {
+		unit_err(m, "failed to allocate local golden images\n");
+		goto out;
+	}
+	nvgpu_gr_global_ctx_init_local_golden_image(g, image1, &mem,
+			BENCH_IMAGE_SIZE);
+	nvgpu_gr_global_ctx_init_local_golden_image(g, image2, &mem,
+			BENCH_IMAGE_SIZE);
+
+	start = nvgpu_current_time_ns();
+	for (i = 0U; i < BENCH_LOOPS; i++) {
+		valid = valid && nvgpu_gr_global_ctx_compare_golden_images(g,
+				true, image1, image2, BENCH_IMAGE_SIZE);
+	}
+	compare_ns = nvgpu_current_time_ns() - start;
+	if (!valid) {
+		unit_err(m, "identical images do not match\n");
+		goto out;
+	}
+
+	start = nvgpu_current_time_ns();
+	for (i = 0U; i < BENCH_LOOPS; i++) {
+		valid = valid && nvgpu_gr_global_ctx_verify_local_golden_image(g,
+				image2);
+	}
+	checksum_ns = nvgpu_current_time_ns() - start;
+	if (!valid) {
+		unit_err(m, "checksum mismatch on intact image\n");
+		goto out;
+	}
+
+	unit_info(m, "%u x %u KB: compare %lld ns, checksum verify %lld ns\n",
+		BENCH_LOOPS, (u32)(BENCH_IMAGE_SIZE / SZ_1K),
+		(long long)compare_ns, (long long)checksum_ns);
+
+	/* Single bit change anywhere must be detected by both */
+	for (i = 0U; i < 2U; i++) {
+		u32 word = (i == 0U) ? 7U :
+			(u32)(BENCH_IMAGE_SIZE / sizeof(u32)) - 1U;
+
+		image2->context[word] ^= 0x80000000U;
+		if (nvgpu_gr_global_ctx_compare_golden_images(g, true, image1,
+				image2, BENCH_IMAGE_SIZE) ||
+		    nvgpu_gr_global_ctx_verify_local_golden_image(g, image2)) {
+			unit_err(m, "change in word %u not detected\n", word);
+			goto out;
+		}
+		image2->context[word] ^= 0x80000000U;
+	}
+
+	if (!nvgpu_gr_global_ctx_verify_local_golden_image(g, image2)) {
+		unit_err(m, "checksum mismatch on restored image\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+
+out:
+	if (image1 != NULL) {
+		nvgpu_gr_global_ctx_deinit_local_golden_image(g, image1);
+	}
+	if (image2 != NULL) {
+		nvgpu_gr_global_ctx_deinit_local_golden_image(g, image2);
+	}
+	if (nvgpu_mem_is_valid(&mem)) {
+		nvgpu_dma_free(g, &mem);
+	}
+	return ret;
+}
+#endif
+
 struct unit_module_test nvgpu_gr_global_ctx_tests[] = {
 	UNIT_TEST(gr_global_ctx_setup, test_gr_init_setup, NULL, 0),
 	UNIT_TEST(gr_global_ctx_alloc_errors, test_gr_global_ctx_alloc_error_injection, NULL, 0),
 	UNIT_TEST(gr_global_ctx_local_ctx_errors, test_gr_global_ctx_local_ctx_error_injection, NULL, 0),
+	UNIT_TEST(gr_global_ctx_golden_image_variants, test_gr_global_ctx_golden_image_variants, NULL, 0),
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+	UNIT_TEST(gr_global_ctx_compare_bench, test_gr_global_ctx_compare_bench, NULL, 0),
+#endif
 	UNIT_TEST(gr_global_ctx_cleanup, test_gr_remove_setup, NULL, 0),
 };
 
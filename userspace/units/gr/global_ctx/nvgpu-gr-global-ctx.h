@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -113,6 +113,72 @@ int test_gr_global_ctx_alloc_error_injection(struct unit_module *m,
 int test_gr_global_ctx_local_ctx_error_injection(struct unit_module *m,
 		struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_gr_global_ctx_golden_image_variants.
+ *
+ * Description: Verify caching of pre-baked local golden image variants.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_gr_global_ctx_load_local_golden_image_variant,
+ *          nvgpu_gr_global_ctx_save_local_golden_image_variant,
+ *          nvgpu_gr_global_ctx_get_variant_stats,
+ *          nvgpu_gr_global_ctx_init_local_golden_image
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Allocate and initialize a local golden image from a dummy buffer.
+ * - Load variant before it is saved, should fail and leave target
+ *   memory untouched.
+ * - Modify one word of the source buffer and save it as a variant.
+ * - Load the variant, target memory should match modified source.
+ * - Load base image, modified word should not be present.
+ * - Save same variant again, should pass without using a new slot.
+ * - Save a variant for every valid key, all should pass. Saving a key out
+ *   of range should fail with -EINVAL.
+ * - Check variant count, memory usage and hit/miss statistics.
+ * - Re-initialize local golden image, all variants should be dropped.
+ * - Cleanup all the local resources.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_gr_global_ctx_golden_image_variants(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+#ifdef CONFIG_NVGPU_GR_GOLDEN_CTX_VERIFICATION
+/**
+ * Test specification for: test_gr_global_ctx_compare_bench.
+ *
+ * Description: Verify and benchmark golden image comparison and
+ *              checksum verification.
+ *
+ * Test Type: Feature, Performance
+ *
+ * Targets: nvgpu_gr_global_ctx_init_local_golden_image,
+ *          nvgpu_gr_global_ctx_compare_golden_images,
+ *          nvgpu_gr_global_ctx_verify_local_golden_image
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Initialize two 1 MB local golden images from same pattern buffer.
+ * - Compare them repeatedly, all comparisons should pass.
+ * - Verify second image against its checksum repeatedly, all should pass.
+ *   Report time taken by both.
+ * - Flip a bit in first block of second image, both compare and checksum
+ *   verification should fail. Restore it and repeat with last word.
+ * - Verify restored image against its checksum, should pass.
+ * - Cleanup all the local resources.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_gr_global_ctx_compare_bench(struct unit_module *m,
+		struct gk20a *g, void *args);
+#endif
+
 #endif /* UNIT_NVGPU_GR_GLOBAL_CTX_H */
 
 /**
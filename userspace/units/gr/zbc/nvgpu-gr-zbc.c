@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <unit/unit.h>
+#include <unit/io.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/enabled.h>
+#include <nvgpu/gr/zbc.h>
+
+#include "common/gr/zbc_priv.h"
+
+#include "nvgpu-gr-zbc.h"
+
+/* Depth entries beyond the hash buckets, some chains must collide */
+#define TEST_ZBC_MAX_DEPTH_INDEX	(2U * GR_ZBC_HASH_BUCKETS)
+#define TEST_ZBC_MAX_INDEX		15U
+#define TEST_ZBC_DEPTH_BASE		0x1000U
+
+static u32 hw_writes;
+
+static void stub_init_table_indices(struct gk20a *g,
+		struct nvgpu_gr_zbc_table_indices *zbc_indices)
+{
+	zbc_indices->min_color_index = NVGPU_GR_ZBC_STARTOF_TABLE;
+	zbc_indices->max_color_index = TEST_ZBC_MAX_INDEX;
+	zbc_indices->min_depth_index = NVGPU_GR_ZBC_STARTOF_TABLE;
+	zbc_indices->max_depth_index = TEST_ZBC_MAX_DEPTH_INDEX;
+	zbc_indices->min_stencil_index = NVGPU_GR_ZBC_STARTOF_TABLE;
+	zbc_indices->max_stencil_index = TEST_ZBC_MAX_INDEX;
+}
+
+static void stub_add_entry(struct gk20a *g, struct nvgpu_gr_zbc_entry *val,
+		u32 index)
+{
+	hw_writes++;
+}
+
+static void stub_set_color_entry(struct gk20a *g, u32 *color_val_l2,
+		u32 index)
+{
+}
+
+static void stub_set_value_entry(struct gk20a *g, u32 val, u32 index)
+{
+}
+
+/*
+ * Walk every chain of a table and check that each used entry is linked
+ * exactly once, in the bucket of its hash. Returns the longest chain length
+ * or 0 on error.
+ */
+static u32 check_chains(struct unit_module *m, struct nvgpu_gr_zbc *zbc,
+		u32 type)
+{
+	bool seen[TEST_ZBC_MAX_DEPTH_INDEX + 1U] = { false };
+	u32 *heads, min, max_used;
+	u32 bucket, i, hash, next, len, longest = 0U, linked = 0U;
+
+	if (type == NVGPU_GR_ZBC_TYPE_COLOR) {
+		heads = zbc->col_hash;
+		min = zbc->min_color_index;
+		max_used = zbc->max_used_color_index;
+	} else if (type == NVGPU_GR_ZBC_TYPE_DEPTH) {
+		heads = zbc->dep_hash;
+		min = zbc->min_depth_index;
+		max_used = zbc->max_used_depth_index;
+	} else {
+		heads = zbc->s_hash;
+		min = zbc->min_stencil_index;
+		max_used = zbc->max_used_stencil_index;
+	}
+
+	for (bucket = 0U; bucket < GR_ZBC_HASH_BUCKETS; bucket++) {
+		len = 0U;
+		for (i = heads[bucket]; i != GR_ZBC_HASH_NONE; i = next) {
+			if ((i < min) || (i > max_used) || seen[i]) {
+				unit_err(m, "type %u bucket %u: bad index %u\n",
+					type, bucket, i);
+				return 0U;
+			}
+			seen[i] = true;
+
+			if (type == NVGPU_GR_ZBC_TYPE_COLOR) {
+				hash = zbc->zbc_col_tbl[i].hash;
+				next = zbc->zbc_col_tbl[i].next;
+			} else if (type == NVGPU_GR_ZBC_TYPE_DEPTH) {
+				hash = zbc->zbc_dep_tbl[i].hash;
+				next = zbc->zbc_dep_tbl[i].next;
+			} else {
+				hash = zbc->zbc_s_tbl[i].hash;
+				next = zbc->zbc_s_tbl[i].next;
+			}
+			if ((hash & GR_ZBC_HASH_MASK) != bucket) {
+				unit_err(m, "type %u: index %u in bucket %u\n",
+					type, i, bucket);
+				return 0U;
+			}
+			len++;
+			linked++;
+		}
+		longest = max(longest, len);
+	}
+
+	if (linked != (max_used - min + 1U)) {
+		unit_err(m, "type %u: %u entries linked, %u used\n",
+			type, linked, max_used - min + 1U);
+		return 0U;
+	}
+
+	return longest;
+}
+
+static u32 query_ref_cnt(struct gk20a *g, struct nvgpu_gr_zbc *zbc,
+		u32 type, u32 index)
+{
+	struct nvgpu_gr_zbc_query_params query = { 0 };
+
+	query.type = type;
+	query.index_size = index;
+	if (nvgpu_gr_zbc_query_table(g, zbc, &query) != 0) {
+		return U32_MAX;
+	}
+
+	return query.ref_cnt;
+}
+
+static int set_depth(struct gk20a *g, struct nvgpu_gr_zbc *zbc, u32 depth)
+{
+	struct nvgpu_gr_zbc_entry entry = { 0 };
+
+	entry.type = NVGPU_GR_ZBC_TYPE_DEPTH;
+	entry.format = GR_ZBC_Z_FMT_VAL_FP32;
+	entry.depth = depth;
+
+	return nvgpu_gr_zbc_set_table(g, zbc, &entry);
+}
+
+/* Find two depth entries sharing a chain, b newer than a. */
+static bool find_chain_pair(struct nvgpu_gr_zbc *zbc, u32 *a, u32 *b)
+{
+	u32 bucket;
+
+	for (bucket = 0U; bucket < GR_ZBC_HASH_BUCKETS; bucket++) {
+		*b = zbc->dep_hash[bucket];
+		if (*b == GR_ZBC_HASH_NONE) {
+			continue;
+		}
+		*a = zbc->zbc_dep_tbl[*b].next;
+		if (*a != GR_ZBC_HASH_NONE) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void set_stub_hals(struct gk20a *g)
+{
+	nvgpu_set_enabled(g, NVGPU_SUPPORT_ZBC_STENCIL, true);
+	g->ops.gr.zbc.init_table_indices = stub_init_table_indices;
+	g->ops.gr.zbc.add_color = stub_add_entry;
+	g->ops.gr.zbc.add_depth = stub_add_entry;
+	g->ops.gr.zbc.add_stencil = stub_add_entry;
+	g->ops.ltc.set_zbc_color_entry = stub_set_color_entry;
+	g->ops.ltc.set_zbc_depth_entry = stub_set_value_entry;
+	g->ops.ltc.set_zbc_s_entry = stub_set_value_entry;
+}
+
+int test_gr_zbc_hash(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_gr_zbc *zbc = NULL;
+	struct nvgpu_gr_zbc_entry color = { 0 };
+	struct nvgpu_gr_zbc_entry stencil = { 0 };
+	u32 defaults, used, hash, a, b, i;
+	int ret = UNIT_FAIL;
+
+	set_stub_hals(g);
+
+	if (nvgpu_gr_zbc_init(g, &zbc) != 0) {
+		unit_return_fail(m, "zbc init failed\n");
+	}
+
+	/* The default entries are linked at init. */
+	if ((check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_COLOR) == 0U) ||
+	    (check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_DEPTH) == 0U) ||
+	    (check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_STENCIL) == 0U)) {
+		unit_err(m, "bad chains after init\n");
+		goto out;
+	}
+	defaults = zbc->max_used_depth_index;
+
+	/* Fill the depth table, more entries than buckets. */
+	hw_writes = 0U;
+	for (i = defaults + 1U; i <= TEST_ZBC_MAX_DEPTH_INDEX; i++) {
+		if ((set_depth(g, zbc, TEST_ZBC_DEPTH_BASE + i) != 0) ||
+		    (zbc->max_used_depth_index != i)) {
+			unit_err(m, "depth insert %u failed\n", i);
+			goto out;
+		}
+	}
+	if (check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_DEPTH) < 2U) {
+		unit_err(m, "no colliding depth chain\n");
+		goto out;
+	}
+
+	/* Existing values are found through the chains and referenced. */
+	for (i = defaults + 1U; i <= TEST_ZBC_MAX_DEPTH_INDEX; i++) {
+		if ((set_depth(g, zbc, TEST_ZBC_DEPTH_BASE + i) != 0) ||
+		    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH, i) != 2U)) {
+			unit_err(m, "depth reference %u failed\n", i);
+			goto out;
+		}
+	}
+	if ((zbc->max_used_depth_index != TEST_ZBC_MAX_DEPTH_INDEX) ||
+	    (hw_writes != TEST_ZBC_MAX_DEPTH_INDEX - defaults)) {
+		unit_err(m, "references added entries\n");
+		goto out;
+	}
+
+	/* A new value does not fit in the full table. */
+	if (set_depth(g, zbc, 0U - 1U) != -ENOSPC) {
+		unit_err(m, "full table accepted an entry\n");
+		goto out;
+	}
+
+	/*
+	 * Give an entry the full hash of an older entry in its chain: the
+	 * lookup of the older value must skip it on the value compare.
+	 */
+	if (!find_chain_pair(zbc, &a, &b)) {
+		unit_err(m, "no chain pair\n");
+		goto out;
+	}
+	hash = zbc->zbc_dep_tbl[b].hash;
+	zbc->zbc_dep_tbl[b].hash = zbc->zbc_dep_tbl[a].hash;
+	used = query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH, b);
+	if ((set_depth(g, zbc, zbc->zbc_dep_tbl[a].depth) != 0) ||
+	    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH, b) != used)) {
+		unit_err(m, "hash collision matched the wrong entry\n");
+		goto out;
+	}
+	zbc->zbc_dep_tbl[b].hash = hash;
+
+	/* Color and stencil entries are added once and then referenced. */
+	color.type = NVGPU_GR_ZBC_TYPE_COLOR;
+	color.format = GR_ZBC_SOLID_WHITE_COLOR_FMT;
+	color.color_ds[0] = 0x3f000000U;
+	color.color_l2[0] = 0x80808080U;
+	stencil.type = NVGPU_GR_ZBC_TYPE_STENCIL;
+	stencil.format = GR_ZBC_STENCIL_CLEAR_FMT_U8;
+	stencil.stencil = 0x80U;
+	for (i = 0U; i < 2U; i++) {
+		if ((nvgpu_gr_zbc_set_table(g, zbc, &color) != 0) ||
+		    (nvgpu_gr_zbc_set_table(g, zbc, &stencil) != 0)) {
+			unit_err(m, "color/stencil insert failed\n");
+			goto out;
+		}
+	}
+	if ((query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_COLOR,
+			zbc->max_used_color_index) != 2U) ||
+	    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_STENCIL,
+			zbc->max_used_stencil_index) != 2U) ||
+	    (check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_COLOR) == 0U) ||
+	    (check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_STENCIL) == 0U)) {
+		unit_err(m, "bad color/stencil chains\n");
+		goto out;
+	}
+
+	/*
+	 * Entries are only dropped with the table: a new table links the
+	 * defaults only and the old values are added again.
+	 */
+	nvgpu_gr_zbc_deinit(g, zbc);
+	if (nvgpu_gr_zbc_init(g, &zbc) != 0) {
+		unit_return_fail(m, "zbc reinit failed\n");
+	}
+	if ((zbc->max_used_depth_index != defaults) ||
+	    (check_chains(m, zbc, NVGPU_GR_ZBC_TYPE_DEPTH) == 0U) ||
+	    (set_depth(g, zbc, TEST_ZBC_DEPTH_BASE + defaults + 1U) != 0) ||
+	    (zbc->max_used_depth_index != defaults + 1U) ||
+	    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH,
+			defaults + 1U) != 1U)) {
+		unit_err(m, "bad table after reinit\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_gr_zbc_deinit(g, zbc);
+	return ret;
+}
+
+int test_gr_zbc_batch(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_gr_zbc *zbc = NULL;
+	struct nvgpu_gr_zbc_entry depth[4] = { 0 };
+	struct nvgpu_gr_zbc_entry color = { 0 };
+	struct nvgpu_gr_zbc_entry bad = { 0 };
+	struct nvgpu_gr_zbc_entry *batch[5];
+	u32 defaults, i;
+	int ret = UNIT_FAIL;
+
+	set_stub_hals(g);
+
+	if (nvgpu_gr_zbc_init(g, &zbc) != 0) {
+		unit_return_fail(m, "zbc init failed\n");
+	}
+	defaults = zbc->max_used_depth_index;
+
+	for (i = 0U; i < 4U; i++) {
+		depth[i].type = NVGPU_GR_ZBC_TYPE_DEPTH;
+		depth[i].format = GR_ZBC_Z_FMT_VAL_FP32;
+		depth[i].depth = TEST_ZBC_DEPTH_BASE + i;
+	}
+	color.type = NVGPU_GR_ZBC_TYPE_COLOR;
+	color.format = GR_ZBC_SOLID_WHITE_COLOR_FMT;
+	color.color_ds[0] = 0x3f000000U;
+	color.color_l2[0] = 0x80808080U;
+	bad.type = NVGPU_GR_ZBC_TYPE_INVALID;
+
+	/* A single entry is a batch of one. */
+	hw_writes = 0U;
+	if ((nvgpu_gr_zbc_set_table(g, zbc, &depth[0]) != 0) ||
+	    (zbc->table_saves != 1U) || (hw_writes != 1U)) {
+		unit_err(m, "single set failed\n");
+		goto out;
+	}
+
+	/* New and existing entries of several types, one save. */
+	batch[0] = &depth[1];
+	batch[1] = &depth[0];
+	batch[2] = &color;
+	batch[3] = &depth[2];
+	batch[4] = &depth[1];
+	if ((nvgpu_gr_zbc_set_table_batch(g, zbc, batch, 5U) != 0) ||
+	    (zbc->table_saves != 2U) || (hw_writes != 4U) ||
+	    (zbc->max_used_depth_index != defaults + 3U) ||
+	    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH,
+			defaults + 1U) != 2U) ||
+	    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH,
+			defaults + 2U) != 2U)) {
+		unit_err(m, "mixed batch failed\n");
+		goto out;
+	}
+
+	/* Only references, or nothing at all: no save. */
+	if ((nvgpu_gr_zbc_set_table_batch(g, zbc, batch, 3U) != 0) ||
+	    (nvgpu_gr_zbc_set_table_batch(g, zbc, batch, 0U) != 0) ||
+	    (zbc->table_saves != 2U) || (hw_writes != 4U)) {
+		unit_err(m, "batch of references saved the table\n");
+		goto out;
+	}
+
+	/* Entries before a failing one stay and are saved once. */
+	batch[0] = &depth[3];
+	batch[1] = &bad;
+	batch[2] = &depth[0];
+	if ((nvgpu_gr_zbc_set_table_batch(g, zbc, batch, 3U) != -EINVAL) ||
+	    (zbc->table_saves != 3U) || (hw_writes != 5U) ||
+	    (zbc->max_used_depth_index != defaults + 4U) ||
+	    (query_ref_cnt(g, zbc, NVGPU_GR_ZBC_TYPE_DEPTH,
+			defaults + 1U) != 3U)) {
+		unit_err(m, "failing batch not stopped\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_gr_zbc_deinit(g, zbc);
+	return ret;
+}
+
+struct unit_module_test nvgpu_gr_zbc_tests[] = {
+	UNIT_TEST(gr_zbc_hash, test_gr_zbc_hash, NULL, 0),
+	UNIT_TEST(gr_zbc_batch, test_gr_zbc_batch, NULL, 0),
+};
+
+UNIT_MODULE(nvgpu_gr_zbc, nvgpu_gr_zbc_tests, UNIT_PRIO_NVGPU_TEST);
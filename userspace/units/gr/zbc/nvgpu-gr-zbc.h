@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef UNIT_NVGPU_GR_ZBC_H
+#define UNIT_NVGPU_GR_ZBC_H
+
+struct gk20a;
+struct unit_module;
+
+/** @addtogroup SWUTS-gr-zbc
+ *  @{
+ *
+ * Software Unit Test Specification for common.gr.zbc
+ */
+
+/**
+ * Test specification for: test_gr_zbc_hash.
+ *
+ * Description: Test the hash chains used to look up ZBC table entries.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_gr_zbc_init, nvgpu_gr_zbc_deinit, nvgpu_gr_zbc_set_table,
+ *          nvgpu_gr_zbc_query_table
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * - Initialize the tables with stubbed HALs and a depth table of twice
+ *   as many entries as hash buckets. Check the default entries are each
+ *   linked once, in the bucket of their hash.
+ * - Fill the depth table and check the chains, with at least one chain
+ *   holding several entries.
+ * - Add every value again and check the existing entry is referenced
+ *   without writing the hardware.
+ * - Check a new value is rejected with -ENOSPC once the table is full.
+ * - Give an entry the hash of an older entry in its chain and check the
+ *   lookup of the older value does not reference it.
+ * - Add a color and a stencil entry twice and check both are referenced.
+ * - Recreate the tables and check only the defaults are linked and an old
+ *   value is added as a new entry.
+ *
+ * Output: Returns PASS if the entries are linked and found as expected,
+ * FAIL otherwise.
+ */
+int test_gr_zbc_hash(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_gr_zbc_batch.
+ *
+ * Description: Test that a batch of ZBC entries saves the table once.
+ *
+ * Test Type: Feature, Error injection
+ *
+ * Targets: nvgpu_gr_zbc_set_table, nvgpu_gr_zbc_set_table_batch
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * - Add a depth entry with nvgpu_gr_zbc_set_table and check the table is
+ *   saved once.
+ * - Set a batch of new and existing depth entries and a new color entry.
+ *   Check each new entry is written to the hardware, the existing ones are
+ *   referenced and the table is saved once for the whole batch.
+ * - Set a batch of existing entries only, and an empty batch, and check the
+ *   table is not saved.
+ * - Set a batch with an invalid entry in the middle. Check -EINVAL is
+ *   returned, the entry before it is added and saved once and the entry
+ *   after it is not referenced.
+ *
+ * Output: Returns PASS if the entries and table saves are as expected,
+ * FAIL otherwise.
+ */
+int test_gr_zbc_batch(struct unit_module *m, struct gk20a *g, void *args);
+
+#endif /* UNIT_NVGPU_GR_ZBC_H */
+
+/**
+ * @}
+ */
@@ -32,6 +32,9 @@
 #include <nvgpu/posix/posix-fault-injection.h>
 #include <os/posix/os_posix.h>
 #include <nvgpu/dma.h>
+#include <nvgpu/timers.h>
+#include <nvgpu/atomic.h>
+#include <nvgpu/posix/thread.h>
 
 /* for get_litter testing */
 #include "hal/init/hal_gv11b_litter.h"
@@ -808,6 +811,206 @@ int test_quiesce(struct unit_module *m, struct gk20a *g, void *args)
 	return ret;
 }
 
+/*
+ * Steps for the init table executor tests. Each step bumps a shared sequence
+ * counter when it starts and when it ends, so that the ordering between
+ * steps can be checked afterwards.
+ */
+#define INIT_EXEC_STEP_A	1U
+#define INIT_EXEC_STEP_B	2U
+
+static nvgpu_atomic_t init_exec_seq;
+static int init_exec_start[4];
+static int init_exec_end[4];
+
+static void init_exec_reset(void)
+{
+	nvgpu_atomic_set(&init_exec_seq, 0);
+	(void) memset(init_exec_start, 0, sizeof(init_exec_start));
+	(void) memset(init_exec_end, 0, sizeof(init_exec_end));
+}
+
+static int init_exec_step(u32 n, u32 delay_ms, int ret)
+{
+	init_exec_start[n] = nvgpu_atomic_inc_return(&init_exec_seq);
+	if (delay_ms != 0U) {
+		nvgpu_msleep(delay_ms);
+	}
+	init_exec_end[n] = nvgpu_atomic_inc_return(&init_exec_seq);
+
+	return ret;
+}
+
+static int init_exec_step0(struct gk20a *g)
+{
+	return init_exec_step(0U, 20U, 0);
+}
+
+static int init_exec_step1(struct gk20a *g)
+{
+	return init_exec_step(1U, 10U, 0);
+}
+
+static int init_exec_step2(struct gk20a *g)
+{
+	return init_exec_step(2U, 0U, 0);
+}
+
+static int init_exec_step3(struct gk20a *g)
+{
+	return init_exec_step(3U, 0U, 0);
+}
+
+static int init_exec_step1_fail(struct gk20a *g)
+{
+	return init_exec_step(1U, 10U, -EIO);
+}
+
+static int init_exec_step2_fail(struct gk20a *g)
+{
+	return init_exec_step(2U, 0U, -ENOMEM);
+}
+
+int test_init_run_table(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_posix_fault_inj *thread_fi =
+		nvgpu_thread_get_fault_injection();
+	struct nvgpu_init_profile *profile = NULL;
+	u32 saved_workers = g->init_workers;
+	u32 i;
+	int ret = UNIT_FAIL;
+	int err;
+	/*
+	 * step0 (sync), step1 (async, no deps), step2 (async, needs step1),
+	 * step3 (sync).
+	 */
+	struct nvgpu_init_table_t table[] = {
+		{ init_exec_step0, "step0", 0U, 0U, 0ULL, false },
+		{ init_exec_step1, "step1", 0U, INIT_EXEC_STEP_A, 0ULL, true },
+		{ init_exec_step2, "step2", 0U, INIT_EXEC_STEP_B,
+			BIT64(INIT_EXEC_STEP_A), true },
+		{ init_exec_step3, "step3", 0U, 0U, 0ULL, false },
+	};
+	/* async step depending on a later one */
+	struct nvgpu_init_table_t bad_table[] = {
+		{ init_exec_step1, "step1", 0U, 0U, BIT64(INIT_EXEC_STEP_A),
+			true },
+		{ init_exec_step0, "step0", 0U, INIT_EXEC_STEP_A, 0ULL, false },
+	};
+
+	profile = malloc(sizeof(*profile));
+	assert(profile != NULL);
+
+	/* invalid arguments */
+	err = nvgpu_init_run_table(g, table, ARRAY_SIZE(table), NULL);
+	assert(err == -EINVAL);
+	err = nvgpu_init_run_table(g, table,
+			NVGPU_INIT_TABLE_MAX_STEPS + 1U, profile);
+	assert(err == -EINVAL);
+	err = nvgpu_init_run_table(g, bad_table, ARRAY_SIZE(bad_table),
+			profile);
+	assert(err == -EINVAL);
+	assert(nvgpu_init_get_profile(g, NVGPU_INIT_STAGE_MAX) == NULL);
+
+	/* without workers steps run in table order on the calling thread */
+	g->init_workers = 0U;
+	init_exec_reset();
+	err = nvgpu_init_run_table(g, table, ARRAY_SIZE(table), profile);
+	assert(err == 0);
+	assert(profile->num_workers == 0U);
+	for (i = 0U; i < ARRAY_SIZE(table); i++) {
+		assert(init_exec_start[i] == (int)(2U * i + 1U));
+		assert(profile->steps[i].worker == 0U);
+		assert(!profile->steps[i].skipped);
+	}
+
+	/* with workers dependencies are still honoured */
+	g->init_workers = 2U;
+	init_exec_reset();
+	err = nvgpu_init_run_table(g, table, ARRAY_SIZE(table), profile);
+	assert(err == 0);
+	assert(profile->num_workers == 2U);
+	assert(profile->failed_step == ARRAY_SIZE(table));
+	assert(init_exec_start[2] > init_exec_end[1]);
+	for (i = 0U; i < 3U; i++) {
+		assert(init_exec_start[3] > init_exec_end[i]);
+		assert(profile->steps[i].duration_ns >= 0);
+	}
+	assert(profile->steps[0].worker == 0U);
+	assert(profile->steps[3].worker == 0U);
+	assert(profile->busy_ns >= profile->steps[0].duration_ns);
+	unit_info(m, "wall %lld ns, busy %lld ns\n",
+		(long long)profile->wall_ns, (long long)profile->busy_ns);
+
+	/*
+	 * step2 fails right away, step1 fails later. The error of step1 is
+	 * reported as in a serial run and step3 never runs.
+	 */
+	table[1].func = init_exec_step1_fail;
+	table[2].func = init_exec_step2_fail;
+	table[2].deps = 0ULL;
+	init_exec_reset();
+	err = nvgpu_init_run_table(g, table, ARRAY_SIZE(table), profile);
+	assert(err == -EIO);
+	assert(profile->failed_step == 1U);
+	assert(profile->steps[1].err == -EIO);
+	assert(profile->steps[3].skipped);
+	assert(init_exec_start[3] == 0);
+
+	/* workers failing to start fall back to the calling thread */
+	table[1].func = init_exec_step1;
+	table[2].func = init_exec_step2;
+	nvgpu_posix_enable_fault_injection(thread_fi, true, 0);
+	init_exec_reset();
+	err = nvgpu_init_run_table(g, table, ARRAY_SIZE(table), profile);
+	nvgpu_posix_enable_fault_injection(thread_fi, false, 0);
+	assert(err == 0);
+	assert(profile->num_workers == 0U);
+	assert(init_exec_end[3] == 8);
+
+	ret = UNIT_SUCCESS;
+fail:
+	g->init_workers = saved_workers;
+	free(profile);
+	return ret;
+}
+
+int test_poweron_parallel(struct unit_module *m, struct gk20a *g, void *args)
+{
+	const struct nvgpu_init_profile *profile;
+	u32 saved_workers = g->init_workers;
+	int ret = UNIT_FAIL;
+	int err;
+
+	g->init_workers = NVGPU_INIT_DEFAULT_WORKERS;
+
+	set_poweron_funcs_success(g);
+	nvgpu_set_power_state(g, NVGPU_STATE_POWERED_OFF);
+	err = nvgpu_finalize_poweron(g);
+	assert(err == 0);
+
+	profile = nvgpu_init_get_profile(g, NVGPU_INIT_STAGE_FINALIZE);
+	assert(profile != NULL);
+	assert(profile->num_steps > 0U);
+	assert(profile->failed_step == profile->num_steps);
+	assert(profile->wall_ns >= 0);
+
+	/* failing async step */
+	g->ops.mm.pd_cache_init = return_fail;
+	nvgpu_set_power_state(g, NVGPU_STATE_POWERED_OFF);
+	err = nvgpu_finalize_poweron(g);
+	assert(err != 0);
+	assert(profile->failed_step < profile->num_steps);
+	assert(strcmp(profile->steps[profile->failed_step].name,
+		"g->ops.mm.pd_cache_init") == 0);
+	g->ops.mm.pd_cache_init = return_success;
+
+	ret = UNIT_SUCCESS;
+fail:
+	g->init_workers = saved_workers;
+	return ret;
+}
+
 struct unit_module_test init_tests[] = {
 	UNIT_TEST(init_setup_env,			init_test_setup_env,	NULL, 0),
 	UNIT_TEST(get_litter_value,			test_get_litter_value,	NULL, 0),
@@ -819,6 +1022,8 @@ struct unit_module_test init_tests[] = {
 	UNIT_TEST(init_poweroff,			test_poweroff,		NULL, 2),
 	UNIT_TEST(init_check_gpu_state,			test_check_gpu_state,	NULL, 2),
 	UNIT_TEST(init_quiesce,				test_quiesce,		NULL, 2),
+	UNIT_TEST(init_run_table,			test_init_run_table,	NULL, 0),
+	UNIT_TEST(init_poweron_parallel,		test_poweron_parallel,	NULL, 2),
 	UNIT_TEST(init_free_env,			init_test_free_env,	NULL, 0),
 };
 
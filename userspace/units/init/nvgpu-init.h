@@ -339,4 +339,62 @@ int test_poweroff(struct unit_module *m, struct gk20a *g, void *args);
  */
 int test_quiesce(struct unit_module *m, struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_init_run_table
+ *
+ * Description: Test the init table executor used by nvgpu_early_poweron()
+ * and nvgpu_finalize_poweron().
+ *
+ * Test Type: Feature, Error injection
+ *
+ * Targets: nvgpu_init_run_table, nvgpu_init_get_profile
+ *
+ * Input:
+ * - init_test_setup_env() must be called before.
+ *
+ * Steps:
+ * - Call nvgpu_init_run_table() with a NULL profile, too many steps and an
+ *   async step depending on a later step, verify -EINVAL is returned.
+ * - Verify nvgpu_init_get_profile() returns NULL for an invalid stage.
+ * - Run a table of two synchronous and two async steps without workers and
+ *   verify the steps run in table order on the calling thread.
+ * - Run the same table with two workers and verify that dependencies and
+ *   synchronous step ordering are honoured.
+ * - Make both async steps fail, the later one first, and verify the error of
+ *   the earlier one is returned and the last step never runs.
+ * - Inject a thread creation failure and verify the table still runs to
+ *   completion on the calling thread.
+ *
+ * Output:
+ * - UNIT_FAIL if any of the checks above fails.
+ * - UNIT_SUCCESS otherwise
+ */
+int test_init_run_table(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_poweron_parallel
+ *
+ * Description: Test nvgpu_finalize_poweron with init worker threads.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_finalize_poweron, nvgpu_init_get_profile
+ *
+ * Input:
+ * - init_test_setup_env() must be called before.
+ *
+ * Steps:
+ * - Set init workers and setup poweron init function pointers.
+ * - Call nvgpu_finalize_poweron() and verify it succeeds and that the
+ *   finalize init profile is filled in.
+ * - Make the async pd_cache_init step fail, verify nvgpu_finalize_poweron()
+ *   fails and the profile points at the failing step.
+ *
+ * Output:
+ * - UNIT_FAIL if nvgpu_finalize_poweron() returns the unexpected value or
+ *   the profile is wrong.
+ * - UNIT_SUCCESS otherwise
+ */
+int test_poweron_parallel(struct unit_module *m, struct gk20a *g, void *args);
+
 #endif /* UNIT_NVGPU_INIT_H */
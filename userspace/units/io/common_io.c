@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2020-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -20,6 +20,11 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 #include <unit/io.h>
 #include <unit/unit.h>
 
@@ -33,16 +38,20 @@
 #define USER_MODE_BASE (0x00810000U)
 #define NVGPU_READ_VAL (0xD007U)
 
+static u32 read_val = NVGPU_READ_VAL;
+
 static void readl_access_reg_fn(struct gk20a *g,
 	struct nvgpu_reg_access *access)
 {
-	access->value = NVGPU_READ_VAL;
+	access->value = read_val;
 }
 
+static struct nvgpu_reg_access last_write;
+
 static void writel_access_reg_fn(struct gk20a *g,
 	struct nvgpu_reg_access *access)
 {
-
+	last_write = *access;
 }
 
 static struct nvgpu_posix_io_callbacks ut_common_io_reg_callbacks = {
@@ -65,8 +74,288 @@ int test_writel_check(struct unit_module *m, struct gk20a *g, void *args)
 	return UNIT_SUCCESS;
 }
 
+int test_writel_batch(struct unit_module *m, struct gk20a *g, void *args)
+{
+	/* addr, unused, value */
+	const u32 table[] = {
+		USER_MODE_BASE,		0xdeadU,	0x1U,
+		USER_MODE_BASE + 0x4U,	0xdeadU,	0x2U,
+		USER_MODE_BASE + 0x8U,	0xdeadU,	0x3U,
+	};
+	const u32 bad_table[] = {
+		USER_MODE_BASE + 0x2U,	0xdeadU,	0x1U,
+	};
+	struct nvgpu_reg_batch batch = {
+		.table = table,
+		.count = 3U,
+		.stride = 3U,
+		.value = 2U,
+	};
+	struct nvgpu_reg_batch_stats before, after;
+	struct nvgpu_posix_io_stats io;
+
+	nvgpu_posix_register_io(g, &ut_common_io_reg_callbacks);
+
+	if (nvgpu_reg_batch_validate(g, &batch) != 0) {
+		unit_return_fail(m, "valid batch rejected\n");
+	}
+
+	batch.value = 3U;
+	if (nvgpu_reg_batch_validate(g, &batch) == 0) {
+		unit_return_fail(m, "value index outside entry accepted\n");
+	}
+	batch.value = 2U;
+
+	batch.table = bad_table;
+	batch.count = 1U;
+	if (nvgpu_reg_batch_validate(g, &batch) == 0) {
+		unit_return_fail(m, "unaligned register accepted\n");
+	}
+	batch.table = table;
+	batch.count = 3U;
+
+	nvgpu_reg_batch_get_stats(g, &before);
+	nvgpu_posix_io_reset_stats(g);
+
+	nvgpu_writel_batch(g, &batch);
+
+	nvgpu_posix_io_get_stats(g, &io);
+	if ((io.writes != 3ULL) || (io.relaxed_writes != 3ULL) ||
+			(io.reads != 0ULL)) {
+		unit_return_fail(m, "unexpected accesses: w=%llu r=%llu\n",
+			io.writes, io.reads);
+	}
+
+	if ((last_write.addr != USER_MODE_BASE + 0x8U) ||
+			(last_write.value != 0x3U)) {
+		unit_return_fail(m, "batch written out of order\n");
+	}
+
+	nvgpu_reg_batch_get_stats(g, &after);
+	if ((after.batches != before.batches + 1ULL) ||
+			(after.writes != before.writes + 3ULL)) {
+		unit_return_fail(m, "batch stats not updated\n");
+	}
+
+	/* An empty batch writes nothing and is not counted. */
+	batch.count = 0U;
+	nvgpu_posix_io_reset_stats(g);
+	nvgpu_writel_batch(g, &batch);
+	nvgpu_posix_io_get_stats(g, &io);
+	nvgpu_reg_batch_get_stats(g, &before);
+	if ((io.writes != 0ULL) || (before.batches != after.batches)) {
+		unit_return_fail(m, "empty batch wrote registers\n");
+	}
+
+	return UNIT_SUCCESS;
+}
+
+#define LOOKUP_BASE	(0x10000U)
+#define LOOKUP_SIZE	(0x4000U)
+#define LOOKUP_INNER	(0x11800U)
+
+static int check_lookup(struct unit_module *m, struct gk20a *g, u32 addr,
+		u32 base, u64 walks)
+{
+	struct nvgpu_posix_io_reg_space *space;
+	struct nvgpu_posix_io_stats io;
+
+	nvgpu_posix_io_reset_stats(g);
+	space = nvgpu_posix_io_get_reg_space(g, addr);
+	nvgpu_posix_io_get_stats(g, &io);
+
+	if (space == NULL || space->base != base) {
+		unit_err(m, "0x%x: wrong register space\n", addr);
+		return UNIT_FAIL;
+	}
+	if (io.reg_space_walks != walks) {
+		unit_err(m, "0x%x: %llu list walks, expected %llu\n", addr,
+			io.reg_space_walks, walks);
+		return UNIT_FAIL;
+	}
+
+	return UNIT_SUCCESS;
+}
+
+int test_reg_space_lookup(struct unit_module *m, struct gk20a *g, void *args)
+{
+	int ret = UNIT_FAIL;
+
+	if (nvgpu_posix_io_add_reg_space(g, LOOKUP_BASE, LOOKUP_SIZE) != 0) {
+		unit_return_fail(m, "failed to add register space\n");
+	}
+	/* Added last, so it takes precedence within the outer space. */
+	if (nvgpu_posix_io_add_reg_space(g, LOOKUP_INNER, 0x100U) != 0) {
+		nvgpu_posix_io_delete_reg_space(g, LOOKUP_BASE);
+		unit_return_fail(m, "failed to add register space\n");
+	}
+
+	/* First lookup of a page walks the list, the next ones do not. */
+	if (check_lookup(m, g, LOOKUP_BASE + 0x4U, LOOKUP_BASE, 1ULL) != 0 ||
+	    check_lookup(m, g, LOOKUP_BASE + 0x8U, LOOKUP_BASE, 0ULL) != 0 ||
+	    check_lookup(m, g, LOOKUP_BASE + 0xffcU, LOOKUP_BASE, 0ULL) != 0) {
+		goto out;
+	}
+
+	/* The inner space wins over the outer one. */
+	if (check_lookup(m, g, LOOKUP_INNER + 0x50U, LOOKUP_INNER, 1ULL) != 0 ||
+	    check_lookup(m, g, LOOKUP_INNER + 0x54U, LOOKUP_INNER, 0ULL) != 0) {
+		goto out;
+	}
+
+	/*
+	 * The outer space is shadowed in the inner space's page, so its
+	 * addresses there are never cached.
+	 */
+	if (check_lookup(m, g, LOOKUP_INNER - 0x4U, LOOKUP_BASE, 1ULL) != 0 ||
+	    check_lookup(m, g, LOOKUP_INNER - 0x4U, LOOKUP_BASE, 1ULL) != 0) {
+		goto out;
+	}
+
+	/* Removing a space drops its cached pages. */
+	nvgpu_posix_io_delete_reg_space(g, LOOKUP_INNER);
+	if (check_lookup(m, g, LOOKUP_INNER + 0x50U, LOOKUP_BASE, 1ULL) != 0) {
+		goto out;
+	}
+
+	nvgpu_posix_io_delete_reg_space(g, LOOKUP_BASE);
+	if (nvgpu_posix_io_get_reg_space(g, LOOKUP_BASE + 0x4U) != NULL) {
+		unit_return_fail(m, "deleted register space still found\n");
+	}
+	nvgpu_posix_io_reset_error_code(g);
+
+	return UNIT_SUCCESS;
+
+out:
+	nvgpu_posix_io_delete_reg_space(g, LOOKUP_INNER);
+	nvgpu_posix_io_delete_reg_space(g, LOOKUP_BASE);
+	return ret;
+}
+
+static int check_trace(struct unit_module *m, struct gk20a *g)
+{
+	const struct nvgpu_posix_io_trace_entry *e;
+	const char *callsite;
+	u64 count;
+
+	e = nvgpu_posix_io_trace_entries(g, &count);
+	if (e == NULL || count != 2ULL) {
+		unit_err(m, "%llu accesses recorded\n", count);
+		return UNIT_FAIL;
+	}
+
+	if (e[0].dir != NVGPU_POSIX_IO_TRACE_WRITE ||
+	    e[0].aperture != NVGPU_POSIX_REG_BAR0 ||
+	    e[0].addr != USER_MODE_BASE || e[0].value != 0x5U ||
+	    e[1].dir != NVGPU_POSIX_IO_TRACE_READ ||
+	    e[1].addr != USER_MODE_BASE + 0x4U ||
+	    e[1].value != NVGPU_READ_VAL) {
+		unit_err(m, "wrong accesses recorded\n");
+		return UNIT_FAIL;
+	}
+
+	callsite = nvgpu_posix_io_trace_callsite(g, e[0].callsite);
+	if (callsite == NULL || strcmp(callsite, "test_io_trace") != 0 ||
+	    e[1].callsite != e[0].callsite) {
+		unit_err(m, "wrong callsite %s\n",
+			callsite != NULL ? callsite : "(null)");
+		return UNIT_FAIL;
+	}
+
+	return UNIT_SUCCESS;
+}
+
+int test_io_trace(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_posix_io_trace_replay_stats stats;
+	char path[] = "/tmp/nvgpu-io-trace-XXXXXX";
+	const u32 bad_magic = 0U;
+	int ret = UNIT_FAIL;
+	FILE *f;
+	int fd;
+
+	nvgpu_posix_register_io(g, &ut_common_io_reg_callbacks);
+
+	fd = mkstemp(path);
+	if (fd < 0) {
+		unit_return_fail(m, "failed to create trace file\n");
+	}
+	(void) close(fd);
+
+	if (nvgpu_posix_io_trace_start(g) != 0) {
+		unit_err(m, "failed to start trace\n");
+		goto out;
+	}
+	nvgpu_writel(g, USER_MODE_BASE, 0x5U);
+	(void) nvgpu_readl(g, USER_MODE_BASE + 0x4U);
+	nvgpu_posix_io_trace_stop(g);
+	/* Not recorded. */
+	nvgpu_writel(g, USER_MODE_BASE + 0x8U, 0x6U);
+
+	if (check_trace(m, g) != UNIT_SUCCESS) {
+		goto out;
+	}
+
+	if (nvgpu_posix_io_trace_save(g, path) != 0) {
+		unit_err(m, "failed to save trace\n");
+		goto out;
+	}
+	/* Drop the recorded trace; the loaded one must be identical. */
+	if (nvgpu_posix_io_trace_start(g) != 0 ||
+	    nvgpu_posix_io_trace_load(g, path) != 0 ||
+	    check_trace(m, g) != UNIT_SUCCESS) {
+		unit_err(m, "trace not loaded back\n");
+		goto out;
+	}
+
+	(void) memset(&last_write, 0, sizeof(last_write));
+	if (nvgpu_posix_io_trace_replay(g, &stats) != 0 ||
+	    stats.writes != 1ULL || stats.reads != 1ULL ||
+	    stats.read_mismatches != 0ULL) {
+		unit_err(m, "replay failed\n");
+		goto out;
+	}
+	if (last_write.addr != USER_MODE_BASE || last_write.value != 0x5U) {
+		unit_err(m, "replay did not write the recorded value\n");
+		goto out;
+	}
+
+	/* A read returning a different value is reported. */
+	read_val = NVGPU_READ_VAL + 1U;
+	(void) nvgpu_posix_io_trace_replay(g, &stats);
+	read_val = NVGPU_READ_VAL;
+	if (stats.read_mismatches != 1ULL) {
+		unit_err(m, "read mismatch not reported\n");
+		goto out;
+	}
+
+	/* A file which is not a trace is rejected and keeps the trace. */
+	f = fopen(path, "r+b");
+	if (f == NULL || fwrite(&bad_magic, sizeof(bad_magic), 1, f) != 1U) {
+		unit_err(m, "failed to corrupt trace file\n");
+		if (f != NULL) {
+			(void) fclose(f);
+		}
+		goto out;
+	}
+	(void) fclose(f);
+	if (nvgpu_posix_io_trace_load(g, path) != -EINVAL ||
+	    check_trace(m, g) != UNIT_SUCCESS) {
+		unit_err(m, "invalid trace file accepted\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	(void) unlink(path);
+	return ret;
+}
+
 struct unit_module_test io_tests[] = {
 	UNIT_TEST(writel_check, test_writel_check, NULL, 0),
+	UNIT_TEST(writel_batch, test_writel_batch, NULL, 0),
+	UNIT_TEST(reg_space_lookup, test_reg_space_lookup, NULL, 0),
+	UNIT_TEST(io_trace, test_io_trace, NULL, 0),
 };
 
 UNIT_MODULE(io, io_tests, UNIT_PRIO_NVGPU_TEST);
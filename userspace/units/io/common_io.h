@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2020-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -55,4 +55,93 @@
  */
 int test_writel_check(struct unit_module *m, struct gk20a *g, void *args);
 
+/**
+ * Test specification for test_writel_batch
+ *
+ * Description: Validate and write a register batch.
+ *
+ * Test Type: Feature, Error injection
+ *
+ * Targets: nvgpu_reg_batch_validate, nvgpu_writel_batch,
+ *          nvgpu_reg_batch_get_stats
+ *
+ * Inputs: None
+ *
+ * Steps:
+ * - Register io callbacks which record the last register write.
+ * - Validate a three entry batch with a three word stride; check it passes.
+ * - Validate the batch with a value index outside of the entry and with an
+ *   unaligned register offset; check both are rejected.
+ * - Write the batch. Check the posix io counters report three relaxed
+ *   writes and no reads, that the last write is the last table entry and
+ *   that the batch statistics were updated.
+ * - Write an empty batch; check no register is written and the statistics
+ *   are unchanged.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_writel_batch(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for test_reg_space_lookup
+ *
+ * Description: Look up overlapping register spaces through the page cache.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_posix_io_get_reg_space, nvgpu_posix_io_add_reg_space,
+ *          nvgpu_posix_io_delete_reg_space
+ *
+ * Inputs: None
+ *
+ * Steps:
+ * - Add an outer register space and a smaller inner one inside it.
+ * - Look up addresses of the outer space. Check only the first lookup of the
+ *   page walks the register space list.
+ * - Look up addresses of the inner space. Check the inner space is returned
+ *   and only the first lookup walks the list.
+ * - Look up an outer space address in the page of the inner space twice.
+ *   Check the outer space is returned and both lookups walk the list.
+ * - Delete the inner space. Check its addresses now map to the outer space.
+ * - Delete the outer space. Check the lookup fails.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_reg_space_lookup(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for test_io_trace
+ *
+ * Description: Record, save, load and replay a register access trace.
+ *
+ * Test Type: Feature, Error injection
+ *
+ * Targets: nvgpu_posix_io_trace_start, nvgpu_posix_io_trace_stop,
+ *          nvgpu_posix_io_trace_entries, nvgpu_posix_io_trace_callsite,
+ *          nvgpu_posix_io_trace_save, nvgpu_posix_io_trace_load,
+ *          nvgpu_posix_io_trace_replay
+ *
+ * Inputs: None
+ *
+ * Steps:
+ * - Start a trace, write and read a register and stop the trace. Write
+ *   another register.
+ * - Check the trace holds the write and the read with their values and
+ *   that both are attributed to this test function.
+ * - Save the trace to a file, start a new trace and load the file. Check
+ *   the loaded trace is identical.
+ * - Replay the trace. Check one write and one matching read are issued and
+ *   that the recorded value was written.
+ * - Replay the trace with the read callback returning a different value.
+ *   Check the read mismatch is reported.
+ * - Corrupt the magic of the file and load it. Check -EINVAL is returned
+ *   and the trace is unchanged.
+ *
+ * Output: Returns PASS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_io_trace(struct unit_module *m, struct gk20a *g, void *args);
+
 #endif /* __UNIT_COMMON_IO_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -31,6 +31,8 @@
 #include <nvgpu/gk20a.h>
 #include <nvgpu/sizes.h>
 #include <nvgpu/dma.h>
+#include <nvgpu/string.h>
+#include <nvgpu/ce_app.h>
 #include <nvgpu/posix/io.h>
 #include <nvgpu/posix/posix-fault-injection.h>
 #include <os/posix/os_posix.h>
@@ -546,6 +548,437 @@ return_fail:
 /*
  * Test: test_nvgpu_mem_phys_ops
  */
+/* Size of the buffers used by the nvgpu_mem_ops_submit() tests */
+#define OPS_BUF_SIZE	(8U * SZ_4K)
+#define OPS_BUF_WORDS	(OPS_BUF_SIZE / (u32)sizeof(u32))
+
+static int alloc_ops_sysmem(struct gk20a *g, struct nvgpu_mem *mem)
+{
+	(void) memset(mem, 0, sizeof(*mem));
+	mem->cpu_va = nvgpu_kzalloc(g, OPS_BUF_SIZE);
+	if (mem->cpu_va == NULL) {
+		return -ENOMEM;
+	}
+	mem->aperture = APERTURE_SYSMEM;
+	mem->size = OPS_BUF_SIZE;
+	mem->aligned_size = OPS_BUF_SIZE;
+
+	return 0;
+}
+
+static void fill_pattern(u32 *buf, u32 words, u32 seed)
+{
+	u32 i;
+
+	for (i = 0U; i < words; i++) {
+		buf[i] = seed + (i * 0x01010101U);
+	}
+}
+
+int test_nvgpu_mem_copy_sysmem(struct unit_module *m,
+					struct gk20a *g, void *args)
+{
+	struct nvgpu_mem src, dst;
+	struct nvgpu_mem_op ops[8];
+	u32 *src_va, *dst_va;
+	u32 i;
+	int ret = UNIT_FAIL;
+
+	if (alloc_ops_sysmem(g, &src) != 0) {
+		unit_return_fail(m, "src alloc failed\n");
+	}
+	if (alloc_ops_sysmem(g, &dst) != 0) {
+		nvgpu_kfree(g, src.cpu_va);
+		unit_return_fail(m, "dst alloc failed\n");
+	}
+	src_va = src.cpu_va;
+	dst_va = dst.cpu_va;
+	fill_pattern(src_va, OPS_BUF_WORDS, 0x1000U);
+
+	/* Plain copy */
+	if ((nvgpu_mem_copy(g, &dst, 0x100, &src, 0x200, 0x400) != 0) ||
+	    (memcmp(dst_va + 0x40, src_va + 0x80, 0x400) != 0) ||
+	    (dst_va[0x3f] != 0U) || (dst_va[0x140] != 0U)) {
+		unit_err(m, "sysmem copy failed\n");
+		goto done;
+	}
+
+	/* Adjacent copies and fills, merged into one of each */
+	for (i = 0U; i < 4U; i++) {
+		ops[i].type = NVGPU_MEM_OP_COPY;
+		ops[i].dst = &dst;
+		ops[i].dst_offset = 0x1000 + (i * 0x100);
+		ops[i].src = &src;
+		ops[i].src_offset = 0x2000 + (i * 0x100);
+		ops[i].c = 0U;
+		ops[i].size = 0x100;
+
+		ops[i + 4U].type = NVGPU_MEM_OP_FILL;
+		ops[i + 4U].dst = &dst;
+		ops[i + 4U].dst_offset = 0x3000 + (i * 0x100);
+		ops[i + 4U].src = NULL;
+		ops[i + 4U].src_offset = 0;
+		ops[i + 4U].c = 0xa5U;
+		ops[i + 4U].size = 0x100;
+	}
+	if ((nvgpu_mem_ops_submit(g, ops, 8U) != 0) ||
+	    (memcmp(dst_va + 0x400, src_va + 0x800, 0x400) != 0)) {
+		unit_err(m, "vectored sysmem copy failed\n");
+		goto done;
+	}
+	for (i = 0xc00U; i < 0xd00U; i++) {
+		if (dst_va[i] != 0xa5a5a5a5U) {
+			unit_err(m, "vectored sysmem fill failed at %u\n", i);
+			goto done;
+		}
+	}
+
+	/*
+	 * Copies chained within one buffer run in order: the second copy
+	 * reads what the first one wrote, so they must not be merged.
+	 */
+	fill_pattern(dst_va, OPS_BUF_WORDS, 0x2000U);
+	for (i = 0U; i < 2U; i++) {
+		ops[i].type = NVGPU_MEM_OP_COPY;
+		ops[i].dst = &dst;
+		ops[i].dst_offset = 0x40 + (i * 0x40);
+		ops[i].src = &dst;
+		ops[i].src_offset = i * 0x40;
+		ops[i].size = 0x40;
+	}
+	if ((nvgpu_mem_ops_submit(g, ops, 2U) != 0) ||
+	    (memcmp(dst_va + 0x10, dst_va, 0x40) != 0) ||
+	    (memcmp(dst_va + 0x20, dst_va, 0x40) != 0)) {
+		unit_err(m, "chained sysmem copy failed\n");
+		goto done;
+	}
+
+	/* Nothing to do */
+	if ((nvgpu_mem_ops_submit(g, NULL, 0U) != 0) ||
+	    (nvgpu_mem_copy(g, &dst, 0, &src, 0, 0) != 0)) {
+		unit_err(m, "empty submit failed\n");
+		goto done;
+	}
+
+	/* Bad operations are rejected before anything runs */
+	fill_pattern(dst_va, OPS_BUF_WORDS, 0x3000U);
+	if ((nvgpu_mem_copy(g, &dst, 2, &src, 0, 0x40) != -EINVAL) ||
+	    (nvgpu_mem_copy(g, &dst, 0, &src, 0, 0x42) != -EINVAL) ||
+	    (nvgpu_mem_copy(g, &dst, OPS_BUF_SIZE - 0x40, &src, 0,
+			0x80) != -EINVAL) ||
+	    (nvgpu_mem_copy(g, &dst, 0, &src, OPS_BUF_SIZE + 0x40,
+			0x40) != -EINVAL) ||
+	    (nvgpu_mem_copy(g, &dst, 0x20, &dst, 0, 0x40) != -EINVAL) ||
+	    (nvgpu_mem_copy(g, &dst, 0, NULL, 0, 0x40) != -EINVAL) ||
+	    (nvgpu_mem_copy(g, NULL, 0, &src, 0, 0x40) != -EINVAL)) {
+		unit_err(m, "bad copy accepted\n");
+		goto done;
+	}
+
+	ops[0].type = NVGPU_MEM_OP_COPY;
+	ops[0].dst = &dst;
+	ops[0].dst_offset = 0;
+	ops[0].src = &src;
+	ops[0].src_offset = 0;
+	ops[0].size = 0x40;
+	ops[1].type = NVGPU_MEM_OP_FILL;
+	ops[1].dst = &dst;
+	ops[1].dst_offset = 0x40;
+	ops[1].c = 0x100U;
+	ops[1].size = 0x40;
+	if (nvgpu_mem_ops_submit(g, ops, 2U) != -EINVAL) {
+		unit_err(m, "bad fill value accepted\n");
+		goto done;
+	}
+
+	src.aperture = APERTURE_INVALID;
+	if (nvgpu_mem_copy(g, &dst, 0, &src, 0, 0x40) != -EINVAL) {
+		unit_err(m, "invalid aperture accepted\n");
+		goto done;
+	}
+	src.aperture = APERTURE_SYSMEM;
+
+	if (dst_va[0] != 0x3000U) {
+		unit_err(m, "rejected operations were run\n");
+		goto done;
+	}
+
+	ret = UNIT_SUCCESS;
+done:
+	nvgpu_kfree(g, dst.cpu_va);
+	nvgpu_kfree(g, src.cpu_va);
+	return ret;
+}
+
+#ifdef CONFIG_NVGPU_DGPU
+/* Backing store of the vidmem buffers of test_nvgpu_mem_copy_vidmem() */
+static u32 *ops_vidmem;
+#define OPS_VIDMEM_SIZE	SZ_1M
+
+static bool ops_vidmem_range(u32 addr)
+{
+	return (addr >= pram_data032_r(0)) &&
+		(addr < (pram_data032_r(0) + SZ_1M));
+}
+
+/* Vidmem word behind a PRAMIN register, all buffers sit in window 0 */
+static u32 *ops_vidmem_word(struct gk20a *g, u32 addr)
+{
+	u32 base = g->mm.pramin_window <<
+		bus_bar0_window_target_bar0_window_base_shift_v();
+
+	return &ops_vidmem[(base + addr - pram_data032_r(0)) / sizeof(u32)];
+}
+
+static void ops_writel_access_reg_fn(struct gk20a *g,
+			     struct nvgpu_reg_access *access)
+{
+	if (ops_vidmem_range(access->addr)) {
+		*ops_vidmem_word(g, access->addr) = access->value;
+	} else {
+		nvgpu_posix_io_writel_reg_space(g, access->addr, access->value);
+	}
+}
+
+static void ops_readl_access_reg_fn(struct gk20a *g,
+			    struct nvgpu_reg_access *access)
+{
+	if (ops_vidmem_range(access->addr)) {
+		access->value = *ops_vidmem_word(g, access->addr);
+	} else {
+		access->value = nvgpu_posix_io_readl_reg_space(g, access->addr);
+	}
+}
+
+/* PRAMIN callbacks backed by ops_vidmem */
+static struct nvgpu_posix_io_callbacks ops_pramin_callbacks = {
+	.writel          = ops_writel_access_reg_fn,
+	.writel_check    = ops_writel_access_reg_fn,
+	.bar1_writel     = ops_writel_access_reg_fn,
+	.usermode_writel = ops_writel_access_reg_fn,
+
+	.__readl         = ops_readl_access_reg_fn,
+	.readl           = ops_readl_access_reg_fn,
+	.bar1_readl      = ops_readl_access_reg_fn,
+};
+
+/*
+ * Build a vidmem buffer of OPS_BUF_SIZE bytes from two chunks of the
+ * backing store at the given addresses.
+ */
+static int alloc_ops_vidmem(struct gk20a *g, struct nvgpu_mem *mem,
+		u64 phys0, u64 phys1)
+{
+	struct nvgpu_mem_sgl *sgl;
+	struct nvgpu_sgt *sgt;
+
+	(void) memset(mem, 0, sizeof(*mem));
+	mem->vidmem_alloc = nvgpu_kzalloc(g, sizeof(struct nvgpu_page_alloc));
+	sgl = nvgpu_kzalloc(g, 2U * sizeof(struct nvgpu_mem_sgl));
+	sgt = nvgpu_sgt_create_from_mem(g, mem);
+	if ((mem->vidmem_alloc == NULL) || (sgl == NULL) || (sgt == NULL)) {
+		nvgpu_sgt_free(g, sgt);
+		nvgpu_kfree(g, sgl);
+		nvgpu_kfree(g, mem->vidmem_alloc);
+		return -ENOMEM;
+	}
+
+	sgl[0].next = &sgl[1];
+	sgl[0].phys = phys0;
+	sgl[0].length = OPS_BUF_SIZE / 2U;
+	sgl[1].phys = phys1;
+	sgl[1].length = OPS_BUF_SIZE / 2U;
+	mem->vidmem_alloc->sgt.ops = sgt->ops;
+	mem->vidmem_alloc->sgt.sgl = (void *)sgl;
+	nvgpu_sgt_free(g, sgt);
+
+	mem->aperture = APERTURE_VIDMEM;
+	mem->size = OPS_BUF_SIZE;
+	mem->aligned_size = OPS_BUF_SIZE;
+
+	return 0;
+}
+
+static void free_ops_vidmem(struct gk20a *g, struct nvgpu_mem *mem)
+{
+	nvgpu_kfree(g, mem->vidmem_alloc->sgt.sgl);
+	nvgpu_kfree(g, mem->vidmem_alloc);
+}
+
+/* Byte offset of a vidmem buffer in the backing store */
+static u32 *ops_vidmem_at(struct nvgpu_mem *mem, u64 offset)
+{
+	struct nvgpu_mem_sgl *sgl = mem->vidmem_alloc->sgt.sgl;
+
+	if (offset >= sgl->length) {
+		offset -= sgl->length;
+		sgl = sgl->next;
+	}
+
+	return &ops_vidmem[(sgl->phys + offset) / sizeof(u32)];
+}
+
+/* Compare a vidmem range, possibly split across chunks, with a buffer */
+static bool ops_vidmem_equal(struct nvgpu_mem *mem, u64 offset,
+		const u32 *data, u64 size)
+{
+	u64 i;
+
+	for (i = 0ULL; i < size; i += sizeof(u32)) {
+		if (*ops_vidmem_at(mem, offset + i) != data[i / sizeof(u32)]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static u64 pramin_accesses(struct gk20a *g)
+{
+	struct nvgpu_pramin_stats stats;
+
+	nvgpu_pramin_get_stats(g, &stats);
+
+	return stats.hits + stats.misses;
+}
+
+int test_nvgpu_mem_copy_vidmem(struct unit_module *m,
+					struct gk20a *g, void *args)
+{
+	struct nvgpu_mem sys, vid0, vid1;
+	struct nvgpu_mem_op ops[4];
+	u32 *sys_va, *ref = NULL;
+	u64 accesses;
+	u32 arch, impl, i;
+	int ret = UNIT_FAIL;
+
+	ops_vidmem = (u32 *) calloc(1, OPS_VIDMEM_SIZE);
+	if (ops_vidmem == NULL) {
+		unit_return_fail(m, "vidmem alloc failed\n");
+	}
+
+	nvgpu_init_pramin(&g->mm);
+	nvgpu_posix_register_io(g, &ops_pramin_callbacks);
+	g->ops.bus.set_bar0_window = gk20a_bus_set_bar0_window;
+	/* Any GPU with the gk20a PRAMIN layout */
+	arch = g->params.gpu_arch;
+	impl = g->params.gpu_impl;
+	g->params.gpu_arch = NVGPU_GPUID_GP10B;
+	g->params.gpu_impl = 0U;
+	nvgpu_pramin_ops_init(g);
+	g->params.gpu_arch = arch;
+	g->params.gpu_impl = impl;
+	if (g->ops.pramin.data032_r == NULL) {
+		free(ops_vidmem);
+		unit_return_fail(m, "no PRAMIN HAL\n");
+	}
+	if (nvgpu_posix_io_add_reg_space(g, bus_bar0_window_r(), 0x100) != 0) {
+		free(ops_vidmem);
+		unit_return_fail(m, "reg space alloc failed\n");
+	}
+	/* No copy engine on posix, everything goes through PRAMIN */
+	g->mm.vidmem.ce_ctx_id = NVGPU_CE_INVAL_CTX_ID;
+
+	if (alloc_ops_sysmem(g, &sys) != 0) {
+		goto free_env;
+	}
+	if (alloc_ops_vidmem(g, &vid0, 0x10000, 0x30000) != 0) {
+		goto free_sys;
+	}
+	if (alloc_ops_vidmem(g, &vid1, 0x80000, 0x20000) != 0) {
+		goto free_vid0;
+	}
+	ref = nvgpu_kzalloc(g, OPS_BUF_SIZE);
+	if (ref == NULL) {
+		goto free_vid1;
+	}
+	sys_va = sys.cpu_va;
+	fill_pattern(sys_va, OPS_BUF_WORDS, 0x4000U);
+	nvgpu_memcpy((u8 *)ref, (u8 *)sys_va, OPS_BUF_SIZE);
+
+	/* sysmem to vidmem, across both chunks */
+	if ((nvgpu_mem_copy(g, &vid0, 0, &sys, 0, OPS_BUF_SIZE) != 0) ||
+	    !ops_vidmem_equal(&vid0, 0, ref, OPS_BUF_SIZE)) {
+		unit_err(m, "sysmem to vidmem copy failed\n");
+		goto free_ref;
+	}
+
+	/* vidmem to vidmem, through the bounce buffer */
+	if ((nvgpu_mem_copy(g, &vid1, 0, &vid0, 0, OPS_BUF_SIZE) != 0) ||
+	    !ops_vidmem_equal(&vid1, 0, ref, OPS_BUF_SIZE)) {
+		unit_err(m, "vidmem to vidmem copy failed\n");
+		goto free_ref;
+	}
+
+	/* vidmem to sysmem */
+	(void) memset(sys_va, 0, OPS_BUF_SIZE);
+	if ((nvgpu_mem_copy(g, &sys, 0x100, &vid1, 0x3f00, 0x200) != 0) ||
+	    (memcmp(sys_va + 0x40, ref + 0xfc0, 0x200) != 0) ||
+	    (sys_va[0x3f] != 0U) || (sys_va[0xc0] != 0U)) {
+		unit_err(m, "vidmem to sysmem copy failed\n");
+		goto free_ref;
+	}
+
+	/* vidmem fill, in place of part of the data */
+	for (i = 0x400U; i < 0x500U; i++) {
+		ref[i] = 0x5a5a5a5aU;
+	}
+	ops[0].type = NVGPU_MEM_OP_FILL;
+	ops[0].dst = &vid1;
+	ops[0].dst_offset = 0x1000;
+	ops[0].src = NULL;
+	ops[0].src_offset = 0;
+	ops[0].c = 0x5aU;
+	ops[0].size = 0x400;
+	if ((nvgpu_mem_ops_submit(g, ops, 1U) != 0) ||
+	    !ops_vidmem_equal(&vid1, 0, ref, OPS_BUF_SIZE)) {
+		unit_err(m, "vidmem fill failed\n");
+		goto free_ref;
+	}
+
+	/* Adjacent sysmem to vidmem copies take a single PRAMIN pass */
+	fill_pattern(sys_va, OPS_BUF_WORDS, 0x5000U);
+	for (i = 0U; i < 4U; i++) {
+		ops[i].type = NVGPU_MEM_OP_COPY;
+		ops[i].dst = &vid0;
+		ops[i].dst_offset = 0x800 + (i * 0x80);
+		ops[i].src = &sys;
+		ops[i].src_offset = i * 0x80;
+		ops[i].c = 0U;
+		ops[i].size = 0x80;
+	}
+	accesses = pramin_accesses(g);
+	if ((nvgpu_mem_ops_submit(g, ops, 4U) != 0) ||
+	    !ops_vidmem_equal(&vid0, 0x800, sys_va, 0x200) ||
+	    (pramin_accesses(g) != accesses + 1U)) {
+		unit_err(m, "vectored vidmem copy not merged\n");
+		goto free_ref;
+	}
+
+	/* Vidmem buffer without backing pages is rejected */
+	sys.aperture = APERTURE_VIDMEM;
+	if (nvgpu_mem_copy(g, &vid1, 0, &sys, 0, 0x40) != -EINVAL) {
+		unit_err(m, "vidmem buffer without pages accepted\n");
+		goto free_ref;
+	}
+	sys.aperture = APERTURE_SYSMEM;
+
+	ret = UNIT_SUCCESS;
+free_ref:
+	nvgpu_kfree(g, ref);
+free_vid1:
+	free_ops_vidmem(g, &vid1);
+free_vid0:
+	free_ops_vidmem(g, &vid0);
+free_sys:
+	nvgpu_kfree(g, sys.cpu_va);
+free_env:
+	nvgpu_posix_io_delete_reg_space(g, bus_bar0_window_r());
+	free(ops_vidmem);
+	return ret;
+}
+#endif
+
 int test_nvgpu_mem_phys_ops(struct unit_module *m,
 					struct gk20a *g, void *args)
 {
@@ -714,6 +1147,7 @@ struct unit_module_test nvgpu_mem_tests[] = {
 	UNIT_TEST(nvgpu_mem_phys_ops,	test_nvgpu_mem_phys_ops,	NULL, 2),
 	UNIT_TEST(nvgpu_memset_sysmem,	test_nvgpu_memset_sysmem,	NULL, 0),
 	UNIT_TEST(nvgpu_mem_wr_rd,	test_nvgpu_mem_wr_rd,		NULL, 0),
+	UNIT_TEST(nvgpu_mem_copy_sysmem,	test_nvgpu_mem_copy_sysmem,	NULL, 0),
 	UNIT_TEST(mem_iommu_translate,	test_nvgpu_mem_iommu_translate,	NULL, 2),
 
 	/*
@@ -724,6 +1158,7 @@ struct unit_module_test nvgpu_mem_tests[] = {
 	UNIT_TEST(create_mem_from_mem,	test_nvgpu_mem_create_from_mem,	NULL, 0),
 #ifdef CONFIG_NVGPU_DGPU
 	UNIT_TEST(nvgpu_mem_vidmem,	test_nvgpu_mem_vidmem,		NULL, 2),
+	UNIT_TEST(nvgpu_mem_copy_vidmem,	test_nvgpu_mem_copy_vidmem,	NULL, 0),
 #endif
 	/*
 	 * Free test should be executed at the end to free allocated memory.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -138,6 +138,34 @@ int test_nvgpu_memset_sysmem(struct unit_module *m,
  */
 int test_nvgpu_mem_wr_rd(struct unit_module *m, struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_nvgpu_mem_copy_sysmem
+ *
+ * Description: Test vectored copy and fill of sysmem buffers
+ *
+ * Test Type: Feature, Error injection
+ *
+ * Targets: nvgpu_mem_copy, nvgpu_mem_ops_submit
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Copy a range between two sysmem buffers and check that only the range is
+ *   written.
+ * - Submit adjacent copies and fills and check the result.
+ * - Submit two chained copies within one buffer and check that the second one
+ *   copies the data written by the first one.
+ * - Submit empty operations and check that they succeed.
+ * - Submit misaligned, out of range, overlapping, NULL, bad fill value and bad
+ *   aperture operations and check that they fail with -EINVAL without writing
+ *   anything.
+ *
+ * Output: Returns SUCCESS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_nvgpu_mem_copy_sysmem(struct unit_module *m,
+						struct gk20a *g, void *args);
+
 /**
  * Test specification for: test_nvgpu_mem_iommu_translate
  *
@@ -245,6 +273,34 @@ int test_nvgpu_mem_create_from_mem(struct unit_module *m, struct gk20a *g,
  */
 int test_nvgpu_mem_vidmem(struct unit_module *m, struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_nvgpu_mem_copy_vidmem
+ *
+ * Description: Test vectored copy and fill between all aperture combinations
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_mem_copy, nvgpu_mem_ops_submit
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Back the PRAMIN window with a buffer and build two vidmem buffers of two
+ *   chunks each in it. No copy engine context is set up.
+ * - Copy sysmem to vidmem, vidmem to vidmem and vidmem to sysmem, across the
+ *   chunks, and check the data.
+ * - Fill part of a vidmem buffer and check the data.
+ * - Submit adjacent sysmem to vidmem copies and check that they are done in a
+ *   single PRAMIN access.
+ * - Copy from a vidmem buffer without backing pages and check that it fails
+ *   with -EINVAL.
+ *
+ * Output: Returns SUCCESS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_nvgpu_mem_copy_vidmem(struct unit_module *m,
+						struct gk20a *g, void *args);
+
 /**
  * Test specification for: test_free_nvgpu_mem
  *
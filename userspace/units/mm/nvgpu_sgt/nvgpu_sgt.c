@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -27,6 +27,10 @@
 #include <nvgpu/nvgpu_mem.h>
 #include <nvgpu/nvgpu_sgt.h>
 #include <nvgpu/sizes.h>
+#include <nvgpu/gk20a.h>
+#include <nvgpu/ipa_pa_cache.h>
+#include <nvgpu/errno.h>
+#include <nvgpu/string.h>
 #include <os/posix/os_posix.h>
 
 #include "nvgpu_sgt.h"
@@ -406,11 +410,206 @@ int test_nvgpu_sgt_alignment_with_iommu(struct unit_module *m,
 	return ret;
 }
 
+/* IPA to PA chunks reported by the emulated hypervisor */
+static const struct nvgpu_ipa_desc hyp_chunks[] = {
+	{ .ipa_base = 0x100000, .ipa_size = 0x20000, .pa_base = 0x800000, },
+	{ .ipa_base = 0x120000, .ipa_size = 0x10000, .pa_base = 0x820000, },
+	{ .ipa_base = 0x130000, .ipa_size = 0x10000, .pa_base = 0x900000, },
+};
+static u32 hyp_calls;
+
+/* Same flow as the Tegra HV phys_addr hook: cache first, then hypervisor */
+static u64 ops_sgl_ipa_to_pa_hv(struct gk20a *g, void *sgl,
+				u64 ipa, u64 *pa_len)
+{
+	struct nvgpu_hyp_ipa_pa_info info;
+	u64 pa;
+	u32 i;
+
+	pa = nvgpu_ipa_to_pa_cache_lookup_locked(g, ipa, pa_len);
+	if (pa != 0ULL) {
+		return pa;
+	}
+
+	hyp_calls++;
+	for (i = 0U; i < ARRAY_SIZE(hyp_chunks); i++) {
+		if ((ipa >= hyp_chunks[i].ipa_base) &&
+		    (ipa < hyp_chunks[i].ipa_base + hyp_chunks[i].ipa_size)) {
+			info.base = hyp_chunks[i].pa_base;
+			info.offset = ipa - hyp_chunks[i].ipa_base;
+			info.size = hyp_chunks[i].ipa_size;
+			pa = info.base + info.offset;
+			*pa_len = info.size - info.offset;
+			nvgpu_ipa_to_pa_add_to_cache(g, ipa, pa, &info);
+			return pa;
+		}
+	}
+
+	return 0ULL;
+}
+
+static u64 ops_sgl_ipa_phys(struct gk20a *g, void *sgl)
+{
+	return nvgpu_mem_sgl_phys(g, sgl);
+}
+
+static struct nvgpu_sgt_ops nvgpu_sgt_hv_ops = {
+	.sgl_next = nvgpu_mem_sgl_next,
+	.sgl_ipa = ops_sgl_ipa_phys,
+	.sgl_ipa_to_pa = ops_sgl_ipa_to_pa_hv,
+	.sgl_length = nvgpu_mem_sgl_length,
+};
+
+static bool check_ipa_pa_cache_stats(struct unit_module *m, struct gk20a *g,
+				     u64 hits, u64 misses, u64 evictions,
+				     u64 replaced, u32 entries)
+{
+	struct nvgpu_ipa_pa_cache_stats stats;
+
+	nvgpu_ipa_pa_cache_get_stats(g, &stats);
+	if ((stats.hits != hits) || (stats.misses != misses) ||
+	    (stats.evictions != evictions) || (stats.replaced != replaced) ||
+	    (stats.entries != entries)) {
+		unit_err(m, "stats %llu/%llu/%llu/%llu/%u, expected %llu/%llu/%llu/%llu/%u\n",
+			 stats.hits, stats.misses, stats.evictions,
+			 stats.replaced, stats.entries, hits, misses,
+			 evictions, replaced, entries);
+		return false;
+	}
+
+	return true;
+}
+
+int test_nvgpu_sgt_ipa_to_pa_batch(struct unit_module *m, struct gk20a *g,
+				   void *args)
+{
+	int ret = UNIT_FAIL;
+	struct nvgpu_sgt *sgt;
+	struct nvgpu_sgt_ops const *saved_ops_ptr;
+	struct nvgpu_sgt_pa_range ranges[4];
+	struct nvgpu_hyp_ipa_pa_info info;
+	struct nvgpu_mem_sgl sgl_table[] = {
+		{ .phys = 0x100000, .length = 0x30000, },
+		{ .phys = 0x130000, .length = 0x10000, },
+	};
+	struct nvgpu_mem_sgl bad_sgl[] = {
+		{ .phys = 0x200000, .length = 0x10000, },
+	};
+	u64 size, pa_len;
+	u32 num, i;
+
+	(void) memset(&g->ipa_pa_cache, 0, sizeof(g->ipa_pa_cache));
+	nvgpu_rwsem_init(&g->ipa_pa_cache.ipa_pa_rw_lock);
+	hyp_calls = 0U;
+
+	sgt = nvgpu_mem_sgt_posix_create_from_list(g, sgl_table,
+				ARRAY_SIZE(sgl_table), &size);
+	if (sgt == NULL) {
+		unit_return_fail(m, "nvgpu_mem_sgt_posix_create_from_list failed\n");
+	}
+	saved_ops_ptr = sgt->ops;
+	sgt->ops = &nvgpu_sgt_hv_ops;
+
+	/*
+	 * Cold cache: one hypervisor call per chunk, the first two chunks are
+	 * merged into one descriptor and one range.
+	 */
+	if ((nvgpu_sgt_ipa_to_pa_batch(g, sgt, ranges, ARRAY_SIZE(ranges),
+			&num) != 0) || (num != 2U) ||
+	    (ranges[0].pa != 0x800000) || (ranges[0].length != 0x30000) ||
+	    (ranges[1].pa != 0x900000) || (ranges[1].length != 0x10000) ||
+	    (hyp_calls != 3U) ||
+	    !check_ipa_pa_cache_stats(m, g, 0U, 3U, 0U, 0U, 2U)) {
+		unit_err(m, "cold batch translation failed\n");
+		goto out;
+	}
+
+	/* Warm cache: one lookup per SGL entry */
+	if ((nvgpu_sgt_ipa_to_pa_batch(g, sgt, ranges, ARRAY_SIZE(ranges),
+			&num) != 0) || (num != 2U) ||
+	    (ranges[0].length != 0x30000) || (hyp_calls != 3U) ||
+	    !check_ipa_pa_cache_stats(m, g, 2U, 3U, 0U, 0U, 2U)) {
+		unit_err(m, "warm batch translation failed\n");
+		goto out;
+	}
+
+	/* A range query in the middle of a merged descriptor */
+	if ((nvgpu_ipa_to_pa_cache_lookup_locked(g, 0x118000, &pa_len) !=
+			0x818000) || (pa_len != 0x18000)) {
+		unit_err(m, "range lookup failed\n");
+		goto out;
+	}
+
+	if ((nvgpu_sgt_ipa_to_pa_batch(g, sgt, ranges, 1U, &num) != -ENOSPC) ||
+	    (num != 1U)) {
+		unit_err(m, "short range array not reported\n");
+		goto out;
+	}
+
+	/* An overlapping chunk replaces the stale descriptor */
+	info.base = 0x700000;
+	info.offset = 0U;
+	info.size = 0x20000;
+	nvgpu_ipa_to_pa_add_to_cache(g, 0xf0000, 0x700000, &info);
+	if ((nvgpu_ipa_to_pa_cache_lookup_locked(g, 0x108000, NULL) !=
+			0x718000) ||
+	    (nvgpu_ipa_to_pa_cache_lookup_locked(g, 0x120000, NULL) != 0U) ||
+	    (nvgpu_ipa_to_pa_cache_lookup_locked(g, 0x130000, NULL) !=
+			0x900000) ||
+	    !check_ipa_pa_cache_stats(m, g, 7U, 4U, 0U, 1U, 2U)) {
+		unit_err(m, "overlapping insertion failed\n");
+		goto out;
+	}
+
+	/* Filling the cache evicts one descriptor per insertion */
+	for (i = 0U; i < MAX_IPA_PA_CACHE; i++) {
+		info.base = 0x40000000ULL + (u64)i * 0x40000ULL;
+		info.size = 0x10000;
+		nvgpu_ipa_to_pa_add_to_cache(g, 0x10000000ULL +
+				(u64)i * 0x20000ULL, info.base, &info);
+		if (nvgpu_ipa_to_pa_cache_lookup_locked(g,
+				0x10000000ULL + (u64)i * 0x20000ULL + 0x100ULL,
+				NULL) != info.base + 0x100ULL) {
+			unit_err(m, "lookup of descriptor %u failed\n", i);
+			goto out;
+		}
+	}
+	if (!check_ipa_pa_cache_stats(m, g, 7U + MAX_IPA_PA_CACHE, 4U, 2U,
+			1U, MAX_IPA_PA_CACHE)) {
+		unit_err(m, "eviction failed\n");
+		goto out;
+	}
+
+	/* A failed translation is reported, not recorded as a PA range */
+	sgt->ops = saved_ops_ptr;
+	nvgpu_sgt_free(g, sgt);
+	sgt = nvgpu_mem_sgt_posix_create_from_list(g, bad_sgl,
+				ARRAY_SIZE(bad_sgl), &size);
+	if (sgt == NULL) {
+		unit_return_fail(m, "nvgpu_mem_sgt_posix_create_from_list failed\n");
+	}
+	saved_ops_ptr = sgt->ops;
+	sgt->ops = &nvgpu_sgt_hv_ops;
+	if ((nvgpu_sgt_ipa_to_pa_batch(g, sgt, ranges, ARRAY_SIZE(ranges),
+			&num) != -EINVAL) || (num != 0U)) {
+		unit_err(m, "failed translation not reported\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	sgt->ops = saved_ops_ptr;
+	nvgpu_sgt_free(g, sgt);
+
+	return ret;
+}
+
 struct unit_module_test nvgpu_sgt_tests[] = {
 	UNIT_TEST(sgt_basic_apis,		test_nvgpu_sgt_basic_apis,		NULL, 0),
 	UNIT_TEST(sgt_get_next,			test_nvgpu_sgt_get_next,		NULL, 0),
 	UNIT_TEST(sgt_alignment_non_iommu,	test_nvgpu_sgt_alignment_non_iommu,	NULL, 0),
 	UNIT_TEST(sgt_alignment_with_iommu,	test_nvgpu_sgt_alignment_with_iommu,	NULL, 0),
+	UNIT_TEST(sgt_ipa_to_pa_batch,		test_nvgpu_sgt_ipa_to_pa_batch,		NULL, 0),
 };
 
 UNIT_MODULE(nvgpu_sgt, nvgpu_sgt_tests, UNIT_PRIO_NVGPU_TEST);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -165,4 +165,42 @@ int test_nvgpu_sgt_alignment_non_iommu(struct unit_module *m,
 int test_nvgpu_sgt_alignment_with_iommu(struct unit_module *m,
 					       struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_nvgpu_sgt_ipa_to_pa_batch
+ *
+ * Description: Test the batched IPA to PA translation of an sgt and the
+ * interval cache of IPA to PA translations behind it.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_sgt_ipa_to_pa_batch, nvgpu_ipa_to_pa_cache_lookup_locked,
+ *          nvgpu_ipa_to_pa_add_to_cache, nvgpu_ipa_pa_cache_get_stats
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Create an sgt of two entries whose sgl_ipa_to_pa op looks up the IPA to
+ *   PA cache and, on a miss, translates with an emulated hypervisor and adds
+ *   the result to the cache.
+ * - Translate the sgt with an empty cache and verify the ranges, that the
+ *   hypervisor was called once per physical chunk and that the chunks
+ *   contiguous in IPA and PA were merged in the cache.
+ * - Translate the sgt again and verify only cache hits, one per entry.
+ * - Look up an IPA in the middle of a merged descriptor and verify the PA and
+ *   the length to the end of the physically contiguous range.
+ * - Translate with a too small range array and verify -ENOSPC.
+ * - Add a chunk overlapping a cached descriptor and verify the stale
+ *   descriptor is dropped and counted as replaced, not evicted.
+ * - Add more descriptors than the cache holds and verify each new one can be
+ *   looked up and one descriptor is evicted per insertion once full.
+ * - Verify the hit, miss, eviction and replacement counts after each step.
+ * - Translate an sgt whose IPA the hypervisor cannot translate and verify
+ *   -EINVAL with no range recorded.
+ *
+ * Output: Returns SUCCESS if the steps above were executed successfully. FAIL
+ * otherwise.
+ */
+int test_nvgpu_sgt_ipa_to_pa_batch(struct unit_module *m,
+				   struct gk20a *g, void *args);
+
 #endif /* UNIT_NVGPU_SGT_H */
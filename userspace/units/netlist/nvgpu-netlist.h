@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -85,7 +85,8 @@ int test_netlist_init_support(struct unit_module *m,
  *          nvgpu_netlist_get_fecs_inst_list,
  *          nvgpu_netlist_get_fecs_data_list,
  *          nvgpu_netlist_get_gpccs_inst_list,
- *          nvgpu_netlist_get_gpccs_data_list
+ *          nvgpu_netlist_get_gpccs_data_list,
+ *          nvgpu_netlist_get_stats
  *
  * Input: None
  *
@@ -104,6 +105,7 @@ int test_netlist_init_support(struct unit_module *m,
  * - Call nvgpu_netlist_get_fecs_data_list
  * - Call nvgpu_netlist_get_gpccs_inst_list
  * - Call nvgpu_netlist_get_gpccs_data_list
+ * - Call nvgpu_netlist_get_stats and check the lists were mapped in place
  * Checked called functions returns correct data
  *
  * Output: Returns PASS if returned data is valid. FAIL otherwise.
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <unit/io.h>
+#include <unit/unit.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/kmem.h>
+#include <nvgpu/pmu/rpc_pool.h>
+
+#include "nvgpu-pmu-rpc-pool.h"
+
+#define TEST_WINDOW		NVGPU_PMU_RPC_ASYNC_WINDOW
+#define TEST_MAX_FENCE		(3U * TEST_WINDOW)
+#define TEST_RESPONSE(fence)	((u64)(fence) * 100ULL)
+
+/* Behaviour of the stubbed PMU ack wait */
+enum test_ack_mode {
+	/* the RPC being waited for completes */
+	TEST_ACK_COMPLETE,
+	/* the PMU does not respond */
+	TEST_ACK_TIMEOUT,
+};
+
+static struct nvgpu_pmu_rpc_pool *test_pool;
+static enum test_ack_mode test_ack_mode;
+static u32 test_ack_waits;
+static u64 test_dst[TEST_MAX_FENCE + 1U];
+
+static int test_wait_ack(struct gk20a *g, u32 timeout_ms, void *var, u8 val)
+{
+	u32 i;
+
+	(void)timeout_ms;
+	(void)val;
+
+	test_ack_waits++;
+	if (test_ack_mode == TEST_ACK_TIMEOUT) {
+		return -ETIMEDOUT;
+	}
+
+	for (i = 0U; i < TEST_WINDOW; i++) {
+		struct rpc_handler_payload *payload =
+			&test_pool->slots[i].payload;
+
+		if (var == (void *)&payload->complete) {
+			nvgpu_pmu_rpc_pool_complete(g, test_pool, payload);
+			return 0;
+		}
+	}
+
+	return -EINVAL;
+}
+
+/* Claim the slot of the next fence and post an RPC with a known response */
+static struct nvgpu_pmu_rpc_slot *test_post(struct gk20a *g)
+{
+	struct nvgpu_pmu_rpc_slot *slot;
+
+	slot = nvgpu_pmu_rpc_pool_claim(g, test_pool);
+	if ((slot == NULL) || (slot->fence > TEST_MAX_FENCE)) {
+		return NULL;
+	}
+
+	slot->buff[0] = TEST_RESPONSE(slot->fence);
+	slot->payload.rpc_buff = slot->buff;
+	slot->payload.size_rpc = (u16)sizeof(u64);
+	slot->payload.copy_back = &test_dst[slot->fence];
+	test_dst[slot->fence] = 0ULL;
+
+	return slot;
+}
+
+static int test_pool_setup(struct unit_module *m, struct gk20a *g)
+{
+	test_pool = NULL;
+	if (nvgpu_pmu_rpc_pool_init(g, &test_pool, test_wait_ack) != 0) {
+		unit_err(m, "pool init failed\n");
+		return UNIT_FAIL;
+	}
+	nvgpu_pmu_rpc_pool_sw_setup(g, test_pool);
+
+	test_ack_mode = TEST_ACK_COMPLETE;
+	test_ack_waits = 0U;
+	(void) memset(test_dst, 0, sizeof(test_dst));
+
+	return UNIT_SUCCESS;
+}
+
+/* Post an RPC for each fence of the window, which needs no ack wait */
+static bool test_fill_window(struct unit_module *m, struct gk20a *g)
+{
+	struct nvgpu_pmu_rpc_slot *slot;
+	u32 i;
+
+	for (i = 0U; i < TEST_WINDOW; i++) {
+		slot = test_post(g);
+		if ((slot == NULL) ||
+		    (slot != &test_pool->slots[slot->fence % TEST_WINDOW])) {
+			unit_err(m, "claim %u failed\n", i);
+			return false;
+		}
+	}
+	if (test_ack_waits != 0U) {
+		unit_err(m, "claims waited for an ack\n");
+		return false;
+	}
+
+	return true;
+}
+
+int test_pmu_rpc_pool_slot_reuse(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	struct nvgpu_pmu_rpc_slot *slot;
+	u64 fence;
+	int ret = UNIT_FAIL;
+
+	if (test_pool_setup(m, g) != UNIT_SUCCESS) {
+		return UNIT_FAIL;
+	}
+
+	if (!test_fill_window(m, g)) {
+		goto out;
+	}
+
+	/* the next fence waits for the first one and reuses its slot */
+	slot = test_post(g);
+	fence = TEST_WINDOW + 1ULL;
+	if ((slot == NULL) || (slot->fence != fence) ||
+	    (slot != &test_pool->slots[1]) || (test_ack_waits != 1U) ||
+	    (test_dst[1] != TEST_RESPONSE(1U))) {
+		unit_err(m, "slot of fence 1 not reused\n");
+		goto out;
+	}
+
+	/* allocated RPC buffers are freed on completion */
+	slot->payload.rpc_buff = nvgpu_kzalloc(g, sizeof(u64));
+	if (slot->payload.rpc_buff == NULL) {
+		unit_err(m, "alloc failed\n");
+		goto out;
+	}
+	*(u64 *)slot->payload.rpc_buff = TEST_RESPONSE(fence);
+	slot->payload.free_rpc_buff = true;
+
+	if ((nvgpu_pmu_rpc_pool_wait(g, test_pool, 1ULL, 10U) != 0) ||
+	    (test_ack_waits != 1U)) {
+		unit_err(m, "wait for completed fence failed\n");
+		goto out;
+	}
+
+	if ((nvgpu_pmu_rpc_pool_wait_all(g, test_pool, 10U) != 0) ||
+	    (test_ack_waits != (1U + TEST_WINDOW))) {
+		unit_err(m, "wait_all failed\n");
+		goto out;
+	}
+	for (fence = 1ULL; fence <= (TEST_WINDOW + 1ULL); fence++) {
+		if (test_dst[fence] != TEST_RESPONSE(fence)) {
+			unit_err(m, "fence %llu not copied back\n", fence);
+			goto out;
+		}
+	}
+	if ((slot->payload.rpc_buff != NULL) || slot->payload.free_rpc_buff) {
+		unit_err(m, "RPC buffer not freed\n");
+		goto out;
+	}
+
+	if ((nvgpu_pmu_rpc_pool_wait_all(g, test_pool, 10U) != 0) ||
+	    (test_ack_waits != (1U + TEST_WINDOW))) {
+		unit_err(m, "wait_all waited for completed fences\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_pmu_rpc_pool_deinit(g, test_pool);
+	test_pool = NULL;
+	return ret;
+}
+
+int test_pmu_rpc_pool_abandon(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	struct nvgpu_pmu_rpc_slot *slot;
+	u64 fence;
+	u32 waits;
+	int ret = UNIT_FAIL;
+
+	if (test_pool_setup(m, g) != UNIT_SUCCESS) {
+		return UNIT_FAIL;
+	}
+
+	if (!test_fill_window(m, g)) {
+		goto out;
+	}
+
+	/* fence 1 times out and abandons its slot */
+	test_ack_mode = TEST_ACK_TIMEOUT;
+	if ((nvgpu_pmu_rpc_pool_wait(g, test_pool, 1ULL, 10U) != -ETIMEDOUT) ||
+	    !test_pool->slots[1].abandoned ||
+	    (test_pool->slots[1].payload.copy_back != NULL) ||
+	    (test_ack_waits != 1U)) {
+		unit_err(m, "fence 1 not abandoned\n");
+		goto out;
+	}
+	if ((nvgpu_pmu_rpc_pool_wait(g, test_pool, 1ULL, 10U) != -ETIMEDOUT) ||
+	    (test_ack_waits != 1U)) {
+		unit_err(m, "abandoned fence waited for again\n");
+		goto out;
+	}
+
+	/* fence 17 is skipped, fence 18 reuses the slot of fence 2 */
+	test_ack_mode = TEST_ACK_COMPLETE;
+	slot = test_post(g);
+	if ((slot == NULL) || (slot->fence != (TEST_WINDOW + 2ULL)) ||
+	    (slot != &test_pool->slots[2]) || (test_ack_waits != 2U) ||
+	    (test_dst[2] != TEST_RESPONSE(2U))) {
+		unit_err(m, "abandoned slot not skipped\n");
+		goto out;
+	}
+	if (nvgpu_pmu_rpc_pool_wait(g, test_pool, TEST_WINDOW + 1ULL,
+			10U) != 0) {
+		unit_err(m, "wait for skipped fence failed\n");
+		goto out;
+	}
+
+	/* the late response of fence 1 is dropped */
+	nvgpu_pmu_rpc_pool_complete(g, test_pool,
+		&test_pool->slots[1].payload);
+	if ((test_dst[1] != 0ULL) ||
+	    (nvgpu_pmu_rpc_pool_wait(g, test_pool, 1ULL, 10U) != 0)) {
+		unit_err(m, "late response of fence 1 copied back\n");
+		goto out;
+	}
+
+	/* complete fences 3..18, then reach the slot of fence 1 again */
+	if (nvgpu_pmu_rpc_pool_wait_all(g, test_pool, 10U) != 0) {
+		unit_err(m, "wait_all failed\n");
+		goto out;
+	}
+	waits = test_ack_waits;
+	do {
+		slot = test_post(g);
+	} while ((slot != NULL) && (slot != &test_pool->slots[1]));
+	if ((slot == NULL) || slot->abandoned ||
+	    (slot->fence != ((2ULL * TEST_WINDOW) + 1ULL)) ||
+	    (test_ack_waits != waits)) {
+		unit_err(m, "abandoned slot not reused\n");
+		goto out;
+	}
+
+	/* fill the window and abandon every fence */
+	slot = test_post(g);
+	if ((slot == NULL) || (test_ack_waits != waits)) {
+		unit_err(m, "claim failed\n");
+		goto out;
+	}
+	test_ack_mode = TEST_ACK_TIMEOUT;
+	for (fence = slot->fence - TEST_WINDOW + 1ULL; fence <= slot->fence;
+			fence++) {
+		if (nvgpu_pmu_rpc_pool_wait(g, test_pool, fence, 10U) !=
+				-ETIMEDOUT) {
+			unit_err(m, "fence %llu did not time out\n", fence);
+			goto out;
+		}
+	}
+	waits = test_ack_waits;
+	if ((nvgpu_pmu_rpc_pool_wait_all(g, test_pool, 10U) != -ETIMEDOUT) ||
+	    (nvgpu_pmu_rpc_pool_claim(g, test_pool) != NULL) ||
+	    (test_ack_waits != waits)) {
+		unit_err(m, "claim with all slots abandoned did not fail\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_pmu_rpc_pool_deinit(g, test_pool);
+	test_pool = NULL;
+	return ret;
+}
+
+struct unit_module_test nvgpu_pmu_rpc_pool_tests[] = {
+	UNIT_TEST(pmu_rpc_pool_slot_reuse, test_pmu_rpc_pool_slot_reuse,
+		NULL, 0),
+	UNIT_TEST(pmu_rpc_pool_abandon, test_pmu_rpc_pool_abandon, NULL, 0),
+};
+
+UNIT_MODULE(nvgpu_pmu_rpc_pool, nvgpu_pmu_rpc_pool_tests,
+	UNIT_PRIO_NVGPU_TEST);
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef UNIT_NVGPU_PMU_RPC_POOL_H
+#define UNIT_NVGPU_PMU_RPC_POOL_H
+
+#include <nvgpu/types.h>
+
+struct gk20a;
+struct unit_module;
+
+/** @addtogroup SWUTS-pmu-rpc-pool
+ *  @{
+ *
+ * Software Unit Test Specification for common.pmu.ipc.rpc_pool
+ */
+
+/**
+ * Test specification for: test_pmu_rpc_pool_slot_reuse.
+ *
+ * Description: Verify that slots are reused in fence order once the RPC
+ * which last used them has completed.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_pmu_rpc_pool_init, nvgpu_pmu_rpc_pool_sw_setup,
+ *          nvgpu_pmu_rpc_pool_claim, nvgpu_pmu_rpc_pool_complete,
+ *          nvgpu_pmu_rpc_pool_wait, nvgpu_pmu_rpc_pool_wait_all,
+ *          nvgpu_pmu_rpc_pool_deinit
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Initialize the pool with a stubbed PMU ack wait which completes the
+ *   RPC being waited for.
+ * - Claim a slot for each fence of the window and check that no ack wait
+ *   is needed.
+ * - Claim one more slot and check that it is the slot of the first fence,
+ *   that exactly one ack wait was done and that the response of the first
+ *   fence was copied back.
+ * - Wait for the reused fence and check that no ack wait is needed.
+ * - Wait for all fences and check that every response was copied back.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_pmu_rpc_pool_slot_reuse(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_pmu_rpc_pool_abandon.
+ *
+ * Description: Verify that an RPC which timed out abandons its slot until
+ * it completes late, and that its response is dropped.
+ *
+ * Test Type: Feature, Error injection
+ *
+ * Targets: nvgpu_pmu_rpc_pool_claim, nvgpu_pmu_rpc_pool_complete,
+ *          nvgpu_pmu_rpc_pool_wait, nvgpu_pmu_rpc_pool_wait_all
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Claim a slot for each fence of the window.
+ * - Make the stubbed ack wait time out, wait for the first fence and check
+ *   that -ETIMEDOUT is returned and that waiting again fails without an
+ *   ack wait.
+ * - Let the stubbed ack wait complete RPCs again. Claim one more slot and
+ *   check that the fence of the abandoned slot is skipped without an ack
+ *   wait and that the next slot is used once its RPC completed.
+ * - Complete the abandoned RPC late and check that its response is not
+ *   copied back. Check that the slot is reused by a later claim without an
+ *   ack wait.
+ * - Fill the window and make the ack wait time out on each fence, check
+ *   that wait_all then fails and a claim fails without an ack wait.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_pmu_rpc_pool_abandon(struct unit_module *m,
+		struct gk20a *g, void *args);
+
+/**
+ * @}
+ */
+
+#endif /* UNIT_NVGPU_PMU_RPC_POOL_H */
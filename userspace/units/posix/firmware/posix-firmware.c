@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <unit/io.h>
+#include <unit/unit.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/firmware.h>
+
+#include "posix-firmware.h"
+
+#define TEST_FW_DIR		"firmware"
+#define TEST_FW_SUBDIR		"firmware/gv11b"
+#define TEST_FW_NAME		"posix_fw_cache_test.bin"
+#define TEST_FW_PATH		TEST_FW_SUBDIR "/" TEST_FW_NAME
+#define TEST_FW_SIZE		4096U
+
+static bool created_dir, created_subdir;
+
+static void fw_fill(u8 *buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		buf[i] = (u8)((i * 7U) + 3U);
+	}
+}
+
+static int fw_create(struct unit_module *m)
+{
+	u8 buf[TEST_FW_SIZE];
+	FILE *f;
+
+	if (mkdir(TEST_FW_DIR, 0755) == 0) {
+		created_dir = true;
+	}
+	if (mkdir(TEST_FW_SUBDIR, 0755) == 0) {
+		created_subdir = true;
+	}
+
+	f = fopen(TEST_FW_PATH, "wb");
+	if (f == NULL) {
+		unit_err(m, "cannot create %s\n", TEST_FW_PATH);
+		return -1;
+	}
+
+	fw_fill(buf, sizeof(buf));
+	if (fwrite(buf, 1, sizeof(buf), f) != sizeof(buf)) {
+		unit_err(m, "cannot write %s\n", TEST_FW_PATH);
+		(void) fclose(f);
+		return -1;
+	}
+
+	return fclose(f);
+}
+
+static void fw_remove(struct gk20a *g)
+{
+	nvgpu_firmware_cache_flush(g);
+
+	(void) unlink(TEST_FW_PATH);
+	if (created_subdir) {
+		(void) rmdir(TEST_FW_SUBDIR);
+		created_subdir = false;
+	}
+	if (created_dir) {
+		(void) rmdir(TEST_FW_DIR);
+		created_dir = false;
+	}
+}
+
+static bool fw_check(struct nvgpu_firmware *fw)
+{
+	u8 buf[TEST_FW_SIZE];
+
+	fw_fill(buf, sizeof(buf));
+	return (fw->size == TEST_FW_SIZE) &&
+		(memcmp(fw->data, buf, TEST_FW_SIZE) == 0);
+}
+
+int test_fw_cache_read_only(struct unit_module *m,
+		struct gk20a *g, void *args)
+{
+	struct nvgpu_firmware_cache_stats before, after;
+	struct nvgpu_firmware *fw1 = NULL, *fw2 = NULL;
+	int ret = UNIT_FAIL;
+
+	if (fw_create(m) != 0) {
+		goto done;
+	}
+
+	nvgpu_firmware_cache_get_stats(g, &before);
+
+	fw1 = nvgpu_request_firmware(g, TEST_FW_NAME,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
+	fw2 = nvgpu_request_firmware(g, TEST_FW_NAME,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
+	if ((fw1 == NULL) || (fw2 == NULL)) {
+		unit_err(m, "read-only request failed\n");
+		goto done;
+	}
+
+	if (!fw_check(fw1) || (fw1->data != fw2->data)) {
+		unit_err(m, "read-only views differ\n");
+		goto done;
+	}
+
+	nvgpu_firmware_cache_get_stats(g, &after);
+	if ((after.misses != before.misses + 1U) ||
+			(after.hits != before.hits + 1U) ||
+			(after.bytes_copied != before.bytes_copied) ||
+			(after.bytes_loaded != before.bytes_loaded + TEST_FW_SIZE)) {
+		unit_err(m, "unexpected cache stats\n");
+		goto done;
+	}
+
+	ret = UNIT_SUCCESS;
+
+done:
+	if (fw2 != NULL) {
+		nvgpu_release_firmware(g, fw2);
+	}
+	if (fw1 != NULL) {
+		nvgpu_release_firmware(g, fw1);
+	}
+	fw_remove(g);
+	return ret;
+}
+
+int test_fw_cache_copy(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_firmware_cache_stats before, after;
+	struct nvgpu_firmware *ro = NULL, *rw = NULL;
+	int ret = UNIT_FAIL;
+
+	if (fw_create(m) != 0) {
+		goto done;
+	}
+
+	nvgpu_firmware_cache_get_stats(g, &before);
+
+	ro = nvgpu_request_firmware(g, TEST_FW_NAME,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
+	rw = nvgpu_request_firmware(g, TEST_FW_NAME, 0U);
+	if ((ro == NULL) || (rw == NULL)) {
+		unit_err(m, "request failed\n");
+		goto done;
+	}
+
+	if (!fw_check(rw) || (rw->data == ro->data)) {
+		unit_err(m, "writable request did not get a private copy\n");
+		goto done;
+	}
+
+	nvgpu_firmware_cache_get_stats(g, &after);
+	if (after.bytes_copied != before.bytes_copied + TEST_FW_SIZE) {
+		unit_err(m, "unexpected copied bytes\n");
+		goto done;
+	}
+
+	rw->data[0] = (u8)~rw->data[0];
+	if (!fw_check(ro)) {
+		unit_err(m, "read-only view modified through copy\n");
+		goto done;
+	}
+
+	if (nvgpu_request_firmware(g, "posix_fw_cache_missing.bin", 0U) !=
+			NULL) {
+		unit_err(m, "missing firmware loaded\n");
+		goto done;
+	}
+
+	if (nvgpu_request_firmware(g, NULL, 0U) != NULL) {
+		unit_err(m, "NULL firmware name loaded\n");
+		goto done;
+	}
+
+	ret = UNIT_SUCCESS;
+
+done:
+	if (rw != NULL) {
+		nvgpu_release_firmware(g, rw);
+	}
+	if (ro != NULL) {
+		nvgpu_release_firmware(g, ro);
+	}
+	fw_remove(g);
+	return ret;
+}
+
+static bool fw_request_release(struct gk20a *g)
+{
+	struct nvgpu_firmware *fw;
+
+	fw = nvgpu_request_firmware(g, TEST_FW_NAME,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
+	if (fw == NULL) {
+		return false;
+	}
+	nvgpu_release_firmware(g, fw);
+	return true;
+}
+
+static u32 fw_cache_entries(struct gk20a *g)
+{
+	struct nvgpu_firmware_cache_stats stats;
+
+	nvgpu_firmware_cache_get_stats(g, &stats);
+	return stats.entries;
+}
+
+int test_fw_cache_policy(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_firmware *fw = NULL;
+	int ret = UNIT_FAIL;
+
+	if (fw_create(m) != 0) {
+		goto done;
+	}
+	nvgpu_firmware_cache_flush(g);
+
+	nvgpu_firmware_cache_set_policy(g, NVGPU_FIRMWARE_CACHE_KEEP, 0UL);
+	if (!fw_request_release(g) || (fw_cache_entries(g) != 1U)) {
+		unit_err(m, "KEEP policy did not retain the image\n");
+		goto done;
+	}
+
+	nvgpu_firmware_cache_flush(g);
+	if (fw_cache_entries(g) != 0U) {
+		unit_err(m, "flush did not evict the image\n");
+		goto done;
+	}
+
+	nvgpu_firmware_cache_set_policy(g, NVGPU_FIRMWARE_CACHE_LRU,
+			TEST_FW_SIZE - 1U);
+	if (!fw_request_release(g) || (fw_cache_entries(g) != 0U)) {
+		unit_err(m, "LRU policy retained an image over budget\n");
+		goto done;
+	}
+
+	nvgpu_firmware_cache_set_policy(g, NVGPU_FIRMWARE_CACHE_LRU,
+			TEST_FW_SIZE);
+	if (!fw_request_release(g) || (fw_cache_entries(g) != 1U)) {
+		unit_err(m, "LRU policy did not retain the image\n");
+		goto done;
+	}
+
+	nvgpu_firmware_cache_set_policy(g, NVGPU_FIRMWARE_CACHE_RELEASE, 0UL);
+	if (fw_cache_entries(g) != 0U) {
+		unit_err(m, "RELEASE policy retained an idle image\n");
+		goto done;
+	}
+
+	fw = nvgpu_request_firmware(g, TEST_FW_NAME,
+			NVGPU_REQUEST_FIRMWARE_READ_ONLY);
+	if ((fw == NULL) || (fw_cache_entries(g) != 1U)) {
+		unit_err(m, "RELEASE policy dropped a referenced image\n");
+		goto done;
+	}
+	nvgpu_release_firmware(g, fw);
+	fw = NULL;
+	if (fw_cache_entries(g) != 0U) {
+		unit_err(m, "RELEASE policy retained a released image\n");
+		goto done;
+	}
+
+	ret = UNIT_SUCCESS;
+
+done:
+	if (fw != NULL) {
+		nvgpu_release_firmware(g, fw);
+	}
+	nvgpu_firmware_cache_set_policy(g, NVGPU_FIRMWARE_CACHE_LRU,
+			NVGPU_FIRMWARE_CACHE_DEFAULT_BUDGET);
+	fw_remove(g);
+	return ret;
+}
+
+struct unit_module_test posix_firmware_tests[] = {
+	UNIT_TEST(fw_cache_read_only, test_fw_cache_read_only, NULL, 0),
+	UNIT_TEST(fw_cache_copy, test_fw_cache_copy, NULL, 0),
+	UNIT_TEST(fw_cache_policy, test_fw_cache_policy, NULL, 0),
+};
+
+UNIT_MODULE(posix_firmware, posix_firmware_tests, UNIT_PRIO_POSIX_TEST);
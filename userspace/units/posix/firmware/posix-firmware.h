@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @addtogroup SWUTS-posix-firmware
+ * @{
+ *
+ * Software Unit Test Specification for posix-firmware
+ */
+
+#ifndef UNIT_POSIX_FIRMWARE_H
+#define UNIT_POSIX_FIRMWARE_H
+
+/**
+ * Test specification for test_fw_cache_read_only
+ *
+ * Description: Test that read-only firmware requests share the cached image.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_request_firmware, nvgpu_release_firmware,
+ *          nvgpu_firmware_cache_get_stats
+ *
+ * Inputs: A test firmware image written to the firmware search path.
+ *
+ * Steps:
+ * 1) Request the image twice with NVGPU_REQUEST_FIRMWARE_READ_ONLY.
+ * 2) Check that both requests return the image contents through the same
+ *    data pointer.
+ * 3) Check that the cache recorded one miss, one hit and no copied bytes.
+ * 4) Release both requests.
+ *
+ * Output: Returns PASS if the read-only views are shared and the statistics
+ * match, FAIL otherwise.
+ */
+int test_fw_cache_read_only(struct unit_module *m, struct gk20a *g,
+		void *args);
+
+/**
+ * Test specification for test_fw_cache_copy
+ *
+ * Description: Test that writable firmware requests get private copies of
+ * the cached image.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_request_firmware, nvgpu_release_firmware,
+ *          nvgpu_firmware_cache_get_stats
+ *
+ * Inputs: A test firmware image written to the firmware search path.
+ *
+ * Steps:
+ * 1) Request the image read-only and writable.
+ * 2) Check that the writable request has its own buffer with the image
+ *    contents and that the copied byte count grew by the image size.
+ * 3) Modify the writable buffer and check the read-only view is unchanged.
+ * 4) Release both requests.
+ * 5) Request a missing image and a NULL name, and check both fail.
+ *
+ * Output: Returns PASS if the copies are private and the statistics match,
+ * FAIL otherwise.
+ */
+int test_fw_cache_copy(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for test_fw_cache_policy
+ *
+ * Description: Test the firmware cache eviction policies.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_firmware_cache_set_policy, nvgpu_firmware_cache_flush,
+ *          nvgpu_release_firmware
+ *
+ * Inputs: A test firmware image written to the firmware search path.
+ *
+ * Steps:
+ * 1) Select NVGPU_FIRMWARE_CACHE_KEEP, request and release the image and
+ *    check it stays cached.
+ * 2) Flush the cache and check the image was evicted.
+ * 3) Select NVGPU_FIRMWARE_CACHE_LRU with a budget smaller than the image,
+ *    request and release it and check it was evicted.
+ * 4) Select NVGPU_FIRMWARE_CACHE_RELEASE, request the image, check it stays
+ *    cached while referenced and is evicted on release.
+ * 5) Restore the default LRU policy.
+ *
+ * Output: Returns PASS if every policy retains and evicts the image as
+ * expected, FAIL otherwise.
+ */
+int test_fw_cache_policy(struct unit_module *m, struct gk20a *g, void *args);
+
+#endif /* UNIT_POSIX_FIRMWARE_H */
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <unit/io.h>
+#include <unit/unit.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/log.h>
+#include <nvgpu/errata.h>
+
+#include "posix-log.h"
+
+#define TRACE_RING_EVENTS	16U
+
+/*
+ * Only sites of the driver are recorded, so the trace tests log through the
+ * sites of nvgpu_print_errata_flags().
+ */
+#define ERRATA_FUNC	"nvgpu_print_errata_flags"
+#define ERRATA_ROW_FMT	"%-55.55s %-5.5s %s"
+
+static struct nvgpu_log_site *errata_row_site(void)
+{
+	struct nvgpu_log_site *site;
+	u32 i;
+
+	for (i = 0U; i < nvgpu_log_sites_count(); i++) {
+		site = nvgpu_log_site_get(i);
+		if (strcmp(site->func, ERRATA_FUNC) == 0 &&
+		    strcmp(site->format, ERRATA_ROW_FMT) == 0) {
+			return site;
+		}
+	}
+
+	return NULL;
+}
+
+static bool trace_check(struct unit_module *m,
+		const struct nvgpu_log_trace_event *ev, const char *expect)
+{
+	char buf[128];
+	const char *func, *fmt;
+	int line;
+
+	if (nvgpu_log_trace_site(ev->site, &func, &line, &fmt) != 0 ||
+	    strcmp(func, ERRATA_FUNC) != 0) {
+		unit_err(m, "bad call site %u\n", ev->site);
+		return false;
+	}
+
+	if (nvgpu_log_trace_format(ev, buf, sizeof(buf)) != 0 ||
+	    strcmp(buf, expect) != 0) {
+		unit_err(m, "decoded \"%s\", expected \"%s\"\n", buf, expect);
+		return false;
+	}
+
+	return true;
+}
+
+int test_log_trace_record(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_log_trace_event ev[TRACE_RING_EVENTS];
+	struct nvgpu_log_trace_stats stats;
+	struct nvgpu_log_site *site = errata_row_site();
+	char str[NVGPU_LOG_TRACE_STR_LEN + 8U];
+	char expect[128];
+	u64 log_mask = g->log_mask;
+	u64 fallbacks;
+	int ret = UNIT_FAIL;
+
+	g->log_mask |= gpu_dbg_info;
+
+	if (site == NULL) {
+		unit_err(m, "no " ERRATA_FUNC " site\n");
+		goto out;
+	}
+
+	if (nvgpu_log_trace_enable(g, 0U) != -EINVAL) {
+		unit_err(m, "zero sized rings accepted\n");
+		goto out;
+	}
+
+	if (nvgpu_log_trace_enable(g, TRACE_RING_EVENTS) != 0) {
+		unit_err(m, "failed to enable trace mode\n");
+		goto out;
+	}
+
+	nvgpu_print_errata_flags(g);
+	if (nvgpu_log_trace_read(g, ev, 2U) != 2U) {
+		unit_err(m, "expected recorded events\n");
+		goto out;
+	}
+
+	(void) snprintf(expect, sizeof(expect), ERRATA_ROW_FMT,
+			"Flag", "Chip", "Description");
+	if (!trace_check(m, &ev[0], "NVGPU Erratas present in chip") ||
+	    !trace_check(m, &ev[1], expect)) {
+		goto out;
+	}
+
+	if (ev[1].timestamp < ev[0].timestamp) {
+		unit_err(m, "timestamps out of order\n");
+		goto out;
+	}
+
+	/* Drop the rows of the erratas present. */
+	(void) nvgpu_log_trace_read(g, ev, TRACE_RING_EVENTS);
+
+	/* Strings are copied, the caller's buffer may be reused. */
+	(void) strcpy(str, "stack");
+	nvgpu_log_site_impl(g, site, ERRATA_ROW_FMT, str, "c", "d");
+	(void) strcpy(str, "gone");
+
+	/* Strings share NVGPU_LOG_TRACE_STR_LEN bytes and are truncated. */
+	(void) memset(str, 'x', sizeof(str) - 1U);
+	str[sizeof(str) - 1U] = '\0';
+	nvgpu_log_site_impl(g, site, ERRATA_ROW_FMT, str, str, str);
+
+	(void) snprintf(expect, sizeof(expect), ERRATA_ROW_FMT,
+			"stack", "c", "d");
+	if (nvgpu_log_trace_read(g, ev, 4U) != 2U ||
+	    !trace_check(m, &ev[0], expect)) {
+		goto out;
+	}
+
+	str[NVGPU_LOG_TRACE_STR_LEN - 1U] = '\0';
+	(void) snprintf(expect, sizeof(expect), ERRATA_ROW_FMT, str, "", "");
+	if (!trace_check(m, &ev[1], expect)) {
+		goto out;
+	}
+
+	/* Sites of other modules cannot be recorded, printed directly. */
+	nvgpu_log_trace_get_stats(g, &stats);
+	fallbacks = stats.fallbacks;
+	nvgpu_log_info(g, "%d", 1);
+	nvgpu_log_trace_get_stats(g, &stats);
+	if (stats.fallbacks - fallbacks != 1U ||
+	    nvgpu_log_trace_read(g, ev, 4U) != 0U) {
+		unit_err(m, "message of the unit test recorded\n");
+		goto out;
+	}
+
+	nvgpu_log_trace_disable(g);
+	nvgpu_print_errata_flags(g);
+	if (nvgpu_log_trace_read(g, ev, 4U) != 0U) {
+		unit_err(m, "event recorded with trace mode disabled\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_log_trace_disable(g);
+	g->log_mask = log_mask;
+	return ret;
+}
+
+int test_log_trace_overflow(struct unit_module *m, struct gk20a *g,
+		void *args)
+{
+	struct nvgpu_log_trace_event ev[TRACE_RING_EVENTS * 2U];
+	struct nvgpu_log_trace_stats before, after;
+	struct nvgpu_log_site *site = errata_row_site();
+	char num[16], expect[128];
+	u64 log_mask = g->log_mask;
+	int ret = UNIT_FAIL;
+	u32 i, n;
+
+	g->log_mask |= gpu_dbg_info;
+
+	if (site == NULL) {
+		unit_err(m, "no " ERRATA_FUNC " site\n");
+		goto out;
+	}
+
+	if (nvgpu_log_trace_enable(g, TRACE_RING_EVENTS) != 0) {
+		unit_err(m, "failed to enable trace mode\n");
+		goto out;
+	}
+
+	/* Start from empty rings. */
+	(void) nvgpu_log_trace_read(g, ev, TRACE_RING_EVENTS * 2U);
+	nvgpu_log_trace_get_stats(g, &before);
+
+	for (i = 0U; i < TRACE_RING_EVENTS + 8U; i++) {
+		(void) snprintf(num, sizeof(num), "%u", i);
+		nvgpu_log_site_impl(g, site, ERRATA_ROW_FMT, num, "", "");
+	}
+
+	n = nvgpu_log_trace_read(g, ev, TRACE_RING_EVENTS * 2U);
+	if (n != TRACE_RING_EVENTS) {
+		unit_err(m, "read %u events, expected %u\n", n,
+				TRACE_RING_EVENTS);
+		goto out;
+	}
+
+	for (i = 0U; i < n; i++) {
+		(void) snprintf(num, sizeof(num), "%u", 8U + i);
+		(void) snprintf(expect, sizeof(expect), ERRATA_ROW_FMT,
+				num, "", "");
+		if (!trace_check(m, &ev[i], expect)) {
+			goto out;
+		}
+	}
+
+	nvgpu_log_trace_get_stats(g, &after);
+	if (after.events - before.events != TRACE_RING_EVENTS + 8U ||
+	    after.lost - before.lost != 8U) {
+		unit_err(m, "bad trace statistics\n");
+		goto out;
+	}
+
+	for (i = 0U; i < 3U; i++) {
+		nvgpu_log_site_impl(g, site, ERRATA_ROW_FMT, "decoded", "", "");
+	}
+
+	if (nvgpu_log_trace_decode(g) != 3U ||
+	    nvgpu_log_trace_decode(g) != 0U) {
+		unit_err(m, "decode did not drain the new events\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	nvgpu_log_trace_disable(g);
+	g->log_mask = log_mask;
+	return ret;
+}
+
+static u64 errata_site_hits(struct gk20a *g)
+{
+	struct nvgpu_log_site *site;
+	u64 hits = 0ULL;
+	u32 i;
+
+	nvgpu_log_sites_reset_hits();
+	nvgpu_print_errata_flags(g);
+
+	for (i = 0U; i < nvgpu_log_sites_count(); i++) {
+		site = nvgpu_log_site_get(i);
+		if (strcmp(site->func, ERRATA_FUNC) == 0) {
+			hits += (u64)nvgpu_atomic64_read(&site->hits);
+		}
+	}
+
+	return hits;
+}
+
+int test_log_sites(struct unit_module *m, struct gk20a *g, void *args)
+{
+	u64 log_mask = g->log_mask;
+	int ret = UNIT_FAIL;
+	u32 n;
+
+	if (nvgpu_log_sites_count() == 0U ||
+	    nvgpu_log_site_get(nvgpu_log_sites_count()) != NULL) {
+		unit_err(m, "no log sites registered\n");
+		goto out;
+	}
+
+	n = nvgpu_log_sites_set(ERRATA_FUNC, 0, NVGPU_LOG_SITE_MASK);
+	if (n < 3U) {
+		unit_err(m, "found %u sites in " ERRATA_FUNC "\n", n);
+		goto out;
+	}
+
+	if (nvgpu_log_sites_set(ERRATA_FUNC, 0, 0xffU) != 0U) {
+		unit_err(m, "invalid site state accepted\n");
+		goto out;
+	}
+
+	g->log_mask = 0ULL;
+	if (errata_site_hits(g) != 0ULL) {
+		unit_err(m, "sites hit with empty log mask\n");
+		goto out;
+	}
+
+	(void) nvgpu_log_sites_set(ERRATA_FUNC, 0, NVGPU_LOG_SITE_ON);
+	if (errata_site_hits(g) < 3ULL) {
+		unit_err(m, "enabled sites not hit\n");
+		goto out;
+	}
+
+	g->log_mask = gpu_dbg_info;
+	(void) nvgpu_log_sites_set(ERRATA_FUNC, 0, NVGPU_LOG_SITE_OFF);
+	if (errata_site_hits(g) != 0ULL) {
+		unit_err(m, "disabled sites hit\n");
+		goto out;
+	}
+
+	(void) nvgpu_log_sites_set(ERRATA_FUNC, 0, NVGPU_LOG_SITE_MASK);
+	if (errata_site_hits(g) < 3ULL) {
+		unit_err(m, "sites following the log mask not hit\n");
+		goto out;
+	}
+
+	ret = UNIT_SUCCESS;
+out:
+	(void) nvgpu_log_sites_set(ERRATA_FUNC, 0, NVGPU_LOG_SITE_MASK);
+	g->log_mask = log_mask;
+	return ret;
+}
+
+struct unit_module_test posix_log_tests[] = {
+	UNIT_TEST(log_trace_record, test_log_trace_record, NULL, 0),
+	UNIT_TEST(log_trace_overflow, test_log_trace_overflow, NULL, 0),
+	UNIT_TEST(log_sites, test_log_sites, NULL, 0),
+};
+
+UNIT_MODULE(posix_log, posix_log_tests, UNIT_PRIO_POSIX_TEST);
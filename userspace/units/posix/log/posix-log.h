@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @addtogroup SWUTS-posix-log
+ * @{
+ *
+ * Software Unit Test Specification for posix-log
+ */
+
+#ifndef UNIT_POSIX_LOG_H
+#define UNIT_POSIX_LOG_H
+
+/**
+ * Test specification for test_log_trace_record
+ *
+ * Description: Test that debug messages are recorded in binary trace mode and
+ * formatted on read.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_log_trace_enable, nvgpu_log_trace_disable,
+ *          nvgpu_log_trace_read, nvgpu_log_trace_site,
+ *          nvgpu_log_trace_format, nvgpu_log_trace_get_stats,
+ *          nvgpu_log_site_impl
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * 1) Enable gpu_dbg_info in the log mask and enable trace mode.
+ * 2) Call nvgpu_print_errata_flags(), read the events back and check the
+ *    call site and the formatted text of the first two messages.
+ * 3) Log a string from a stack buffer through a site of
+ *    nvgpu_print_errata_flags(), overwrite the buffer before reading the
+ *    event back and check the original string is decoded. Log strings
+ *    longer than NVGPU_LOG_TRACE_STR_LEN and check they are truncated.
+ * 4) Log a message from a site of the unit test and check it is counted as
+ *    a fallback and not recorded.
+ * 5) Disable trace mode and check further messages are not recorded.
+ *
+ * Output: Returns PASS if the events decode to the original messages, FAIL
+ * otherwise.
+ */
+int test_log_trace_record(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for test_log_trace_overflow
+ *
+ * Description: Test that full trace rings overwrite the oldest events.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_log_trace_enable, nvgpu_log_trace_read,
+ *          nvgpu_log_trace_decode, nvgpu_log_trace_get_stats
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * 1) Enable trace mode and log more messages than a ring holds.
+ * 2) Read the events and check only the newest ring size events are
+ *    returned, oldest first, and the rest are counted as lost.
+ * 3) Log a few more messages and check nvgpu_log_trace_decode() prints
+ *    exactly those.
+ *
+ * Output: Returns PASS if the ring keeps the newest events and the counters
+ * match, FAIL otherwise.
+ */
+int test_log_trace_overflow(struct unit_module *m, struct gk20a *g,
+		void *args);
+
+/**
+ * Test specification for test_log_sites
+ *
+ * Description: Test per call site enabling of debug messages.
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_log_sites_count, nvgpu_log_site_get, nvgpu_log_sites_set,
+ *          nvgpu_log_sites_reset_hits, nvgpu_log_site_impl
+ *
+ * Inputs: None.
+ *
+ * Steps:
+ * 1) Check that log sites are registered and that the sites of
+ *    nvgpu_print_errata_flags() can be selected by function name.
+ * 2) With an empty log mask, call nvgpu_print_errata_flags() and check the
+ *    sites were not hit.
+ * 3) Turn the sites on, call nvgpu_print_errata_flags() and check the sites
+ *    were hit despite the empty log mask.
+ * 4) Enable gpu_dbg_info, turn the sites off and check they were not hit.
+ * 5) Return the sites to following the log mask and check they were hit.
+ *
+ * Output: Returns PASS if the site states override the log mask as
+ * expected, FAIL otherwise.
+ */
+int test_log_sites(struct unit_module *m, struct gk20a *g, void *args);
+
+#endif /* UNIT_POSIX_LOG_H */
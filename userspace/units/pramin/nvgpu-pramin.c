@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2018-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -473,6 +473,75 @@ free_vidmem:
 		return UNIT_FAIL;
 }
 
+/*
+ * Test case to exercize the PRAMIN window cache: accesses within the current
+ * 1 MB window must not reprogram it, accesses outside of it must.
+ */
+static int test_pramin_window_cache(struct unit_module *m, struct gk20a *g,
+				void *__args)
+{
+	struct nvgpu_pramin_stats before, after;
+	struct nvgpu_mem mem = { };
+	struct nvgpu_mem_sgl *sgl;
+	u32 word = 0;
+	bool success = false;
+
+	if (init_test_env(m, g) != 0) {
+		unit_return_fail(m, "Module init failed\n");
+	}
+
+	if (create_alloc_and_sgt(m, g, &mem) != 0) {
+		return UNIT_FAIL;
+	}
+
+	sgl = create_sgl(m, TEST_SIZE, VIDMEM_ADDRESS);
+	if (sgl == NULL) {
+		goto free_vidmem;
+	}
+	mem.vidmem_alloc->sgt.sgl = (void *)sgl;
+
+	/* Move the window to the start of the buffer. */
+	nvgpu_pramin_rd_n(g, &mem, 0, sizeof(word), &word);
+
+	/* Single word accesses within the same window are all hits. */
+	nvgpu_pramin_get_stats(g, &before);
+	nvgpu_pramin_wr_n(g, &mem, sizeof(u32), sizeof(word), &word);
+	nvgpu_pramin_rd_n(g, &mem, SZ_4K, sizeof(word), &word);
+	nvgpu_pramin_rd_n(g, &mem, SZ_64K, sizeof(word), &word);
+	nvgpu_pramin_get_stats(g, &after);
+	if ((after.hits != before.hits + 3ULL) ||
+			(after.misses != before.misses) ||
+			(after.switches != before.switches)) {
+		unit_err(m, "Window reprogrammed within the same window\n");
+		goto free_sgl;
+	}
+
+	/* An access in the next 1 MB window moves the window. */
+	nvgpu_pramin_rd_n(g, &mem, SZ_1M, sizeof(word), &word);
+	nvgpu_pramin_get_stats(g, &before);
+	if ((before.misses != after.misses + 1ULL) ||
+			(before.switches != after.switches + 1ULL)) {
+		unit_err(m, "Window not moved\n");
+		goto free_sgl;
+	}
+
+	if (word != vidmem[(VIDMEM_ADDRESS + SZ_1M) / sizeof(u32)]) {
+		unit_err(m, "Wrong data read through moved window\n");
+		goto free_sgl;
+	}
+	success = true;
+
+free_sgl:
+	free(sgl);
+free_vidmem:
+	free(mem.vidmem_alloc);
+
+	if (success)
+		return UNIT_SUCCESS;
+	else
+		return UNIT_FAIL;
+}
+
 /*
  * Test case to exercize the special case where NVGPU is dying. In that case,
  * PRAM is not available and PRAMIN should handle the case by not trying to
@@ -504,6 +573,7 @@ struct unit_module_test pramin_tests[] = {
 	UNIT_TEST(nvgpu_pramin_rd_n_1_sgl, test_pramin_rd_n_single, NULL, 0),
 	UNIT_TEST(nvgpu_pramin_wr_n_3_sgl, test_pramin_wr_n_multi, NULL, 0),
 	UNIT_TEST(nvgpu_pramin_memset, test_pramin_memset, NULL, 0),
+	UNIT_TEST(nvgpu_pramin_window_cache, test_pramin_window_cache, NULL, 0),
 	UNIT_TEST(nvgpu_pramin_dying, test_pramin_nvgpu_dying, NULL, 0),
 	UNIT_TEST(nvgpu_pramin_free_test_env, free_test_env, NULL, 0),
 #endif
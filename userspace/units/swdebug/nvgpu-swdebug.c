@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <unit/io.h>
+#include <unit/unit.h>
+
+#include <nvgpu/gk20a.h>
+#include <nvgpu/swhist.h>
+#include <nvgpu/thread.h>
+#include <nvgpu/string.h>
+
+#include "nvgpu-swdebug.h"
+
+#define TEST_THREADS		8U
+#define TEST_THREAD_SAMPLES	10000U
+
+int test_swhist_bucket(struct unit_module *m, struct gk20a *g, void *args)
+{
+	const u64 ns[] = { 0ULL, 1ULL, 2ULL, 3ULL, 4ULL, 1023ULL, 1024ULL,
+			   1ULL << 40 };
+	const u32 expected[] = { 0U, 0U, 1U, 1U, 2U, 9U, 10U,
+				 NVGPU_SWHIST_BUCKETS - 1U };
+	u32 i;
+
+	for (i = 0U; i < ARRAY_SIZE(ns); i++) {
+		if (nvgpu_swhist_bucket(ns[i]) != expected[i]) {
+			unit_return_fail(m, "%llu ns in bucket %u\n", ns[i],
+				nvgpu_swhist_bucket(ns[i]));
+		}
+	}
+
+	return UNIT_SUCCESS;
+}
+
+int test_swhist_record(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_swhist h;
+	struct nvgpu_swhist_data data, empty;
+	s64 start_ns;
+	u32 i;
+
+	(void) memset(&h, 0, sizeof(h));
+	(void) memset(&empty, 0, sizeof(empty));
+
+	for (i = 0U; i < 100U; i++) {
+		nvgpu_swhist_record(g, &h, (i < 90U) ? 100ULL : 5000ULL);
+	}
+
+	nvgpu_swhist_read(&h, &data);
+	if ((data.count != 100ULL) || (data.sum_ns != 59000ULL) ||
+	    (data.max_ns != 5000ULL) ||
+	    (data.buckets[nvgpu_swhist_bucket(100ULL)] != 90ULL) ||
+	    (data.buckets[nvgpu_swhist_bucket(5000ULL)] != 10ULL)) {
+		unit_return_fail(m, "bad histogram copy\n");
+	}
+
+	if ((nvgpu_swhist_percentile(&data, 50U) != 127ULL) ||
+	    (nvgpu_swhist_percentile(&data, 99U) != 5000ULL) ||
+	    (nvgpu_swhist_percentile(&empty, 50U) != 0ULL)) {
+		unit_return_fail(m, "bad percentiles\n");
+	}
+
+	nvgpu_swhist_merge(&data, &data);
+	if ((data.count != 200ULL) || (data.sum_ns != 118000ULL) ||
+	    (data.max_ns != 5000ULL) ||
+	    (data.buckets[nvgpu_swhist_bucket(100ULL)] != 180ULL)) {
+		unit_return_fail(m, "bad merge\n");
+	}
+
+	nvgpu_swhist_reset(&h);
+	nvgpu_swhist_read(&h, &data);
+	if (memcmp(&data, &empty, sizeof(data)) != 0) {
+		unit_return_fail(m, "histogram not cleared\n");
+	}
+
+	nvgpu_swhist_reset(&g->swhist[NVGPU_SWHIST_PREEMPT]);
+	start_ns = nvgpu_swhist_begin();
+	nvgpu_swhist_end(g, NVGPU_SWHIST_PREEMPT, start_ns);
+	nvgpu_swhist_read_probe(g, NVGPU_SWHIST_PREEMPT, &data);
+	if (data.count != 1ULL) {
+		unit_return_fail(m, "probe not recorded\n");
+	}
+
+	if ((strcmp(nvgpu_swhist_probe_name(NVGPU_SWHIST_SUBMIT),
+			"submit") != 0) ||
+	    (strcmp(nvgpu_swhist_probe_name(NVGPU_SWHIST_NUM_PROBES),
+			"unknown") != 0)) {
+		unit_return_fail(m, "bad probe names\n");
+	}
+
+	return UNIT_SUCCESS;
+}
+
+struct swhist_thread_args {
+	struct gk20a *g;
+	struct nvgpu_swhist *h;
+	u64 ns;
+};
+
+static int swhist_thread_fn(void *data)
+{
+	struct swhist_thread_args *args = data;
+	u32 i;
+
+	for (i = 0U; i < TEST_THREAD_SAMPLES; i++) {
+		nvgpu_swhist_record(args->g, args->h, args->ns);
+	}
+
+	return 0;
+}
+
+int test_swhist_concurrent(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct nvgpu_thread threads[TEST_THREADS];
+	struct swhist_thread_args targs[TEST_THREADS];
+	struct nvgpu_swhist h;
+	struct nvgpu_swhist_data data;
+	u64 sum = 0ULL;
+	u32 i, started = 0U;
+	int ret = UNIT_SUCCESS;
+
+	(void) memset(&h, 0, sizeof(h));
+	(void) memset(threads, 0, sizeof(threads));
+
+	for (i = 0U; i < TEST_THREADS; i++) {
+		targs[i].g = g;
+		targs[i].h = &h;
+		targs[i].ns = 1ULL << i;
+		sum += TEST_THREAD_SAMPLES * targs[i].ns;
+
+		if (nvgpu_thread_create(&threads[i], &targs[i],
+				swhist_thread_fn, "swhist_test") != 0) {
+			unit_err(m, "thread %u create failed\n", i);
+			ret = UNIT_FAIL;
+			break;
+		}
+		started++;
+	}
+
+	for (i = 0U; i < started; i++) {
+		nvgpu_thread_join(&threads[i]);
+	}
+
+	if (ret != UNIT_SUCCESS) {
+		return ret;
+	}
+
+	nvgpu_swhist_read(&h, &data);
+	if ((data.count != (u64)TEST_THREADS * TEST_THREAD_SAMPLES) ||
+	    (data.sum_ns != sum) ||
+	    (data.max_ns != 1ULL << (TEST_THREADS - 1U))) {
+		unit_return_fail(m, "samples lost: count %llu sum %llu\n",
+			data.count, data.sum_ns);
+	}
+
+	for (i = 0U; i < TEST_THREADS; i++) {
+		if (data.buckets[i] != TEST_THREAD_SAMPLES) {
+			unit_return_fail(m, "bucket %u: %llu\n", i,
+				data.buckets[i]);
+		}
+	}
+
+	return UNIT_SUCCESS;
+}
+
+struct unit_module_test swdebug_tests[] = {
+	UNIT_TEST(swhist_bucket, test_swhist_bucket, NULL, 0),
+	UNIT_TEST(swhist_record, test_swhist_record, NULL, 0),
+	UNIT_TEST(swhist_concurrent, test_swhist_concurrent, NULL, 0),
+};
+
+UNIT_MODULE(swdebug, swdebug_tests, UNIT_PRIO_NVGPU_TEST);
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef UNIT_NVGPU_SWDEBUG_H
+#define UNIT_NVGPU_SWDEBUG_H
+
+struct gk20a;
+struct unit_module;
+
+/** @addtogroup SWUTS-swdebug
+ *  @{
+ *
+ * Software Unit Test Specification for nvgpu.common.swdebug
+ */
+
+/**
+ * Test specification for: test_swhist_bucket
+ *
+ * Description: Verify the latency to bucket mapping of the histograms.
+ *
+ * Test Type: Feature Based
+ *
+ * Targets: nvgpu_swhist_bucket
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Map 0, 1, 2, 3, 4, 1023, 1024 and 2^40 ns to buckets.
+ * - Verify 0 and 1 map to bucket 0, powers of two start a new bucket and
+ *   latencies past the last bucket are clamped to it.
+ *
+ * Output: Returns PASS if all mappings are as expected, FAIL otherwise.
+ */
+int test_swhist_bucket(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_swhist_record
+ *
+ * Description: Verify recording, reading, merging and clearing histograms.
+ *
+ * Test Type: Feature Based
+ *
+ * Targets: nvgpu_swhist_record, nvgpu_swhist_read, nvgpu_swhist_merge,
+ *          nvgpu_swhist_percentile, nvgpu_swhist_reset,
+ *          nvgpu_swhist_begin, nvgpu_swhist_end, nvgpu_swhist_read_probe,
+ *          nvgpu_swhist_probe_name
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Record 90 samples of 100 ns and 10 samples of 5000 ns.
+ * - Verify count, sum, max and bucket counts of the copy.
+ * - Verify the 50th and 99th percentiles fall in the buckets of 100 ns and
+ *   5000 ns, and the percentile of an empty histogram is 0.
+ * - Merge the copy into itself and verify all totals doubled.
+ * - Clear the histogram and verify it reads back empty.
+ * - Time a probe with nvgpu_swhist_begin/end and verify it has one sample.
+ * - Verify the probe names.
+ *
+ * Output: Returns PASS if all checks pass, FAIL otherwise.
+ */
+int test_swhist_record(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * Test specification for: test_swhist_concurrent
+ *
+ * Description: Verify no sample is lost when several threads record into
+ * the same histogram.
+ *
+ * Test Type: Feature Based
+ *
+ * Targets: nvgpu_swhist_record, nvgpu_swhist_read
+ *
+ * Input: None
+ *
+ * Steps:
+ * - Start 8 threads which each record 10000 samples into one histogram.
+ * - Join the threads and verify the count, sum and buckets add up.
+ *
+ * Output: Returns PASS if all samples are accounted, FAIL otherwise.
+ */
+int test_swhist_concurrent(struct unit_module *m, struct gk20a *g, void *args);
+
+/**
+ * @}
+ */
+
+#endif /* UNIT_NVGPU_SWDEBUG_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2021, NVIDIA CORPORATION.  All rights reserved.
+ * Copyright (c) 2019-2022, NVIDIA CORPORATION.  All rights reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a
  * copy of this software and associated documentation files (the "Software"),
@@ -32,6 +32,7 @@
 #include <nvgpu/posix/posix-nvhost.h>
 #include <nvgpu/channel.h>
 #include <nvgpu/channel_user_syncpt.h>
+#include <nvgpu/priv_cmdbuf.h>
 
 #include "../fifo/nvgpu-fifo-common.h"
 #include "../fifo/nvgpu-fifo-gv11b.h"
@@ -515,6 +516,129 @@ done:
 	return ret;
 }
 
+#define PRIV_CMDBUF_TEST_JOBS	4U
+#define PRIV_CMDBUF_TEST_MAX	512U
+/* Typical semaphore wait and incr command sizes in words */
+#define PRIV_CMDBUF_TEST_WAIT	8U
+#define PRIV_CMDBUF_TEST_INCR	10U
+
+static struct priv_cmd_entry *priv_cmd_entries[PRIV_CMDBUF_TEST_MAX];
+
+static u64 priv_cmdbuf_entry_gva(struct gk20a *g, struct priv_cmd_entry *e,
+		u32 size)
+{
+	u64 gva = 0ULL;
+	u32 entry_size = 0U;
+
+	nvgpu_priv_cmdbuf_append_zeros(g, e, size);
+	nvgpu_priv_cmdbuf_finish(g, e, &gva, &entry_size);
+
+	return (entry_size == size) ? gva : 0ULL;
+}
+
+int test_sync_priv_cmdbuf(struct unit_module *m, struct gk20a *g, void *args)
+{
+	struct priv_cmd_queue *q = NULL;
+	struct nvgpu_priv_cmdbuf_stats stats;
+	u32 wait_size = PRIV_CMDBUF_TEST_WAIT;
+	u32 n, i;
+	u64 gva_a, gva_b;
+	int ret = UNIT_FAIL;
+	int err;
+
+	/* Fixed size queue: fill the wait class, free out of order */
+	err = nvgpu_priv_cmdbuf_queue_alloc_sized(ch->vm,
+			PRIV_CMDBUF_TEST_WAIT, PRIV_CMDBUF_TEST_INCR,
+			PRIV_CMDBUF_TEST_JOBS, false, &q);
+	assert(err == 0);
+
+	nvgpu_priv_cmdbuf_queue_get_stats(q, &stats);
+	assert(stats.wait.slabs == 1U);
+	assert(stats.wait.max_slabs == 1U);
+	assert(stats.wait.slots_total >= PRIV_CMDBUF_TEST_JOBS);
+	assert(stats.wait.slots_total <= PRIV_CMDBUF_TEST_MAX);
+	assert(stats.incr.slots_total >= PRIV_CMDBUF_TEST_JOBS);
+
+	for (n = 0U; n < PRIV_CMDBUF_TEST_MAX; n++) {
+		err = nvgpu_priv_cmdbuf_alloc(q, wait_size,
+				&priv_cmd_entries[n]);
+		if (err != 0) {
+			break;
+		}
+	}
+	assert(err == -EAGAIN);
+	assert(n == stats.wait.slots_total);
+
+	nvgpu_priv_cmdbuf_queue_get_stats(q, &stats);
+	assert(stats.wait.slots_used == n);
+	assert(stats.wait.alloc_failures == 1ULL);
+	assert(stats.wait.grows == 0U);
+
+	/* A free in the middle makes room again; the slot is reused */
+	gva_a = priv_cmdbuf_entry_gva(g, priv_cmd_entries[n / 2U], wait_size);
+	assert(gva_a != 0ULL);
+	nvgpu_priv_cmdbuf_free(q, priv_cmd_entries[n / 2U]);
+	err = nvgpu_priv_cmdbuf_alloc(q, wait_size,
+			&priv_cmd_entries[n / 2U]);
+	assert(err == 0);
+	gva_b = priv_cmdbuf_entry_gva(g, priv_cmd_entries[n / 2U], wait_size);
+	assert(gva_a == gva_b);
+
+	for (i = 0U; i < n; i++) {
+		nvgpu_priv_cmdbuf_free(q, priv_cmd_entries[n - 1U - i]);
+	}
+
+	nvgpu_priv_cmdbuf_queue_get_stats(q, &stats);
+	assert(stats.wait.slots_used == 0U);
+	assert(stats.wait.slots_peak == n);
+
+	/* Multiple pre-fences take contiguous wait slots */
+	err = nvgpu_priv_cmdbuf_alloc(q, 3U * wait_size,
+			&priv_cmd_entries[0]);
+	assert(err == 0);
+	nvgpu_priv_cmdbuf_queue_get_stats(q, &stats);
+	assert(stats.wait.slots_used == 3U);
+	nvgpu_priv_cmdbuf_rollback(q, priv_cmd_entries[0]);
+
+	nvgpu_priv_cmdbuf_queue_free(q);
+	q = NULL;
+
+	/* Growable queue: one extra slab once the first one is full */
+	err = nvgpu_priv_cmdbuf_queue_alloc_sized(ch->vm,
+			PRIV_CMDBUF_TEST_WAIT, PRIV_CMDBUF_TEST_INCR,
+			PRIV_CMDBUF_TEST_JOBS, true, &q);
+	assert(err == 0);
+
+	nvgpu_priv_cmdbuf_queue_get_stats(q, &stats);
+	n = stats.wait.slots_total + 1U;
+	assert(n <= PRIV_CMDBUF_TEST_MAX);
+
+	for (i = 0U; i < n; i++) {
+		err = nvgpu_priv_cmdbuf_alloc(q, wait_size,
+				&priv_cmd_entries[i]);
+		assert(err == 0);
+	}
+
+	nvgpu_priv_cmdbuf_queue_get_stats(q, &stats);
+	assert(stats.wait.slabs == 2U);
+	assert(stats.wait.grows == 1U);
+	assert(stats.wait.slots_used == n);
+	assert(stats.incr.slabs == 1U);
+
+	for (i = 0U; i < n; i++) {
+		nvgpu_priv_cmdbuf_free(q, priv_cmd_entries[i]);
+	}
+
+	ret = UNIT_SUCCESS;
+
+done:
+	if (q != NULL) {
+		nvgpu_priv_cmdbuf_queue_free(q);
+	}
+
+	return ret;
+}
+
 int test_sync_deinit(struct unit_module *m, struct gk20a *g, void *args)
 {
 
@@ -541,6 +665,7 @@ struct unit_module_test nvgpu_sync_tests[] = {
 	UNIT_TEST(sync_user_managed_apis, test_sync_usermanaged_syncpt_apis, NULL, 0),
 	UNIT_TEST(sync_get_ro_map, test_sync_get_ro_map, NULL, 0),
 	UNIT_TEST(sync_fail, test_sync_create_fail, NULL, 0),
+	UNIT_TEST(sync_priv_cmdbuf, test_sync_priv_cmdbuf, NULL, 0),
 	UNIT_TEST(sync_deinit, test_sync_deinit, NULL, 0),
 };
 
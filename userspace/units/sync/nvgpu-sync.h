@@ -203,6 +203,39 @@ int test_sync_get_ro_map(struct unit_module *m, struct gk20a *g, void *args);
  */
 int test_sync_create_fail(struct unit_module *m, struct gk20a *g, void *args);
 
+/**
+ * Test specification for: test_sync_priv_cmdbuf
+ *
+ * Description: Slab based private command buffer allocation
+ *
+ * Test Type: Feature
+ *
+ * Targets: nvgpu_priv_cmdbuf_queue_alloc_sized, nvgpu_priv_cmdbuf_alloc,
+ *	    nvgpu_priv_cmdbuf_free, nvgpu_priv_cmdbuf_rollback,
+ *	    nvgpu_priv_cmdbuf_queue_get_stats, nvgpu_priv_cmdbuf_queue_free,
+ *	    nvgpu_priv_cmdbuf_append_zeros, nvgpu_priv_cmdbuf_finish
+ *
+ * Input: test_sync_init run for this GPU
+ *
+ * Steps:
+ * - Create a queue that cannot grow, with wait and incr commands of 8 and 10
+ *   words.
+ *   - Allocate wait commands until -EAGAIN is returned; check that the number
+ *     of allocations equals the number of wait slots.
+ *   - Free an entry in the middle and check that the next allocation
+ *     succeeds and gets the same GPU VA.
+ *   - Free all entries in reverse order; check that the used slot count is
+ *     zero and the peak equals the number of slots.
+ *   - Allocate a command of three wait commands and check that it takes
+ *     three slots.
+ * - Create a growable queue.
+ *   - Allocate one wait command more than fits in the first slab; check
+ *     that the wait class grew to two slabs and the incr class did not.
+ *
+ * Output: Returns PASS if all the above steps are successful. FAIL otherwise.
+ */
+int test_sync_priv_cmdbuf(struct unit_module *m, struct gk20a *g, void *args);
+
 /** @} */
 
 #endif /* UNIT_NVGPU_SYNC_H */